@@ -0,0 +1,430 @@
+// benchmain.cpp - бенчмарк всех зарегистрированных шифров
+//
+// Для каждого шифра из CipherFactory::getAllCiphers() прогоняет матрицу
+// размеров входа (16 Б … 64 МБ) и печатает JSON: МБ/с, нс/байт,
+// p50/p99 времени одного вызова и число выделений памяти на вызов.
+//
+//   cryptoApp_bench [--cipher id]... [--max-size байт] [--params file.json] [--portable]
+//                   [--a52-attack] [-o out.json]
+//   cryptoApp_bench --self-test [-o out.json]
+//
+// Шифры с бинарным путём (supportsBytes) измеряются через encryptBytes,
+// остальные — через encrypt(QString) на русском тексте; трассировка шагов
+// отключена (traceLevel=none), чтобы мерить сам шифр. С --portable каждый
+// шифр прогоняется ещё раз с отключёнными SIMD/AES-NI путями (portableResults).
+// --a52-attack добавляет замер восстановления ключа A5/2 по известной гамме
+// (a52Attack): догадок R4 в секунду и время до нахождения ключа.
+// --self-test вместо замеров прогоняет контрольные примеры (selftest.h):
+// ГОСТ Р 34.13-2015 А.1/А.2, MGM, AES и NIST GCM; код возврата 1 при несовпадении.
+
+#include <cstdlib>
+#include <cstdio>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSysInfo>
+#include "cipherfactory.h"
+#include "cpufeatures.h"
+#include "a52.h"
+#include "a52attack.h"
+#include "selftest.h"
+
+// ==================== Счётчик выделений памяти ====================
+// На glibc перехватываем malloc целиком — так учитываются и контейнеры Qt,
+// которые выделяют память мимо operator new. На остальных платформах
+// считаются только выделения через operator new.
+static std::atomic<quint64> g_allocations{0};
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) __THROW
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) __THROW
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) __THROW
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+#include <new>
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+namespace {
+    // Матрица размеров входа
+    const qint64 SIZES[] = {
+        16, 256, 4 * 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024
+    };
+
+    // Ограничения на одну ячейку матрицы
+    const qint64 MIN_CELL_NS = 200 * 1000 * 1000LL;   // не меньше 0.2 с измерений
+    const int MIN_ITERATIONS = 5;
+    const int MAX_ITERATIONS = 10000;
+    const qint64 SLOW_CALL_NS = 250 * 1000 * 1000LL;  // дальше не растём, если один вызов дольше
+
+    const QString RUSSIAN = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+
+    // Параметры по умолчанию — общие для блочных и поточных шифров
+    QVariantMap defaultParams()
+    {
+        QVariantMap params;
+        params["key"] = "8899AABBCCDDEEFF0011223344556677FEDCBA98765432100123456789ABCDEF";
+        params["keySize"] = "256";
+        params["iv"] = "1234567890ABCEF0";
+        params["keyType"] = "binary";
+        params["binaryKey"] = "0001001000110100010101100111100010011010101111001101111011110001";
+        params["traceLevel"] = "none";
+        return params;
+    }
+
+    struct Cell {
+        qint64 size = 0;
+        int iterations = 0;
+        qint64 totalNs = 0;
+        qint64 p50Ns = 0;
+        qint64 p99Ns = 0;
+        double allocsPerCall = 0;
+        QString error;
+    };
+
+    qint64 percentile(std::vector<qint64>& samples, double p)
+    {
+        std::sort(samples.begin(), samples.end());
+        size_t idx = size_t(p * double(samples.size() - 1) + 0.5);
+        return samples[std::min(idx, samples.size() - 1)];
+    }
+
+    // Один вызов шифра; false + error, если шифр вернул ошибку
+    using Call = std::function<bool(QString&)>;
+
+    Cell measure(qint64 size, const Call& call)
+    {
+        Cell cell;
+        cell.size = size;
+
+        // Прогрев и проверка параметров
+        if (!call(cell.error)) {
+            return cell;
+        }
+
+        std::vector<qint64> samples;
+        samples.reserve(MAX_ITERATIONS);
+        quint64 allocsBefore = g_allocations.load(std::memory_order_relaxed);
+        QElapsedTimer timer;
+        QString error;
+
+        while (cell.iterations < MAX_ITERATIONS &&
+               (cell.iterations < MIN_ITERATIONS || cell.totalNs < MIN_CELL_NS)) {
+            timer.start();
+            call(error);
+            qint64 ns = timer.nsecsElapsed();
+            samples.push_back(ns);
+            cell.totalNs += ns;
+            ++cell.iterations;
+
+            // Крупные входы медленных шифров — хватит и одного вызова
+            if (ns > SLOW_CALL_NS) {
+                break;
+            }
+        }
+
+        quint64 allocs = g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+        // samples.reserve выполнен до замера, push_back не выделяет
+        cell.allocsPerCall = double(allocs) / cell.iterations;
+        cell.p99Ns = percentile(samples, 0.99);
+        cell.p50Ns = percentile(samples, 0.50);
+        return cell;
+    }
+
+    QJsonObject cellToJson(const Cell& cell)
+    {
+        QJsonObject obj;
+        obj["size"] = cell.size;
+        if (!cell.error.isEmpty()) {
+            obj["error"] = cell.error;
+            return obj;
+        }
+
+        double seconds = double(cell.totalNs) / 1e9;
+        double bytes = double(cell.size) * cell.iterations;
+        obj["iterations"] = cell.iterations;
+        obj["mbPerSec"] = seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+        obj["nsPerByte"] = bytes > 0 ? double(cell.totalNs) / bytes : 0.0;
+        obj["p50Ns"] = cell.p50Ns;
+        obj["p99Ns"] = cell.p99Ns;
+        obj["allocsPerCall"] = cell.allocsPerCall;
+        return obj;
+    }
+
+    QJsonArray benchSizes(CipherInterface* cipher, const QVariantMap& params, qint64 maxSize)
+    {
+        const bool bytesMode = cipher->supportsBytes();
+
+        QJsonArray results;
+        for (qint64 size : SIZES) {
+            if (size > maxSize) {
+                break;
+            }
+
+            Cell cell;
+            if (bytesMode) {
+                QByteArray input(size, Qt::Uninitialized);
+                QRandomGenerator gen(quint32(size));
+                for (qint64 i = 0; i < size; ++i) {
+                    input[i] = char(gen.generate() & 0xFF);
+                }
+                QByteArray output;
+                cell = measure(size, [&](QString& error) {
+                    return cipher->encryptBytes(input, output, params, &error);
+                });
+            } else {
+                QString input;
+                input.reserve(size);
+                for (qint64 i = 0; i < size; ++i) {
+                    input.append(RUSSIAN[int(i % RUSSIAN.size())]);
+                }
+                cell = measure(size, [&](QString& error) {
+                    CipherResult result = cipher->encrypt(input, params);
+                    if (!result.ok()) {
+                        error = result.message;
+                        return false;
+                    }
+                    return true;
+                });
+            }
+
+            results.append(cellToJson(cell));
+
+            // Ошибка параметров или слишком медленный шифр — большие размеры не нужны
+            if (!cell.error.isEmpty() || cell.totalNs / qMax(cell.iterations, 1) > SLOW_CALL_NS) {
+                break;
+            }
+        }
+        return results;
+    }
+
+    QJsonObject benchCipher(const CipherInfo& info, const QVariantMap& params, qint64 maxSize, bool portable)
+    {
+        std::unique_ptr<CipherInterface> cipher(info.creator());
+        const bool bytesMode = cipher->supportsBytes();
+
+        QJsonObject obj;
+        obj["id"] = info.id;
+        obj["name"] = info.displayName;
+        obj["category"] = info.categoryName();
+        obj["mode"] = bytesMode ? "bytes" : "text";
+        obj["unit"] = bytesMode ? "byte" : "char";
+        obj["results"] = benchSizes(cipher.get(), params, maxSize);
+
+        if (portable) {
+            const bool wasEnabled = CpuFeatures::isEnabled();
+            CpuFeatures::setEnabled(false);
+            obj["portableResults"] = benchSizes(cipher.get(), params, maxSize);
+            CpuFeatures::setEnabled(wasEnabled);
+        }
+        return obj;
+    }
+
+    QJsonObject cpuFeaturesToJson()
+    {
+        const CpuFeatures& features = CpuFeatures::detected();
+        QJsonObject obj;
+        obj["enabled"] = CpuFeatures::isEnabled();
+        obj["sse2"] = features.sse2;
+        obj["ssse3"] = features.ssse3;
+        obj["avx2"] = features.avx2;
+        obj["aesni"] = features.aesni;
+        obj["pclmul"] = features.pclmul;
+        return obj;
+    }
+
+    // Восстановление случайного ключа A5/2 по гамме двух кадров со случайными номерами
+    QJsonObject benchA52Attack()
+    {
+        QRandomGenerator* rng = QRandomGenerator::global();
+        const uint64_t key = rng->generate64();
+        A52Generator generator(key);
+
+        QVector<A52KnownFrame> frames;
+        for (int i = 0; i < 2; ++i) {
+            A52KnownFrame frame;
+            frame.frame = rng->generate() & A52Cipher::FRAME_MASK;
+            frame.bits = A52Cipher::FRAME_BITS;
+            frame.keystream.resize((frame.bits + 7) / 8);
+            generator.startFrame(frame.frame);
+            generator.generate(reinterpret_cast<uint8_t*>(frame.keystream.data()), frame.keystream.size());
+            frames.append(frame);
+        }
+
+        uint64_t found = 0;
+        A52Attack::Stats stats;
+        QString error;
+        const bool ok = A52Attack::recoverKey(frames, found, &stats, &error);
+
+        QJsonObject obj;
+        obj["frames"] = int(frames.size());
+        obj["guessBits"] = A52Attack::GUESS_BITS;
+        obj["guesses"] = stats.guesses;
+        obj["seconds"] = double(stats.elapsedNs) / 1e9;
+        obj["guessesPerSec"] = stats.guessesPerSecond();
+        obj["found"] = ok;
+        if (!ok) {
+            obj["error"] = error;
+            return obj;
+        }
+
+        // Ключ эквивалентный, а не исходный — сверяется гамма кадра, которого не было в атаке
+        const uint32_t check = rng->generate() & A52Cipher::FRAME_MASK;
+        QByteArray expected(frames.first().keystream.size(), 0);
+        QByteArray actual(expected.size(), 0);
+        generator.startFrame(check);
+        generator.generate(reinterpret_cast<uint8_t*>(expected.data()), expected.size());
+        A52Generator recovered(found);
+        recovered.startFrame(check);
+        recovered.generate(reinterpret_cast<uint8_t*>(actual.data()), actual.size());
+        obj["equivalentKey"] = actual == expected;
+        return obj;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Бенчмарк пропускной способности и задержки шифров cryptoApp");
+    parser.addHelpOption();
+    QCommandLineOption cipherOption({"c", "cipher"}, "Только указанный шифр (можно повторять).", "id");
+    QCommandLineOption maxSizeOption("max-size", "Максимальный размер входа в байтах (64 МБ).", "bytes",
+                                     QString::number(64 * 1024 * 1024));
+    QCommandLineOption paramsOption("params",
+        "JSON-объект {\"<id>\": {параметры}} поверх параметров по умолчанию.", "file.json");
+    QCommandLineOption portableOption("portable",
+        "Дополнительно замерить каждый шифр без SIMD/AES-NI (поле portableResults).");
+    QCommandLineOption a52AttackOption("a52-attack",
+        "Замерить восстановление ключа A5/2 по известной гамме (поле a52Attack).");
+    QCommandLineOption selfTestOption("self-test",
+        "Вместо замеров проверить контрольные примеры ГОСТ Р 34.13-2015, MGM, AES и GCM (поле selfTest).");
+    QCommandLineOption outputOption({"o", "output"}, "Файл для JSON (по умолчанию stdout).", "file");
+    parser.addOptions({cipherOption, maxSizeOption, paramsOption, portableOption, a52AttackOption,
+                       selfTestOption, outputOption});
+    parser.process(app);
+
+    QList<int> onlyIds;
+    for (const QString& id : parser.values(cipherOption)) {
+        onlyIds.append(id.toInt());
+    }
+    qint64 maxSize = parser.value(maxSizeOption).toLongLong();
+
+    QJsonObject overrides;
+    if (parser.isSet(paramsOption)) {
+        QFile file(parser.value(paramsOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCritical().noquote() << "ОШИБКА: Не удалось открыть" << file.fileName();
+            return 2;
+        }
+        overrides = QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    // Режим контрольных примеров — без замеров шифров
+    const bool selfTestMode = parser.isSet(selfTestOption);
+    int selfTestFailed = 0;
+    QJsonObject selfTest;
+    if (selfTestMode) {
+        qInfo().noquote() << "Контрольные примеры";
+        selfTest = SelfTest::run(selfTestFailed);
+    }
+
+    QJsonArray ciphers;
+    const QMap<int, CipherInfo>& all = CipherFactory::instance().getAllCiphers();
+    for (const CipherInfo& info : all) {
+        if (selfTestMode || (!onlyIds.isEmpty() && !onlyIds.contains(info.id))) {
+            continue;
+        }
+
+        QVariantMap params = defaultParams();
+        const QVariantMap extra = overrides.value(QString::number(info.id)).toObject().toVariantMap();
+        for (auto it = extra.constBegin(); it != extra.constEnd(); ++it) {
+            params.insert(it.key(), it.value());
+        }
+
+        qInfo().noquote() << "Бенчмарк:" << info.displayName;
+        ciphers.append(benchCipher(info, params, maxSize, parser.isSet(portableOption)));
+    }
+
+    QJsonObject report;
+    report["tool"] = "cryptoApp_bench";
+    report["formatVersion"] = 1;
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["qtVersion"] = qVersion();
+    report["cpu"] = QSysInfo::currentCpuArchitecture();
+    report["cpuFeatures"] = cpuFeaturesToJson();
+    report["os"] = QSysInfo::prettyProductName();
+    report["ciphers"] = ciphers;
+    if (selfTestMode) {
+        report["selfTest"] = selfTest;
+    }
+    if (parser.isSet(a52AttackOption)) {
+        qInfo().noquote() << "Бенчмарк: восстановление ключа A5/2";
+        report["a52Attack"] = benchA52Attack();
+    }
+
+    QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile out(parser.value(outputOption));
+        if (!out.open(QIODevice::WriteOnly) || out.write(json) != json.size()) {
+            qCritical().noquote() << "ОШИБКА: Не удалось записать" << out.fileName();
+            return 1;
+        }
+    } else {
+        fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    }
+
+    if (selfTestFailed > 0) {
+        qCritical().noquote() << "ОШИБКА: Не пройдено контрольных примеров:" << selfTestFailed;
+        return 1;
+    }
+    return 0;
+}
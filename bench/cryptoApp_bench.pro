@@ -0,0 +1,42 @@
+# Бенчмарк шифров: qmake bench/cryptoApp_bench.pro && make
+# Собирает те же исходники, что и cryptoApp, но со своей точкой входа.
+CONFIG += c++17 console
+CONFIG -= app_bundle
+QT += core widgets printsupport
+
+TARGET = cryptoApp_bench
+TEMPLATE = app
+
+ROOT = $$PWD/..
+
+INCLUDEPATH += \
+    $$ROOT \
+    $$ROOT/core \
+    $$ROOT/gui \
+    $$ROOT/ciphers \
+    $$ROOT/fabrics \
+    $$ROOT/classes \
+    $$ROOT/cli
+
+SOURCES += \
+    benchmain.cpp \
+    selftest.cpp \
+    $$files($$ROOT/core/*.cpp) \
+    $$files($$ROOT/ciphers/*.cpp) \
+    $$files($$ROOT/fabrics/*.cpp) \
+    $$files($$ROOT/classes/*.cpp) \
+    $$files($$ROOT/gui/*.cpp)
+
+HEADERS += \
+    selftest.h \
+    $$files($$ROOT/core/*.h) \
+    $$files($$ROOT/ciphers/*.h) \
+    $$files($$ROOT/fabrics/*.h) \
+    $$files($$ROOT/classes/*.h) \
+    $$files($$ROOT/gui/*.h)
+
+win32 {
+    QMAKE_LFLAGS += -Wl,-subsystem,console
+}
+
+QMAKE_CXXFLAGS += -finput-charset=UTF-8 -fexec-charset=UTF-8
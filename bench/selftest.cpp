@@ -0,0 +1,254 @@
+#include "selftest.h"
+#include "cipherfactory.h"
+#include "cpufeatures.h"
+#include <QJsonArray>
+#include <QVariantMap>
+#include <memory>
+
+namespace {
+    // Номера шифров из их регистраций в CipherFactory
+    const int MAGMA_CTR_ID = 15;
+    const int MAGMA_ID = 18;
+    const int AES_ID = 19;
+    const int KUZNECHIK_ID = 20;
+
+    // Пустая строка — параметр не задается
+    struct KnownAnswer {
+        int cipherId;
+        const char* name;
+        const char* mode;
+        const char* key;
+        const char* keySize;
+        const char* iv;
+        const char* aad;
+        const char* plain;
+        const char* expected;
+    };
+
+    // ГОСТ Р 34.13-2015, приложение А.1
+    const char KUZ_KEY[] = "8899aabbccddeeff0011223344556677fedcba98765432100123456789abcdef";
+    const char KUZ_PLAIN[] =
+        "1122334455667700ffeeddccbbaa998800112233445566778899aabbcceeff0a"
+        "112233445566778899aabbcceeff0a002233445566778899aabbcceeff0a0011";
+    const char KUZ_IV[] = "1234567890abcef0a1b2c3d4e5f0011223344556677889901213141516171819";
+
+    // ГОСТ Р 34.13-2015, приложение А.2
+    const char MAGMA_KEY[] = "ffeeddccbbaa99887766554433221100f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+    const char MAGMA_PLAIN[] = "92def06b3c130a59db54c704f8189d204a98fb2e67a8024c8912409b17b57e41";
+    const char MAGMA_IV[] = "1234567890abcdef234567890abcdef1";
+
+    // NIST GCM, тестовые примеры 3-6
+    const char GCM_KEY[] = "feffe9928665731c6d6a8f9467308308";
+    const char GCM_PLAIN[] =
+        "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+        "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255";
+    const char GCM_PLAIN_60[] =
+        "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+        "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39";
+    const char GCM_AAD[] = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+
+    // SP 800-38A, приложение F
+    const char AES_KEY[] = "2b7e151628aed2a6abf7158809cf4f3c";
+    const char AES_PLAIN[] = "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51";
+
+    const KnownAnswer KNOWN_ANSWERS[] = {
+        {KUZNECHIK_ID, "ГОСТ Р 34.13-2015 А.1.1 ECB", "ECB", KUZ_KEY, "", "", "", KUZ_PLAIN,
+         "7f679d90bebc24305a468d42b9d4edcdb429912c6e0032f9285452d76718d08b"
+         "f0ca33549d247ceef3f5a5313bd4b157d0b09ccde830b9eb3a02c4c5aa8ada98"},
+        {KUZNECHIK_ID, "ГОСТ Р 34.13-2015 А.1.2 CTR", "CTR", KUZ_KEY, "", "1234567890abcef0", "", KUZ_PLAIN,
+         "f195d8bec10ed1dbd57b5fa240bda1b885eee733f6a13e5df33ce4b33c45dee4"
+         "a5eae88be6356ed3d5e877f13564a3a5cb91fab1f20cbab6d1c6d15820bdba73"},
+        {KUZNECHIK_ID, "ГОСТ Р 34.13-2015 А.1.3 OFB", "OFB", KUZ_KEY, "", KUZ_IV, "", KUZ_PLAIN,
+         "81800a59b1842b24ff1f795e897abd95ed5b47a7048cfab48fb521369d9326bf"
+         "66a257ac3ca0b8b1c80fe7fc10288a13203ebbc066138660a0292243f6903150"},
+        {KUZNECHIK_ID, "ГОСТ Р 34.13-2015 А.1.4 CBC", "CBC", KUZ_KEY, "", KUZ_IV, "", KUZ_PLAIN,
+         "689972d4a085fa4d90e52e3d6d7dcc272826e661b478eca6af1e8e448d5ea5ac"
+         "fe7babf1e91999e85640e8b0f49d90d0167688065a895c631a2d9a1560b63970"},
+        {KUZNECHIK_ID, "ГОСТ Р 34.13-2015 А.1.5 CFB", "CFB", KUZ_KEY, "", KUZ_IV, "", KUZ_PLAIN,
+         "81800a59b1842b24ff1f795e897abd95ed5b47a7048cfab48fb521369d9326bf"
+         "79f2a8eb5cc68d38842d264e97a238b54ffebecd4e922de6c75bd9dd44fbf4d1"},
+        {KUZNECHIK_ID, "ГОСТ Р 34.13-2015 А.1.6 MAC", "MAC", KUZ_KEY, "", "", "", KUZ_PLAIN,
+         "336f4d296059fbe3"},
+
+        {MAGMA_ID, "ГОСТ Р 34.13-2015 А.2.1 ECB", "ECB", MAGMA_KEY, "", "", "", MAGMA_PLAIN,
+         "2b073f0494f372a0de70e715d3556e4811d8d9e9eacfbc1e7c68260996c67efb"},
+        {MAGMA_ID, "ГОСТ Р 34.13-2015 А.2.2 CTR", "CTR", MAGMA_KEY, "", "12345678", "", MAGMA_PLAIN,
+         "4e98110c97b7b93c3e250d93d6e85d69136d868807b2dbef568eb680ab52a12d"},
+        {MAGMA_ID, "ГОСТ Р 34.13-2015 А.2.3 OFB", "OFB", MAGMA_KEY, "", MAGMA_IV, "", MAGMA_PLAIN,
+         "db37e0e266903c830d46644c1f9a089ca0f83062430e327ec824efb8bd4fdb05"},
+        {MAGMA_ID, "ГОСТ Р 34.13-2015 А.2.4 CBC", "CBC", MAGMA_KEY, "",
+         "1234567890abcdef234567890abcdef134567890abcdef12", "", MAGMA_PLAIN,
+         "96d1b05eea683919aff76129abb937b95058b4a1c4bc001920b78b1a7cd7e667"},
+        {MAGMA_ID, "ГОСТ Р 34.13-2015 А.2.5 CFB", "CFB", MAGMA_KEY, "", MAGMA_IV, "", MAGMA_PLAIN,
+         "db37e0e266903c830d46644c1f9a089c24bdd2035315d38bbcc0321421075505"},
+        {MAGMA_ID, "ГОСТ Р 34.13-2015 А.2.6 MAC", "MAC", MAGMA_KEY, "", "", "", MAGMA_PLAIN,
+         "154e7210"},
+
+        // У Магмы CTR синхропосылка — весь 64-битный счетчик: IV || 0 из примера А.2.2
+        {MAGMA_CTR_ID, "ГОСТ Р 34.13-2015 А.2.2 CTR (Магма CTR)", "CTR", MAGMA_KEY, "", "1234567800000000", "",
+         MAGMA_PLAIN,
+         "4e98110c97b7b93c3e250d93d6e85d69136d868807b2dbef568eb680ab52a12d"},
+
+        // Р 1323565.1.026-2019, приложения А.1 и А.2: шифртекст и имитовставка
+        {KUZNECHIK_ID, "Р 1323565.1.026-2019 MGM (Кузнечик)", "MGM", KUZ_KEY, "",
+         "1122334455667700ffeeddccbbaa9988",
+         "0202020202020202010101010101010104040404040404040303030303030303ea0505050505050505",
+         "1122334455667700ffeeddccbbaa998800112233445566778899aabbcceeff0a"
+         "112233445566778899aabbcceeff0a002233445566778899aabbcceeff0a0011aabbcc",
+         "a9757b8147956e9055b8a33de89f42fc8075d2212bf9fd5bd3f7069aadc16b39"
+         "497ab15915a6ba85936b5d0ea9f6851cc60c14d4d3f883d0ab94420695c76deb"
+         "2c7552cf5d656f40c34f5c46e8bb0e29fcdb4c"},
+        {MAGMA_CTR_ID, "Р 1323565.1.026-2019 MGM (Магма)", "MGM", MAGMA_KEY, "", "12def06b3c130a59",
+         "01010101010101010202020202020202030303030303030304040404040404040505050505050505ea",
+         "ffeeddccbbaa998811223344556677008899aabbcceeff0a0011223344556677"
+         "99aabbcceeff0a001122334455667788aabbcceeff0a00112233445566778899aabbcc",
+         "c795066c5f9ea03b85113342459185ae1f2e00d6bf2b785d940470b8bb9c8e7d"
+         "9a5dd3731f7ddc70ec27cb0ace6fa57670f65c646abb75d547aa37c3bcb5c34e"
+         "03bb9ca7928069aa10fd10"},
+
+        {AES_ID, "FIPS-197 C.1 AES-128", "ECB", "000102030405060708090a0b0c0d0e0f", "128", "", "",
+         "00112233445566778899aabbccddeeff", "69c4e0d86a7b0430d8cdb78070b4c55a"},
+        {AES_ID, "FIPS-197 C.3 AES-256", "ECB",
+         "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "256", "", "",
+         "00112233445566778899aabbccddeeff", "8ea2b7ca516745bfeafc49904b496089"},
+        {AES_ID, "SP 800-38A F.2.1 CBC-AES128", "CBC", AES_KEY, "128", "000102030405060708090a0b0c0d0e0f", "",
+         AES_PLAIN, "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"},
+        {AES_ID, "SP 800-38A F.5.1 CTR-AES128", "CTR", AES_KEY, "128", "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", "",
+         AES_PLAIN, "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"},
+
+        // Шифртекст || тег (128 бит)
+        {AES_ID, "NIST GCM Test Case 1", "GCM", "00000000000000000000000000000000", "128",
+         "000000000000000000000000", "", "", "58e2fccefa7e3061367f1d57a4e7455a"},
+        {AES_ID, "NIST GCM Test Case 2", "GCM", "00000000000000000000000000000000", "128",
+         "000000000000000000000000", "", "00000000000000000000000000000000",
+         "0388dace60b6a392f328c2b971b2fe78ab6e47d42cec13bdf53a67b21257bddf"},
+        {AES_ID, "NIST GCM Test Case 3", "GCM", GCM_KEY, "128", "cafebabefacedbaddecaf888", "", GCM_PLAIN,
+         "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+         "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985"
+         "4d5c2af327cd64a62cf35abd2ba6fab4"},
+        {AES_ID, "NIST GCM Test Case 4", "GCM", GCM_KEY, "128", "cafebabefacedbaddecaf888", GCM_AAD,
+         GCM_PLAIN_60,
+         "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+         "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091"
+         "5bc94fbc3221a5db94fae95ae7121a47"},
+        {AES_ID, "NIST GCM Test Case 5", "GCM", GCM_KEY, "128", "cafebabefacedbad", GCM_AAD, GCM_PLAIN_60,
+         "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c7423"
+         "73806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598"
+         "3612d2e79e3b0785561be14aaca2fccb"},
+        {AES_ID, "NIST GCM Test Case 6", "GCM", GCM_KEY, "128",
+         "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+         "c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b",
+         GCM_AAD, GCM_PLAIN_60,
+         "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca7"
+         "01e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5"
+         "619cc5aefffe0bfa462af43c1699d050"},
+    };
+
+    QVariantMap knownAnswerParams(const KnownAnswer& ka)
+    {
+        QVariantMap params;
+        params["mode"] = ka.mode;
+        params["key"] = ka.key;
+        params["traceLevel"] = "none";
+        if (*ka.keySize) {
+            params["keySize"] = ka.keySize;
+        }
+        if (*ka.iv) {
+            params["iv"] = ka.iv;
+        }
+        if (*ka.aad) {
+            params["aad"] = ka.aad;
+        }
+        return params;
+    }
+
+    // Зашифрование должно дать expected, расшифрование (кроме MAC) — вернуть plain
+    QJsonObject check(CipherInterface* cipher, const KnownAnswer& ka, bool& passed)
+    {
+        const QVariantMap params = knownAnswerParams(ka);
+        const QByteArray plain = QByteArray::fromHex(ka.plain);
+        const QByteArray expected = QByteArray::fromHex(ka.expected);
+
+        QJsonObject obj;
+        obj["name"] = ka.name;
+        obj["cipher"] = ka.cipherId;
+        obj["simd"] = CpuFeatures::isEnabled();
+        passed = false;
+
+        QByteArray out;
+        QString error;
+        if (!cipher->encryptBytes(plain, out, params, &error)) {
+            obj["error"] = error;
+            obj["passed"] = false;
+            return obj;
+        }
+        if (out != expected) {
+            obj["got"] = QString::fromLatin1(out.toHex());
+            obj["passed"] = false;
+            return obj;
+        }
+
+        if (QByteArray(ka.mode) != "MAC") {
+            QByteArray back;
+            if (!cipher->decryptBytes(out, back, params, &error)) {
+                obj["error"] = error;
+                obj["passed"] = false;
+                return obj;
+            }
+            if (back != plain) {
+                obj["decrypted"] = QString::fromLatin1(back.toHex());
+                obj["passed"] = false;
+                return obj;
+            }
+        }
+
+        passed = true;
+        obj["passed"] = true;
+        return obj;
+    }
+}
+
+QJsonObject SelfTest::run(int& failed)
+{
+    const QMap<int, CipherInfo>& all = CipherFactory::instance().getAllCiphers();
+    const bool wasEnabled = CpuFeatures::isEnabled();
+
+    QJsonArray cases;
+    int passedCount = 0;
+    failed = 0;
+    for (const KnownAnswer& ka : KNOWN_ANSWERS) {
+        QJsonObject obj;
+        if (!all.contains(ka.cipherId)) {
+            obj["name"] = ka.name;
+            obj["cipher"] = ka.cipherId;
+            obj["error"] = "Шифр не зарегистрирован";
+            obj["passed"] = false;
+            cases.append(obj);
+            ++failed;
+            continue;
+        }
+
+        std::unique_ptr<CipherInterface> cipher(all.value(ka.cipherId).creator());
+        // С ускоренными путями (если они не отключены) и на переносимом коде
+        for (bool simd : {true, false}) {
+            if (simd && !wasEnabled) {
+                continue;
+            }
+            CpuFeatures::setEnabled(simd);
+            bool passed = false;
+            cases.append(check(cipher.get(), ka, passed));
+            if (passed) {
+                ++passedCount;
+            } else {
+                ++failed;
+            }
+        }
+    }
+    CpuFeatures::setEnabled(wasEnabled);
+
+    QJsonObject result;
+    result["passed"] = passedCount;
+    result["failed"] = failed;
+    result["cases"] = cases;
+    return result;
+}
@@ -0,0 +1,17 @@
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+#include <QJsonObject>
+
+// Контрольные примеры (known-answer) для cryptoApp_bench --self-test: через
+// encryptBytes/decryptBytes шифров из CipherFactory прогоняются примеры
+// ГОСТ Р 34.13-2015 (приложения А.1 — Кузнечик, А.2 — Магма), пример MGM
+// из Р 1323565.1.026-2019, AES из FIPS-197 и SP 800-38A и тестовые примеры
+// GCM из спецификации NIST (McGrew, Viega). Каждый пример проверяется
+// с SIMD/AES-NI путями и без них.
+namespace SelfTest {
+    // {"passed", "failed", "cases": [...]}; failed — число несовпадений и ошибок
+    QJsonObject run(int& failed);
+}
+
+#endif // SELFTEST_H
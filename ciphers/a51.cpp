@@ -1,15 +1,23 @@
 #include "a51.h"
 #include "cipherfactory.h"
 #include "cipherwidgetfactory.h"
+#include "cpufeatures.h"
+#include "keyschedulecache.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QComboBox>
 #include <QStackedWidget>
+#include <QSpinBox>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 #include <QDebug>
 #include <cstring>
+#include <vector>
+
+#if defined(CRYPTOAPP_X86)
+#include <immintrin.h>
+#endif
 
 // ==================== Многочлены обратной связи ====================
 const int A51Cipher::R1_TAPS[4] = {18, 17, 16, 13};
@@ -128,202 +136,571 @@ void TextKeyEdit::focusOutEvent(QFocusEvent* event)
     QLineEdit::focusOutEvent(event);
 }
 
-// ==================== A51Cipher Implementation ====================
+// ==================== A51Generator Implementation ====================
+
+namespace {
+    const int REG_LEN[3] = {A51Cipher::R1_LEN, A51Cipher::R2_LEN, A51Cipher::R3_LEN};
+    const uint32_t REG_MASK[3] = {
+        (1u << A51Cipher::R1_LEN) - 1, (1u << A51Cipher::R2_LEN) - 1, (1u << A51Cipher::R3_LEN) - 1
+    };
+
+    struct A51Tables
+    {
+        // По 4 битам синхронизации каждого регистра (биты окна CLOCK_BIT..CLOCK_BIT+3):
+        // в битах 0-3, 4-7, 8-11 — на каких из четырех тактов сдвигались R1, R2, R3
+        // (бит j — такт j), в битах 12-14, 15-17, 18-20 — сколько раз
+        uint32_t steps[1 << 12];
+
+        // По маске тактов регистра и 5 битам окна начиная с LEN-1 — его вклад
+        // в 4 выходных бита (первый такт — старший бит)
+        uint8_t output[16][32];
+
+        // Окно из 64 бит по состоянию регистра — XOR выборок по байтам состояния
+        uint64_t expand[3][3][256];
+    };
+
+    // Окно последовательности регистра r по его состоянию: бит n ≥ LEN —
+    // обратная связь от битов n - LEN + TAPS[i]
+    uint64_t expandState(int r, uint32_t state)
+    {
+        static const int* const TAPS[3] = {A51Cipher::R1_TAPS, A51Cipher::R2_TAPS, A51Cipher::R3_TAPS};
+        static const int TAP_COUNT[3] = {4, 2, 4};
+
+        uint64_t w = state;
+        for (int n = REG_LEN[r]; n < 64; ++n) {
+            uint64_t fb = 0;
+            for (int i = 0; i < TAP_COUNT[r]; ++i) {
+                fb ^= w >> (n - REG_LEN[r] + TAPS[r][i]);
+            }
+            w |= (fb & 1) << n;
+        }
+        return w;
+    }
 
-A51Cipher::A51Cipher()
-    : m_r1(0), m_r2(0), m_r3(0), m_frameNumber(0)
-{
+    A51Tables buildTables()
+    {
+        A51Tables t;
+
+        for (uint32_t index = 0; index < (1u << 12); ++index) {
+            uint32_t taken[3] = {0, 0, 0};
+            uint32_t pattern[3] = {0, 0, 0};
+            for (int j = 0; j < 4; ++j) {
+                bool clock[3];
+                for (int r = 0; r < 3; ++r) {
+                    clock[r] = (index >> (4 * r + taken[r])) & 1;
+                }
+                const bool maj = (clock[0] && clock[1]) || (clock[0] && clock[2]) || (clock[1] && clock[2]);
+                for (int r = 0; r < 3; ++r) {
+                    if (clock[r] == maj) {
+                        pattern[r] |= 1u << j;
+                        ++taken[r];
+                    }
+                }
+            }
+            t.steps[index] = pattern[0] | (pattern[1] << 4) | (pattern[2] << 8)
+                           | (taken[0] << 12) | (taken[1] << 15) | (taken[2] << 18);
+        }
+
+        for (int p = 0; p < 16; ++p) {
+            for (int bits = 0; bits < 32; ++bits) {
+                uint8_t out = 0;
+                int taken = 0;
+                for (int j = 0; j < 4; ++j) {
+                    taken += (p >> j) & 1;
+                    out |= ((bits >> taken) & 1) << (3 - j);
+                }
+                t.output[p][bits] = out;
+            }
+        }
+
+        for (int r = 0; r < 3; ++r) {
+            for (int k = 0; k < 3; ++k) {
+                for (uint32_t b = 0; b < 256; ++b) {
+                    t.expand[r][k][b] = expandState(r, (b << (8 * k)) & REG_MASK[r]);
+                }
+            }
+        }
+        return t;
+    }
+
+    const A51Tables TABLES = buildTables();
+
+    inline uint64_t refill(int r, uint64_t w)
+    {
+        return TABLES.expand[r][0][w & 0xFF] ^ TABLES.expand[r][1][(w >> 8) & 0xFF]
+             ^ TABLES.expand[r][2][(w >> 16) & 0xFF & (REG_MASK[r] >> 16)];
+    }
+
+    // Четыре такта; возвращает 4 бита гаммы
+    inline uint32_t step(uint64_t& w1, uint64_t& w2, uint64_t& w3)
+    {
+        const uint32_t e = TABLES.steps[((w1 >> (A51Cipher::R1_CLOCK_BIT - 0)) & 0x00F)
+                                      | ((w2 >> (A51Cipher::R2_CLOCK_BIT - 4)) & 0x0F0)
+                                      | ((w3 >> (A51Cipher::R3_CLOCK_BIT - 8)) & 0xF00)];
+        const uint32_t out = TABLES.output[e & 0xF][(w1 >> (A51Cipher::R1_LEN - 1)) & 0x1F]
+                           ^ TABLES.output[(e >> 4) & 0xF][(w2 >> (A51Cipher::R2_LEN - 1)) & 0x1F]
+                           ^ TABLES.output[(e >> 8) & 0xF][(w3 >> (A51Cipher::R3_LEN - 1)) & 0x1F];
+        w1 >>= (e >> 12) & 7;
+        w2 >>= (e >> 15) & 7;
+        w3 >>= (e >> 18) & 7;
+        return out;
+    }
+
+    // Такт загрузки (ключ и номер кадра): все регистры сдвигаются, бит XOR
+    // с выталкиваемым младшим битом входит в старший
+    inline void loadBit(uint32_t* regs, uint32_t bit)
+    {
+        for (int r = 0; r < 3; ++r) {
+            regs[r] = ((regs[r] >> 1) | ((bit ^ (regs[r] & 1)) << (REG_LEN[r] - 1))) & REG_MASK[r];
+        }
+    }
 }
 
-uint32_t A51Cipher::feedbackR1() const
+void A51Generator::setKey(uint64_t key)
 {
-    uint32_t fb = 0;
-    fb ^= (m_r1 >> 18) & 1;
-    fb ^= (m_r1 >> 17) & 1;
-    fb ^= (m_r1 >> 16) & 1;
-    fb ^= (m_r1 >> 13) & 1;
-    return fb;
+    m_key = key;
+
+    // Этап 1: 64 такта, XOR с битами ключа (от старшего)
+    m_keyRegs[0] = m_keyRegs[1] = m_keyRegs[2] = 0;
+    for (int i = 63; i >= 0; --i) {
+        loadBit(m_keyRegs, uint32_t(key >> i) & 1);
+    }
+    startFrame(0);
 }
 
-uint32_t A51Cipher::feedbackR2() const
+void A51Generator::startFrame(uint32_t frame)
 {
-    uint32_t fb = 0;
-    fb ^= (m_r2 >> 21) & 1;
-    fb ^= (m_r2 >> 20) & 1;
-    return fb;
+    m_framed = false;
+    loadFrame(frame & A51Cipher::FRAME_MASK);
 }
 
-uint32_t A51Cipher::feedbackR3() const
+void A51Generator::startFrames(uint32_t firstFrame)
 {
-    uint32_t fb = 0;
-    fb ^= (m_r3 >> 22) & 1;
-    fb ^= (m_r3 >> 21) & 1;
-    fb ^= (m_r3 >> 20) & 1;
-    fb ^= (m_r3 >> 7) & 1;
-    return fb;
+    m_framed = true;
+    loadFrame(firstFrame & A51Cipher::FRAME_MASK);
 }
 
-bool A51Cipher::majority(bool x, bool y, bool z) const
+void A51Generator::loadFrame(uint32_t frame)
 {
-    return (x && y) || (x && z) || (y && z);
+    // Этап 2: 22 такта, XOR с битами номера кадра (от младшего)
+    uint32_t regs[3] = {m_keyRegs[0], m_keyRegs[1], m_keyRegs[2]};
+    for (int i = 0; i < 22; ++i) {
+        loadBit(regs, (frame >> i) & 1);
+    }
+
+    // Этап 3: 100 тактов холостого прогона
+    uint64_t w1 = refill(0, regs[0]);
+    uint64_t w2 = refill(1, regs[1]);
+    uint64_t w3 = refill(2, regs[2]);
+    for (int i = 0; i < MIX_STEPS; ++i) {
+        if (i % REFILL_STEPS == 0) {
+            w1 = refill(0, w1);
+            w2 = refill(1, w2);
+            w3 = refill(2, w3);
+        }
+        step(w1, w2, w3);
+    }
+
+    m_w[0] = w1;
+    m_w[1] = w2;
+    m_w[2] = w3;
+    m_sinceRefill = MIX_STEPS % REFILL_STEPS;
+    m_frame = frame;
+    m_frameSteps = 0;
 }
 
-bool A51Cipher::getClockBit(uint32_t reg, int bitPos) const
+void A51Generator::produce(uint8_t* out, qsizetype pos, qsizetype nibbles)
 {
-    return (reg >> bitPos) & 1;
+    while (nibbles > 0) {
+        if (m_framed && m_frameSteps == FRAME_STEPS) {
+            if (nibbles >= qsizetype(FRAME_STEPS) * BITSLICE_MIN_FRAMES) {
+                const qsizetype done = produceFrames(out, pos, nibbles);
+                pos += done;
+                nibbles -= done;
+                continue;
+            }
+            loadFrame((m_frame + 1) & A51Cipher::FRAME_MASK);
+        }
+        const qsizetype n = m_framed ? qMin<qsizetype>(nibbles, FRAME_STEPS - m_frameSteps) : nibbles;
+
+        // Состояние — в локальных переменных: запись в out через uint8_t*
+        // иначе заставляет перечитывать поля после каждого байта
+        uint64_t w1 = m_w[0], w2 = m_w[1], w3 = m_w[2];
+        int sinceRefill = m_sinceRefill;
+        qsizetype i = 0;
+
+        // До границы байта — по одной выборке
+        while (i < n && (pos + i) % 2 != 0) {
+            if (sinceRefill == REFILL_STEPS) {
+                w1 = refill(0, w1);
+                w2 = refill(1, w2);
+                w3 = refill(2, w3);
+                sinceRefill = 0;
+            }
+            out[(pos + i) / 2] |= uint8_t(step(w1, w2, w3));
+            ++sinceRefill;
+            ++i;
+        }
+
+        // Основной цикл: пополнение окон раньше срока безопасно (окно
+        // пересчитывается из самого регистра), поэтому 8 выборок без проверок
+        uint8_t* dst = out + (pos + i) / 2;
+        for (; i + REFILL_STEPS <= n; i += REFILL_STEPS) {
+            w1 = refill(0, w1);
+            w2 = refill(1, w2);
+            w3 = refill(2, w3);
+            for (int k = 0; k < REFILL_STEPS / 2; ++k) {
+                const uint32_t hi = step(w1, w2, w3);
+                const uint32_t lo = step(w1, w2, w3);
+                *dst++ = uint8_t((hi << 4) | lo);
+            }
+            sinceRefill = REFILL_STEPS;
+        }
+
+        for (; i < n; ++i) {
+            if (sinceRefill == REFILL_STEPS) {
+                w1 = refill(0, w1);
+                w2 = refill(1, w2);
+                w3 = refill(2, w3);
+                sinceRefill = 0;
+            }
+            const uint8_t v = uint8_t(step(w1, w2, w3));
+            if ((pos + i) % 2 == 0) {
+                out[(pos + i) / 2] = uint8_t(v << 4);
+            } else {
+                out[(pos + i) / 2] |= v;
+            }
+            ++sinceRefill;
+        }
+
+        m_w[0] = w1;
+        m_w[1] = w2;
+        m_w[2] = w3;
+        m_sinceRefill = sinceRefill;
+        if (m_framed) {
+            m_frameSteps += int(n);
+        }
+        pos += n;
+        nibbles -= n;
+    }
 }
 
-void A51Cipher::shiftR1()
+qsizetype A51Generator::produceFrames(uint8_t* out, qsizetype pos, qsizetype nibbles)
 {
-    uint32_t fb = feedbackR1();
-    m_r1 = (m_r1 >> 1) | (fb << (R1_LEN - 1));
-    m_r1 &= (1 << R1_LEN) - 1;
+    constexpr qsizetype BATCH_FRAMES = 1024;
+    constexpr qsizetype STRIDE = (A51Cipher::FRAME_BITS + 7) / 8;
+    const qsizetype count = qMin(nibbles / FRAME_STEPS, BATCH_FRAMES);
+
+    std::vector<uint64_t> keys(static_cast<size_t>(count), m_key);
+    std::vector<uint32_t> frames(static_cast<size_t>(count));
+    for (qsizetype i = 0; i < count; ++i) {
+        frames[size_t(i)] = (m_frame + 1 + uint32_t(i)) & A51Cipher::FRAME_MASK;
+    }
+    std::vector<uint8_t> gamma(static_cast<size_t>(count * STRIDE));
+    A51BitSlice::generate(keys.data(), frames.data(), count, A51Cipher::FRAME_BITS, gamma.data(), STRIDE);
+
+    // Кадр — 57 полубайт: с четного полубайта копируется как есть,
+    // с нечетного — со сдвигом на полубайт
+    for (qsizetype f = 0; f < count; ++f) {
+        const uint8_t* src = gamma.data() + f * STRIDE;
+        const qsizetype p = pos + f * FRAME_STEPS;
+        uint8_t* dst = out + p / 2;
+        if (p % 2 == 0) {
+            std::memcpy(dst, src, STRIDE - 1);
+            dst[STRIDE - 1] = src[STRIDE - 1] & 0xF0;
+        } else {
+            dst[0] = uint8_t((dst[0] & 0xF0) | (src[0] >> 4));
+            for (qsizetype j = 1; j < STRIDE; ++j) {
+                dst[j] = uint8_t((src[j - 1] << 4) | (src[j] >> 4));
+            }
+        }
+    }
+    KeyScheduleCache::secureZero(keys.data(), keys.size() * sizeof(uint64_t));
+
+    m_frame = frames[size_t(count - 1)];
+    m_frameSteps = FRAME_STEPS;
+    return count * FRAME_STEPS;
 }
 
-void A51Cipher::shiftR2()
+void A51Generator::generate(uint8_t* out, qsizetype bytes)
 {
-    uint32_t fb = feedbackR2();
-    m_r2 = (m_r2 >> 1) | (fb << (R2_LEN - 1));
-    m_r2 &= (1 << R2_LEN) - 1;
+    produce(out, 0, bytes * 2);
 }
 
-void A51Cipher::shiftR3()
+void A51Generator::generateFrames(uint32_t firstFrame, qsizetype count, uint8_t* out)
 {
-    uint32_t fb = feedbackR3();
-    m_r3 = (m_r3 >> 1) | (fb << (R3_LEN - 1));
-    m_r3 &= (1 << R3_LEN) - 1;
+    startFrames(firstFrame);
+    produce(out, 0, count * FRAME_STEPS);
 }
 
-void A51Cipher::initializeRegisters(const std::bitset<64>& key, uint32_t frameNumber)
-{
-    // Обнуляем регистры
-    m_r1 = 0;
-    m_r2 = 0;
-    m_r3 = 0;
+// ==================== A51BitSlice Implementation ====================
 
-    // Этап 1: 64 такта, XOR с битами ключа
-    for (int i = 0; i < 64; ++i) {
-        // Безопасное получение бита ключа
-        bool keyBit = false;
-        int keyIndex = 63 - i;
-        if (keyIndex >= 0 && keyIndex < 64) {
-            keyBit = key[keyIndex];
-        }
+namespace {
+    // Тактов загрузки: 64 бита ключа и 22 бита номера кадра
+    const int LOAD_STEPS = 64 + 22;
 
-        // Сдвигаем регистры и XOR-им бит ключа с младшим битом
-        uint32_t new_r1 = (m_r1 >> 1);
-        uint32_t new_r2 = (m_r2 >> 1);
-        uint32_t new_r3 = (m_r3 >> 1);
+    // Бит загрузки шага step входит в старший бит регистра и затем
+    // LOAD_STEPS - 1 - step раз вращается вправо
+    constexpr int loadPosition(int len, int step)
+    {
+        return ((len - 1 - (LOAD_STEPS - 1 - step)) % len + len) % len;
+    }
 
-        uint32_t lsb1 = m_r1 & 1;
-        uint32_t lsb2 = m_r2 & 1;
-        uint32_t lsb3 = m_r3 & 1;
+    // Бит загрузки шага step: сначала ключ от старшего бита, затем кадр от младшего
+    inline int loadSource(int step)
+    {
+        return step < 64 ? 63 - step : step;
+    }
 
-        new_r1 |= ((keyBit ^ lsb1) << (R1_LEN - 1));
-        new_r2 |= ((keyBit ^ lsb2) << (R2_LEN - 1));
-        new_r3 |= ((keyBit ^ lsb3) << (R3_LEN - 1));
+    inline void storeBits(uint8_t* p, uint64_t v, int bytes)
+    {
+        for (int j = 0; j < bytes; ++j) {
+            p[j] = static_cast<uint8_t>(v >> (56 - j * 8));
+        }
+    }
 
-        m_r1 = new_r1 & ((1 << R1_LEN) - 1);
-        m_r2 = new_r2 & ((1 << R2_LEN) - 1);
-        m_r3 = new_r3 & ((1 << R3_LEN) - 1);
+    // Шаг транспонирования: обмен блоков J×J между строками k и k + J
+    template<int J>
+    inline void transposeStep(uint64_t* s, uint64_t mask)
+    {
+        for (int k = 0; k < 64; k = ((k | J) + 1) & ~J) {
+            const uint64_t t = ((s[k] >> J) ^ s[k | J]) & mask;
+            s[k | J] ^= t;
+            s[k] ^= t << J;
+        }
     }
 
-    // Этап 2: 22 такта, XOR с битами номера кадра
-    for (int i = 0; i < 22; ++i) {
-        bool frameBit = (frameNumber >> i) & 1;
+    // Бит c строки r ↔ бит r строки c
+    void transpose64(uint64_t* s)
+    {
+        transposeStep<32>(s, 0x00000000FFFFFFFFull);
+        transposeStep<16>(s, 0x0000FFFF0000FFFFull);
+        transposeStep<8>(s, 0x00FF00FF00FF00FFull);
+        transposeStep<4>(s, 0x0F0F0F0F0F0F0F0Full);
+        transposeStep<2>(s, 0x3333333333333333ull);
+        transposeStep<1>(s, 0x5555555555555555ull);
+    }
 
-        uint32_t new_r1 = (m_r1 >> 1);
-        uint32_t new_r2 = (m_r2 >> 1);
-        uint32_t new_r3 = (m_r3 >> 1);
+    // Сдвиг регистра в полосах из mask: бит i ← бит i + 1, старший — обратная связь
+    template<int Len, int N>
+    inline void clockSlice(uint64_t* r, uint64_t mask, const int (&taps)[N])
+    {
+        uint64_t fb = 0;
+        for (int i = 0; i < N; ++i) {
+            fb ^= r[taps[i]];
+        }
+        for (int i = 0; i < Len - 1; ++i) {
+            r[i] ^= (r[i] ^ r[i + 1]) & mask;
+        }
+        r[Len - 1] ^= (r[Len - 1] ^ fb) & mask;
+    }
 
-        uint32_t lsb1 = m_r1 & 1;
-        uint32_t lsb2 = m_r2 & 1;
-        uint32_t lsb3 = m_r3 & 1;
+    inline uint64_t clockAll(uint64_t* r1, uint64_t* r2, uint64_t* r3)
+    {
+        const uint64_t c1 = r1[A51Cipher::R1_CLOCK_BIT];
+        const uint64_t c2 = r2[A51Cipher::R2_CLOCK_BIT];
+        const uint64_t c3 = r3[A51Cipher::R3_CLOCK_BIT];
+        const uint64_t maj = (c1 & c2) | (c1 & c3) | (c2 & c3);
+        clockSlice<A51Cipher::R1_LEN>(r1, ~(c1 ^ maj), A51Cipher::R1_TAPS);
+        clockSlice<A51Cipher::R2_LEN>(r2, ~(c2 ^ maj), A51Cipher::R2_TAPS);
+        clockSlice<A51Cipher::R3_LEN>(r3, ~(c3 ^ maj), A51Cipher::R3_TAPS);
+        return r1[A51Cipher::R1_LEN - 1] ^ r2[A51Cipher::R2_LEN - 1] ^ r3[A51Cipher::R3_LEN - 1];
+    }
 
-        new_r1 |= ((frameBit ^ lsb1) << (R1_LEN - 1));
-        new_r2 |= ((frameBit ^ lsb2) << (R2_LEN - 1));
-        new_r3 |= ((frameBit ^ lsb3) << (R3_LEN - 1));
+    // Пачка из 64 пар, заполнены первые lanes
+    void slice64(const uint64_t* keys, const uint32_t* frames, int lanes,
+                 qsizetype bits, uint8_t* out, qsizetype stride)
+    {
+        // Строки 0..63 — биты ключа, 64..127 — биты номера кадра
+        uint64_t load[128];
+        for (int l = 0; l < 64; ++l) {
+            load[l] = l < lanes ? keys[l] : 0;
+            load[64 + l] = l < lanes ? frames[l] & A51Cipher::FRAME_MASK : 0;
+        }
+        transpose64(load);
+        transpose64(load + 64);
+
+        uint64_t r1[A51Cipher::R1_LEN] = {};
+        uint64_t r2[A51Cipher::R2_LEN] = {};
+        uint64_t r3[A51Cipher::R3_LEN] = {};
+        for (int step = 0; step < LOAD_STEPS; ++step) {
+            const uint64_t x = load[loadSource(step)];
+            r1[loadPosition(A51Cipher::R1_LEN, step)] ^= x;
+            r2[loadPosition(A51Cipher::R2_LEN, step)] ^= x;
+            r3[loadPosition(A51Cipher::R3_LEN, step)] ^= x;
+        }
 
-        m_r1 = new_r1 & ((1 << R1_LEN) - 1);
-        m_r2 = new_r2 & ((1 << R2_LEN) - 1);
-        m_r3 = new_r3 & ((1 << R3_LEN) - 1);
-    }
+        // 100 тактов холостого прогона
+        for (int i = 0; i < 100; ++i) {
+            clockAll(r1, r2, r3);
+        }
 
-    // Этап 3: 100 тактов холостого прогона
-    for (int i = 0; i < 100; ++i) {
-        bool clock1 = (m_r1 >> R1_CLOCK_BIT) & 1;
-        bool clock2 = (m_r2 >> R2_CLOCK_BIT) & 1;
-        bool clock3 = (m_r3 >> R3_CLOCK_BIT) & 1;
+        // Гамма по 64 такта: строка 63 - t — такт t, после транспонирования
+        // строка l — 64 бита гаммы пары l, первый такт — старший бит
+        uint64_t o[64];
+        for (qsizetype t0 = 0; t0 < bits; t0 += 64) {
+            const int n = int(qMin<qsizetype>(64, bits - t0));
+            for (int t = 0; t < n; ++t) {
+                o[63 - t] = clockAll(r1, r2, r3);
+            }
+            for (int t = n; t < 64; ++t) {
+                o[63 - t] = 0;
+            }
+            transpose64(o);
+            for (int l = 0; l < lanes; ++l) {
+                storeBits(out + l * stride + t0 / 8, o[l], (n + 7) / 8);
+            }
+        }
 
-        bool maj = (clock1 && clock2) || (clock1 && clock3) || (clock2 && clock3);
+        KeyScheduleCache::secureZero(load, sizeof(load));
+        KeyScheduleCache::secureZero(r1, sizeof(r1));
+        KeyScheduleCache::secureZero(r2, sizeof(r2));
+        KeyScheduleCache::secureZero(r3, sizeof(r3));
+    }
 
-        if (clock1 == maj) {
-            uint32_t fb = feedbackR1();
-            m_r1 = (m_r1 >> 1) | (fb << (R1_LEN - 1));
-            m_r1 &= (1 << R1_LEN) - 1;
+#if defined(CRYPTOAPP_X86)
+    // То же для 256 пар: четыре независимые 64-битные полосы регистра AVX2,
+    // пара l — полоса l / 64, бит l % 64
+    template<int J>
+    CRYPTOAPP_TARGET("avx2")
+    inline void transposeStepAvx2(__m256i* s, uint64_t mask)
+    {
+        const __m256i m = _mm256_set1_epi64x(qint64(mask));
+        for (int k = 0; k < 64; k = ((k | J) + 1) & ~J) {
+            const __m256i t = _mm256_and_si256(
+                _mm256_xor_si256(_mm256_srli_epi64(s[k], J), s[k | J]), m);
+            s[k | J] = _mm256_xor_si256(s[k | J], t);
+            s[k] = _mm256_xor_si256(s[k], _mm256_slli_epi64(t, J));
         }
-        if (clock2 == maj) {
-            uint32_t fb = feedbackR2();
-            m_r2 = (m_r2 >> 1) | (fb << (R2_LEN - 1));
-            m_r2 &= (1 << R2_LEN) - 1;
+    }
+
+    CRYPTOAPP_TARGET("avx2")
+    void transpose64Avx2(__m256i* s)
+    {
+        transposeStepAvx2<32>(s, 0x00000000FFFFFFFFull);
+        transposeStepAvx2<16>(s, 0x0000FFFF0000FFFFull);
+        transposeStepAvx2<8>(s, 0x00FF00FF00FF00FFull);
+        transposeStepAvx2<4>(s, 0x0F0F0F0F0F0F0F0Full);
+        transposeStepAvx2<2>(s, 0x3333333333333333ull);
+        transposeStepAvx2<1>(s, 0x5555555555555555ull);
+    }
+
+    template<int Len, int N>
+    CRYPTOAPP_TARGET("avx2")
+    inline void clockSliceAvx2(__m256i* r, __m256i mask, const int (&taps)[N])
+    {
+        __m256i fb = _mm256_setzero_si256();
+        for (int i = 0; i < N; ++i) {
+            fb = _mm256_xor_si256(fb, r[taps[i]]);
         }
-        if (clock3 == maj) {
-            uint32_t fb = feedbackR3();
-            m_r3 = (m_r3 >> 1) | (fb << (R3_LEN - 1));
-            m_r3 &= (1 << R3_LEN) - 1;
+        for (int i = 0; i < Len - 1; ++i) {
+            r[i] = _mm256_xor_si256(r[i], _mm256_and_si256(_mm256_xor_si256(r[i], r[i + 1]), mask));
         }
+        r[Len - 1] = _mm256_xor_si256(r[Len - 1], _mm256_and_si256(_mm256_xor_si256(r[Len - 1], fb), mask));
     }
-}
 
-bool A51Cipher::generateKeystreamBit()
-{
-    // Получаем биты синхронизации
-    bool clock1 = (m_r1 >> R1_CLOCK_BIT) & 1;
-    bool clock2 = (m_r2 >> R2_CLOCK_BIT) & 1;
-    bool clock3 = (m_r3 >> R3_CLOCK_BIT) & 1;
+    // Регистр сдвигается там, где его бит синхронизации равен большинству
+    CRYPTOAPP_TARGET("avx2")
+    inline __m256i clockAllAvx2(__m256i* r1, __m256i* r2, __m256i* r3)
+    {
+        const __m256i ones = _mm256_set1_epi64x(-1);
+        const __m256i c1 = r1[A51Cipher::R1_CLOCK_BIT];
+        const __m256i c2 = r2[A51Cipher::R2_CLOCK_BIT];
+        const __m256i c3 = r3[A51Cipher::R3_CLOCK_BIT];
+        const __m256i maj = _mm256_or_si256(_mm256_and_si256(c1, _mm256_or_si256(c2, c3)), _mm256_and_si256(c2, c3));
+        clockSliceAvx2<A51Cipher::R1_LEN>(r1, _mm256_andnot_si256(_mm256_xor_si256(c1, maj), ones), A51Cipher::R1_TAPS);
+        clockSliceAvx2<A51Cipher::R2_LEN>(r2, _mm256_andnot_si256(_mm256_xor_si256(c2, maj), ones), A51Cipher::R2_TAPS);
+        clockSliceAvx2<A51Cipher::R3_LEN>(r3, _mm256_andnot_si256(_mm256_xor_si256(c3, maj), ones), A51Cipher::R3_TAPS);
+        return _mm256_xor_si256(_mm256_xor_si256(r1[A51Cipher::R1_LEN - 1], r2[A51Cipher::R2_LEN - 1]),
+                                r3[A51Cipher::R3_LEN - 1]);
+    }
 
-    // Вычисляем мажоритарный бит
-    bool maj = (clock1 && clock2) || (clock1 && clock3) || (clock2 && clock3);
+    // Целая пачка из 256 пар
+    CRYPTOAPP_TARGET("avx2")
+    void slice256Avx2(const uint64_t* keys, const uint32_t* frames, qsizetype bits, uint8_t* out, qsizetype stride)
+    {
+        const int quarter = A51BitSlice::AVX2_LANES / 4;
+        __m256i load[128];
+        for (int l = 0; l < 64; ++l) {
+            load[l] = _mm256_set_epi64x(qint64(keys[3 * quarter + l]), qint64(keys[2 * quarter + l]),
+                                        qint64(keys[quarter + l]), qint64(keys[l]));
+            load[64 + l] = _mm256_set_epi64x(qint64(frames[3 * quarter + l] & A51Cipher::FRAME_MASK),
+                                             qint64(frames[2 * quarter + l] & A51Cipher::FRAME_MASK),
+                                             qint64(frames[quarter + l] & A51Cipher::FRAME_MASK),
+                                             qint64(frames[l] & A51Cipher::FRAME_MASK));
+        }
+        transpose64Avx2(load);
+        transpose64Avx2(load + 64);
+
+        __m256i r1[A51Cipher::R1_LEN];
+        __m256i r2[A51Cipher::R2_LEN];
+        __m256i r3[A51Cipher::R3_LEN];
+        for (__m256i& v : r1) v = _mm256_setzero_si256();
+        for (__m256i& v : r2) v = _mm256_setzero_si256();
+        for (__m256i& v : r3) v = _mm256_setzero_si256();
+        for (int step = 0; step < LOAD_STEPS; ++step) {
+            const __m256i x = load[loadSource(step)];
+            __m256i& a = r1[loadPosition(A51Cipher::R1_LEN, step)];
+            __m256i& b = r2[loadPosition(A51Cipher::R2_LEN, step)];
+            __m256i& c = r3[loadPosition(A51Cipher::R3_LEN, step)];
+            a = _mm256_xor_si256(a, x);
+            b = _mm256_xor_si256(b, x);
+            c = _mm256_xor_si256(c, x);
+        }
 
-    // Сдвигаем регистры
-    if (clock1 == maj) {
-        uint32_t fb = feedbackR1();
-        m_r1 = (m_r1 >> 1) | (fb << (R1_LEN - 1));
-        m_r1 &= (1 << R1_LEN) - 1;
-    }
-    if (clock2 == maj) {
-        uint32_t fb = feedbackR2();
-        m_r2 = (m_r2 >> 1) | (fb << (R2_LEN - 1));
-        m_r2 &= (1 << R2_LEN) - 1;
-    }
-    if (clock3 == maj) {
-        uint32_t fb = feedbackR3();
-        m_r3 = (m_r3 >> 1) | (fb << (R3_LEN - 1));
-        m_r3 &= (1 << R3_LEN) - 1;
-    }
+        for (int i = 0; i < 100; ++i) {
+            clockAllAvx2(r1, r2, r3);
+        }
 
-    // Выходной бит
-    bool out1 = (m_r1 >> (R1_LEN - 1)) & 1;
-    bool out2 = (m_r2 >> (R2_LEN - 1)) & 1;
-    bool out3 = (m_r3 >> (R3_LEN - 1)) & 1;
+        __m256i o[64];
+        alignas(32) uint64_t lanes[4];
+        for (qsizetype t0 = 0; t0 < bits; t0 += 64) {
+            const int n = int(qMin<qsizetype>(64, bits - t0));
+            for (int t = 0; t < n; ++t) {
+                o[63 - t] = clockAllAvx2(r1, r2, r3);
+            }
+            for (int t = n; t < 64; ++t) {
+                o[63 - t] = _mm256_setzero_si256();
+            }
+            transpose64Avx2(o);
+            for (int r = 0; r < 64; ++r) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), o[r]);
+                for (int part = 0; part < 4; ++part) {
+                    storeBits(out + (part * quarter + r) * stride + t0 / 8, lanes[part], (n + 7) / 8);
+                }
+            }
+        }
 
-    return out1 ^ out2 ^ out3;
+        KeyScheduleCache::secureZero(load, sizeof(load));
+        KeyScheduleCache::secureZero(r1, sizeof(r1));
+        KeyScheduleCache::secureZero(r2, sizeof(r2));
+        KeyScheduleCache::secureZero(r3, sizeof(r3));
+    }
+#endif
 }
 
-std::bitset<64> A51Cipher::generateGamma(int numBits)
+void A51BitSlice::generate(const uint64_t* keys, const uint32_t* frames, qsizetype count,
+                           qsizetype bits, uint8_t* out, qsizetype stride)
 {
-    std::bitset<64> gamma;
-    int maxBits = qMin(numBits, 64);
-
-    for (int i = 0; i < maxBits; ++i) {
-        bool bit = generateKeystreamBit();
-        if (bit) {
-            gamma.set(63 - i);
+    qsizetype done = 0;
+#if defined(CRYPTOAPP_X86)
+    if (CpuFeatures::get().avx2) {
+        for (; done + AVX2_LANES <= count; done += AVX2_LANES) {
+            slice256Avx2(keys + done, frames + done, bits, out + done * stride, stride);
         }
     }
-    return gamma;
+#endif
+    for (; done < count; done += LANES) {
+        const int lanes = int(qMin<qsizetype>(LANES, count - done));
+        slice64(keys + done, frames + done, lanes, bits, out + done * stride, stride);
+    }
 }
 
+// ==================== A51Cipher Implementation ====================
+
+A51Cipher::A51Cipher()
+{
+}
 
 std::bitset<64> A51Cipher::textToBits(const QString& text) const
 {
@@ -348,114 +725,94 @@ std::bitset<64> A51Cipher::textToBits(const QString& text) const
     return result;
 }
 
-QString A51Cipher::bitsToText(const std::bitset<64>& bits) const
-{
-    QString result;
-
-    for (int i = 0; i < 13; ++i) {
-        int pos = 0;
-        for (int b = 0; b < 5; ++b) {
-            int bitPos = (i * 5) + b;
-            if (bitPos < 64 && bits[63 - bitPos]) {
-                pos |= (1 << (4 - b));
-            }
-        }
-        if (pos < m_alphabet.length()) {
-            result.append(m_alphabet[pos]);
-        } else {
-            result.append('?');
-        }
-    }
-
-    return result;
-}
-
-CipherResult A51Cipher::processText(const QString& text, const std::bitset<64>& key, bool encrypt)
+CipherResult A51Cipher::processText(const QString& text, const QVariantMap& params, StepTrace& trace)
 {
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = false;
 
+    uint32_t frame = 0;
+    bool framed = false;
+    QString error;
+    if (!frameFromParams(params, frame, framed, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return result;
+    }
+
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало работы A5/1", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало работы A5/1", "Инициализация"));
+    }
 
     // 1. Фильтруем только буквы алфавита
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Входной текст: %1").arg(filteredText.left(50) + (filteredText.length() > 50 ? "..." : "")),
-        "Подготовка данных"));
-
-    // 2. Преобразуем весь текст в биты (каждая буква = 5 бит)
-    int totalBits = filteredText.length() * 5;
-    std::bitset<1024> textBits; // Достаточно большой для текста любой длины
-
-    for (int i = 0; i < filteredText.length(); ++i) {
-        int pos = m_alphabet.indexOf(filteredText[i]);
-        if (pos >= 0 && pos < 32) {
-            for (int b = 0; b < 5; ++b) {
-                bool bit = (pos >> (4 - b)) & 1;
-                int bitPos = (i * 5) + b;
-                if (bitPos < totalBits) {
-                    textBits.set(totalBits - 1 - bitPos, bit);
-                }
-            }
-        }
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Входной текст: %1").arg(filteredText.left(50) + (filteredText.length() > 50 ? "..." : "")),
+            "Подготовка данных"));
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Всего бит для шифрования: %1").arg(totalBits),
-        "Преобразование текста"));
-
-    // 3. Инициализируем регистры (один раз для всего сообщения)
-    // Используем фиксированный номер кадра (например 0)
-    initializeRegisters(key, 0);
+    // 2. Каждая буква — 5 бит гаммы
+    const qsizetype totalBits = filteredText.length() * 5;
 
-    steps.append(CipherStep(3, QChar(),
-        "Инициализация регистров (кадр 0)",
-        "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Всего бит для шифрования: %1").arg(totalBits),
+            "Преобразование текста"));
+    }
 
-    // 4. Генерируем гамму на ВСЮ длину текста (непрерывно)
-    std::bitset<1024> gamma;
-    for (int i = 0; i < totalBits; ++i) {
-        bool bit = generateKeystreamBit();
-        if (bit) {
-            gamma.set(totalBits - 1 - i);
-        }
+    // 3. Инициализируем регистры (один раз для всего сообщения или на каждый кадр GSM)
+    A51Generator generator(keyFromParams(params).to_ullong());
+    if (framed) {
+        generator.startFrames(frame);
+    } else {
+        generator.startFrame(frame);
     }
 
-    // Строка гаммы для отладки (первые 20 бит)
-    QString gammaPreview;
-    for (int i = 0; i < qMin(20, totalBits); ++i) {
-        gammaPreview.append(gamma[totalBits - 1 - i] ? '1' : '0');
-        if ((i + 1) % 5 == 0 && i + 1 < qMin(20, totalBits)) gammaPreview.append(" ");
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            framed ? QString("Инициализация регистров (кадры с %1 по %2 бит)").arg(frame).arg(FRAME_BITS)
+                   : QString("Инициализация регистров (кадр %1)").arg(frame),
+            "Инициализация"));
     }
-    steps.append(CipherStep(4, QChar(),
-        QString("Гамма (первые %1 бит): %2...").arg(qMin(20, totalBits)).arg(gammaPreview),
-        "Генерация гаммы"));
 
-    // 5. XOR
-    std::bitset<1024> resultBits;
-    for (int i = 0; i < totalBits; ++i) {
-        resultBits[i] = textBits[i] ^ gamma[i];
+    // 4. Генерируем гамму на ВСЮ длину текста (непрерывно)
+    std::vector<uint8_t> gamma(size_t((totalBits + 7) / 8));
+    generator.generate(gamma.data(), qsizetype(gamma.size()));
+    auto gammaBit = [&gamma](qsizetype i) {
+        return (gamma[size_t(i / 8)] >> (7 - i % 8)) & 1;
+    };
+
+    if (trace.want(TraceLevel::Summary)) {
+        // Строка гаммы для отладки (первые 20 бит)
+        const int previewBits = int(qMin<qsizetype>(20, totalBits));
+        QString gammaPreview;
+        for (int i = 0; i < previewBits; ++i) {
+            gammaPreview.append(gammaBit(i) ? '1' : '0');
+            if ((i + 1) % 5 == 0 && i + 1 < previewBits) gammaPreview.append(" ");
+        }
+        steps.append(CipherStep(4, QChar(),
+            QString("Гамма (первые %1 бит): %2...").arg(previewBits).arg(gammaPreview),
+            "Генерация гаммы"));
     }
 
-    // 6. Преобразуем обратно в текст
+    // 5. XOR номера буквы с 5 битами гаммы (первый бит гаммы — старший)
     QString resultText;
-    int numLetters = totalBits / 5;
-    for (int i = 0; i < numLetters; ++i) {
-        int pos = 0;
+    resultText.reserve(filteredText.length());
+    for (qsizetype i = 0; i < filteredText.length(); ++i) {
+        int pos = m_alphabet.indexOf(filteredText[i]);
+        if (pos < 0 || pos >= 32) {
+            pos = 0;
+        }
         for (int b = 0; b < 5; ++b) {
-            int bitPos = (i * 5) + b;
-            if (bitPos < totalBits && resultBits[totalBits - 1 - bitPos]) {
-                pos |= (1 << (4 - b));
-            }
+            pos ^= gammaBit(i * 5 + b) << (4 - b);
         }
         if (pos < m_alphabet.length()) {
             resultText.append(m_alphabet[pos]);
@@ -464,9 +821,11 @@ CipherResult A51Cipher::processText(const QString& text, const std::bitset<64>&
         }
     }
 
-    steps.append(CipherStep(5, QChar(),
-        QString("Результат: %1").arg(resultText),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(5, QChar(),
+            QString("Результат: %1").arg(resultText),
+            "Завершение"));
+    }
 
     result.result = resultText;
     result.steps = steps;
@@ -474,7 +833,7 @@ CipherResult A51Cipher::processText(const QString& text, const std::bitset<64>&
     return result;
 }
 
-CipherResult A51Cipher::encrypt(const QString& text, const QVariantMap& params)
+std::bitset<64> A51Cipher::keyFromParams(const QVariantMap& params) const
 {
     QString keyType = params.value("keyType", "binary").toString();
     std::bitset<64> key;
@@ -494,7 +853,32 @@ CipherResult A51Cipher::encrypt(const QString& text, const QVariantMap& params)
         key = textToBits(textKey);
     }
 
-    return processText(text, key, true);
+    return key;
+}
+
+bool A51Cipher::frameFromParams(const QVariantMap& params, uint32_t& frame, bool& framed, QString* error)
+{
+    const QString framing = params.value("framing", "continuous").toString();
+    if (framing != "continuous" && framing != "gsm") {
+        if (error) *error = QString("ОШИБКА: Неизвестный режим кадров: %1 (continuous или gsm)").arg(framing);
+        return false;
+    }
+    framed = (framing == "gsm");
+
+    bool ok = true;
+    const qlonglong value = params.value("frame", 0).toLongLong(&ok);
+    if (!ok || value < 0 || value > FRAME_MASK) {
+        if (error) *error = QString("ОШИБКА: Номер кадра должен быть от 0 до %1").arg(FRAME_MASK);
+        return false;
+    }
+    frame = uint32_t(value);
+    return true;
+}
+
+CipherResult A51Cipher::encrypt(const QString& text, const QVariantMap& params)
+{
+    StepTrace trace(params);
+    return trace.finish(processText(text, params, trace));
 }
 
 CipherResult A51Cipher::decrypt(const QString& text, const QVariantMap& params)
@@ -502,13 +886,88 @@ CipherResult A51Cipher::decrypt(const QString& text, const QVariantMap& params)
     return encrypt(text, params);
 }
 
+// Бинарный путь: гамма накладывается побайтно, старший бит байта — первый бит гаммы
+class A51Stream : public KeystreamCipherStream
+{
+public:
+    explicit A51Stream(const A51Cipher& cipher)
+        : KeystreamCipherStream(8), m_cipher(cipher) {}
+
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        uint32_t frame = 0;
+        bool framed = false;
+        if (!A51Cipher::frameFromParams(params, frame, framed, error)) {
+            return false;
+        }
+        reset();
+        m_generator.setKey(m_cipher.keyFromParams(params).to_ullong());
+        if (framed) {
+            m_generator.startFrames(frame);
+        } else {
+            m_generator.startFrame(frame);
+        }
+        return true;
+    }
+
+protected:
+    void nextKeystream(uint8_t* block) override
+    {
+        m_generator.generate(block, 8);
+    }
+
+    // Гамма вырабатывается кусками в буфер на стеке и накладывается одним проходом
+    void xorBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+    {
+        uint8_t gamma[CHUNK_BYTES];
+        qsizetype len = blocks * 8;
+        while (len > 0) {
+            const qsizetype n = qMin<qsizetype>(len, CHUNK_BYTES);
+            m_generator.generate(gamma, n);
+            for (qsizetype i = 0; i < n; ++i) {
+                out[i] = in[i] ^ gamma[i];
+            }
+            in += n;
+            out += n;
+            len -= n;
+        }
+    }
+
+private:
+    static constexpr qsizetype CHUNK_BYTES = 4096;
+
+    A51Cipher m_cipher;
+    A51Generator m_generator;
+};
+
+std::unique_ptr<CipherStream> A51Cipher::createStream(bool encrypt)
+{
+    Q_UNUSED(encrypt)
+    return std::make_unique<A51Stream>(*this);
+}
+
+bool A51Cipher::encryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    A51Stream stream(*this);
+    if (!stream.init(params, error)) {
+        out.clear();
+        return false;
+    }
 
-void A51Cipher::reset()
+    // Через промежуточный буфер: in и out могут быть одним объектом
+    QByteArray buffer;
+    buffer.reserve(in.size());
+    if (!stream.update(in, buffer, error) || !stream.final(buffer, error)) {
+        out.clear();
+        return false;
+    }
+    out = buffer;
+    return true;
+}
+
+bool A51Cipher::decryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
 {
-    m_r1 = 0;
-    m_r2 = 0;
-    m_r3 = 0;
-    m_frameNumber = 0;
+    return encryptBytes(in, out, params, error);
 }
 
 // ==================== A51CipherRegister Implementation ====================
@@ -579,13 +1038,30 @@ A51CipherRegister::A51CipherRegister()
 
             mainLayout->addWidget(stackedWidget);
 
+            // Номер кадра и разбиение гаммы на пакеты GSM
+            QHBoxLayout* frameRow = new QHBoxLayout();
+            QLabel* frameLabel = new QLabel("Кадр:");
+            frameLabel->setFixedWidth(100);
+            QSpinBox* frameSpin = new QSpinBox();
+            frameSpin->setRange(0, int(A51Cipher::FRAME_MASK));
+            frameSpin->setValue(0);
+            QComboBox* framingCombo = new QComboBox();
+            framingCombo->addItem("Один кадр (непрерывная гамма)", "continuous");
+            framingCombo->addItem("Пакеты GSM (228 бит на кадр)", "gsm");
+            frameRow->addWidget(frameLabel);
+            frameRow->addWidget(frameSpin);
+            frameRow->addWidget(framingCombo);
+            frameRow->addStretch();
+            mainLayout->addLayout(frameRow);
+
             // Информационная панель
             QLabel* infoLabel = new QLabel(
                 "A5/1 (GSM) — потоковый шифр с тремя РСЛОС:\n"
                 "R1: x^19 + x^18 + x^17 + x^14 + 1 (19 бит)\n"
                 "R2: x^22 + x^21 + 1 (22 бита)\n"
                 "R3: x^23 + x^22 + x^21 + x^8 + 1 (23 бита)\n"
-                "Ключ: 64 бита (двоичный или 13 букв по 5 бит)"
+                "Ключ: 64 бита (двоичный или 13 букв по 5 бит)\n"
+                "Кадр: 22 бита; в режиме пакетов GSM каждые 228 бит гаммы — следующий кадр"
             );
             infoLabel->setStyleSheet("color: #666; font-style: italic; padding: 5px; background-color: #f5f5f5; border-radius: 3px;");
             infoLabel->setWordWrap(true);
@@ -597,6 +1073,8 @@ A51CipherRegister::A51CipherRegister()
             widgets["binaryKey"] = binaryEdit;
             widgets["textKey"] = textEdit;
             widgets["stackedWidget"] = stackedWidget;
+            widgets["frame"] = frameSpin;
+            widgets["framing"] = framingCombo;
 
             QObject::connect(typeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
                 [stackedWidget](int index) {
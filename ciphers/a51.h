@@ -20,7 +20,16 @@ public:
     virtual CipherResult encrypt(const QString& text, const QVariantMap& params) override;
     virtual CipherResult decrypt(const QString& text, const QVariantMap& params) override;
 
-private:
+    // Бинарный путь: XOR байтов с гаммой, ключ и кадры — как в encrypt
+    virtual bool supportsBytes() const override { return true; }
+    virtual bool encryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+    virtual bool decryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+
+    // Потоковый режим: регистры сохраняют состояние между вызовами update
+    virtual std::unique_ptr<CipherStream> createStream(bool encrypt) override;
+
     // Длины регистров
     static const int R1_LEN = 19;
     static const int R2_LEN = 22;
@@ -36,62 +45,119 @@ private:
     static const int R2_TAPS[2];
     static const int R3_TAPS[4];
 
-    // Регистры
-    uint32_t m_r1;  // 19 бит (максимум 0x7FFFF)
-    uint32_t m_r2;  // 22 бита (максимум 0x3FFFFF)
-    uint32_t m_r3;  // 23 бита (максимум 0x7FFFFF)
+    // Номер кадра — 22 бита; пакет GSM — 228 бит гаммы на кадр
+    static constexpr uint32_t FRAME_MASK = (1u << 22) - 1;
+    static constexpr int FRAME_BITS = 228;
 
-    // Номер кадра (22 бита)
-    uint32_t m_frameNumber;
+private:
+    friend class A51Stream;
 
     // Алфавит для текстового ключа
-    QString m_alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& m_alphabet = Alphabet::russian();
 
     // Вспомогательные функции
     bool textToBinaryKey(const QString& textKey, std::bitset<64>& key) const;
     QString binaryToText(const std::bitset<64>& bits) const;
     bool binaryStringToBitset(const QString& binaryStr, std::bitset<64>& key) const;
     QString bitsetToBinaryString(const std::bitset<64>& bits) const;
-    // В заголовочном файле a51.h добавить:
-    void reset();
 
+    // Ключ из параметров (keyType: binary/text)
+    std::bitset<64> keyFromParams(const QVariantMap& params) const;
 
-    // Функции РСЛОС
-    uint32_t feedbackR1() const;
-    uint32_t feedbackR2() const;
-    uint32_t feedbackR3() const;
+    // Номер первого кадра (params["frame"]) и разбиение гаммы на пакеты GSM
+    // (params["framing"]: continuous — один кадр без ограничения длины, gsm — по 228 бит на кадр)
+    static bool frameFromParams(const QVariantMap& params, uint32_t& frame, bool& framed, QString* error);
 
-    // Функция большинства (majority function)
-    bool majority(bool x, bool y, bool z) const;
+    // Шифрование/дешифрование текста
+    CipherResult processText(const QString& text, const QVariantMap& params, StepTrace& trace);
+
+    // Преобразование текста в биты (русский алфавит -> 5 бит)
+    std::bitset<64> textToBits(const QString& text) const;
+};
 
-    // Получение бита синхронизации из регистра
-    bool getClockBit(uint32_t reg, int bitPos) const;
+// Генератор гаммы A5/1 без ограничения длины. Регистр хранится вместе со своим
+// будущим: в окне из 64 бит биты 0..LEN-1 — сам регистр, выше — биты, которые
+// войдут в него при следующих сдвигах (последовательность РСЛОС зависит только
+// от числа его собственных тактов). Поэтому бит синхронизации и выходной бит
+// после k тактов — просто биты окна CLOCK_BIT + k и LEN-1 + k, и четыре такта
+// с мажоритарным управлением разбираются одной выборкой из таблицы по четырем
+// очередным битам синхронизации каждого регистра: она дает, какие регистры
+// сдвигались на каждом такте, а вторая таблица — выходные биты. Окна
+// пополняются по таблицам раз в 32 такта.
+class A51Generator
+{
+public:
+    A51Generator() = default;
 
-    // Сдвиг регистра с обратной связью
-    void shiftR1();
-    void shiftR2();
-    void shiftR3();
+    // Ключ: старший бит загружается первым (как std::bitset<64>::to_ullong())
+    explicit A51Generator(uint64_t key) { setKey(key); }
+    void setKey(uint64_t key);
 
-    // Инициализация регистров (64 + 22 + 100 тактов)
-    void initializeRegisters(const std::bitset<64>& key, uint32_t frameNumber);
+    // Один кадр: гамма без ограничения длины
+    void startFrame(uint32_t frame);
 
-    // Генерация одного бита гаммы
-    bool generateKeystreamBit();
+    // Последовательность пакетов GSM: после каждых 228 бит гаммы — следующий кадр
+    void startFrames(uint32_t firstFrame);
 
-    // Генерация гаммы заданной длины
-    std::bitset<64> generateGamma(int length);
+    // Очередные bytes байт гаммы, первый бит — старший бит байта
+    void generate(uint8_t* out, qsizetype bytes);
 
-    // Шифрование/дешифрование текста
-    CipherResult processText(const QString& text, const std::bitset<64>& key, bool encrypt);
+    // count кадров подряд с firstFrame по 228 бит, без выравнивания кадров на байты;
+    // out — (count * 228 + 7) / 8 байт, неполный последний байт дополняется нулями
+    void generateFrames(uint32_t firstFrame, qsizetype count, uint8_t* out);
 
-    // Преобразование текста в биты (русский алфавит -> 5 бит)
-    std::bitset<64> textToBits(const QString& text) const;
+    // Номер текущего кадра
+    uint32_t frame() const { return m_frame; }
 
-    // Преобразование битов в текст (5 бит -> русская буква)
-    QString bitsToText(const std::bitset<64>& bits) const;
+private:
+    // Серии из стольких целых кадров подряд в режиме пакетов GSM
+    // вырабатываются побитово-срезовым A51BitSlice
+    static constexpr int BITSLICE_MIN_FRAMES = 64;
+
+    // Тактов на одну выборку из таблицы и выборок между пополнениями окон.
+    // Таблица тактирования индексируется 3 * STEP_CLOCKS битами: при 4 тактах
+    // она (вместе с таблицей выхода) занимает 17 КиБ и живет в L1, при 8 —
+    // 64 МиБ, и промахи кеша съедают выигрыш от вдвое меньшего числа выборок
+    static constexpr int STEP_CLOCKS = 4;
+    static constexpr int REFILL_STEPS = 8;
+    static constexpr int FRAME_STEPS = A51Cipher::FRAME_BITS / STEP_CLOCKS;
+    static constexpr int MIX_STEPS = 100 / STEP_CLOCKS;
+
+    void loadFrame(uint32_t frame);
+
+    // Целые кадры с m_frame + 1 через A51BitSlice; возвращает число полубайт
+    qsizetype produceFrames(uint8_t* out, qsizetype pos, qsizetype nibbles);
+
+    // nibbles полубайт гаммы с полубайта pos буфера out (четный — старший в байте)
+    void produce(uint8_t* out, qsizetype pos, qsizetype nibbles);
+
+    uint64_t m_key = 0;
+    uint32_t m_keyRegs[3] = {0, 0, 0};
+    uint64_t m_w[3] = {0, 0, 0};
+    int m_sinceRefill = 0;
+    uint32_t m_frame = 0;
+    bool m_framed = false;
+    int m_frameSteps = 0;
+};
 
-    // Преобразование строки битов в QByteArray
-    QByteArray bitsToBytes(const std::bitset<64>& bits, int numBits) const;
+// Побитово-срезовый (bit-sliced) A5/1 для пачек независимых пар (ключ, кадр):
+// бит i регистра у всех пар пачки — одно машинное слово, по биту на пару
+// (64 пары в uint64_t, 256 — в регистре AVX2). Мажоритарное тактирование —
+// маски: регистр сдвигается только в тех парах, где его бит синхронизации
+// совпал с большинством. Загрузка ключа и номера кадра линейна (регистры
+// только вращаются), поэтому сводится к XOR срезов ключа в нужные биты.
+class A51BitSlice
+{
+public:
+    static constexpr int LANES = 64;
+    static constexpr int AVX2_LANES = 256;
+
+    // bits бит гаммы для каждой из count пар (keys[i], frames[i]); гамма пары i —
+    // с out + i * stride, stride ≥ (bits + 7) / 8, первый бит — старший бит байта,
+    // как у A51Generator::startFrame + generate. Целые пачки по 256 пар при
+    // наличии AVX2 идут через AVX2, остальное — по 64
+    static void generate(const uint64_t* keys, const uint32_t* frames, qsizetype count,
+                         qsizetype bits, uint8_t* out, qsizetype stride);
 };
 
 // Класс для регистрации шифра
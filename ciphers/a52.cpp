@@ -6,9 +6,11 @@
 #include <QLabel>
 #include <QComboBox>
 #include <QStackedWidget>
+#include <QSpinBox>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 #include <QDebug>
+#include <vector>
 
 // ==================== Многочлены обратной связи ====================
 // R1: x^19 + x^18 + x^17 + x^14 + 1
@@ -139,297 +141,445 @@ void A52TextKeyEdit::focusOutEvent(QFocusEvent* event)
     QLineEdit::focusOutEvent(event);
 }
 
-// ==================== A52Cipher Implementation ====================
+// ==================== A52Generator Implementation ====================
 
-A52Cipher::A52Cipher()
-    : m_r1(0), m_r2(0), m_r3(0), m_r4(0), m_frameNumber(0)
-{
-}
+namespace {
+    const int REG_LEN[4] = {A52Cipher::R1_LEN, A52Cipher::R2_LEN, A52Cipher::R3_LEN, A52Cipher::R4_LEN};
+    const uint32_t REG_MASK[4] = {
+        (1u << A52Cipher::R1_LEN) - 1, (1u << A52Cipher::R2_LEN) - 1,
+        (1u << A52Cipher::R3_LEN) - 1, (1u << A52Cipher::R4_LEN) - 1
+    };
+    const int* const REG_TAPS[4] = {A52Cipher::R1_TAPS, A52Cipher::R2_TAPS, A52Cipher::R3_TAPS, A52Cipher::R4_TAPS};
+    const int REG_TAP_COUNT[4] = {4, 2, 4, 2};
+    const int* const REG_F_BITS[3] = {A52Cipher::R1_F_BITS, A52Cipher::R2_F_BITS, A52Cipher::R3_F_BITS};
 
-uint32_t A52Cipher::feedbackR1() const
-{
-    uint32_t fb = 0;
-    for (int i = 0; i < 4; ++i) {
-        fb ^= (m_r1 >> R1_TAPS[i]) & 1;
+    // Первый бит окна R4, от которого берется индекс таблицы тактов
+    const int R4_INDEX_SHIFT = A52Cipher::R4_CLOCK_BIT1;
+
+    struct A52Tables
+    {
+        // По 11 битам окна R4 начиная с R4_CLOCK_BIT1: в битах 0-3, 4-7, 8-11 —
+        // на каких из четырех тактов сдвигались R1, R2, R3 (бит j — такт j),
+        // в битах 12-14, 15-17, 18-20 — сколько раз
+        uint32_t steps[1 << 11];
+
+        // По маске тактов регистра и 5 битам его выходного окна — вклад
+        // в 4 выходных бита (первый такт — старший бит)
+        uint8_t output[16][32];
+
+        // Окно из 64 бит по состоянию регистра — XOR выборок по байтам состояния
+        uint64_t expand[4][3][256];
+    };
+
+    inline bool majority(bool x, bool y, bool z)
+    {
+        return (x && y) || (x && z) || (y && z);
     }
-    return fb;
-}
 
-uint32_t A52Cipher::feedbackR2() const
-{
-    uint32_t fb = 0;
-    for (int i = 0; i < 2; ++i) {
-        fb ^= (m_r2 >> R2_TAPS[i]) & 1;
+    // Окно последовательности регистра r по его состоянию: бит n ≥ LEN —
+    // обратная связь от битов n - LEN + TAPS[i]
+    uint64_t expandState(int r, uint32_t state)
+    {
+        uint64_t w = state;
+        for (int n = REG_LEN[r]; n < 64; ++n) {
+            uint64_t fb = 0;
+            for (int i = 0; i < REG_TAP_COUNT[r]; ++i) {
+                fb ^= w >> (n - REG_LEN[r] + REG_TAPS[r][i]);
+            }
+            w |= (fb & 1) << n;
+        }
+        return w;
     }
-    return fb;
-}
 
-uint32_t A52Cipher::feedbackR3() const
-{
-    uint32_t fb = 0;
-    for (int i = 0; i < 4; ++i) {
-        fb ^= (m_r3 >> R3_TAPS[i]) & 1;
+    A52Tables buildTables()
+    {
+        A52Tables t;
+
+        // Бит управления k на такте j — бит окна R4 k + j, в индексе — k + j - R4_INDEX_SHIFT
+        const int clockBit[3] = {A52Cipher::R4_CLOCK_BIT3, A52Cipher::R4_CLOCK_BIT1, A52Cipher::R4_CLOCK_BIT2};
+        for (uint32_t index = 0; index < (1u << 11); ++index) {
+            uint32_t taken[3] = {0, 0, 0};
+            uint32_t pattern[3] = {0, 0, 0};
+            for (int j = 0; j < 4; ++j) {
+                bool clock[3];
+                for (int r = 0; r < 3; ++r) {
+                    clock[r] = (index >> (clockBit[r] + j - R4_INDEX_SHIFT)) & 1;
+                }
+                const bool maj = majority(clock[0], clock[1], clock[2]);
+                for (int r = 0; r < 3; ++r) {
+                    if (clock[r] == maj) {
+                        pattern[r] |= 1u << j;
+                        ++taken[r];
+                    }
+                }
+            }
+            t.steps[index] = pattern[0] | (pattern[1] << 4) | (pattern[2] << 8)
+                           | (taken[0] << 12) | (taken[1] << 15) | (taken[2] << 18);
+        }
+
+        for (int p = 0; p < 16; ++p) {
+            for (int bits = 0; bits < 32; ++bits) {
+                uint8_t out = 0;
+                int taken = 0;
+                for (int j = 0; j < 4; ++j) {
+                    taken += (p >> j) & 1;
+                    out |= ((bits >> taken) & 1) << (3 - j);
+                }
+                t.output[p][bits] = out;
+            }
+        }
+
+        for (int r = 0; r < 4; ++r) {
+            for (int k = 0; k < 3; ++k) {
+                for (uint32_t b = 0; b < 256; ++b) {
+                    t.expand[r][k][b] = expandState(r, (b << (8 * k)) & REG_MASK[r]);
+                }
+            }
+        }
+        return t;
     }
-    return fb;
-}
 
-uint32_t A52Cipher::feedbackR4() const
-{
-    uint32_t fb = 0;
-    for (int i = 0; i < 2; ++i) {
-        fb ^= (m_r4 >> R4_TAPS[i]) & 1;
+    const A52Tables TABLES = buildTables();
+
+    inline uint64_t refill(int r, uint64_t w)
+    {
+        return TABLES.expand[r][0][w & 0xFF] ^ TABLES.expand[r][1][(w >> 8) & 0xFF]
+             ^ TABLES.expand[r][2][(w >> 16) & 0xFF & (REG_MASK[r] >> 16)];
     }
-    return fb;
-}
 
-bool A52Cipher::majority(bool x, bool y, bool z) const
-{
-    return (x && y) || (x && z) || (y && z);
-}
+    // Выходное окно регистра r: бит t — старший бит XOR F* после t сдвигов.
+    // Верно для t + LEN - 1 < 64, с запасом на REFILL_STEPS выборок
+    inline uint64_t outputWindow(int r, uint64_t w)
+    {
+        const uint64_t a = w >> REG_F_BITS[r][0];
+        const uint64_t b = w >> REG_F_BITS[r][1];
+        const uint64_t c = w >> REG_F_BITS[r][2];
+        return (w >> (REG_LEN[r] - 1)) ^ (a & b) ^ (a & c) ^ (b & c);
+    }
 
-bool A52Cipher::majorityFromBits(uint32_t reg, int bit1, int bit2, int bit3) const
-{
-    bool x = (reg >> bit1) & 1;
-    bool y = (reg >> bit2) & 1;
-    bool z = (reg >> bit3) & 1;
-    return majority(x, y, z);
-}
+    // Окна всех регистров: w — последовательности R1–R4, g — выходные окна R1–R3
+    struct Windows
+    {
+        uint64_t w1, w2, w3, w4;
+        uint64_t g1, g2, g3;
+    };
+
+    inline void refillAll(Windows& s)
+    {
+        s.w1 = refill(0, s.w1);
+        s.w2 = refill(1, s.w2);
+        s.w3 = refill(2, s.w3);
+        s.w4 = refill(3, s.w4);
+        s.g1 = outputWindow(0, s.w1);
+        s.g2 = outputWindow(1, s.w2);
+        s.g3 = outputWindow(2, s.w3);
+    }
 
-bool A52Cipher::getBit(uint32_t reg, int bitPos) const
-{
-    return (reg >> bitPos) & 1;
-}
+    // Четыре такта; возвращает 4 бита гаммы
+    inline uint32_t step(Windows& s)
+    {
+        const uint32_t e = TABLES.steps[(s.w4 >> R4_INDEX_SHIFT) & 0x7FF];
+        const uint32_t out = TABLES.output[e & 0xF][s.g1 & 0x1F]
+                           ^ TABLES.output[(e >> 4) & 0xF][s.g2 & 0x1F]
+                           ^ TABLES.output[(e >> 8) & 0xF][s.g3 & 0x1F];
+        const int c1 = (e >> 12) & 7;
+        const int c2 = (e >> 15) & 7;
+        const int c3 = (e >> 18) & 7;
+        s.w1 >>= c1;
+        s.g1 >>= c1;
+        s.w2 >>= c2;
+        s.g2 >>= c2;
+        s.w3 >>= c3;
+        s.g3 >>= c3;
+        s.w4 >>= 4;
+        return out;
+    }
 
-void A52Cipher::shiftR1()
-{
-    uint32_t fb = feedbackR1();
-    m_r1 = (m_r1 >> 1) | (fb << (R1_LEN - 1));
-    m_r1 &= (1 << R1_LEN) - 1;
+    // Такт загрузки (ключ и номер кадра): все регистры сдвигаются, бит XOR
+    // с выталкиваемым младшим битом входит в старший
+    inline void loadBit(uint32_t* regs, uint32_t bit)
+    {
+        for (int r = 0; r < 4; ++r) {
+            regs[r] = ((regs[r] >> 1) | ((bit ^ (regs[r] & 1)) << (REG_LEN[r] - 1))) & REG_MASK[r];
+        }
+    }
+
+    inline void shiftReg(uint32_t* regs, int r)
+    {
+        uint32_t fb = 0;
+        for (int i = 0; i < REG_TAP_COUNT[r]; ++i) {
+            fb ^= regs[r] >> REG_TAPS[r][i];
+        }
+        regs[r] = ((regs[r] >> 1) | ((fb & 1) << (REG_LEN[r] - 1))) & REG_MASK[r];
+    }
+
+    // Один такт с управлением через R4 (без выходного бита)
+    inline void clockBit(uint32_t* regs)
+    {
+        const bool clock1 = (regs[3] >> A52Cipher::R4_CLOCK_BIT3) & 1;  // для R1
+        const bool clock2 = (regs[3] >> A52Cipher::R4_CLOCK_BIT1) & 1;  // для R2
+        const bool clock3 = (regs[3] >> A52Cipher::R4_CLOCK_BIT2) & 1;  // для R3
+        const bool maj = majority(clock1, clock2, clock3);
+
+        if (clock1 == maj) shiftReg(regs, 0);
+        if (clock2 == maj) shiftReg(regs, 1);
+        if (clock3 == maj) shiftReg(regs, 2);
+        shiftReg(regs, 3);  // R4 всегда сдвигается
+    }
 }
 
-void A52Cipher::shiftR2()
+void A52Generator::setKey(uint64_t key)
 {
-    uint32_t fb = feedbackR2();
-    m_r2 = (m_r2 >> 1) | (fb << (R2_LEN - 1));
-    m_r2 &= (1 << R2_LEN) - 1;
+    // Этап 1: 64 такта, XOR с битами ключа (от старшего)
+    m_keyRegs[0] = m_keyRegs[1] = m_keyRegs[2] = m_keyRegs[3] = 0;
+    for (int i = 63; i >= 0; --i) {
+        loadBit(m_keyRegs, uint32_t(key >> i) & 1);
+    }
+    startFrame(0);
 }
 
-void A52Cipher::shiftR3()
+void A52Generator::startFrame(uint32_t frame)
 {
-    uint32_t fb = feedbackR3();
-    m_r3 = (m_r3 >> 1) | (fb << (R3_LEN - 1));
-    m_r3 &= (1 << R3_LEN) - 1;
+    m_framed = false;
+    loadFrame(frame & A52Cipher::FRAME_MASK);
 }
 
-void A52Cipher::shiftR4()
+void A52Generator::startFrames(uint32_t firstFrame)
 {
-    uint32_t fb = feedbackR4();
-    m_r4 = (m_r4 >> 1) | (fb << (R4_LEN - 1));
-    m_r4 &= (1 << R4_LEN) - 1;
+    m_framed = true;
+    loadFrame(firstFrame & A52Cipher::FRAME_MASK);
 }
 
-void A52Cipher::initializeRegisters(const std::bitset<64>& key, uint32_t frameNumber)
+void A52Generator::loadFrame(uint32_t frame)
 {
-    // Обнуляем регистры
-    m_r1 = 0;
-    m_r2 = 0;
-    m_r3 = 0;
-    m_r4 = 0;
-
-    // Этап 1: 64 такта, XOR с битами ключа
-    for (int i = 0; i < 64; ++i) {
-        bool keyBit = key[63 - i];
-
-        uint32_t lsb1 = m_r1 & 1;
-        uint32_t lsb2 = m_r2 & 1;
-        uint32_t lsb3 = m_r3 & 1;
-        uint32_t lsb4 = m_r4 & 1;
-
-        m_r1 = (m_r1 >> 1) | ((keyBit ^ lsb1) << (R1_LEN - 1));
-        m_r2 = (m_r2 >> 1) | ((keyBit ^ lsb2) << (R2_LEN - 1));
-        m_r3 = (m_r3 >> 1) | ((keyBit ^ lsb3) << (R3_LEN - 1));
-        m_r4 = (m_r4 >> 1) | ((keyBit ^ lsb4) << (R4_LEN - 1));
-
-        m_r1 &= (1 << R1_LEN) - 1;
-        m_r2 &= (1 << R2_LEN) - 1;
-        m_r3 &= (1 << R3_LEN) - 1;
-        m_r4 &= (1 << R4_LEN) - 1;
-    }
-
-    // Этап 2: 22 такта, XOR с битами номера кадра
+    // Этап 2: 22 такта, XOR с битами номера кадра (от младшего)
+    uint32_t regs[4] = {m_keyRegs[0], m_keyRegs[1], m_keyRegs[2], m_keyRegs[3]};
     for (int i = 0; i < 22; ++i) {
-        bool frameBit = (frameNumber >> i) & 1;
-
-        uint32_t lsb1 = m_r1 & 1;
-        uint32_t lsb2 = m_r2 & 1;
-        uint32_t lsb3 = m_r3 & 1;
-        uint32_t lsb4 = m_r4 & 1;
+        loadBit(regs, (frame >> i) & 1);
+    }
 
-        m_r1 = (m_r1 >> 1) | ((frameBit ^ lsb1) << (R1_LEN - 1));
-        m_r2 = (m_r2 >> 1) | ((frameBit ^ lsb2) << (R2_LEN - 1));
-        m_r3 = (m_r3 >> 1) | ((frameBit ^ lsb3) << (R3_LEN - 1));
-        m_r4 = (m_r4 >> 1) | ((frameBit ^ lsb4) << (R4_LEN - 1));
+    // Этап 3: установка битов R4(3), R4(7), R4(10) в 1
+    regs[3] |= (1u << 3) | (1u << 7) | (1u << 10);
 
-        m_r1 &= (1 << R1_LEN) - 1;
-        m_r2 &= (1 << R2_LEN) - 1;
-        m_r3 &= (1 << R3_LEN) - 1;
-        m_r4 &= (1 << R4_LEN) - 1;
+    // Этап 4: 99 тактов холостого прогона — остаток по одному такту, затем по четыре
+    for (int i = 0; i < MIX_CLOCKS % STEP_CLOCKS; ++i) {
+        clockBit(regs);
+    }
+    Windows s = {regs[0], regs[1], regs[2], regs[3], 0, 0, 0};
+    for (int i = 0; i < MIX_CLOCKS / STEP_CLOCKS; ++i) {
+        if (i % REFILL_STEPS == 0) {
+            refillAll(s);
+        }
+        step(s);
     }
 
-    // Этап 3: 1 такт - установка битов R4(3), R4(7), R4(10) в 1
-    m_r4 |= (1 << 3) | (1 << 7) | (1 << 10);
-    m_r4 &= (1 << R4_LEN) - 1;
+    m_w[0] = s.w1;
+    m_w[1] = s.w2;
+    m_w[2] = s.w3;
+    m_w[3] = s.w4;
+    m_g[0] = s.g1;
+    m_g[1] = s.g2;
+    m_g[2] = s.g3;
+    // Выборок после последнего пополнения (от 1 до REFILL_STEPS)
+    m_sinceRefill = (MIX_CLOCKS / STEP_CLOCKS - 1) % REFILL_STEPS + 1;
+    m_frame = frame;
+    m_frameSteps = 0;
+}
 
-    // Этап 4: 99 тактов холостого прогона
-    for (int i = 0; i < 99; ++i) {
-        bool clock1 = getBit(m_r4, R4_CLOCK_BIT3);  // R4(10) для R1
-        bool clock2 = getBit(m_r4, R4_CLOCK_BIT1);  // R4(3) для R2
-        bool clock3 = getBit(m_r4, R4_CLOCK_BIT2);  // R4(7) для R3
+void A52Generator::produce(uint8_t* out, qsizetype pos, qsizetype nibbles)
+{
+    while (nibbles > 0) {
+        if (m_framed && m_frameSteps == FRAME_STEPS) {
+            loadFrame((m_frame + 1) & A52Cipher::FRAME_MASK);
+        }
+        const qsizetype n = m_framed ? qMin<qsizetype>(nibbles, FRAME_STEPS - m_frameSteps) : nibbles;
+
+        // Состояние — в локальных переменных: запись в out через uint8_t*
+        // иначе заставляет перечитывать поля после каждого байта
+        Windows s = {m_w[0], m_w[1], m_w[2], m_w[3], m_g[0], m_g[1], m_g[2]};
+        int sinceRefill = m_sinceRefill;
+        qsizetype i = 0;
+
+        // До границы байта — по одной выборке
+        while (i < n && (pos + i) % 2 != 0) {
+            if (sinceRefill == REFILL_STEPS) {
+                refillAll(s);
+                sinceRefill = 0;
+            }
+            out[(pos + i) / 2] |= uint8_t(step(s));
+            ++sinceRefill;
+            ++i;
+        }
 
-        bool maj = majority(clock1, clock2, clock3);
+        // Основной цикл: пополнение окон раньше срока безопасно (окно
+        // пересчитывается из самого регистра), поэтому 8 выборок без проверок
+        uint8_t* dst = out + (pos + i) / 2;
+        for (; i + REFILL_STEPS <= n; i += REFILL_STEPS) {
+            refillAll(s);
+            for (int k = 0; k < REFILL_STEPS / 2; ++k) {
+                const uint32_t hi = step(s);
+                const uint32_t lo = step(s);
+                *dst++ = uint8_t((hi << 4) | lo);
+            }
+            sinceRefill = REFILL_STEPS;
+        }
 
-        if (clock1 == maj) shiftR1();
-        if (clock2 == maj) shiftR2();
-        if (clock3 == maj) shiftR3();
+        for (; i < n; ++i) {
+            if (sinceRefill == REFILL_STEPS) {
+                refillAll(s);
+                sinceRefill = 0;
+            }
+            const uint8_t v = uint8_t(step(s));
+            if ((pos + i) % 2 == 0) {
+                out[(pos + i) / 2] = uint8_t(v << 4);
+            } else {
+                out[(pos + i) / 2] |= v;
+            }
+            ++sinceRefill;
+        }
 
-        // R4 всегда сдвигается (по описанию A5/2)
-        shiftR4();
+        m_w[0] = s.w1;
+        m_w[1] = s.w2;
+        m_w[2] = s.w3;
+        m_w[3] = s.w4;
+        m_g[0] = s.g1;
+        m_g[1] = s.g2;
+        m_g[2] = s.g3;
+        m_sinceRefill = sinceRefill;
+        if (m_framed) {
+            m_frameSteps += int(n);
+        }
+        pos += n;
+        nibbles -= n;
     }
 }
 
-bool A52Cipher::generateKeystreamBit()
+void A52Generator::generate(uint8_t* out, qsizetype bytes)
 {
-    // Получаем биты синхронизации из R4
-    bool clock1 = getBit(m_r4, R4_CLOCK_BIT3);  // для R1
-    bool clock2 = getBit(m_r4, R4_CLOCK_BIT1);  // для R2
-    bool clock3 = getBit(m_r4, R4_CLOCK_BIT2);  // для R3
-
-    bool maj = majority(clock1, clock2, clock3);
-
-    // Сдвигаем регистры
-    if (clock1 == maj) shiftR1();
-    if (clock2 == maj) shiftR2();
-    if (clock3 == maj) shiftR3();
-    shiftR4();  // R4 всегда сдвигается
-
-    // Вычисляем F* для каждого регистра
-    bool f1 = majorityFromBits(m_r1, R1_F_BITS[0], R1_F_BITS[1], R1_F_BITS[2]);
-    bool f2 = majorityFromBits(m_r2, R2_F_BITS[0], R2_F_BITS[1], R2_F_BITS[2]);
-    bool f3 = majorityFromBits(m_r3, R3_F_BITS[0], R3_F_BITS[1], R3_F_BITS[2]);
-
-    // Выходной бит = XOR старших битов и F*
-    bool out1 = (m_r1 >> (R1_LEN - 1)) & 1;
-    bool out2 = (m_r2 >> (R2_LEN - 1)) & 1;
-    bool out3 = (m_r3 >> (R3_LEN - 1)) & 1;
-
-    return out1 ^ out2 ^ out3 ^ f1 ^ f2 ^ f3;
+    produce(out, 0, bytes * 2);
 }
 
-std::bitset<1024> A52Cipher::generateGamma(int numBits)
+void A52Generator::generateFrames(uint32_t firstFrame, qsizetype count, uint8_t* out)
 {
-    std::bitset<1024> gamma;
-    for (int i = 0; i < numBits; ++i) {
-        bool bit = generateKeystreamBit();
-        if (bit) {
-            gamma.set(numBits - 1 - i);
-        }
-    }
-    return gamma;
+    startFrames(firstFrame);
+    produce(out, 0, count * FRAME_STEPS);
 }
 
-std::bitset<1024> A52Cipher::textToBits(const QString& text, int& totalBits) const
-{
-    std::bitset<1024> result;
-    QString filtered = CipherUtils::filterAlphabetOnly(text, m_alphabet);
-    totalBits = filtered.length() * 5;
+// ==================== A52Cipher Implementation ====================
 
-    for (int i = 0; i < filtered.length(); ++i) {
-        int pos = m_alphabet.indexOf(filtered[i]);
-        if (pos >= 0 && pos < 32) {
-            for (int b = 0; b < 5; ++b) {
-                bool bit = (pos >> (4 - b)) & 1;
-                int bitPos = (i * 5) + b;
-                if (bitPos < totalBits) {
-                    result.set(totalBits - 1 - bitPos, bit);
-                }
-            }
-        }
-    }
-    return result;
+A52Cipher::A52Cipher()
+{
 }
 
-QString A52Cipher::bitsToText(const std::bitset<1024>& bits, int totalBits) const
+std::bitset<64> A52Cipher::textToBits(const QString& text) const
 {
-    QString result;
-    int numLetters = totalBits / 5;
-
-    for (int i = 0; i < numLetters; ++i) {
-        int pos = 0;
-        for (int b = 0; b < 5; ++b) {
-            int bitPos = (i * 5) + b;
-            if (bitPos < totalBits && bits[totalBits - 1 - bitPos]) {
-                pos |= (1 << (4 - b));
-            }
-        }
-        if (pos < m_alphabet.length()) {
-            result.append(m_alphabet[pos]);
+    // Биты букв подряд как одно число: старшие биты длинного ключа отбрасываются
+    QString filtered = CipherUtils::filterAlphabetOnly(text, m_alphabet);
+    uint64_t key = 0;
+    for (int i = 0; i < filtered.length(); ++i) {
+        int pos = m_alphabet.indexOf(filtered[i]);
+        if (pos < 0 || pos >= 32) {
+            pos = 0;
         }
+        key = (key << 5) | uint64_t(pos);
     }
-    return result;
+    return std::bitset<64>(key);
 }
 
-CipherResult A52Cipher::processText(const QString& text, const std::bitset<64>& key, bool encrypt)
+CipherResult A52Cipher::processText(const QString& text, const QVariantMap& params, StepTrace& trace)
 {
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = false;
 
+    uint32_t frame = 0;
+    bool framed = false;
+    QString error;
+    if (!frameFromParams(params, frame, framed, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return result;
+    }
+
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало работы A5/2", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало работы A5/2", "Инициализация"));
+    }
 
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Входной текст: %1").arg(filteredText.left(50)),
-        "Подготовка данных"));
-
-    int totalBits;
-    std::bitset<1024> textBits = textToBits(filteredText, totalBits);
-
-    steps.append(CipherStep(2, QChar(),
-        QString("Всего бит: %1").arg(totalBits),
-        "Преобразование текста"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Входной текст: %1").arg(filteredText.left(50)),
+            "Подготовка данных"));
+    }
 
-    initializeRegisters(key, 0);
+    // Каждая буква — 5 бит гаммы
+    const qsizetype totalBits = filteredText.length() * 5;
 
-    steps.append(CipherStep(3, QChar(), "Инициализация регистров (кадр 0)", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Всего бит: %1").arg(totalBits),
+            "Преобразование текста"));
+    }
 
-    std::bitset<1024> gamma = generateGamma(totalBits);
+    A52Generator generator(keyFromParams(params).to_ullong());
+    if (framed) {
+        generator.startFrames(frame);
+    } else {
+        generator.startFrame(frame);
+    }
 
-    QString gammaPreview;
-    for (int i = 0; i < qMin(20, totalBits); ++i) {
-        gammaPreview.append(gamma[totalBits - 1 - i] ? '1' : '0');
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            framed ? QString("Инициализация регистров (кадры с %1 по %2 бит)").arg(frame).arg(FRAME_BITS)
+                   : QString("Инициализация регистров (кадр %1)").arg(frame),
+            "Инициализация"));
     }
-    steps.append(CipherStep(4, QChar(),
-        QString("Гамма (первые %1 бит): %2...").arg(qMin(20, totalBits)).arg(gammaPreview),
-        "Генерация гаммы"));
 
-    std::bitset<1024> resultBits;
-    for (int i = 0; i < totalBits; ++i) {
-        resultBits[i] = textBits[i] ^ gamma[i];
+    std::vector<uint8_t> gamma(size_t((totalBits + 7) / 8));
+    generator.generate(gamma.data(), qsizetype(gamma.size()));
+    auto gammaBit = [&gamma](qsizetype i) {
+        return (gamma[size_t(i / 8)] >> (7 - i % 8)) & 1;
+    };
+
+    if (trace.want(TraceLevel::Summary)) {
+        const int previewBits = int(qMin<qsizetype>(20, totalBits));
+        QString gammaPreview;
+        for (int i = 0; i < previewBits; ++i) {
+            gammaPreview.append(gammaBit(i) ? '1' : '0');
+        }
+        steps.append(CipherStep(4, QChar(),
+            QString("Гамма (первые %1 бит): %2...").arg(previewBits).arg(gammaPreview),
+            "Генерация гаммы"));
     }
 
-    QString resultText = bitsToText(resultBits, totalBits);
+    // XOR номера буквы с 5 битами гаммы (первый бит гаммы — старший)
+    QString resultText;
+    resultText.reserve(filteredText.length());
+    for (qsizetype i = 0; i < filteredText.length(); ++i) {
+        int pos = m_alphabet.indexOf(filteredText[i]);
+        if (pos < 0 || pos >= 32) {
+            pos = 0;
+        }
+        for (int b = 0; b < 5; ++b) {
+            pos ^= gammaBit(i * 5 + b) << (4 - b);
+        }
+        if (pos < m_alphabet.length()) {
+            resultText.append(m_alphabet[pos]);
+        }
+    }
 
-    steps.append(CipherStep(5, QChar(),
-        QString("Результат: %1").arg(resultText),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(5, QChar(),
+            QString("Результат: %1").arg(resultText),
+            "Завершение"));
+    }
 
     result.result = resultText;
     result.steps = steps;
@@ -437,7 +587,7 @@ CipherResult A52Cipher::processText(const QString& text, const std::bitset<64>&
     return result;
 }
 
-CipherResult A52Cipher::encrypt(const QString& text, const QVariantMap& params)
+std::bitset<64> A52Cipher::keyFromParams(const QVariantMap& params) const
 {
     QString keyType = params.value("keyType", "binary").toString();
     std::bitset<64> key;
@@ -452,15 +602,35 @@ CipherResult A52Cipher::encrypt(const QString& text, const QVariantMap& params)
             }
         }
     } else {
-        QString textKey = params.value("textKey", "").toString();
-        int totalBits;
-        std::bitset<1024> textBits = textToBits(textKey, totalBits);
-        for (int i = 0; i < 64; ++i) {
-            key.set(63 - i, textBits[63 - i]);
-        }
+        key = textToBits(params.value("textKey", "").toString());
     }
 
-    return processText(text, key, true);
+    return key;
+}
+
+bool A52Cipher::frameFromParams(const QVariantMap& params, uint32_t& frame, bool& framed, QString* error)
+{
+    const QString framing = params.value("framing", "continuous").toString();
+    if (framing != "continuous" && framing != "gsm") {
+        if (error) *error = QString("ОШИБКА: Неизвестный режим кадров: %1 (continuous или gsm)").arg(framing);
+        return false;
+    }
+    framed = (framing == "gsm");
+
+    bool ok = true;
+    const qlonglong value = params.value("frame", 0).toLongLong(&ok);
+    if (!ok || value < 0 || value > FRAME_MASK) {
+        if (error) *error = QString("ОШИБКА: Номер кадра должен быть от 0 до %1").arg(FRAME_MASK);
+        return false;
+    }
+    frame = uint32_t(value);
+    return true;
+}
+
+CipherResult A52Cipher::encrypt(const QString& text, const QVariantMap& params)
+{
+    StepTrace trace(params);
+    return trace.finish(processText(text, params, trace));
 }
 
 CipherResult A52Cipher::decrypt(const QString& text, const QVariantMap& params)
@@ -468,6 +638,90 @@ CipherResult A52Cipher::decrypt(const QString& text, const QVariantMap& params)
     return encrypt(text, params);
 }
 
+// Бинарный путь: гамма накладывается побайтно, старший бит байта — первый бит гаммы
+class A52Stream : public KeystreamCipherStream
+{
+public:
+    explicit A52Stream(const A52Cipher& cipher)
+        : KeystreamCipherStream(8), m_cipher(cipher) {}
+
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        uint32_t frame = 0;
+        bool framed = false;
+        if (!A52Cipher::frameFromParams(params, frame, framed, error)) {
+            return false;
+        }
+        reset();
+        m_generator.setKey(m_cipher.keyFromParams(params).to_ullong());
+        if (framed) {
+            m_generator.startFrames(frame);
+        } else {
+            m_generator.startFrame(frame);
+        }
+        return true;
+    }
+
+protected:
+    void nextKeystream(uint8_t* block) override
+    {
+        m_generator.generate(block, 8);
+    }
+
+    // Гамма вырабатывается кусками в буфер на стеке и накладывается одним проходом
+    void xorBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+    {
+        uint8_t gamma[CHUNK_BYTES];
+        qsizetype len = blocks * 8;
+        while (len > 0) {
+            const qsizetype n = qMin<qsizetype>(len, CHUNK_BYTES);
+            m_generator.generate(gamma, n);
+            for (qsizetype i = 0; i < n; ++i) {
+                out[i] = in[i] ^ gamma[i];
+            }
+            in += n;
+            out += n;
+            len -= n;
+        }
+    }
+
+private:
+    static constexpr qsizetype CHUNK_BYTES = 4096;
+
+    A52Cipher m_cipher;
+    A52Generator m_generator;
+};
+
+std::unique_ptr<CipherStream> A52Cipher::createStream(bool encrypt)
+{
+    Q_UNUSED(encrypt)
+    return std::make_unique<A52Stream>(*this);
+}
+
+bool A52Cipher::encryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    A52Stream stream(*this);
+    if (!stream.init(params, error)) {
+        out.clear();
+        return false;
+    }
+
+    // Через промежуточный буфер: in и out могут быть одним объектом
+    QByteArray buffer;
+    buffer.reserve(in.size());
+    if (!stream.update(in, buffer, error) || !stream.final(buffer, error)) {
+        out.clear();
+        return false;
+    }
+    out = buffer;
+    return true;
+}
+
+bool A52Cipher::decryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    return encryptBytes(in, out, params, error);
+}
+
 // ==================== A52CipherRegister Implementation ====================
 
 A52CipherRegister::A52CipherRegister()
@@ -540,12 +794,30 @@ A52CipherRegister::A52CipherRegister()
 
             mainLayout->addWidget(stackedWidget);
 
+            // Номер кадра и разбиение гаммы на пакеты GSM
+            QHBoxLayout* frameRow = new QHBoxLayout();
+            QLabel* frameLabel = new QLabel("Кадр:");
+            frameLabel->setFixedWidth(100);
+            QSpinBox* frameSpin = new QSpinBox();
+            frameSpin->setRange(0, int(A52Cipher::FRAME_MASK));
+            frameSpin->setValue(0);
+            QComboBox* framingCombo = new QComboBox();
+            framingCombo->addItem("Один кадр (непрерывная гамма)", "continuous");
+            framingCombo->addItem("Пакеты GSM (228 бит на кадр)", "gsm");
+            frameRow->addWidget(frameLabel);
+            frameRow->addWidget(frameSpin);
+            frameRow->addWidget(framingCombo);
+            frameRow->addStretch();
+            mainLayout->addLayout(frameRow);
+
             layout->addWidget(paramsContainer);
 
             widgets["keyType"] = typeCombo;
             widgets["binaryKey"] = binaryEdit;
             widgets["textKey"] = textEdit;
             widgets["stackedWidget"] = stackedWidget;
+            widgets["frame"] = frameSpin;
+            widgets["framing"] = framingCombo;
 
             QObject::connect(typeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
                 [stackedWidget](int index) {
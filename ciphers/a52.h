@@ -20,7 +20,16 @@ public:
     virtual CipherResult encrypt(const QString& text, const QVariantMap& params) override;
     virtual CipherResult decrypt(const QString& text, const QVariantMap& params) override;
 
-private:
+    // Бинарный путь: XOR байтов с гаммой, ключ и кадры — как в encrypt
+    virtual bool supportsBytes() const override { return true; }
+    virtual bool encryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+    virtual bool decryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+
+    // Потоковый режим: регистры сохраняют состояние между вызовами update
+    virtual std::unique_ptr<CipherStream> createStream(bool encrypt) override;
+
     // Длины регистров
     static const int R1_LEN = 19;
     static const int R2_LEN = 22;
@@ -43,58 +52,89 @@ private:
     static const int R3_TAPS[4];
     static const int R4_TAPS[2];  // x^17 + x^12 + 1
 
-    // Регистры
-    uint32_t m_r1;  // 19 бит
-    uint32_t m_r2;  // 22 бита
-    uint32_t m_r3;  // 23 бита
-    uint32_t m_r4;  // 17 бит
+    // Номер кадра — 22 бита; пакет GSM — 228 бит гаммы на кадр
+    static constexpr uint32_t FRAME_MASK = (1u << 22) - 1;
+    static constexpr int FRAME_BITS = 228;
 
-    // Номер кадра (22 бита)
-    uint32_t m_frameNumber;
+private:
+    friend class A52Stream;
 
     // Алфавит для текстового ключа
-    QString m_alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& m_alphabet = Alphabet::russian();
 
     // Вспомогательные функции
     bool textToBinaryKey(const QString& textKey, std::bitset<64>& key) const;
     QString binaryToText(const std::bitset<64>& bits) const;
 
-    // Функции обратной связи
-    uint32_t feedbackR1() const;
-    uint32_t feedbackR2() const;
-    uint32_t feedbackR3() const;
-    uint32_t feedbackR4() const;
+    // Ключ из параметров (keyType: binary/text)
+    std::bitset<64> keyFromParams(const QVariantMap& params) const;
+
+    // Номер первого кадра (params["frame"]) и разбиение гаммы на пакеты GSM
+    // (params["framing"]: continuous — один кадр без ограничения длины, gsm — по 228 бит на кадр)
+    static bool frameFromParams(const QVariantMap& params, uint32_t& frame, bool& framed, QString* error);
+
+    // Шифрование/дешифрование текста
+    CipherResult processText(const QString& text, const QVariantMap& params, StepTrace& trace);
 
-    // Функция большинства (majority function)
-    bool majority(bool x, bool y, bool z) const;
-    bool majorityFromBits(uint32_t reg, int bit1, int bit2, int bit3) const;
+    // Текстовый ключ: 5-битные номера букв подряд, ключ — последние 64 бита
+    std::bitset<64> textToBits(const QString& text) const;
+};
 
-    // Получение бита из регистра
-    bool getBit(uint32_t reg, int bitPos) const;
+// Генератор гаммы A5/2 без ограничения длины. R4 сдвигается на каждом такте,
+// поэтому биты управления на четырех тактах вперед — 11 бит его окна (как у
+// A51Generator, окно из 64 бит — регистр и биты, которые войдут в него при
+// следующих сдвигах), и одна выборка из таблицы по ним дает, какие из R1–R3
+// сдвигались на каждом из четырех тактов. Вклад регистра в выходной бит —
+// старший бит XOR F* — вычисляется сразу для всех сдвигов окна несколькими
+// операциями над словом при пополнении окна и затем только сдвигается вместе
+// с ним; вторая таблица по маске тактов собирает из него 4 бита гаммы.
+class A52Generator
+{
+public:
+    A52Generator() = default;
 
-    // Сдвиг регистра с обратной связью
-    void shiftR1();
-    void shiftR2();
-    void shiftR3();
-    void shiftR4();
+    // Ключ: старший бит загружается первым (как std::bitset<64>::to_ullong())
+    explicit A52Generator(uint64_t key) { setKey(key); }
+    void setKey(uint64_t key);
 
-    // Инициализация регистров (64 + 22 + 1 + 99 тактов)
-    void initializeRegisters(const std::bitset<64>& key, uint32_t frameNumber);
+    // Один кадр: гамма без ограничения длины
+    void startFrame(uint32_t frame);
 
-    // Генерация одного бита гаммы (с учетом F*)
-    bool generateKeystreamBit();
+    // Последовательность пакетов GSM: после каждых 228 бит гаммы — следующий кадр
+    void startFrames(uint32_t firstFrame);
 
-    // Генерация гаммы заданной длины
-    std::bitset<1024> generateGamma(int numBits);
+    // Очередные bytes байт гаммы, первый бит — старший бит байта
+    void generate(uint8_t* out, qsizetype bytes);
 
-    // Шифрование/дешифрование текста
-    CipherResult processText(const QString& text, const std::bitset<64>& key, bool encrypt);
+    // count кадров подряд с firstFrame по 228 бит, без выравнивания кадров на байты;
+    // out — (count * 228 + 7) / 8 байт, неполный последний байт дополняется нулями
+    void generateFrames(uint32_t firstFrame, qsizetype count, uint8_t* out);
 
-    // Преобразование текста в биты (русский алфавит -> 5 бит)
-    std::bitset<1024> textToBits(const QString& text, int& totalBits) const;
+    // Номер текущего кадра
+    uint32_t frame() const { return m_frame; }
 
-    // Преобразование битов в текст (5 бит -> русская буква)
-    QString bitsToText(const std::bitset<1024>& bits, int totalBits) const;
+private:
+    // Тактов на одну выборку из таблицы и выборок между пополнениями окон
+    static constexpr int STEP_CLOCKS = 4;
+    static constexpr int REFILL_STEPS = 8;
+    static constexpr int FRAME_STEPS = A52Cipher::FRAME_BITS / STEP_CLOCKS;
+
+    // Холостой прогон — 99 тактов: остаток от деления на STEP_CLOCKS
+    // выполняется по одному такту до перехода к окнам
+    static constexpr int MIX_CLOCKS = 99;
+
+    void loadFrame(uint32_t frame);
+
+    // nibbles полубайт гаммы с полубайта pos буфера out (четный — старший в байте)
+    void produce(uint8_t* out, qsizetype pos, qsizetype nibbles);
+
+    uint32_t m_keyRegs[4] = {0, 0, 0, 0};
+    uint64_t m_w[4] = {0, 0, 0, 0};
+    uint64_t m_g[3] = {0, 0, 0};
+    int m_sinceRefill = 0;
+    uint32_t m_frame = 0;
+    bool m_framed = false;
+    int m_frameSteps = 0;
 };
 
 // Виджет для ввода бинарного ключа (A5/2)
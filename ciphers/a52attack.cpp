@@ -0,0 +1,586 @@
+#include "a52attack.h"
+#include "a52.h"
+#include "cipherparallel.h"
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+    const int REG_LEN[4] = {A52Cipher::R1_LEN, A52Cipher::R2_LEN, A52Cipher::R3_LEN, A52Cipher::R4_LEN};
+    const int* const REG_TAPS[4] = {A52Cipher::R1_TAPS, A52Cipher::R2_TAPS, A52Cipher::R3_TAPS, A52Cipher::R4_TAPS};
+    const int REG_TAP_COUNT[4] = {4, 2, 4, 2};
+    const int* const REG_F_BITS[3] = {A52Cipher::R1_F_BITS, A52Cipher::R2_F_BITS, A52Cipher::R3_F_BITS};
+
+    constexpr int pairCount(int len)
+    {
+        return len * (len - 1) / 2;
+    }
+
+    // Полный набор переменных: произведения пар битов R1, R2, R3 (пара i < j регистра —
+    // PAIR_BASE + j(j-1)/2 + i), затем 64 бита R1–R3 подряд (R1 — 0..18, R2 — 19..40,
+    // R3 — 41..63)
+    const int PAIR_BASE[3] = {
+        0, pairCount(A52Cipher::R1_LEN), pairCount(A52Cipher::R1_LEN) + pairCount(A52Cipher::R2_LEN)
+    };
+    constexpr int PAIRS = pairCount(A52Cipher::R1_LEN) + pairCount(A52Cipher::R2_LEN)
+                        + pairCount(A52Cipher::R3_LEN);
+    const int LIN_OFFSET[3] = {0, A52Cipher::R1_LEN, A52Cipher::R1_LEN + A52Cipher::R2_LEN};
+    constexpr int MAX_COLS = PAIRS + 64 + 1;
+
+    const int MIX_CLOCKS = 99;
+    const uint32_t R4_FORCED = (1u << 3) | (1u << 7) | (1u << 10);
+    const uint32_t R4_MASK = (1u << A52Cipher::R4_LEN) - 1;
+
+    // Догадок в одном куске параллельного перебора
+    const qint64 GUESS_CHUNK = 256;
+
+    // Больше неопределенных битов состояния у догадки не перебирается — гаммы мало
+    const int MAX_UNDETERMINED_BITS = 12;
+
+    inline void flipBit(uint64_t* row, int col)
+    {
+        row[col / 64] ^= 1ull << (col % 64);
+    }
+
+    inline bool testBit(const uint64_t* row, int col)
+    {
+        return (row[col / 64] >> (col % 64)) & 1;
+    }
+
+    // XOR младших len бит bits в столбцы col..col+len-1
+    inline void xorBits(uint64_t* row, int col, uint64_t bits, int len)
+    {
+        const int shift = col % 64;
+        row[col / 64] ^= bits << shift;
+        if (shift != 0 && shift + len > 64) {
+            row[col / 64 + 1] ^= bits >> (64 - shift);
+        }
+    }
+
+    // 64 столбца начиная с col одним словом
+    inline uint64_t readBits(const uint64_t* row, int col)
+    {
+        const int w = col / 64;
+        const int shift = col % 64;
+        return shift == 0 ? row[w] : (row[w] >> shift) | (row[w + 1] << (64 - shift));
+    }
+
+    inline uint32_t parity(uint64_t x)
+    {
+        x ^= x >> 32;
+        x ^= x >> 16;
+        x ^= x >> 8;
+        x ^= x >> 4;
+        x ^= x >> 2;
+        x ^= x >> 1;
+        return uint32_t(x & 1);
+    }
+
+    inline bool majority(bool x, bool y, bool z)
+    {
+        return (x && y) || (x && z) || (y && z);
+    }
+
+    // Загрузка ключа и номера кадра без выставления битов R4 и холостого прогона
+    void loadRegisters(uint64_t key, uint32_t frame, uint32_t* regs)
+    {
+        for (int r = 0; r < 4; ++r) {
+            regs[r] = 0;
+        }
+        for (int i = 0; i < 64 + 22; ++i) {
+            const uint32_t bit = i < 64 ? uint32_t(key >> (63 - i)) & 1 : (frame >> (i - 64)) & 1;
+            for (int r = 0; r < 4; ++r) {
+                regs[r] = ((regs[r] >> 1) | ((bit ^ (regs[r] & 1)) << (REG_LEN[r] - 1)))
+                        & ((1u << REG_LEN[r]) - 1);
+            }
+        }
+    }
+
+    // Последовательность регистра r из state: элемент n — бит 0 регистра после n сдвигов,
+    // бит b после c сдвигов — элемент c + b
+    std::vector<uint8_t> registerSequence(int r, uint32_t state, int length)
+    {
+        std::vector<uint8_t> s(static_cast<size_t>(length));
+        for (int n = 0; n < length; ++n) {
+            if (n < REG_LEN[r]) {
+                s[size_t(n)] = (state >> n) & 1;
+            } else {
+                uint8_t fb = 0;
+                for (int i = 0; i < REG_TAP_COUNT[r]; ++i) {
+                    fb ^= s[size_t(n - REG_LEN[r] + REG_TAPS[r][i])];
+                }
+                s[size_t(n)] = fb;
+            }
+        }
+        return s;
+    }
+
+    struct FrameModel
+    {
+        uint32_t r4 = 0;                     // Вклад номера кадра в R4
+        std::vector<uint8_t> constant[3];    // Последовательности R1–R3 от вклада номера кадра
+        std::vector<uint8_t> keystream;      // Биты гаммы
+    };
+
+    // Все, что не зависит от догадки R4. Столбцы системы — только встречающиеся
+    // произведения (0..linCol-1), затем 64 бита R1–R3 и правая часть rhsCol
+    struct Model
+    {
+        // Последовательности R1–R3 как линейные формы от их состояния после загрузки ключа
+        std::vector<uint32_t> linear[3];
+
+        // По числу сдвигов c регистра r — строка (words слов) его выходного члена:
+        // старший бит и F* от линейных частей битов; вклад кадра добавляется отдельно
+        std::vector<uint64_t> quad[3];
+
+        std::vector<FrameModel> frames;
+        int equations = 0;
+        int linCol = 0;
+        int rhsCol = 0;
+        int words = 0;
+
+        // Позиции R4, которые не выставляются в 1, — биты догадки по порядку
+        int guessPositions[A52Cipher::R4_LEN] = {};
+    };
+
+    // Произведение линейных форм x и y от битов регистра r в полной нумерации:
+    // x_i·y_i — бит i, x_i·y_j + x_j·y_i — произведение пары
+    void addProduct(uint64_t* row, int r, uint32_t x, uint32_t y)
+    {
+        for (int i = 0; i < REG_LEN[r]; ++i) {
+            if (!((x >> i) & 1)) {
+                continue;
+            }
+            for (int j = 0; j < REG_LEN[r]; ++j) {
+                if (!((y >> j) & 1)) {
+                    continue;
+                }
+                if (i == j) {
+                    flipBit(row, PAIRS + LIN_OFFSET[r] + i);
+                } else {
+                    const int lo = qMin(i, j);
+                    const int hi = qMax(i, j);
+                    flipBit(row, PAIR_BASE[r] + hi * (hi - 1) / 2 + lo);
+                }
+            }
+        }
+    }
+
+    void buildModel(const QVector<A52KnownFrame>& frames, Model& model)
+    {
+        int maxBits = 0;
+        for (const A52KnownFrame& f : frames) {
+            maxBits = qMax(maxBits, f.bits);
+            model.equations += f.bits;
+        }
+        const int maxShifts = MIX_CLOCKS + maxBits;
+        const int fullWords = MAX_COLS / 64 + 1;
+
+        // Выходные члены в полной нумерации и объединение встречающихся в них произведений
+        std::vector<uint64_t> full[3];
+        std::vector<uint64_t> used(static_cast<size_t>(fullWords), 0);
+        for (int r = 0; r < 3; ++r) {
+            const int len = REG_LEN[r];
+            std::vector<uint32_t>& lin = model.linear[r];
+            lin.resize(size_t(maxShifts + len));
+            for (int n = 0; n < int(lin.size()); ++n) {
+                if (n < len) {
+                    lin[size_t(n)] = 1u << n;
+                } else {
+                    uint32_t fb = 0;
+                    for (int i = 0; i < REG_TAP_COUNT[r]; ++i) {
+                        fb ^= lin[size_t(n - len + REG_TAPS[r][i])];
+                    }
+                    lin[size_t(n)] = fb;
+                }
+            }
+
+            // F* = ab + ac + bc
+            full[r].assign(size_t(maxShifts + 1) * fullWords, 0);
+            for (int c = 0; c <= maxShifts; ++c) {
+                uint64_t* row = full[r].data() + size_t(c) * fullWords;
+                const uint32_t a = lin[size_t(c + REG_F_BITS[r][0])];
+                const uint32_t b = lin[size_t(c + REG_F_BITS[r][1])];
+                const uint32_t d = lin[size_t(c + REG_F_BITS[r][2])];
+                addProduct(row, r, a, b);
+                addProduct(row, r, a, d);
+                addProduct(row, r, b, d);
+                xorBits(row, PAIRS + LIN_OFFSET[r], lin[size_t(c + len - 1)], len);
+                for (int w = 0; w < fullWords; ++w) {
+                    used[size_t(w)] |= row[w];
+                }
+            }
+        }
+
+        // Обратная связь берется со старших битов, и младшие биты регистров выдвигаются
+        // за холостой прогон, не дойдя до гаммы: из 655 произведений встречается
+        // около 160. Остальные в систему не входят — строка умещается в 4 слова вместо 12
+        std::vector<int> pairCol(static_cast<size_t>(PAIRS), -1);
+        int cols = 0;
+        for (int p = 0; p < PAIRS; ++p) {
+            if (testBit(used.data(), p)) {
+                pairCol[size_t(p)] = cols++;
+            }
+        }
+        model.linCol = cols;
+        model.rhsCol = cols + 64;
+        model.words = model.rhsCol / 64 + 1;
+
+        for (int r = 0; r < 3; ++r) {
+            model.quad[r].assign(size_t(maxShifts + 1) * model.words, 0);
+            for (int c = 0; c <= maxShifts; ++c) {
+                const uint64_t* src = full[r].data() + size_t(c) * fullWords;
+                uint64_t* dst = model.quad[r].data() + size_t(c) * model.words;
+                for (int p = PAIR_BASE[r]; p < PAIR_BASE[r] + pairCount(REG_LEN[r]); ++p) {
+                    if (testBit(src, p)) {
+                        flipBit(dst, pairCol[size_t(p)]);
+                    }
+                }
+                xorBits(dst, model.linCol, readBits(src, PAIRS), 64);
+            }
+        }
+
+        for (const A52KnownFrame& f : frames) {
+            FrameModel fm;
+            uint32_t regs[4];
+            loadRegisters(0, f.frame, regs);
+            fm.r4 = regs[3];
+            for (int r = 0; r < 3; ++r) {
+                fm.constant[r] = registerSequence(r, regs[r], MIX_CLOCKS + f.bits + REG_LEN[r]);
+            }
+            fm.keystream.resize(size_t(f.bits));
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(f.keystream.constData());
+            for (int i = 0; i < f.bits; ++i) {
+                fm.keystream[size_t(i)] = (data[i / 8] >> (7 - i % 8)) & 1;
+            }
+            model.frames.push_back(std::move(fm));
+        }
+
+        int k = 0;
+        for (int b = 0; b < A52Cipher::R4_LEN; ++b) {
+            if (!((R4_FORCED >> b) & 1)) {
+                model.guessPositions[k++] = b;
+            }
+        }
+    }
+
+    // Биты R4 после загрузки ключа (без вклада кадра) по номеру догадки
+    uint32_t guessState(const Model& model, uint32_t index)
+    {
+        uint32_t state = 0;
+        for (int k = 0; k < A52Attack::GUESS_BITS; ++k) {
+            state |= ((index >> k) & 1) << model.guessPositions[k];
+        }
+        return state;
+    }
+
+    // Уравнения для догадки R4 в rows; возвращает их число. active — биты R1–R3,
+    // от которых при этой догадке зависит гамма
+    int buildRows(const Model& model, uint32_t r4Key, uint64_t* rows, uint64_t& active)
+    {
+        active = 0;
+        const int words = model.words;
+        uint64_t* row = rows;
+        for (const FrameModel& fm : model.frames) {
+            uint32_t r4 = (r4Key ^ fm.r4) | R4_FORCED;
+            int shifts[3] = {0, 0, 0};
+            const int clocks = MIX_CLOCKS + int(fm.keystream.size());
+            for (int k = 0; k < clocks; ++k) {
+                const bool clock1 = (r4 >> A52Cipher::R4_CLOCK_BIT3) & 1;  // для R1
+                const bool clock2 = (r4 >> A52Cipher::R4_CLOCK_BIT1) & 1;  // для R2
+                const bool clock3 = (r4 >> A52Cipher::R4_CLOCK_BIT2) & 1;  // для R3
+                const bool maj = majority(clock1, clock2, clock3);
+                shifts[0] += clock1 == maj;
+                shifts[1] += clock2 == maj;
+                shifts[2] += clock3 == maj;
+                const uint32_t fb = ((r4 >> A52Cipher::R4_TAPS[0]) ^ (r4 >> A52Cipher::R4_TAPS[1])) & 1;
+                r4 = ((r4 >> 1) | (fb << (A52Cipher::R4_LEN - 1))) & R4_MASK;
+
+                if (k < MIX_CLOCKS) {
+                    continue;
+                }
+
+                const uint64_t* q1 = model.quad[0].data() + size_t(shifts[0]) * words;
+                const uint64_t* q2 = model.quad[1].data() + size_t(shifts[1]) * words;
+                const uint64_t* q3 = model.quad[2].data() + size_t(shifts[2]) * words;
+                for (int w = 0; w < words; ++w) {
+                    row[w] = q1[w] ^ q2[w] ^ q3[w];
+                }
+
+                // Бит со вкладом кадра c: (a + ca)(b + cb) = ab + cb·a + ca·b + ca·cb
+                uint32_t rhs = fm.keystream[size_t(k - MIX_CLOCKS)];
+                for (int r = 0; r < 3; ++r) {
+                    const uint8_t* cs = fm.constant[r].data() + shifts[r];
+                    const uint32_t* lin = model.linear[r].data() + shifts[r];
+                    const int* f = REG_F_BITS[r];
+                    const bool ca = cs[f[0]];
+                    const bool cb = cs[f[1]];
+                    const bool cc = cs[f[2]];
+                    uint32_t form = 0;
+                    if (cb != cc) form ^= lin[f[0]];
+                    if (ca != cc) form ^= lin[f[1]];
+                    if (ca != cb) form ^= lin[f[2]];
+                    xorBits(row, model.linCol + LIN_OFFSET[r], form, REG_LEN[r]);
+                    active |= uint64_t(lin[f[0]] | lin[f[1]] | lin[f[2]] | lin[REG_LEN[r] - 1]) << LIN_OFFSET[r];
+                    rhs ^= cs[REG_LEN[r] - 1] ^ uint32_t(majority(ca, cb, cc));
+                }
+                row[model.rhsCol / 64] |= uint64_t(rhs) << (model.rhsCol % 64);
+                row += words;
+            }
+        }
+        return int((row - rows) / words);
+    }
+
+    // Прямой ход Гаусса по столбцам 0..rhsCol-1; pivots[col] — строка ведущего
+    // элемента или -1. Строки ниже ранга в пройденных столбцах нулевые, поэтому
+    // обмен и сложение строк начинаются со слова текущего столбца
+    int eliminate(uint64_t* rows, int count, int words, int rhsCol, int* pivots)
+    {
+        int rank = 0;
+        for (int col = 0; col < rhsCol; ++col) {
+            pivots[col] = -1;
+            const int w = col / 64;
+            const uint64_t bit = 1ull << (col % 64);
+
+            int p = rank;
+            while (p < count && !(rows[size_t(p) * words + w] & bit)) {
+                ++p;
+            }
+            if (p == count) {
+                continue;
+            }
+
+            uint64_t* pivot = rows + size_t(rank) * words;
+            if (p != rank) {
+                uint64_t* other = rows + size_t(p) * words;
+                for (int k = w; k < words; ++k) {
+                    std::swap(pivot[k], other[k]);
+                }
+            }
+            for (int i = rank + 1; i < count; ++i) {
+                uint64_t* row = rows + size_t(i) * words;
+                if (row[w] & bit) {
+                    for (int k = w; k < words; ++k) {
+                        row[k] ^= pivot[k];
+                    }
+                }
+            }
+            pivots[col] = rank++;
+        }
+        return rank;
+    }
+
+    // Система для догадки в rows и прямой ход; false — система несовместна
+    bool reduceGuess(const Model& model, uint32_t r4Key, uint64_t* rows, int* pivots, uint64_t& active)
+    {
+        const int count = buildRows(model, r4Key, rows, active);
+        const int rank = eliminate(rows, count, model.words, model.rhsCol, pivots);
+        for (int i = rank; i < count; ++i) {
+            if (testBit(rows + size_t(i) * model.words, model.rhsCol)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Обратный ход только по битам R1–R3: их ведущие строки не содержат произведений.
+    // Биты без ведущего элемента берутся из undetermined
+    uint64_t backSubstitute(const Model& model, const uint64_t* rows, const int* pivots, uint64_t undetermined)
+    {
+        uint64_t solution = undetermined;
+        for (int b = 63; b >= 0; --b) {
+            const int p = pivots[model.linCol + b];
+            if (p < 0) {
+                continue;
+            }
+            const uint64_t* row = rows + size_t(p) * model.words;
+            const uint64_t bit = parity(readBits(row, model.linCol) & solution)
+                               ^ uint32_t(testBit(row, model.rhsCol));
+            solution |= bit << b;
+        }
+        return solution;
+    }
+
+    // Ключ, дающий биты known из solution в R1–R3 и угаданный R4 после загрузки: бит
+    // состояния — линейная форма от битов ключа. Свободные биты ключа — нули;
+    // false — несовместно
+    bool keyFromState(uint64_t solution, uint64_t known, uint32_t r4Key, uint64_t& key)
+    {
+        uint64_t forms[4][32] = {};
+        for (int i = 0; i < 64 + 22; ++i) {
+            const uint64_t input = i < 64 ? 1ull << (63 - i) : 0;
+            for (int r = 0; r < 4; ++r) {
+                const uint64_t low = forms[r][0];
+                for (int b = 0; b < REG_LEN[r] - 1; ++b) {
+                    forms[r][b] = forms[r][b + 1];
+                }
+                forms[r][REG_LEN[r] - 1] = input ^ low;
+            }
+        }
+
+        // Строка: биты ключа и правая часть
+        std::vector<std::pair<uint64_t, uint32_t>> rows;
+        for (int r = 0; r < 3; ++r) {
+            for (int b = 0; b < REG_LEN[r]; ++b) {
+                const int bit = LIN_OFFSET[r] + b;
+                if ((known >> bit) & 1) {
+                    rows.emplace_back(forms[r][b], uint32_t(solution >> bit) & 1);
+                }
+            }
+        }
+        for (int b = 0; b < A52Cipher::R4_LEN; ++b) {
+            if (!((R4_FORCED >> b) & 1)) {
+                rows.emplace_back(forms[3][b], (r4Key >> b) & 1);
+            }
+        }
+
+        // Приведенный ступенчатый вид: ведущий бит строки не входит в другие строки
+        const int count = int(rows.size());
+        int pivotCol[64];
+        int rank = 0;
+        for (int col = 0; col < 64; ++col) {
+            int p = rank;
+            while (p < count && !((rows[size_t(p)].first >> col) & 1)) {
+                ++p;
+            }
+            if (p == count) {
+                continue;
+            }
+            std::swap(rows[size_t(p)], rows[size_t(rank)]);
+            for (int i = 0; i < count; ++i) {
+                if (i != rank && ((rows[size_t(i)].first >> col) & 1)) {
+                    rows[size_t(i)].first ^= rows[size_t(rank)].first;
+                    rows[size_t(i)].second ^= rows[size_t(rank)].second;
+                }
+            }
+            pivotCol[rank++] = col;
+        }
+        for (int i = rank; i < count; ++i) {
+            if (rows[size_t(i)].second) {
+                return false;
+            }
+        }
+
+        key = 0;
+        for (int i = 0; i < rank; ++i) {
+            key |= uint64_t(rows[size_t(i)].second) << pivotCol[i];
+        }
+        return true;
+    }
+
+    bool verifyKey(const QVector<A52KnownFrame>& frames, uint64_t key)
+    {
+        A52Generator generator(key);
+        std::vector<uint8_t> gamma;
+        for (const A52KnownFrame& f : frames) {
+            const int bytes = (f.bits + 7) / 8;
+            gamma.resize(size_t(bytes));
+            generator.startFrame(f.frame);
+            generator.generate(gamma.data(), bytes);
+            const uint8_t* expected = reinterpret_cast<const uint8_t*>(f.keystream.constData());
+            for (int i = 0; i < bytes; ++i) {
+                uint8_t diff = gamma[size_t(i)] ^ expected[i];
+                if (i == bytes - 1 && f.bits % 8 != 0) {
+                    diff &= uint8_t(0xFF << (8 - f.bits % 8));
+                }
+                if (diff) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+const int A52Attack::GUESS_BITS = A52Cipher::R4_LEN - 3;
+
+bool A52Attack::recoverKey(const QVector<A52KnownFrame>& frames, uint64_t& key,
+                           Stats* stats, QString* error, qint64 maxGuesses)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (frames.isEmpty()) {
+        if (error) *error = "ОШИБКА: Нет кадров с известной гаммой";
+        return false;
+    }
+    for (const A52KnownFrame& f : frames) {
+        if (f.frame > A52Cipher::FRAME_MASK) {
+            if (error) *error = QString("ОШИБКА: Номер кадра должен быть от 0 до %1").arg(A52Cipher::FRAME_MASK);
+            return false;
+        }
+        if (f.bits <= 0 || qint64(f.bits) > qint64(f.keystream.size()) * 8) {
+            if (error) *error = QString("ОШИБКА: Кадр %1: число бит гаммы вне данных").arg(f.frame);
+            return false;
+        }
+    }
+
+    Model model;
+    buildModel(frames, model);
+
+    const qint64 space = qint64(1) << GUESS_BITS;
+    const qint64 total = maxGuesses > 0 ? qMin(maxGuesses, space) : space;
+    const int chunks = int((total + GUESS_CHUNK - 1) / GUESS_CHUNK);
+
+    std::atomic<bool> found{false};
+    std::atomic<qint64> tried{0};
+    std::mutex mutex;
+    uint64_t foundKey = 0;
+
+    CipherParallel::run(chunks, [&](int index) {
+        std::vector<uint64_t> rows(size_t(model.equations) * model.words);
+        int pivots[MAX_COLS];
+        const qint64 begin = qint64(index) * GUESS_CHUNK;
+        const qint64 end = qMin(total, begin + GUESS_CHUNK);
+        qint64 done = 0;
+        for (qint64 i = begin; i < end && !found.load(std::memory_order_relaxed); ++i, ++done) {
+            const uint32_t r4Key = guessState(model, uint32_t(i));
+            uint64_t active = 0;
+            if (!reduceGuess(model, r4Key, rows.data(), pivots, active)) {
+                continue;
+            }
+
+            // Биты, от которых зависит гамма, но которые система не определила,
+            // перебираются (при достаточной гамме их нет или единицы)
+            uint64_t undetermined = 0;
+            for (int b = 0; b < 64; ++b) {
+                if (((active >> b) & 1) && pivots[model.linCol + b] < 0) {
+                    undetermined |= 1ull << b;
+                }
+            }
+            if (int(qPopulationCount(quint64(undetermined))) > MAX_UNDETERMINED_BITS) {
+                continue;
+            }
+
+            uint64_t subset = 0;
+            do {
+                const uint64_t solution = backSubstitute(model, rows.data(), pivots, subset);
+                uint64_t candidate = 0;
+                if (keyFromState(solution, active, r4Key, candidate) && verifyKey(frames, candidate)) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!found.load(std::memory_order_relaxed)) {
+                        foundKey = candidate;
+                        found.store(true, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                subset = (subset - undetermined) & undetermined;
+            } while (subset != 0);
+        }
+        tried.fetch_add(done, std::memory_order_relaxed);
+    });
+
+    if (stats) {
+        stats->guesses = tried.load();
+        stats->elapsedNs = timer.nsecsElapsed();
+    }
+    if (!found.load()) {
+        if (error) *error = "Ключ не найден: гамма не соответствует A5/2 или ее недостаточно";
+        return false;
+    }
+    key = foundKey;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef A52ATTACK_H
+#define A52ATTACK_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+// Кадр с известной гаммой A5/2: первые bits бит гаммы после инициализации
+// кадра frame (как A52Generator::startFrame + generate, первый бит — старший бит байта)
+struct A52KnownFrame
+{
+    uint32_t frame = 0;
+    QByteArray keystream;
+    int bits = 0;
+};
+
+// Восстановление ключа A5/2 по известной гамме (Баркан–Бихам–Келлер).
+// R4 тактируется независимо от остальных регистров, поэтому при угаданном R4 известно,
+// сколько раз сдвигался каждый из R1–R3 к любому такту, и их биты — линейные функции
+// состояния после загрузки ключа. Выходной бит (старшие биты и F* — мажоритарная
+// функция трех битов регистра) квадратичен; произведения пар битов одного регистра
+// становятся отдельными переменными, и система решается исключением Гаусса над GF(2)
+// по строкам, упакованным в 64-битные слова. Несовместная система отбрасывает
+// догадку, решение проверяется повторной выработкой гаммы. Догадки R4 перебираются
+// параллельно через CipherParallel.
+//
+// Обратная связь в этой реализации берется со старших битов, и младшие биты R1–R3
+// выдвигаются за холостой прогон, не влияя на гамму, поэтому находится не исходный
+// ключ, а эквивалентный. Одного кадра GSM (228 бит) хватает для ключа, дающего его
+// гамму; чтобы ключ давал ту же гамму и на остальных кадрах, нужны два-три кадра
+// с номерами, различающимися не только в младших битах (соседние кадры меняют
+// лишь часть битов R4)
+class A52Attack
+{
+public:
+    // Биты R4, которые не выставляются в 1 при инициализации, — перебираемые
+    static const int GUESS_BITS;
+
+    struct Stats
+    {
+        qint64 guesses = 0;     // Проверено догадок R4
+        qint64 elapsedNs = 0;
+
+        double guessesPerSecond() const
+        {
+            return elapsedNs > 0 ? double(guesses) * 1e9 / double(elapsedNs) : 0.0;
+        }
+    };
+
+    // Ключ, дающий ту же гамму на кадрах frames. maxGuesses > 0 ограничивает перебор
+    // первыми догадками — для замера скорости. false — ключ не найден или входные данные
+    // некорректны (error)
+    static bool recoverKey(const QVector<A52KnownFrame>& frames, uint64_t& key,
+                           Stats* stats = nullptr, QString* error = nullptr, qint64 maxGuesses = 0);
+};
+
+#endif // A52ATTACK_H
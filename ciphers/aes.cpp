@@ -1,6 +1,12 @@
 #include "aes.h"
 #include "cipherfactory.h"
 #include "cipherwidgetfactory.h"
+#include "keyschedulecache.h"
+#include "cpufeatures.h"
+#include "cipherparallel.h"
+#include "cipherprogress.h"
+#include "ghash.h"
+#include "hexcodec.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QLabel>
@@ -9,50 +15,350 @@
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 #include <QDebug>
+#include <cstring>
+#include <vector>
+
+#if defined(CRYPTOAPP_X86)
+#include <immintrin.h>
+#endif
 
 AESCipher::AESCipher()
 {
 }
 
-// ==================== S-блок  ====================
-const std::array<uint8_t, 256> AESCipher::S_BOX = {
-    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
-    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
-    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
-    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
-    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
-    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
-    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
-    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
-    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
-    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
-    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
-    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
-    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
-    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
-    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
-    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
-};
+// ==================== S-блок и T-таблицы ====================
+
+namespace {
+    constexpr std::array<uint8_t, 256> SBOX = {
+        0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+        0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+        0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+        0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+        0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+        0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+        0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+        0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+        0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+        0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+        0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+        0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+        0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+        0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+        0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+        0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+    };
+
+    // Обратный S-блок (FIPS-197, Рис. 14)
+    constexpr std::array<uint8_t, 256> INV_SBOX = {
+        0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
+        0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
+        0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+        0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
+        0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
+        0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+        0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
+        0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
+        0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+        0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
+        0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
+        0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+        0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
+        0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
+        0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+        0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
+    };
+
+    constexpr uint8_t gfMul(uint8_t a, uint8_t b)
+    {
+        uint8_t result = 0;
+        for (int i = 0; i < 8; ++i) {
+            if (b & 1) result ^= a;
+            a = uint8_t((a << 1) ^ ((a & 0x80) ? 0x1B : 0x00));
+            b >>= 1;
+        }
+        return result;
+    }
 
-// Обратный S-блок (FIPS-197, Рис. 14)
-const std::array<uint8_t, 256> AESCipher::INV_S_BOX = {
-    0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
-    0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
-    0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
-    0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
-    0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
-    0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
-    0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
-    0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
-    0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
-    0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
-    0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
-    0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
-    0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
-    0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
-    0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
-    0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
-};
+    constexpr uint32_t rotr(uint32_t x, int n)
+    {
+        return n == 0 ? x : (x >> n) | (x << (32 - n));
+    }
+
+    // T-таблицы объединяют SubBytes, ShiftRows и MixColumns одного байта:
+    // Te0[x] = (2·S[x], S[x], S[x], 3·S[x]), Td0[x] = (e·S⁻¹[x], 9·S⁻¹[x], d·S⁻¹[x], b·S⁻¹[x]),
+    // Te1..Te3 и Td1..Td3 — те же слова, циклически сдвинутые на 8, 16, 24 бита.
+    // Строятся при компиляции, в рантайме — только четыре выборки и XOR на столбец
+    template<int Rot>
+    constexpr std::array<uint32_t, 256> makeTe()
+    {
+        std::array<uint32_t, 256> table{};
+        for (int x = 0; x < 256; ++x) {
+            uint8_t s = SBOX[x];
+            uint32_t word = (uint32_t(gfMul(s, 0x02)) << 24) | (uint32_t(s) << 16)
+                          | (uint32_t(s) << 8) | gfMul(s, 0x03);
+            table[x] = rotr(word, Rot);
+        }
+        return table;
+    }
+
+    template<int Rot>
+    constexpr std::array<uint32_t, 256> makeTd()
+    {
+        std::array<uint32_t, 256> table{};
+        for (int x = 0; x < 256; ++x) {
+            uint8_t s = INV_SBOX[x];
+            uint32_t word = (uint32_t(gfMul(s, 0x0e)) << 24) | (uint32_t(gfMul(s, 0x09)) << 16)
+                          | (uint32_t(gfMul(s, 0x0d)) << 8) | gfMul(s, 0x0b);
+            table[x] = rotr(word, Rot);
+        }
+        return table;
+    }
+
+    constexpr std::array<uint32_t, 256> Te0 = makeTe<0>();
+    constexpr std::array<uint32_t, 256> Te1 = makeTe<8>();
+    constexpr std::array<uint32_t, 256> Te2 = makeTe<16>();
+    constexpr std::array<uint32_t, 256> Te3 = makeTe<24>();
+
+    constexpr std::array<uint32_t, 256> Td0 = makeTd<0>();
+    constexpr std::array<uint32_t, 256> Td1 = makeTd<8>();
+    constexpr std::array<uint32_t, 256> Td2 = makeTd<16>();
+    constexpr std::array<uint32_t, 256> Td3 = makeTd<24>();
+
+    inline uint32_t loadBe32(const uint8_t* p)
+    {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+
+    inline void storeBe32(uint8_t* p, uint32_t v)
+    {
+        p[0] = uint8_t(v >> 24);
+        p[1] = uint8_t(v >> 16);
+        p[2] = uint8_t(v >> 8);
+        p[3] = uint8_t(v);
+    }
+
+    // InvMixColumns одного столбца: Td[S[x]] дает чистый InvMixColumns без InvSubBytes
+    inline uint32_t invMixColumn(uint32_t w)
+    {
+        return Td0[SBOX[w >> 24]] ^ Td1[SBOX[(w >> 16) & 0xFF]]
+             ^ Td2[SBOX[(w >> 8) & 0xFF]] ^ Td3[SBOX[w & 0xFF]];
+    }
+}
+
+const std::array<uint8_t, 256> AESCipher::S_BOX = SBOX;
+const std::array<uint8_t, 256> AESCipher::INV_S_BOX = INV_SBOX;
+
+// ==================== AES-NI ====================
+// Раунд целиком — одна инструкция AESENC/AESDEC. Раундовые ключи в байтовом
+// порядке FIPS-197 совпадают с форматом XMM-регистра, поэтому берутся из
+// RoundKeys::bytes как есть; для расшифрования к средним ключам применяется
+// AESIMC (эквивалентный обратный шифр, как и в Td-таблицах).
+
+#if defined(CRYPTOAPP_X86)
+namespace {
+    using KeyBlocks = std::array<std::array<uint8_t, 16>, 15>;
+
+    // Блоков за итерацию: AESENC имеет задержку в несколько тактов при
+    // пропускной способности 1-2 за такт, независимые блоки заполняют конвейер
+    const int AESNI_LANES = 8;
+
+    CRYPTOAPP_TARGET("sse2")
+    inline __m128i shiftXor3(__m128i x)
+    {
+        // x ^ (x << 32) ^ (x << 64) ^ (x << 96): префиксный XOR слов ключа
+        x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+        x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+        return _mm_xor_si128(x, _mm_slli_si128(x, 4));
+    }
+
+    CRYPTOAPP_TARGET("sse2")
+    inline void storeKey(KeyBlocks& keys, int index, __m128i key)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(keys[index].data()), key);
+    }
+
+    // AES-128: каждый шаг — следующий ключ из предыдущего
+    template<int Rcon>
+    CRYPTOAPP_TARGET("aes,sse2")
+    inline __m128i expand128(__m128i key)
+    {
+        __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, Rcon), 0xFF);
+        return _mm_xor_si128(shiftXor3(key), assist);
+    }
+
+    // AES-192: состояние — 6 слов (lo: 4 слова, hi: младшие 2 слова)
+    template<int Rcon>
+    CRYPTOAPP_TARGET("aes,sse2")
+    inline void expand192(__m128i& lo, __m128i& hi)
+    {
+        __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(hi, Rcon), 0x55);
+        lo = _mm_xor_si128(shiftXor3(lo), assist);
+        __m128i last = _mm_shuffle_epi32(lo, 0xFF);
+        hi = _mm_xor_si128(_mm_xor_si128(hi, _mm_slli_si128(hi, 4)), last);
+    }
+
+    // Ключ из двух 64-битных половин: (младшая a, младшая b) и (старшая a, младшая b)
+    CRYPTOAPP_TARGET("sse2")
+    inline __m128i joinLow(__m128i a, __m128i b)
+    {
+        return _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), 0));
+    }
+
+    CRYPTOAPP_TARGET("sse2")
+    inline __m128i joinHighLow(__m128i a, __m128i b)
+    {
+        return _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b), 1));
+    }
+
+    // AES-256: чередуются шаг с RotWord+Rcon (четные ключи) и SubWord без Rcon (нечетные)
+    template<int Rcon>
+    CRYPTOAPP_TARGET("aes,sse2")
+    inline void expand256(__m128i& even, __m128i& odd)
+    {
+        __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(odd, Rcon), 0xFF);
+        even = _mm_xor_si128(shiftXor3(even), assist);
+        assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(even, 0x00), 0xAA);
+        odd = _mm_xor_si128(shiftXor3(odd), assist);
+    }
+
+    CRYPTOAPP_TARGET("aes,sse2")
+    void aesniExpandKey(const uint8_t* key, int keySize, KeyBlocks& keys)
+    {
+        __m128i k0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+
+        if (keySize == 128) {
+            __m128i k = k0;
+            storeKey(keys, 0, k);
+            k = expand128<0x01>(k); storeKey(keys, 1, k);
+            k = expand128<0x02>(k); storeKey(keys, 2, k);
+            k = expand128<0x04>(k); storeKey(keys, 3, k);
+            k = expand128<0x08>(k); storeKey(keys, 4, k);
+            k = expand128<0x10>(k); storeKey(keys, 5, k);
+            k = expand128<0x20>(k); storeKey(keys, 6, k);
+            k = expand128<0x40>(k); storeKey(keys, 7, k);
+            k = expand128<0x80>(k); storeKey(keys, 8, k);
+            k = expand128<0x1B>(k); storeKey(keys, 9, k);
+            k = expand128<0x36>(k); storeKey(keys, 10, k);
+        } else if (keySize == 192) {
+            // Ключи по 4 слова нарезаются из потока 6-словных шагов
+            __m128i lo = k0;
+            __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(key + 16));
+            storeKey(keys, 0, lo);
+            __m128i prevHi = hi;
+            expand192<0x01>(lo, hi);
+            storeKey(keys, 1, joinLow(prevHi, lo));
+            storeKey(keys, 2, joinHighLow(lo, hi));
+            expand192<0x02>(lo, hi);
+            storeKey(keys, 3, lo);
+            prevHi = hi;
+            expand192<0x04>(lo, hi);
+            storeKey(keys, 4, joinLow(prevHi, lo));
+            storeKey(keys, 5, joinHighLow(lo, hi));
+            expand192<0x08>(lo, hi);
+            storeKey(keys, 6, lo);
+            prevHi = hi;
+            expand192<0x10>(lo, hi);
+            storeKey(keys, 7, joinLow(prevHi, lo));
+            storeKey(keys, 8, joinHighLow(lo, hi));
+            expand192<0x20>(lo, hi);
+            storeKey(keys, 9, lo);
+            prevHi = hi;
+            expand192<0x40>(lo, hi);
+            storeKey(keys, 10, joinLow(prevHi, lo));
+            storeKey(keys, 11, joinHighLow(lo, hi));
+            expand192<0x80>(lo, hi);
+            storeKey(keys, 12, lo);
+        } else {
+            __m128i even = k0;
+            __m128i odd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + 16));
+            storeKey(keys, 0, even);
+            storeKey(keys, 1, odd);
+            expand256<0x01>(even, odd); storeKey(keys, 2, even); storeKey(keys, 3, odd);
+            expand256<0x02>(even, odd); storeKey(keys, 4, even); storeKey(keys, 5, odd);
+            expand256<0x04>(even, odd); storeKey(keys, 6, even); storeKey(keys, 7, odd);
+            expand256<0x08>(even, odd); storeKey(keys, 8, even); storeKey(keys, 9, odd);
+            expand256<0x10>(even, odd); storeKey(keys, 10, even); storeKey(keys, 11, odd);
+            expand256<0x20>(even, odd); storeKey(keys, 12, even); storeKey(keys, 13, odd);
+            // Последний шаг дает только K14
+            __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(odd, 0x40), 0xFF);
+            storeKey(keys, 14, _mm_xor_si128(shiftXor3(even), assist));
+        }
+    }
+
+    CRYPTOAPP_TARGET("aes,sse2")
+    void aesniEncrypt(const uint8_t* in, uint8_t* out, qsizetype blocks, const KeyBlocks& keys, int rounds)
+    {
+        __m128i rk[15];
+        for (int r = 0; r <= rounds; ++r) {
+            rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys[r].data()));
+        }
+
+        for (; blocks >= AESNI_LANES; blocks -= AESNI_LANES) {
+            __m128i b[AESNI_LANES];
+            for (int i = 0; i < AESNI_LANES; ++i) {
+                b[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i), rk[0]);
+            }
+            for (int r = 1; r < rounds; ++r) {
+                for (int i = 0; i < AESNI_LANES; ++i) {
+                    b[i] = _mm_aesenc_si128(b[i], rk[r]);
+                }
+            }
+            for (int i = 0; i < AESNI_LANES; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, _mm_aesenclast_si128(b[i], rk[rounds]));
+            }
+            in += AESNI_LANES * 16;
+            out += AESNI_LANES * 16;
+        }
+
+        for (; blocks > 0; --blocks, in += 16, out += 16) {
+            __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), rk[0]);
+            for (int r = 1; r < rounds; ++r) {
+                b = _mm_aesenc_si128(b, rk[r]);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_aesenclast_si128(b, rk[rounds]));
+        }
+    }
+
+    CRYPTOAPP_TARGET("aes,sse2")
+    void aesniDecrypt(const uint8_t* in, uint8_t* out, qsizetype blocks, const KeyBlocks& keys, int rounds)
+    {
+        // dk[0] = K_Nr, dk[r] = InvMixColumns(K_{Nr-r}), dk[Nr] = K0
+        __m128i dk[15];
+        dk[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys[rounds].data()));
+        for (int r = 1; r < rounds; ++r) {
+            dk[r] = _mm_aesimc_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys[rounds - r].data())));
+        }
+        dk[rounds] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys[0].data()));
+
+        for (; blocks >= AESNI_LANES; blocks -= AESNI_LANES) {
+            __m128i b[AESNI_LANES];
+            for (int i = 0; i < AESNI_LANES; ++i) {
+                b[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i), dk[0]);
+            }
+            for (int r = 1; r < rounds; ++r) {
+                for (int i = 0; i < AESNI_LANES; ++i) {
+                    b[i] = _mm_aesdec_si128(b[i], dk[r]);
+                }
+            }
+            for (int i = 0; i < AESNI_LANES; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, _mm_aesdeclast_si128(b[i], dk[rounds]));
+            }
+            in += AESNI_LANES * 16;
+            out += AESNI_LANES * 16;
+        }
+
+        for (; blocks > 0; --blocks, in += 16, out += 16) {
+            __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), dk[0]);
+            for (int r = 1; r < rounds; ++r) {
+                b = _mm_aesdec_si128(b, dk[r]);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_aesdeclast_si128(b, dk[rounds]));
+        }
+
+        KeyScheduleCache::secureZero(dk, sizeof(dk));
+    }
+}
+#endif
 
 // Константы раундов Rcon (FIPS-197, подраздел 5.2)
 const std::array<uint32_t, 10> AESCipher::RCON = {
@@ -87,6 +393,8 @@ void AESHexEdit::setExpectedLength(int bytes)
     if (bytes > 0) {
         setPlaceholderText(QString("HEX (%1 байт, %2 символа)").arg(bytes).arg(bytes * 2));
         setMaxLength(bytes * 2);
+    } else {
+        setMaxLength(32767);
     }
 }
 
@@ -253,285 +561,1096 @@ void AESCipher::addRoundKey(std::array<uint8_t, 16>& state, const std::array<uin
 
 // ==================== Развертывание ключа ====================
 
-std::vector<std::array<uint8_t, 16>> AESCipher::expandKey(const std::array<uint8_t, 32>& key, int keySize) const
+AESCipher::RoundKeys AESCipher::expandKey(const std::array<uint8_t, 32>& key, int keySize) const
 {
     int Nk = keySize / 32;  // 4, 6 или 8
     int Nr = Nk + 6;        // 10, 12 или 14
     int Nb = 4;
     int totalWords = Nb * (Nr + 1);
 
-    std::vector<uint32_t> w(totalWords, 0);
+    RoundKeys roundKeys;
+    roundKeys.rounds = Nr;
+    std::array<uint32_t, 60>& w = roundKeys.enc;
+
+#if defined(CRYPTOAPP_X86)
+    if (CpuFeatures::get().aesni) {
+        // AESKEYGENASSIST дает те же байтовые ключи; слова для T-таблиц — из них
+        aesniExpandKey(key.data(), keySize, roundKeys.bytes);
+        for (int r = 0; r <= Nr; r++) {
+            for (int c = 0; c < Nb; c++) {
+                w[r * Nb + c] = loadBe32(roundKeys.bytes[r].data() + c * 4);
+            }
+        }
+    } else
+#endif
+    {
+        // Копируем ключ в первые Nk слов (big-endian: байт 0 = старший)
+        for (int i = 0; i < Nk; i++) {
+            w[i] = (key[i*4] << 24) | (key[i*4+1] << 16) | (key[i*4+2] << 8) | key[i*4+3];
+        }
+
+        // Расширение ключа
+        for (int i = Nk; i < totalWords; i++) {
+            uint32_t temp = w[i-1];
+
+            if (i % Nk == 0) {
+                // RotWord + SubWord + Rcon
+                uint32_t rot = (temp << 8) | (temp >> 24);
+                uint32_t sub = (S_BOX[(rot >> 24) & 0xFF] << 24) |
+                               (S_BOX[(rot >> 16) & 0xFF] << 16) |
+                               (S_BOX[(rot >> 8) & 0xFF] << 8) |
+                               S_BOX[rot & 0xFF];
+                temp = sub ^ RCON[i / Nk - 1];
+            } else if (Nk > 6 && i % Nk == 4) {
+                // SubWord для AES-256 на i % Nk == 4
+                temp = (S_BOX[(temp >> 24) & 0xFF] << 24) |
+                       (S_BOX[(temp >> 16) & 0xFF] << 16) |
+                       (S_BOX[(temp >> 8) & 0xFF] << 8) |
+                       S_BOX[temp & 0xFF];
+            }
+
+            w[i] = w[i - Nk] ^ temp;
+        }
+
+        // Преобразуем слова в байтовые ключи раундов
+        for (int r = 0; r <= Nr; r++) {
+            for (int c = 0; c < Nb; c++) {
+                storeBe32(roundKeys.bytes[r].data() + c * 4, w[r * Nb + c]);
+            }
+        }
+    }
+
+    // Ключи эквивалентного обратного шифра: обратный порядок раундов,
+    // для средних раундов — InvMixColumns, чтобы Td-раунд совпал по форме с Te-раундом
+    std::array<uint32_t, 60>& dw = roundKeys.dec;
+    for (int c = 0; c < Nb; c++) {
+        dw[c] = w[Nr * Nb + c];
+        dw[Nr * Nb + c] = w[c];
+    }
+    for (int r = 1; r < Nr; r++) {
+        for (int c = 0; c < Nb; c++) {
+            dw[r * Nb + c] = invMixColumn(w[(Nr - r) * Nb + c]);
+        }
+    }
+
+    return roundKeys;
+}
+
+// ==================== Блочные операции ====================
+
+bool AESCipher::prepareRoundKeys(const QVariantMap& params, std::shared_ptr<const RoundKeys>& roundKeys,
+                                 QString* error) const
+{
+    QString keySizeStr = params.value("keySize", "128").toString();
+    int keySize = keySizeStr.toInt();  // 128, 192 или 256
+    int expectedKeyLen = keySize / 4;  // 32, 48 или 64 HEX символа
+
+    const QString keyText = params.value("key", "").toString();
+    std::array<uint8_t, 32> masterKey{};
+    qsizetype invalidAt = -1;
+    const int keyDigits = int(HexCodec::decode(keyText, masterKey.data(), qsizetype(masterKey.size()), &invalidAt));
+    if (invalidAt >= 0) {
+        KeyScheduleCache::secureZero(masterKey.data(), masterKey.size());
+        if (error) *error = HexCodec::invalidCharError("Ключ", keyText, invalidAt);
+        return false;
+    }
 
-    // Копируем ключ в первые Nk слов (little-endian: байт 0 = младший)
-    for (int i = 0; i < Nk; i++) {
-        w[i] = (key[i*4] << 24) | (key[i*4+1] << 16) | (key[i*4+2] << 8) | key[i*4+3];
+    if ((keySize != 128 && keySize != 192 && keySize != 256) || keyDigits != expectedKeyLen) {
+        KeyScheduleCache::secureZero(masterKey.data(), masterKey.size());
+        if (error) {
+            *error = QString("ОШИБКА: Ключ должен быть %1 HEX символов для %2 бит. Получено: %3")
+                     .arg(expectedKeyLen).arg(keySize).arg(keyDigits);
+        }
+        return false;
     }
 
-    // Расширение ключа
-    for (int i = Nk; i < totalWords; i++) {
-        uint32_t temp = w[i-1];
+    roundKeys = KeyScheduleCache::instance().get<RoundKeys>(
+        "aes", masterKey.data(), keySize / 8,
+        [&] { return expandKey(masterKey, keySize); });
+    KeyScheduleCache::secureZero(masterKey.data(), masterKey.size());
+    return true;
+}
 
-        if (i % Nk == 0) {
-            // RotWord + SubWord + Rcon
-            uint32_t rot = (temp << 8) | (temp >> 24);
-            uint32_t sub = (S_BOX[(rot >> 24) & 0xFF] << 24) |
-                           (S_BOX[(rot >> 16) & 0xFF] << 16) |
-                           (S_BOX[(rot >> 8) & 0xFF] << 8) |
-                           S_BOX[rot & 0xFF];
-            temp = sub ^ RCON[i / Nk - 1];
-        } else if (Nk > 6 && i % Nk == 4) {
-            // SubWord для AES-256 на i % Nk == 4
-            temp = (S_BOX[(temp >> 24) & 0xFF] << 24) |
-                   (S_BOX[(temp >> 16) & 0xFF] << 16) |
-                   (S_BOX[(temp >> 8) & 0xFF] << 8) |
-                   S_BOX[temp & 0xFF];
+void AESCipher::encryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks,
+                              const RoundKeys& roundKeys) const
+{
+#if defined(CRYPTOAPP_X86)
+    if (CpuFeatures::get().aesni) {
+        aesniEncrypt(in, out, blocks, roundKeys.bytes, roundKeys.rounds);
+        return;
+    }
+#endif
+
+    const int Nr = roundKeys.rounds;
+
+    for (qsizetype b = 0; b < blocks; ++b, in += BLOCK_SIZE, out += BLOCK_SIZE) {
+        const uint32_t* rk = roundKeys.enc.data();
+
+        // Столбцы состояния как big-endian слова + начальный AddRoundKey
+        uint32_t s0 = loadBe32(in) ^ rk[0];
+        uint32_t s1 = loadBe32(in + 4) ^ rk[1];
+        uint32_t s2 = loadBe32(in + 8) ^ rk[2];
+        uint32_t s3 = loadBe32(in + 12) ^ rk[3];
+
+        // Раунды 1..Nr-1: строка r берется из столбца c + r (ShiftRows)
+        for (int round = 1; round < Nr; round++) {
+            rk += 4;
+            uint32_t t0 = Te0[s0 >> 24] ^ Te1[(s1 >> 16) & 0xFF] ^ Te2[(s2 >> 8) & 0xFF] ^ Te3[s3 & 0xFF] ^ rk[0];
+            uint32_t t1 = Te0[s1 >> 24] ^ Te1[(s2 >> 16) & 0xFF] ^ Te2[(s3 >> 8) & 0xFF] ^ Te3[s0 & 0xFF] ^ rk[1];
+            uint32_t t2 = Te0[s2 >> 24] ^ Te1[(s3 >> 16) & 0xFF] ^ Te2[(s0 >> 8) & 0xFF] ^ Te3[s1 & 0xFF] ^ rk[2];
+            uint32_t t3 = Te0[s3 >> 24] ^ Te1[(s0 >> 16) & 0xFF] ^ Te2[(s1 >> 8) & 0xFF] ^ Te3[s2 & 0xFF] ^ rk[3];
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
         }
 
-        w[i] = w[i - Nk] ^ temp;
+        // Последний раунд без MixColumns — только S-блок
+        rk += 4;
+        storeBe32(out, ((uint32_t(SBOX[s0 >> 24]) << 24) | (uint32_t(SBOX[(s1 >> 16) & 0xFF]) << 16)
+                       | (uint32_t(SBOX[(s2 >> 8) & 0xFF]) << 8) | SBOX[s3 & 0xFF]) ^ rk[0]);
+        storeBe32(out + 4, ((uint32_t(SBOX[s1 >> 24]) << 24) | (uint32_t(SBOX[(s2 >> 16) & 0xFF]) << 16)
+                           | (uint32_t(SBOX[(s3 >> 8) & 0xFF]) << 8) | SBOX[s0 & 0xFF]) ^ rk[1]);
+        storeBe32(out + 8, ((uint32_t(SBOX[s2 >> 24]) << 24) | (uint32_t(SBOX[(s3 >> 16) & 0xFF]) << 16)
+                           | (uint32_t(SBOX[(s0 >> 8) & 0xFF]) << 8) | SBOX[s1 & 0xFF]) ^ rk[2]);
+        storeBe32(out + 12, ((uint32_t(SBOX[s3 >> 24]) << 24) | (uint32_t(SBOX[(s0 >> 16) & 0xFF]) << 16)
+                            | (uint32_t(SBOX[(s1 >> 8) & 0xFF]) << 8) | SBOX[s2 & 0xFF]) ^ rk[3]);
     }
+}
 
-    // Преобразуем слова в байтовые ключи раундов
-    std::vector<std::array<uint8_t, 16>> roundKeys(Nr + 1);
+void AESCipher::decryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks,
+                              const RoundKeys& roundKeys) const
+{
+#if defined(CRYPTOAPP_X86)
+    if (CpuFeatures::get().aesni) {
+        aesniDecrypt(in, out, blocks, roundKeys.bytes, roundKeys.rounds);
+        return;
+    }
+#endif
 
-    for (int r = 0; r <= Nr; r++) {
-        for (int c = 0; c < Nb; c++) {
-            int wordIndex = r * Nb + c;
-            roundKeys[r][c*4] = (w[wordIndex] >> 24) & 0xFF;
-            roundKeys[r][c*4+1] = (w[wordIndex] >> 16) & 0xFF;
-            roundKeys[r][c*4+2] = (w[wordIndex] >> 8) & 0xFF;
-            roundKeys[r][c*4+3] = w[wordIndex] & 0xFF;
+    const int Nr = roundKeys.rounds;
+
+    for (qsizetype b = 0; b < blocks; ++b, in += BLOCK_SIZE, out += BLOCK_SIZE) {
+        const uint32_t* rk = roundKeys.dec.data();
+
+        uint32_t s0 = loadBe32(in) ^ rk[0];
+        uint32_t s1 = loadBe32(in + 4) ^ rk[1];
+        uint32_t s2 = loadBe32(in + 8) ^ rk[2];
+        uint32_t s3 = loadBe32(in + 12) ^ rk[3];
+
+        // Раунды эквивалентного обратного шифра: строка r берется из столбца c - r (InvShiftRows)
+        for (int round = 1; round < Nr; round++) {
+            rk += 4;
+            uint32_t t0 = Td0[s0 >> 24] ^ Td1[(s3 >> 16) & 0xFF] ^ Td2[(s2 >> 8) & 0xFF] ^ Td3[s1 & 0xFF] ^ rk[0];
+            uint32_t t1 = Td0[s1 >> 24] ^ Td1[(s0 >> 16) & 0xFF] ^ Td2[(s3 >> 8) & 0xFF] ^ Td3[s2 & 0xFF] ^ rk[1];
+            uint32_t t2 = Td0[s2 >> 24] ^ Td1[(s1 >> 16) & 0xFF] ^ Td2[(s0 >> 8) & 0xFF] ^ Td3[s3 & 0xFF] ^ rk[2];
+            uint32_t t3 = Td0[s3 >> 24] ^ Td1[(s2 >> 16) & 0xFF] ^ Td2[(s1 >> 8) & 0xFF] ^ Td3[s0 & 0xFF] ^ rk[3];
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
         }
+
+        // Последний раунд без InvMixColumns — только обратный S-блок
+        rk += 4;
+        storeBe32(out, ((uint32_t(INV_SBOX[s0 >> 24]) << 24) | (uint32_t(INV_SBOX[(s3 >> 16) & 0xFF]) << 16)
+                       | (uint32_t(INV_SBOX[(s2 >> 8) & 0xFF]) << 8) | INV_SBOX[s1 & 0xFF]) ^ rk[0]);
+        storeBe32(out + 4, ((uint32_t(INV_SBOX[s1 >> 24]) << 24) | (uint32_t(INV_SBOX[(s0 >> 16) & 0xFF]) << 16)
+                           | (uint32_t(INV_SBOX[(s3 >> 8) & 0xFF]) << 8) | INV_SBOX[s2 & 0xFF]) ^ rk[1]);
+        storeBe32(out + 8, ((uint32_t(INV_SBOX[s2 >> 24]) << 24) | (uint32_t(INV_SBOX[(s1 >> 16) & 0xFF]) << 16)
+                           | (uint32_t(INV_SBOX[(s0 >> 8) & 0xFF]) << 8) | INV_SBOX[s3 & 0xFF]) ^ rk[2]);
+        storeBe32(out + 12, ((uint32_t(INV_SBOX[s3 >> 24]) << 24) | (uint32_t(INV_SBOX[(s2 >> 16) & 0xFF]) << 16)
+                            | (uint32_t(INV_SBOX[(s1 >> 8) & 0xFF]) << 8) | INV_SBOX[s0 & 0xFF]) ^ rk[3]);
     }
+}
 
-    return roundKeys;
+void AESCipher::traceBlockRounds(const uint8_t* block, const RoundKeys& roundKeys, bool encrypt, int blockIdx,
+                                 QVector<CipherStep>& steps, int& stepCounter) const
+{
+    const int Nr = roundKeys.rounds;
+
+    std::array<uint8_t, 16> state;
+    std::memcpy(state.data(), block, 16);
+
+    if (encrypt) {
+        addRoundKey(state, roundKeys.bytes[0]);
+        for (int round = 1; round <= Nr; round++) {
+            subBytes(state);
+            shiftRows(state);
+            if (round < Nr) {
+                mixColumns(state);
+            }
+            addRoundKey(state, roundKeys.bytes[round]);
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("  Раунд %1: %2").arg(round).arg(HexCodec::encode(state.data(), 16)),
+                QString("Блок %1 раунд %2").arg(blockIdx + 1).arg(round)));
+        }
+    } else {
+        addRoundKey(state, roundKeys.bytes[Nr]);
+        for (int round = 1; round <= Nr; round++) {
+            invShiftRows(state);
+            invSubBytes(state);
+            addRoundKey(state, roundKeys.bytes[Nr - round]);
+            if (round < Nr) {
+                invMixColumns(state);
+            }
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("  Раунд %1: %2").arg(round).arg(HexCodec::encode(state.data(), 16)),
+                QString("Блок %1 раунд %2").arg(blockIdx + 1).arg(round)));
+        }
+    }
 }
 
-// ==================== Вспомогательные функции ====================
+// ==================== Режимы работы ====================
+
+namespace {
+    // Куски для CipherParallel: не меньше 256 КБ на поток; между отчетами
+    // о ходе — пачка по 4 МБ, чтобы всем потокам хватило работы
+    const qsizetype PARALLEL_MIN_BLOCKS = 16384;
+    const qsizetype PARALLEL_BATCH_BLOCKS = qsizetype(1) << 18;
+
+    // Блоков счетчика, шифруемых за один вызов encryptBlocks
+    const int CTR_BUFFER_BLOCKS = 64;
+
+    // counter += n: весь блок — 128-битное big-endian число (CTR)
+    // или только младшие 32 бита по модулю 2^32 (inc32 из GCM)
+    void addCounter(uint8_t counter[16], quint64 n, bool inc32)
+    {
+        const int stop = inc32 ? 12 : 0;
+        for (int i = 15; i >= stop && n != 0; --i) {
+            const quint64 sum = quint64(counter[i]) + (n & 0xFF);
+            counter[i] = uint8_t(sum);
+            n = (n >> 8) + (sum >> 8);
+        }
+    }
 
-QString AESCipher::prepareHexInput(const QString& text) const
+    inline void xorBlock(uint8_t* out, const uint8_t* a, const uint8_t* b)
+    {
+        for (int i = 0; i < 16; ++i) {
+            out[i] = a[i] ^ b[i];
+        }
+    }
+}
+
+void AESCipher::cbcEncrypt(const uint8_t* in, uint8_t* out, qsizetype blocks, uint8_t iv[16],
+                           const RoundKeys& roundKeys) const
 {
-    QString filtered;
-    QRegularExpression hexRegex("[0-9A-Fa-f]");
-    QRegularExpressionMatchIterator it = hexRegex.globalMatch(text);
-    while (it.hasNext()) {
-        filtered.append(it.next().captured());
+    // Каждый блок зависит от предыдущего шифртекста — только последовательно
+    uint8_t x[16];
+    for (qsizetype b = 0; b < blocks; ++b, in += 16, out += 16) {
+        xorBlock(x, in, iv);
+        encryptBlocks(x, out, 1, roundKeys);
+        std::memcpy(iv, out, 16);
     }
-    return filtered.toUpper();
+    KeyScheduleCache::secureZero(x, sizeof(x));
 }
 
-QString AESCipher::bytesToHex(const uint8_t* data, int len) const
+void AESCipher::cbcDecrypt(const uint8_t* in, uint8_t* out, qsizetype blocks, uint8_t iv[16],
+                           const RoundKeys& roundKeys) const
 {
-    QString result;
-    for (int i = 0; i < len; i++) {
-        result.append(QString("%1").arg(data[i], 2, 16, QChar('0')).toUpper());
+    if (blocks <= 0) {
+        return;
     }
-    return result;
+
+    uint8_t last[16];
+    std::memcpy(last, in + (blocks - 1) * 16, 16);
+
+    if (in == out) {
+        // На месте: предыдущий шифртекст затирается, сохраняем его по блоку
+        uint8_t prev[16], cur[16];
+        std::memcpy(prev, iv, 16);
+        for (qsizetype b = 0; b < blocks; ++b, out += 16) {
+            std::memcpy(cur, out, 16);
+            decryptBlocks(out, out, 1, roundKeys);
+            xorBlock(out, out, prev);
+            std::memcpy(prev, cur, 16);
+        }
+    } else {
+        // Расшифрование блоков независимо: D(C_i) ⊕ C_{i-1}, куски — параллельно
+        const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BLOCKS);
+        CipherParallel::run(chunks, [&](int index) {
+            const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+            const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+            decryptBlocks(in + begin * 16, out + begin * 16, end - begin, roundKeys);
+            for (qsizetype b = begin; b < end; ++b) {
+                const uint8_t* prev = (b == 0) ? iv : in + (b - 1) * 16;
+                xorBlock(out + b * 16, out + b * 16, prev);
+            }
+        });
+    }
+
+    std::memcpy(iv, last, 16);
 }
 
-void AESCipher::hexToBytes(const QString& hex, uint8_t* out, int len) const
+void AESCipher::ctrBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks, uint8_t counter[16], bool inc32,
+                          const RoundKeys& roundKeys) const
 {
-    QByteArray bytes = QByteArray::fromHex(hex.toLatin1());
-    for (int i = 0; i < len && i < bytes.size(); i++) {
-        out[i] = static_cast<uint8_t>(bytes[i]);
+    uint8_t gamma[CTR_BUFFER_BLOCKS * 16];
+    while (blocks > 0) {
+        const int n = int(qMin<qsizetype>(blocks, CTR_BUFFER_BLOCKS));
+        for (int i = 0; i < n; ++i) {
+            std::memcpy(gamma + i * 16, counter, 16);
+            addCounter(counter, 1, inc32);
+        }
+        encryptBlocks(gamma, gamma, n, roundKeys);
+        for (int i = 0; i < n * 16; ++i) {
+            out[i] = in[i] ^ gamma[i];
+        }
+        in += n * 16;
+        out += n * 16;
+        blocks -= n;
     }
+    KeyScheduleCache::secureZero(gamma, sizeof(gamma));
 }
 
-// ==================== Шифрование ====================
+bool AESCipher::parseMode(const QVariantMap& params, Mode& mode, QString* error)
+{
+    const QString name = params.value("mode", "ECB").toString().trimmed().toUpper();
+    if (name.isEmpty() || name == "ECB") {
+        mode = Mode::ECB;
+    } else if (name == "CBC") {
+        mode = Mode::CBC;
+    } else if (name == "CTR") {
+        mode = Mode::CTR;
+    } else if (name == "GCM") {
+        mode = Mode::GCM;
+    } else {
+        if (error) {
+            *error = QString("ОШИБКА: Неизвестный режим AES: %1 (ожидается ECB, CBC, CTR или GCM)").arg(name);
+        }
+        return false;
+    }
+    return true;
+}
 
-CipherResult AESCipher::encrypt(const QString& text, const QVariantMap& params)
+QString AESCipher::modeName(Mode mode)
 {
-    CipherResult result;
-    result.cipherName = name();
-    result.alphabet = m_alphabet;
-    result.isNumeric = true;
+    switch (mode) {
+    case Mode::CBC: return "CBC";
+    case Mode::CTR: return "CTR";
+    case Mode::GCM: return "GCM";
+    case Mode::ECB: break;
+    }
+    return "ECB";
+}
 
-    QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало шифрования AES (Rijndael)", "Инициализация"));
+bool AESCipher::prepareIv(const QVariantMap& params, Mode mode, QByteArray& iv, QString* error) const
+{
+    const QString ivText = params.value("iv", "").toString();
+    qsizetype digits = 0;
+    qsizetype invalidAt = -1;
+    iv = HexCodec::decode(ivText, &digits, &invalidAt);
+    if (invalidAt >= 0) {
+        if (error) *error = HexCodec::invalidCharError("IV", ivText, invalidAt);
+        return false;
+    }
 
-    // Получаем параметры
-    QString keyHex = params.value("key", "").toString();
-    QString keySizeStr = params.value("keySize", "128").toString();
-    int keySize = keySizeStr.toInt();  // 128, 192 или 256
+    if (mode == Mode::GCM) {
+        if (digits == 0 || digits % 2 != 0) {
+            if (error) {
+                *error = QString("ОШИБКА: IV для режима GCM должен быть непустой HEX-строкой четной длины "
+                                 "(рекомендуется 24 символа). Получено: %1").arg(digits);
+            }
+            return false;
+        }
+    } else if (digits != BLOCK_SIZE * 2) {
+        if (error) {
+            *error = QString("ОШИБКА: IV должен быть 32 HEX символа для режима %1. Получено: %2")
+                     .arg(modeName(mode)).arg(digits);
+        }
+        return false;
+    }
+    return true;
+}
 
-    QString cleanedKey = prepareHexInput(keyHex);
-    int expectedKeyLen = keySize / 4;  // 32, 48 или 64 HEX символа
+// ==================== Бинарный путь ====================
 
-    if (cleanedKey.length() != expectedKeyLen) {
-        result.result = QString("ОШИБКА: Ключ должен быть %1 HEX символов для %2 бит. Получено: %3")
-                        .arg(expectedKeyLen).arg(keySize).arg(cleanedKey.length());
-        return result;
+class AESStream : public BlockCipherStream
+{
+public:
+    AESStream(const AESCipher& cipher, bool encrypt)
+        : BlockCipherStream(AESCipher::BLOCK_SIZE), m_cipher(cipher), m_encrypt(encrypt) {}
+
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        reset();
+        return m_cipher.prepareRoundKeys(params, m_roundKeys, error);
     }
 
-    // Подготавливаем входные данные
-    QString hexData = prepareHexInput(text);
-    if (hexData.isEmpty()) {
-        result.result = "ОШИБКА: Нет данных для шифрования (введите HEX-строку)";
-        return result;
+protected:
+    void processBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+    {
+        if (m_encrypt) {
+            m_cipher.encryptBlocks(in, out, blocks, *m_roundKeys);
+        } else {
+            m_cipher.decryptBlocks(in, out, blocks, *m_roundKeys);
+        }
     }
 
-    if (hexData.length() % 32 != 0) {
-        result.result = QString("ОШИБКА: Длина данных (%1 HEX символов) должна быть кратна 32 (128 бит)")
-                        .arg(hexData.length());
-        return result;
+private:
+    AESCipher m_cipher;
+    bool m_encrypt;
+    std::shared_ptr<const AESCipher::RoundKeys> m_roundKeys;
+};
+
+// CBC: сцепление с предыдущим шифртекстом; расшифрование пачки делится между потоками
+class AESCBCStream : public BlockCipherStream
+{
+public:
+    AESCBCStream(const AESCipher& cipher, bool encrypt)
+        : BlockCipherStream(AESCipher::BLOCK_SIZE), m_cipher(cipher), m_encrypt(encrypt)
+    {
+        setBatchBlocks(PARALLEL_BATCH_BLOCKS);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: %1 бит, ключ: %2...").arg(keySize).arg(cleanedKey.left(16)),
-        "Параметры"));
+    ~AESCBCStream() override { KeyScheduleCache::secureZero(m_iv, sizeof(m_iv)); }
 
-    // Преобразуем ключ в байты
-    std::array<uint8_t, 32> masterKey{};
-    hexToBytes(cleanedKey, masterKey.data(), keySize / 8);
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        reset();
+        QByteArray iv;
+        if (!m_cipher.prepareRoundKeys(params, m_roundKeys, error)
+            || !m_cipher.prepareIv(params, AESCipher::Mode::CBC, iv, error)) {
+            return false;
+        }
+        std::memcpy(m_iv, iv.constData(), 16);
+        return true;
+    }
 
-    // Развертываем ключи
-    std::vector<std::array<uint8_t, 16>> roundKeys = expandKey(masterKey, keySize);
-    int Nr = keySize / 32 + 6;  // 10, 12 или 14
+protected:
+    void processBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+    {
+        if (m_encrypt) {
+            m_cipher.cbcEncrypt(in, out, blocks, m_iv, *m_roundKeys);
+        } else {
+            m_cipher.cbcDecrypt(in, out, blocks, m_iv, *m_roundKeys);
+        }
+    }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Развернуто %1 раундовых ключей").arg(Nr + 1),
-        "Развертывание ключей"));
+private:
+    AESCipher m_cipher;
+    bool m_encrypt;
+    std::shared_ptr<const AESCipher::RoundKeys> m_roundKeys;
+    uint8_t m_iv[16];
+};
 
-    // Шифрование блоков
-    QString encryptedHex;
-    int blockCounter = 0;
-    int Nb = 4;
+// CTR: гамма E(IV), E(IV+1), ...; куски пачки шифруются в разных потоках
+// со своим смещением счетчика
+class AESCTRStream : public KeystreamCipherStream
+{
+public:
+    explicit AESCTRStream(const AESCipher& cipher)
+        : KeystreamCipherStream(AESCipher::BLOCK_SIZE), m_cipher(cipher)
+    {
+        setBatchBlocks(PARALLEL_BATCH_BLOCKS);
+    }
 
-    for (int i = 0; i < hexData.length(); i += 32) {
-        QString blockHex = hexData.mid(i, 32);
-        blockCounter++;
+    ~AESCTRStream() override { KeyScheduleCache::secureZero(m_counter, sizeof(m_counter)); }
 
-        std::array<uint8_t, 16> state{};
-        hexToBytes(blockHex, state.data(), 16);
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        reset();
+        QByteArray iv;
+        if (!m_cipher.prepareRoundKeys(params, m_roundKeys, error)
+            || !m_cipher.prepareIv(params, AESCipher::Mode::CTR, iv, error)) {
+            return false;
+        }
+        std::memcpy(m_counter, iv.constData(), 16);
+        return true;
+    }
 
-        // Начальный раунд: AddRoundKey
-        addRoundKey(state, roundKeys[0]);
+protected:
+    void nextKeystream(uint8_t* block) override
+    {
+        m_cipher.encryptBlocks(m_counter, block, 1, *m_roundKeys);
+        addCounter(m_counter, 1, false);
+    }
 
-        // Раунды 1..Nr-1
-        for (int round = 1; round < Nr; round++) {
-            subBytes(state);
-            shiftRows(state);
-            mixColumns(state);
-            addRoundKey(state, roundKeys[round]);
+    void xorBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+    {
+        const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BLOCKS);
+        CipherParallel::run(chunks, [&](int index) {
+            const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+            const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+            uint8_t counter[16];
+            std::memcpy(counter, m_counter, 16);
+            addCounter(counter, quint64(begin), false);
+            m_cipher.ctrBlocks(in + begin * 16, out + begin * 16, end - begin, counter, false, *m_roundKeys);
+        });
+        addCounter(m_counter, quint64(blocks), false);
+    }
+
+private:
+    AESCipher m_cipher;
+    std::shared_ptr<const AESCipher::RoundKeys> m_roundKeys;
+    uint8_t m_counter[16];
+};
+
+// GCM (SP 800-38D): CTR с inc32 от J0+1 и GHASH по AAD и шифртексту.
+// Зашифрование дописывает тег в final; при расшифровании последние 16 байт
+// потока придерживаются как тег, а final сверяет его. Открытый текст выдается
+// в update до проверки — при ошибке final вызывающий обязан его отбросить.
+class AESGCMStream : public CipherStream
+{
+public:
+    AESGCMStream(const AESCipher& cipher, bool encrypt)
+        : m_cipher(cipher), m_encrypt(encrypt) {}
+
+    ~AESGCMStream() override { clear(); }
+
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        clear();
+        QByteArray iv;
+        if (!m_cipher.prepareRoundKeys(params, m_roundKeys, error)
+            || !m_cipher.prepareIv(params, AESCipher::Mode::GCM, iv, error)) {
+            return false;
         }
 
-        // Последний раунд (без MixColumns)
-        subBytes(state);
-        shiftRows(state);
-        addRoundKey(state, roundKeys[Nr]);
+        const QString aadText = params.value("aad", "").toString();
+        qsizetype aadDigits = 0;
+        qsizetype invalidAt = -1;
+        const QByteArray aad = HexCodec::decode(aadText, &aadDigits, &invalidAt);
+        if (invalidAt >= 0) {
+            if (error) *error = HexCodec::invalidCharError("AAD", aadText, invalidAt);
+            return false;
+        }
+        if (aadDigits % 2 != 0) {
+            if (error) {
+                *error = QString("ОШИБКА: AAD должен быть HEX-строкой четной длины. Получено: %1")
+                         .arg(aadDigits);
+            }
+            return false;
+        }
 
-        QString encryptedBlockHex = bytesToHex(state.data(), 16);
-        encryptedHex.append(encryptedBlockHex);
+        // H = E(0^128)
+        uint8_t h[16] = {0};
+        m_cipher.encryptBlocks(h, h, 1, *m_roundKeys);
+        m_ghash = std::make_unique<GHash>(h);
+        KeyScheduleCache::secureZero(h, sizeof(h));
+
+        // J0 = IV || 0^31 || 1 для 96-битного IV, иначе GHASH(IV || 0 || [len(IV)]64)
+        uint8_t j0[16] = {0};
+        if (iv.size() == 12) {
+            std::memcpy(j0, iv.constData(), 12);
+            j0[15] = 1;
+        } else {
+            absorb(j0, iv);
+            uint8_t lengths[16] = {0};
+            storeBe64(lengths + 8, quint64(iv.size()) * 8);
+            m_ghash->update(j0, lengths, 1);
+        }
 
-        steps.append(CipherStep(3 + blockCounter, QChar(),
-            QString("Блок %1: %2 → %3").arg(blockCounter).arg(blockHex).arg(encryptedBlockHex),
-            QString("Блок %1").arg(blockCounter)));
+        m_cipher.encryptBlocks(j0, m_tagMask, 1, *m_roundKeys);
+        std::memcpy(m_counter, j0, 16);
+        addCounter(m_counter, 1, true);
+        KeyScheduleCache::secureZero(j0, sizeof(j0));
+
+        absorb(m_hash, aad);
+        m_aadBytes = quint64(aad.size());
+        return true;
     }
 
-    steps.append(CipherStep(4 + blockCounter, QChar(),
-        "Шифрование завершено", "Завершение"));
+    bool update(const char* data, qsizetype len, QByteArray& out, QString* error = nullptr) override
+    {
+        if (!m_ghash) {
+            if (error) {
+                *error = "ОШИБКА: Контекст GCM не инициализирован";
+            }
+            return false;
+        }
+        if (m_encrypt) {
+            return process(reinterpret_cast<const uint8_t*>(data), len, out, error);
+        }
 
-    result.result = encryptedHex;
-    result.steps = steps;
+        // Последние 16 байт могут оказаться тегом — придерживаем их
+        const qsizetype total = m_held + len;
+        if (total <= 16) {
+            std::memcpy(m_tail + m_held, data, len);
+            m_held = int(total);
+            return true;
+        }
 
-    return result;
-}
+        qsizetype release = total - 16;
+        const qsizetype fromHeld = qMin<qsizetype>(release, m_held);
+        if (fromHeld > 0) {
+            if (!process(m_tail, fromHeld, out, error)) {
+                return false;
+            }
+            std::memmove(m_tail, m_tail + fromHeld, m_held - fromHeld);
+            m_held -= int(fromHeld);
+            release -= fromHeld;
+        }
+        if (release > 0 && !process(reinterpret_cast<const uint8_t*>(data), release, out, error)) {
+            return false;
+        }
+        std::memcpy(m_tail + m_held, data + release, len - release);
+        m_held += int(len - release);
+        return true;
+    }
 
-// ==================== Дешифрование ====================
+    bool final(QByteArray& out, QString* error = nullptr) override
+    {
+        if (!m_ghash) {
+            if (error) {
+                *error = "ОШИБКА: Контекст GCM не инициализирован";
+            }
+            return false;
+        }
+        if (!m_encrypt && m_held < 16) {
+            clear();
+            if (error) {
+                *error = "ОШИБКА: Нет тега GCM: данные короче 16 байт";
+            }
+            return false;
+        }
 
-CipherResult AESCipher::decrypt(const QString& text, const QVariantMap& params)
+        if (m_partial > 0) {
+            std::memset(m_block + m_partial, 0, 16 - m_partial);
+            m_ghash->update(m_hash, m_block, 1);
+        }
+        uint8_t lengths[16];
+        storeBe64(lengths, m_aadBytes * 8);
+        storeBe64(lengths + 8, m_dataBytes * 8);
+        m_ghash->update(m_hash, lengths, 1);
+
+        uint8_t tag[16];
+        xorBlock(tag, m_hash, m_tagMask);
+
+        bool ok = true;
+        if (m_encrypt) {
+            out.append(reinterpret_cast<const char*>(tag), 16);
+        } else {
+            // Сравнение за постоянное время
+            uint8_t diff = 0;
+            for (int i = 0; i < 16; ++i) {
+                diff |= uint8_t(tag[i] ^ m_tail[i]);
+            }
+            ok = (diff == 0);
+            m_tagMismatch = !ok;
+            if (!ok && error) {
+                *error = "ОШИБКА: Тег GCM не совпадает — данные, AAD, IV или ключ неверны";
+            }
+        }
+
+        KeyScheduleCache::secureZero(tag, sizeof(tag));
+        clear();
+        return ok;
+    }
+
+    bool tagMismatch() const { return m_tagMismatch; }
+
+private:
+    static void storeBe64(uint8_t* p, quint64 v)
+    {
+        for (int i = 7; i >= 0; --i) {
+            p[i] = uint8_t(v);
+            v >>= 8;
+        }
+    }
+
+    // GHASH по данным, дополненным нулями до целого блока
+    void absorb(uint8_t y[16], const QByteArray& data) const
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(data.constData());
+        const qsizetype blocks = data.size() / 16;
+        m_ghash->update(y, p, blocks);
+        const int rest = int(data.size() % 16);
+        if (rest > 0) {
+            uint8_t last[16] = {0};
+            std::memcpy(last, p + blocks * 16, rest);
+            m_ghash->update(y, last, 1);
+        }
+    }
+
+    bool process(const uint8_t* in, qsizetype len, QByteArray& out, QString* error)
+    {
+        if (len <= 0) {
+            return true;
+        }
+        const qsizetype offset = out.size();
+        out.resize(offset + len);
+        uint8_t* dst = reinterpret_cast<uint8_t*>(out.data()) + offset;
+        m_dataBytes += quint64(len);
+
+        // Дописываем неполный блок прошлого вызова
+        while (m_partial > 0 && len > 0) {
+            *dst = *in ^ m_gamma[m_partial];
+            m_block[m_partial++] = m_encrypt ? *dst : *in;
+            ++dst;
+            ++in;
+            --len;
+            if (m_partial == 16) {
+                m_ghash->update(m_hash, m_block, 1);
+                m_partial = 0;
+            }
+        }
+
+        const qsizetype blocks = len / 16;
+        const qsizetype total = blocks * 16;
+        for (qsizetype done = 0; done < blocks; ) {
+            const qsizetype batch = qMin(blocks - done, PARALLEL_BATCH_BLOCKS);
+            processBlocks(in + done * 16, dst + done * 16, batch);
+            done += batch;
+            if (!CipherProgress::report(done * 16, total)) {
+                out.resize(offset);
+                if (error) {
+                    *error = CipherProgress::canceledMessage();
+                }
+                return false;
+            }
+        }
+        in += total;
+        dst += total;
+        len -= total;
+
+        // Хвост: блок гаммы остается до следующего update
+        if (len > 0) {
+            m_cipher.encryptBlocks(m_counter, m_gamma, 1, *m_roundKeys);
+            addCounter(m_counter, 1, true);
+            for (; len > 0; --len) {
+                *dst = *in ^ m_gamma[m_partial];
+                m_block[m_partial++] = m_encrypt ? *dst : *in;
+                ++dst;
+                ++in;
+            }
+        }
+        return true;
+    }
+
+    // Целые блоки: куски шифруются и хешируются независимо, частичные суммы
+    // склеиваются как Y = Y·H^m ⊕ GHASH(кусок)
+    void processBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks)
+    {
+        const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BLOCKS);
+        std::vector<std::array<uint8_t, 16>> sums(chunks);
+        CipherParallel::run(chunks, [&](int index) {
+            const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+            const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+            uint8_t* y = sums[index].data();
+            if (index == 0) {
+                std::memcpy(y, m_hash, 16);
+            } else {
+                std::memset(y, 0, 16);
+            }
+            uint8_t counter[16];
+            std::memcpy(counter, m_counter, 16);
+            addCounter(counter, quint64(begin), true);
+
+            // GHASH идет по шифртексту: при расшифровании — до наложения гаммы
+            if (!m_encrypt) {
+                m_ghash->update(y, in + begin * 16, end - begin);
+            }
+            m_cipher.ctrBlocks(in + begin * 16, out + begin * 16, end - begin, counter, true, *m_roundKeys);
+            if (m_encrypt) {
+                m_ghash->update(y, out + begin * 16, end - begin);
+            }
+        });
+
+        std::memcpy(m_hash, sums[0].data(), 16);
+        for (int index = 1; index < chunks; ++index) {
+            const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+            const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+            m_ghash->multiplyByPower(m_hash, quint64(end - begin));
+            xorBlock(m_hash, m_hash, sums[index].data());
+        }
+        addCounter(m_counter, quint64(blocks), true);
+    }
+
+    void clear()
+    {
+        m_ghash.reset();
+        KeyScheduleCache::secureZero(m_hash, sizeof(m_hash));
+        KeyScheduleCache::secureZero(m_counter, sizeof(m_counter));
+        KeyScheduleCache::secureZero(m_tagMask, sizeof(m_tagMask));
+        KeyScheduleCache::secureZero(m_gamma, sizeof(m_gamma));
+        KeyScheduleCache::secureZero(m_block, sizeof(m_block));
+        KeyScheduleCache::secureZero(m_tail, sizeof(m_tail));
+        m_partial = 0;
+        m_held = 0;
+        m_aadBytes = 0;
+        m_dataBytes = 0;
+    }
+
+    AESCipher m_cipher;
+    bool m_encrypt;
+    bool m_tagMismatch = false;
+    std::shared_ptr<const AESCipher::RoundKeys> m_roundKeys;
+    std::unique_ptr<GHash> m_ghash;
+    uint8_t m_hash[16] = {0};       // текущее значение GHASH
+    uint8_t m_counter[16] = {0};    // следующий блок счетчика
+    uint8_t m_tagMask[16] = {0};    // E(J0)
+    uint8_t m_gamma[16] = {0};      // гамма неполного блока
+    uint8_t m_block[16] = {0};      // шифртекст неполного блока для GHASH
+    uint8_t m_tail[16] = {0};       // придержанный тег (расшифрование)
+    int m_partial = 0;
+    int m_held = 0;
+    quint64 m_aadBytes = 0;
+    quint64 m_dataBytes = 0;
+};
+
+// Контекст, который createStream отдает наружу: режим выбирается в init по params["mode"]
+class AESModeStream : public CipherStream
 {
-    CipherResult result;
-    result.cipherName = name();
-    result.alphabet = m_alphabet;
-    result.isNumeric = true;
+public:
+    AESModeStream(const AESCipher& cipher, bool encrypt)
+        : m_cipher(cipher), m_encrypt(encrypt) {}
+
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        AESCipher::Mode mode;
+        if (!AESCipher::parseMode(params, mode, error)) {
+            return false;
+        }
+        if (!m_stream || mode != m_mode) {
+            m_mode = mode;
+            m_gcm = nullptr;
+            switch (mode) {
+            case AESCipher::Mode::ECB:
+                m_stream = std::make_unique<AESStream>(m_cipher, m_encrypt);
+                break;
+            case AESCipher::Mode::CBC:
+                m_stream = std::make_unique<AESCBCStream>(m_cipher, m_encrypt);
+                break;
+            case AESCipher::Mode::CTR:
+                m_stream = std::make_unique<AESCTRStream>(m_cipher);
+                break;
+            case AESCipher::Mode::GCM: {
+                auto gcm = std::make_unique<AESGCMStream>(m_cipher, m_encrypt);
+                m_gcm = gcm.get();
+                m_stream = std::move(gcm);
+                break;
+            }
+            }
+        }
+        return m_stream->init(params, error);
+    }
 
-    QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало дешифрования AES (Rijndael)", "Инициализация"));
+    bool update(const char* data, qsizetype len, QByteArray& out, QString* error = nullptr) override
+    {
+        if (!m_stream) {
+            if (error) {
+                *error = "ОШИБКА: Контекст AES не инициализирован";
+            }
+            return false;
+        }
+        return m_stream->update(data, len, out, error);
+    }
 
-    // Получаем параметры
-    QString keyHex = params.value("key", "").toString();
-    QString keySizeStr = params.value("keySize", "128").toString();
-    int keySize = keySizeStr.toInt();
+    bool final(QByteArray& out, QString* error = nullptr) override
+    {
+        if (!m_stream) {
+            if (error) {
+                *error = "ОШИБКА: Контекст AES не инициализирован";
+            }
+            return false;
+        }
+        return m_stream->final(out, error);
+    }
 
-    QString cleanedKey = prepareHexInput(keyHex);
-    int expectedKeyLen = keySize / 4;
+    using CipherStream::update;
 
-    if (cleanedKey.length() != expectedKeyLen) {
-        result.result = QString("ОШИБКА: Ключ должен быть %1 HEX символов для %2 бит. Получено: %3")
-                        .arg(expectedKeyLen).arg(keySize).arg(cleanedKey.length());
-        return result;
+    AESCipher::Mode mode() const { return m_mode; }
+    bool tagMismatch() const { return m_gcm && m_gcm->tagMismatch(); }
+
+private:
+    AESCipher m_cipher;
+    bool m_encrypt;
+    AESCipher::Mode m_mode = AESCipher::Mode::ECB;
+    std::unique_ptr<CipherStream> m_stream;
+    AESGCMStream* m_gcm = nullptr;
+};
+
+std::unique_ptr<CipherStream> AESCipher::createStream(bool encrypt)
+{
+    return std::make_unique<AESModeStream>(*this, encrypt);
+}
+
+// Сообщение целиком — один update потокового контекста
+bool AESCipher::processBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, bool encrypt,
+                             QString* error, CipherStatus* status)
+{
+    if (status) {
+        *status = CipherStatus::InvalidParams;
     }
 
-    QString hexData = prepareHexInput(text);
-    if (hexData.isEmpty()) {
-        result.result = "ОШИБКА: Нет данных для дешифрования (введите HEX-строку)";
-        return result;
+    AESModeStream stream(*this, encrypt);
+    if (!stream.init(params, error)) {
+        out.clear();
+        return false;
     }
 
-    if (hexData.length() % 32 != 0) {
-        result.result = QString("ОШИБКА: Длина данных (%1 HEX символов) должна быть кратна 32 (128 бит)")
-                        .arg(hexData.length());
-        return result;
+    const Mode mode = stream.mode();
+    if ((mode == Mode::ECB || mode == Mode::CBC) && in.size() % 16 != 0) {
+        if (status) {
+            *status = CipherStatus::InvalidInput;
+        }
+        if (error) {
+            *error = QString("ОШИБКА: Длина данных (%1 байт) должна быть кратна 16 (128 бит)").arg(in.size());
+        }
+        return false;
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: %1 бит, ключ: %2...").arg(keySize).arg(cleanedKey.left(16)),
-        "Параметры"));
+    // Через промежуточный буфер: in и out могут быть одним объектом
+    QByteArray buffer;
+    buffer.reserve(in.size() + BLOCK_SIZE);
+    if (!stream.update(in, buffer, error) || !stream.final(buffer, error)) {
+        if (status) {
+            *status = stream.tagMismatch() ? CipherStatus::VerificationFailed
+                    : CipherProgress::canceled() ? CipherStatus::Canceled
+                    : CipherStatus::InvalidInput;
+        }
+        KeyScheduleCache::secureZero(buffer.data(), size_t(buffer.size()));
+        out.clear();
+        return false;
+    }
+    out = buffer;
+    if (status) {
+        *status = CipherStatus::Ok;
+    }
+    return true;
+}
 
-    // Преобразуем ключ в байты
-    std::array<uint8_t, 32> masterKey{};
-    hexToBytes(cleanedKey, masterKey.data(), keySize / 8);
+bool AESCipher::encryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    return processBytes(in, out, params, true, error);
+}
 
-    // Развертываем ключи
-    std::vector<std::array<uint8_t, 16>> roundKeys = expandKey(masterKey, keySize);
-    int Nr = keySize / 32 + 6;
+bool AESCipher::decryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    return processBytes(in, out, params, false, error);
+}
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Развернуто %1 раундовых ключей").arg(Nr + 1),
-        "Развертывание ключей"));
+// ==================== Шифрование / дешифрование (HEX) ====================
 
-    // Дешифрование блоков
-    QString decryptedHex;
-    int blockCounter = 0;
+CipherResult AESCipher::processHex(const QString& text, const QVariantMap& params, bool encrypt)
+{
+    StepTrace trace(params);
+    CipherResult result;
+    result.cipherName = name();
+    result.alphabet = m_alphabet;
+    result.isNumeric = true;
 
-    for (int i = 0; i < hexData.length(); i += 32) {
-        QString blockHex = hexData.mid(i, 32);
-        blockCounter++;
+    const QString operation = encrypt ? "шифрования" : "дешифрования";
 
-        std::array<uint8_t, 16> state{};
-        hexToBytes(blockHex, state.data(), 16);
+    QVector<CipherStep> steps;
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), QString("Начало %1 AES (Rijndael)").arg(operation), "Инициализация"));
+    }
 
-        // Начальный раунд дешифрования
-        addRoundKey(state, roundKeys[Nr]);
-        invShiftRows(state);
-        invSubBytes(state);
+    // Подготавливаем входные данные
+    qsizetype digits = 0;
+    qsizetype invalidAt = -1;
+    const QByteArray input = HexCodec::decode(text, &digits, &invalidAt);
+    if (invalidAt >= 0) {
+        result.fail(CipherStatus::InvalidInput, HexCodec::invalidCharError("Текст", text, invalidAt));
+        return trace.finish(result);
+    }
+    if (digits == 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Нет данных для %1 (введите HEX-строку)").arg(operation));
+        return trace.finish(result);
+    }
 
-        // Раунды Nr-1 .. 1
-        for (int round = Nr - 1; round >= 1; round--) {
-            addRoundKey(state, roundKeys[round]);
-            invMixColumns(state);
-            invShiftRows(state);
-            invSubBytes(state);
+    Mode mode;
+    QString error;
+    if (!parseMode(params, mode, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
+    }
+
+    const bool blockMode = (mode == Mode::ECB || mode == Mode::CBC);
+    if (blockMode && digits % 32 != 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Длина данных (%1 HEX символов) должна быть кратна 32 (128 бит)")
+                                                .arg(digits));
+        return trace.finish(result);
+    }
+    if (!blockMode && digits % 2 != 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Длина данных (%1 HEX символов) должна быть четной")
+                                                .arg(digits));
+        return trace.finish(result);
+    }
+
+    QByteArray output;
+    CipherStatus status = CipherStatus::Ok;
+    if (!processBytes(input, output, params, encrypt, &error, &status)) {
+        result.fail(status, error);
+        return trace.finish(result);
+    }
+
+    int keySize = params.value("keySize", "128").toString().toInt();
+    int Nr = keySize / 32 + 6;  // 10, 12 или 14
+    QString cleanedKey = HexCodec::clean(params.value("key", "").toString());
+
+    if (trace.want(TraceLevel::Summary)) {
+        QString details = QString("Параметры: %1 бит, режим %2, ключ: %3...")
+                          .arg(keySize).arg(modeName(mode)).arg(cleanedKey.left(16));
+        if (mode != Mode::ECB) {
+            details += QString(", IV: %1").arg(HexCodec::clean(params.value("iv", "").toString()));
         }
+        steps.append(CipherStep(1, QChar(), details, "Параметры"));
+    }
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Развернуто %1 раундовых ключей").arg(Nr + 1),
+            "Развертывание ключей"));
+    }
 
-        // Финальный раунд
-        addRoundKey(state, roundKeys[0]);
+    // Тег GCM идет после шифртекста и в поблочную трассировку не попадает
+    const int tagBytes = (mode == Mode::GCM) ? BLOCK_SIZE : 0;
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(input.constData());
+    const uint8_t* dst = reinterpret_cast<const uint8_t*>(output.constData());
+    const int dataBytes = int(encrypt ? input.size() : output.size());
+    int blockCount = (dataBytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    // Результат уже посчитан быстрым путем; пораундовые состояния — пошаговым
+    // (только ECB: в остальных режимах на вход раунда идет не блок данных)
+    std::shared_ptr<const RoundKeys> roundKeys;
+    if (mode == Mode::ECB && trace.want(TraceLevel::PerChar)) {
+        prepareRoundKeys(params, roundKeys, nullptr);
+    }
 
-        QString decryptedBlockHex = bytesToHex(state.data(), 16);
-        decryptedHex.append(decryptedBlockHex);
+    int stepCounter = 4;
+    for (int block = 0; block < blockCount; ++block) {
+        const int len = qMin(BLOCK_SIZE, dataBytes - block * BLOCK_SIZE);
+        if (trace.want(TraceLevel::PerBlock)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("Блок %1: %2 → %3").arg(block + 1)
+                    .arg(HexCodec::encode(src + block * BLOCK_SIZE, len))
+                    .arg(HexCodec::encode(dst + block * BLOCK_SIZE, len)),
+                QString("Блок %1").arg(block + 1)));
+        }
+        if (roundKeys) {
+            traceBlockRounds(src + block * BLOCK_SIZE, *roundKeys, encrypt, block, steps, stepCounter);
+        }
+    }
 
-        steps.append(CipherStep(3 + blockCounter, QChar(),
-            QString("Блок %1: %2 → %3").arg(blockCounter).arg(blockHex).arg(decryptedBlockHex),
-            QString("Блок %1").arg(blockCounter)));
+    if (tagBytes > 0 && trace.want(TraceLevel::Summary)) {
+        const uint8_t* tag = encrypt ? dst + dataBytes : src + dataBytes;
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString(encrypt ? "Тег аутентификации: %1" : "Тег аутентификации %1 проверен")
+                .arg(HexCodec::encode(tag, tagBytes)),
+            "Тег GCM"));
     }
 
-    steps.append(CipherStep(4 + blockCounter, QChar(),
-        "Дешифрование завершено", "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter, QChar(),
+            encrypt ? "Шифрование завершено" : "Дешифрование завершено", "Завершение"));
+    }
 
-    result.result = decryptedHex;
+    result.result = HexCodec::encode(dst, output.size());
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
+}
+
+CipherResult AESCipher::encrypt(const QString& text, const QVariantMap& params)
+{
+    return processHex(text, params, true);
+}
+
+CipherResult AESCipher::decrypt(const QString& text, const QVariantMap& params)
+{
+    return processHex(text, params, false);
 }
 
 // ==================== Регистратор ====================
@@ -579,6 +1698,48 @@ AESCipherRegister::AESCipherRegister()
             keyRow->addStretch();
             vbox->addLayout(keyRow);
 
+            // Режим работы
+            QHBoxLayout* modeRow = new QHBoxLayout();
+            QLabel* modeLabel = new QLabel("Режим:");
+            modeLabel->setFixedWidth(100);
+            QComboBox* modeCombo = new QComboBox();
+            modeCombo->addItem("ECB — простая замена", "ECB");
+            modeCombo->addItem("CBC — сцепление блоков", "CBC");
+            modeCombo->addItem("CTR — счетчик", "CTR");
+            modeCombo->addItem("GCM — счетчик с аутентификацией", "GCM");
+            modeCombo->setObjectName("mode");
+            modeRow->addWidget(modeLabel);
+            modeRow->addWidget(modeCombo);
+            modeRow->addStretch();
+            vbox->addLayout(modeRow);
+
+            // Вектор инициализации
+            QHBoxLayout* ivRow = new QHBoxLayout();
+            QLabel* ivLabel = new QLabel("IV:");
+            ivLabel->setFixedWidth(100);
+            AESHexEdit* ivEdit = new AESHexEdit();
+            ivEdit->setExpectedLength(16);
+            ivEdit->setObjectName("iv");
+            ivEdit->setHex("000102030405060708090a0b0c0d0e0f");
+            ivEdit->setEnabled(false);
+            ivRow->addWidget(ivLabel);
+            ivRow->addWidget(ivEdit);
+            ivRow->addStretch();
+            vbox->addLayout(ivRow);
+
+            // Дополнительные аутентифицируемые данные (GCM)
+            QHBoxLayout* aadRow = new QHBoxLayout();
+            QLabel* aadLabel = new QLabel("AAD:");
+            aadLabel->setFixedWidth(100);
+            AESHexEdit* aadEdit = new AESHexEdit();
+            aadEdit->setObjectName("aad");
+            aadEdit->setPlaceholderText("HEX (необязательно)");
+            aadEdit->setEnabled(false);
+            aadRow->addWidget(aadLabel);
+            aadRow->addWidget(aadEdit);
+            aadRow->addStretch();
+            vbox->addLayout(aadRow);
+
             // Информационная панель
             QLabel* infoLabel = new QLabel(
                 "AES (Rijndael) — симметричный блочный шифр, стандарт FIPS-197:\n"
@@ -586,7 +1747,9 @@ AESCipherRegister::AESCipherRegister()
                 "• Длина ключа: 128, 192 или 256 бит\n"
                 "• Количество раундов: 10, 12 или 14\n"
                 "• Преобразования: SubBytes, ShiftRows, MixColumns, AddRoundKey\n"
-                "• Вход/выход: HEX-строки (длина кратна 32 символам)"
+                "• Режимы: ECB, CBC (длина кратна 32 HEX символам), CTR, GCM (любая длина)\n"
+                "• IV: 32 HEX символа для CBC/CTR, для GCM рекомендуется 24\n"
+                "• GCM: к шифртексту дописывается тег 16 байт, при расшифровании он проверяется"
             );
             infoLabel->setStyleSheet("color: #666; padding: 5px; background-color: #f5f5f5; border-radius: 3px;");
             infoLabel->setWordWrap(true);
@@ -596,6 +1759,9 @@ AESCipherRegister::AESCipherRegister()
 
             widgets["keySize"] = keySizeCombo;
             widgets["key"] = keyEdit;
+            widgets["mode"] = modeCombo;
+            widgets["iv"] = ivEdit;
+            widgets["aad"] = aadEdit;
 
             // Обновляем ожидаемую длину ключа при изменении выбора
             QObject::connect(keySizeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -604,6 +1770,21 @@ AESCipherRegister::AESCipherRegister()
                     keyEdit->setExpectedLength(bytes);
                     keyEdit->setPlaceholderText(QString("HEX (%1 байт, %2 символа)").arg(bytes).arg(bytes * 2));
                 });
+
+            // IV нужен всем режимам, кроме ECB; AAD — только GCM
+            QObject::connect(modeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                [modeCombo, ivEdit, aadEdit](int) {
+                    const QString mode = modeCombo->currentData().toString();
+                    ivEdit->setEnabled(mode != "ECB");
+                    aadEdit->setEnabled(mode == "GCM");
+                    if (mode == "GCM") {
+                        ivEdit->setExpectedLength(0);
+                        ivEdit->setPlaceholderText("HEX (рекомендуется 12 байт, 24 символа)");
+                    } else {
+                        ivEdit->setExpectedLength(16);
+                        ivEdit->setPlaceholderText("HEX (16 байт, 32 символа)");
+                    }
+                });
         }
     );
 }
@@ -6,6 +6,7 @@
 #include <QVector>
 #include <array>
 #include <cstdint>
+#include <memory>
 
 // Класс шифра AES (Rijndael) по FIPS-197
 class AESCipher : public CipherInterface
@@ -19,7 +20,40 @@ public:
     virtual CipherResult encrypt(const QString& text, const QVariantMap& params) override;
     virtual CipherResult decrypt(const QString& text, const QVariantMap& params) override;
 
+    // Бинарный путь: ключ — HEX в params["key"], режим — params["mode"]:
+    // ECB (по умолчанию) и CBC — данные кратны 16 байтам; CTR — любая длина;
+    // GCM — любая длина, к шифртексту дописывается 16-байтный тег.
+    // IV — HEX в params["iv"] (16 байт для CBC/CTR, для GCM рекомендуется 12),
+    // дополнительные данные GCM — HEX в params["aad"]
+    virtual bool supportsBytes() const override { return true; }
+    virtual bool encryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+    virtual bool decryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+
+    // Потоковый контекст выбранного режима: неполный блок переносится в следующий update
+    virtual std::unique_ptr<CipherStream> createStream(bool encrypt) override;
+
+    // Режим работы блочного шифра
+    enum class Mode { ECB, CBC, CTR, GCM };
+
 private:
+    friend class AESStream;
+    friend class AESCBCStream;
+    friend class AESCTRStream;
+    friend class AESGCMStream;
+    friend class AESModeStream;
+
+    // Развернутый ключ. Байтовая форма — для пошагового (трассируемого) пути,
+    // словная — для T-таблиц: big-endian столбцы, у dec — ключи эквивалентного
+    // обратного шифра (FIPS-197, 5.3.5) с уже примененным InvMixColumns
+    struct RoundKeys {
+        int rounds = 0;                                    // Nr: 10, 12 или 14
+        std::array<std::array<uint8_t, 16>, 15> bytes{};   // K0..KNr
+        std::array<uint32_t, 60> enc{};
+        std::array<uint32_t, 60> dec{};
+    };
+
     // Константы
     static const int BLOCK_SIZE = 16;      // 128 бит = 16 байт
     static const int Nb = 4;               // количество столбцов в матрице состояния
@@ -44,12 +78,44 @@ private:
     void addRoundKey(std::array<uint8_t, 16>& state, const std::array<uint8_t, 16>& roundKey) const;
 
     // Развертывание ключа
-    std::vector<std::array<uint8_t, 16>> expandKey(const std::array<uint8_t, 32>& key, int keySize) const;
-
-    // Вспомогательные функции для работы с HEX
-    QString prepareHexInput(const QString& text) const;
-    QString bytesToHex(const uint8_t* data, int len) const;
-    void hexToBytes(const QString& hex, uint8_t* out, int len) const;
+    RoundKeys expandKey(const std::array<uint8_t, 32>& key, int keySize) const;
+
+    // Разбор ключа из параметров и развертывание (false + сообщение при ошибке).
+    // Развернутый ключ берется из KeyScheduleCache, повторный ключ не разворачивается
+    bool prepareRoundKeys(const QVariantMap& params, std::shared_ptr<const RoundKeys>& roundKeys,
+                          QString* error) const;
+
+    // Шифрование/расшифрование blocks блоков по 16 байт: раунд целиком
+    // через T-таблицы (Te0..Te3, Td0..Td3)
+    void encryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks, const RoundKeys& roundKeys) const;
+    void decryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks, const RoundKeys& roundKeys) const;
+
+    // Режимы NIST SP 800-38A/38D: counter/iv продвигаются на число обработанных
+    // блоков; inc32 — GCM увеличивает только младшие 32 бита счетчика
+    void cbcEncrypt(const uint8_t* in, uint8_t* out, qsizetype blocks, uint8_t iv[16],
+                    const RoundKeys& roundKeys) const;
+    void cbcDecrypt(const uint8_t* in, uint8_t* out, qsizetype blocks, uint8_t iv[16],
+                    const RoundKeys& roundKeys) const;
+    void ctrBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks, uint8_t counter[16], bool inc32,
+                   const RoundKeys& roundKeys) const;
+
+    // Разбор режима и IV из параметров (false + сообщение при ошибке)
+    static bool parseMode(const QVariantMap& params, Mode& mode, QString* error);
+    static QString modeName(Mode mode);
+    bool prepareIv(const QVariantMap& params, Mode mode, QByteArray& iv, QString* error) const;
+
+    // Сообщение целиком через потоковый контекст; status различает ошибку
+    // параметров/длины и несовпадение тега GCM
+    bool processBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, bool encrypt,
+                      QString* error, CipherStatus* status = nullptr);
+
+    // Состояние после каждого раунда одного блока по шагам FIPS-197
+    // (SubBytes, ShiftRows, MixColumns, AddRoundKey) — уровень трассировки PerChar
+    void traceBlockRounds(const uint8_t* block, const RoundKeys& roundKeys, bool encrypt, int blockIdx,
+                          QVector<CipherStep>& steps, int& stepCounter) const;
+
+    // Общая часть encrypt/decrypt для QString-адаптера
+    CipherResult processHex(const QString& text, const QVariantMap& params, bool encrypt);
 
     // Алфавит для вывода
     QString m_alphabet = "HEX";
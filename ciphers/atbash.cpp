@@ -8,7 +8,7 @@ AtbashCipher::AtbashCipher()
 
 CipherResult AtbashCipher::encrypt(const QString& text, const QVariantMap& params)
 {
-    Q_UNUSED(params);
+    StepTrace trace(params);
 
     CipherResult result;
     result.cipherName = name();
@@ -18,7 +18,7 @@ CipherResult AtbashCipher::encrypt(const QString& text, const QVariantMap& param
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -35,19 +35,21 @@ CipherResult AtbashCipher::encrypt(const QString& text, const QVariantMap& param
             encryptedText.append(resultChar);
 
             // Добавляем шаг для детализации
-            CipherStep step;
-            step.index = i;
-            step.originalChar = originalChar;
-            step.resultValue = resultChar;
-            step.description = QString("%1 → %2 (зеркальное отражение)")
-                              .arg(originalChar)
-                              .arg(resultChar);
-            result.steps.append(step);
+            if (trace.want(TraceLevel::PerChar)) {
+                CipherStep step;
+                step.index = i;
+                step.originalChar = originalChar;
+                step.resultValue = resultChar;
+                step.description = QString("%1 → %2 (зеркальное отражение)")
+                                  .arg(originalChar)
+                                  .arg(resultChar);
+                result.steps.append(step);
+            }
         }
     }
 
     result.result = encryptedText;
-    return result;
+    return trace.finish(result);
 }
 
 AtbashCipherRegister::AtbashCipherRegister()
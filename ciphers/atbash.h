@@ -22,7 +22,7 @@ public:
     }
 
 private:
-    QString m_alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& m_alphabet = Alphabet::russian();
 };
 
 class AtbashCipherRegister {
@@ -23,6 +23,7 @@ QString BelazoCipher::generateKey(const QString& text, const QString& key) const
 
 CipherResult BelazoCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -32,12 +33,12 @@ CipherResult BelazoCipher::encrypt(const QString& text, const QVariantMap& param
     QString filteredKey = CipherUtils::filterAlphabetOnly(key, m_alphabet);
 
     if (filteredKey.isEmpty()) {
-        result.result = "Ключ не содержит букв алфавита";
+        result.fail(CipherStatus::InvalidParams, "Ключ не содержит букв алфавита");
         return result;
     }
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -55,23 +56,26 @@ CipherResult BelazoCipher::encrypt(const QString& text, const QVariantMap& param
         QChar newChar = m_alphabet[newPos];
         transformed.append(newChar);
 
-        CipherStep step;
-        step.index = i;
-        step.originalChar = ch;
-        step.resultValue = QString(newChar);
-        step.description = QString("%1[%2] + %3[%4] = %5[%6]")
-                          .arg(ch).arg(textPos)
-                          .arg(keyChar).arg(keyPos)
-                          .arg(newChar).arg(newPos);
-        result.steps.append(step);
+        if (trace.want(TraceLevel::PerChar)) {
+            CipherStep step;
+            step.index = i;
+            step.originalChar = ch;
+            step.resultValue = QString(newChar);
+            step.description = QString("%1[%2] + %3[%4] = %5[%6]")
+                              .arg(ch).arg(textPos)
+                              .arg(keyChar).arg(keyPos)
+                              .arg(newChar).arg(newPos);
+            result.steps.append(step);
+        }
     }
 
     result.result = transformed;
-    return result;
+    return trace.finish(result);
 }
 
 CipherResult BelazoCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -81,12 +85,12 @@ CipherResult BelazoCipher::decrypt(const QString& text, const QVariantMap& param
     QString filteredKey = CipherUtils::filterAlphabetOnly(key, m_alphabet);
 
     if (filteredKey.isEmpty()) {
-        result.result = "Ключ не содержит букв алфавита";
+        result.fail(CipherStatus::InvalidParams, "Ключ не содержит букв алфавита");
         return result;
     }
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -104,19 +108,21 @@ CipherResult BelazoCipher::decrypt(const QString& text, const QVariantMap& param
         QChar newChar = m_alphabet[newPos];
         transformed.append(newChar);
 
-        CipherStep step;
-        step.index = i;
-        step.originalChar = ch;
-        step.resultValue = QString(newChar);
-        step.description = QString("%1[%2] - %3[%4] = %5[%6]")
-                          .arg(ch).arg(textPos)
-                          .arg(keyChar).arg(keyPos)
-                          .arg(newChar).arg(newPos);
-        result.steps.append(step);
+        if (trace.want(TraceLevel::PerChar)) {
+            CipherStep step;
+            step.index = i;
+            step.originalChar = ch;
+            step.resultValue = QString(newChar);
+            step.description = QString("%1[%2] - %3[%4] = %5[%6]")
+                              .arg(ch).arg(textPos)
+                              .arg(keyChar).arg(keyPos)
+                              .arg(newChar).arg(newPos);
+            result.steps.append(step);
+        }
     }
 
     result.result = transformed;
-    return result;
+    return trace.finish(result);
 }
 
 BelazoCipherRegister::BelazoCipherRegister()
@@ -17,7 +17,7 @@ public:
     }
 
 private:
-    QString m_alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& m_alphabet = Alphabet::russian();
 
     QString generateKey(const QString& text, const QString& key) const;
 };
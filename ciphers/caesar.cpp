@@ -19,15 +19,18 @@ int CaesarCipher::getShift(const QVariantMap& params) const
 
 CipherResult CaesarCipher::encrypt(const QString& text, const QVariantMap& params)
 {
-    return shiftText(text, getShift(params), "шифрование");
+    StepTrace trace(params);
+    return trace.finish(shiftText(text, getShift(params), "шифрование", trace));
 }
 
 CipherResult CaesarCipher::decrypt(const QString& text, const QVariantMap& params)
 {
-    return shiftText(text, -getShift(params), "дешифрование");
+    StepTrace trace(params);
+    return trace.finish(shiftText(text, -getShift(params), "дешифрование", trace));
 }
 
-CipherResult CaesarCipher::shiftText(const QString& text, int shift, const QString& operation)
+CipherResult CaesarCipher::shiftText(const QString& text, int shift, const QString& operation,
+                                     StepTrace& trace)
 {
     CipherResult result;
     result.cipherName = name();
@@ -36,7 +39,7 @@ CipherResult CaesarCipher::shiftText(const QString& text, int shift, const QStri
     QString filtered = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filtered.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -55,16 +58,18 @@ CipherResult CaesarCipher::shiftText(const QString& text, int shift, const QStri
             QChar newChar = m_alphabet[newIdx];
             transformed.append(newChar);
 
-            CipherStep step;
-            step.index = i;
-            step.originalChar = ch;
-            step.resultValue = QString(newChar);
-            step.description = QString("%1: %2 → %3 (сдвиг %4)")
-                              .arg(operation)
-                              .arg(ch)
-                              .arg(newChar)
-                              .arg(shift > 0 ? "+" + QString::number(shift) : QString::number(shift));
-            result.steps.append(step);
+            if (trace.want(TraceLevel::PerChar)) {
+                CipherStep step;
+                step.index = i;
+                step.originalChar = ch;
+                step.resultValue = QString(newChar);
+                step.description = QString("%1: %2 → %3 (сдвиг %4)")
+                                  .arg(operation)
+                                  .arg(ch)
+                                  .arg(newChar)
+                                  .arg(shift > 0 ? "+" + QString::number(shift) : QString::number(shift));
+                result.steps.append(step);
+            }
         }
     }
 
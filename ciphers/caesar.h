@@ -18,9 +18,9 @@ public:
 
 
 private:
-    QString m_alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& m_alphabet = Alphabet::russian();
 
-    CipherResult shiftText(const QString& text, int shift, const QString& operation);
+    CipherResult shiftText(const QString& text, int shift, const QString& operation, StepTrace& trace);
     int getShift(const QVariantMap& params) const;
 };
 
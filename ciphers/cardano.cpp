@@ -43,7 +43,7 @@ std::vector<std::vector<bool>> CardanoCipher::createDefaultGrid() const
 }
 
 QChar CardanoCipher::getAlphabetChar(int index) const {
-    static const QString alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& alphabet = Alphabet::russian();
     return alphabet[index % alphabet.size()];
 }
 
@@ -150,7 +150,7 @@ void CardanoCipher::clearGrid() {
 
 CipherResult CardanoCipher::encrypt(const QString& text, const QVariantMap& params)
 {
-    Q_UNUSED(params);
+    StepTrace trace(params);
 
     QVector<CipherStep> steps;
 
@@ -183,12 +183,14 @@ CipherResult CardanoCipher::encrypt(const QString& text, const QVariantMap& para
         }
 
         if (!placedChars.isEmpty()) {
-            steps.append(CipherStep(
-                pos,
-                QChar(),
-                placedChars,
-                QString("Позиция %1: %2 букв").arg(pos).arg(placedChars.length())
-            ));
+            if (trace.want(TraceLevel::PerBlock)) {
+                steps.append(CipherStep(
+                    pos,
+                    QChar(),
+                    placedChars,
+                    QString("Позиция %1: %2 букв").arg(pos).arg(placedChars.length())
+                ));
+            }
         }
     }
 
@@ -214,29 +216,36 @@ CipherResult CardanoCipher::encrypt(const QString& text, const QVariantMap& para
         }
     }
 
-    steps.append(CipherStep(
-        5,
-        QChar(),
-        result,
-        QString("Итоговая матрица %1×%2 (пустые клетки заполнены случайно)").arg(m_rows).arg(m_cols)
-    ));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(
+            5,
+            QChar(),
+            result,
+            QString("Итоговая матрица %1×%2 (пустые клетки заполнены случайно)").arg(m_rows).arg(m_cols)
+        ));
+    }
 
-    return CipherResult(result, steps, "Решетка Кардано 6×10", name(), false);
+    return trace.finish(CipherResult(result, steps, "Решетка Кардано 6×10", name(), false));
 }
 
 CipherResult CardanoCipher::decrypt(const QString& text, const QVariantMap& params)
 {
-    Q_UNUSED(params);
+    StepTrace trace(params);
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало дешифрования", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало дешифрования", "Инициализация"));
+    }
 
     // Фильтруем входной текст (оставляем только буквы алфавита)
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        steps.append(CipherStep(1, QChar(), "Ошибка: пустой входной текст", "Проверка"));
-        return CipherResult(QString(), steps, "Решетка Кардано 6×10", name(), true);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(1, QChar(), "Ошибка: пустой входной текст", "Проверка"));
+        }
+        return trace.finish(CipherResult(QString(), steps, "Решетка Кардано 6×10", name(), true)
+            .fail(CipherStatus::InvalidInput, "ОШИБКА: Пустой входной текст"));
     }
 
     // Проверяем, что длина текста соответствует размеру решетки
@@ -251,9 +260,11 @@ CipherResult CardanoCipher::decrypt(const QString& text, const QVariantMap& para
             filteredText = filteredText.left(expectedLength);
         }
 
-        steps.append(CipherStep(1, QChar(),
-            QString("Текст скорректирован до длины %1 (ожидалось %2)").arg(filteredText.length()).arg(expectedLength),
-            "Коррекция длины"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(1, QChar(),
+                QString("Текст скорректирован до длины %1 (ожидалось %2)").arg(filteredText.length()).arg(expectedLength),
+                "Коррекция длины"));
+        }
     }
 
     // Заполняем рабочую решетку символами из входного текста
@@ -266,9 +277,11 @@ CipherResult CardanoCipher::decrypt(const QString& text, const QVariantMap& para
         }
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Заполнена решетка %1×%2 символами").arg(m_rows).arg(m_cols),
-        "Заполнение решетки"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Заполнена решетка %1×%2 символами").arg(m_rows).arg(m_cols),
+            "Заполнение решетки"));
+    }
 
     // Собираем расшифрованный текст, проходя по всем 4 позициям в том же порядке, что и при шифровании
     QString result;
@@ -290,36 +303,47 @@ CipherResult CardanoCipher::decrypt(const QString& text, const QVariantMap& para
         }
 
         if (!collectedChars.isEmpty()) {
-            steps.append(CipherStep(2 + pos, QChar(),
-                QString("Позиция %1: найдено %2 букв: %3")
-                    .arg(pos)
-                    .arg(collectedChars.length())
-                    .arg(collectedChars),
-                QString("Сбор букв из позиции %1").arg(pos)));
+            if (trace.want(TraceLevel::PerBlock)) {
+                steps.append(CipherStep(2 + pos, QChar(),
+                    QString("Позиция %1: найдено %2 букв: %3")
+                        .arg(pos)
+                        .arg(collectedChars.length())
+                        .arg(collectedChars),
+                    QString("Сбор букв из позиции %1").arg(pos)));
+            }
         } else {
-            steps.append(CipherStep(2 + pos, QChar(),
-                QString("Позиция %1: букв не найдено").arg(pos),
-                QString("Проверка позиции %1").arg(pos)));
+            if (trace.want(TraceLevel::PerBlock)) {
+                steps.append(CipherStep(2 + pos, QChar(),
+                    QString("Позиция %1: букв не найдено").arg(pos),
+                    QString("Проверка позиции %1").arg(pos)));
+            }
         }
     }
 
-    steps.append(CipherStep(7, QChar(),
-        QString("Всего собрано %1 букв").arg(totalCharsFound),
-        "Сбор завершен"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(7, QChar(),
+            QString("Всего собрано %1 букв").arg(totalCharsFound),
+            "Сбор завершен"));
+    }
 
     // Проверяем, что результат не пустой
     if (result.isEmpty()) {
-        steps.append(CipherStep(8, QChar(),
-            "Ошибка: не удалось извлечь ни одной буквы",
-            "Проверка результата"));
-        return CipherResult(QString(), steps, "Решетка Кардано 6×10", name(), true);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(8, QChar(),
+                "Ошибка: не удалось извлечь ни одной буквы",
+                "Проверка результата"));
+        }
+        return trace.finish(CipherResult(QString(), steps, "Решетка Кардано 6×10", name(), true)
+            .fail(CipherStatus::InvalidInput, "ОШИБКА: Не удалось извлечь ни одной буквы"));
     }
 
-    steps.append(CipherStep(9, QChar(),
-        QString("Расшифрованный текст: %1").arg(result),
-        "Формирование результата"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(9, QChar(),
+            QString("Расшифрованный текст: %1").arg(result),
+            "Формирование результата"));
+    }
 
-    return CipherResult(result, steps, "Решетка Кардано 6×10", name(), false);
+    return trace.finish(CipherResult(result, steps, "Решетка Кардано 6×10", name(), false));
 }
 
 QString CardanoCipher::name() const {
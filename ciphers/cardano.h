@@ -30,7 +30,7 @@ public:
     int countTotalHoles() const;
 
 private:
-    QString m_alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& m_alphabet = Alphabet::russian();
     std::vector<std::vector<bool>> m_holes; // Решетка
     std::vector<std::vector<QChar>> m_grid; // Рабочая решетка
     int m_rows;
@@ -7,7 +7,7 @@
 #include <QLabel>
 #include <QHBoxLayout>
 
-const QString ColumnTranspositionCipher::RUSSIAN_ALPHABET = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+const Alphabet& ColumnTranspositionCipher::RUSSIAN_ALPHABET = Alphabet::russian();
 
 ColumnTranspositionCipher::ColumnTranspositionCipher()
     : RouteCipher()
@@ -91,7 +91,7 @@ CipherResult ColumnTranspositionCipher::encrypt(const QString& text, const QVari
     QVector<int> columnOrder = keyToColumnOrder(key, cols, errorMessage);
 
     if (columnOrder.isEmpty()) {
-        return CipherResult(errorMessage, QVector<CipherStep>(), "Ошибка", name(), true);
+        return CipherResult::failure(CipherStatus::InvalidParams, "ОШИБКА: " + errorMessage, name());
     }
 
     // Получаем направления записи из расширенных параметров
@@ -121,8 +121,9 @@ CipherResult ColumnTranspositionCipher::encrypt(const QString& text, const QVari
         }
     }
 
-    return encryptImpl(cleanText, rows, cols, writeDirections, readDirections,
-                      rowOrder, columnOrder);
+    StepTrace trace(params);
+    return trace.finish(encryptImpl(cleanText, rows, cols, writeDirections, readDirections,
+                                    rowOrder, columnOrder, trace));
 }
 
 
@@ -152,7 +153,7 @@ CipherResult ColumnTranspositionCipher::decrypt(const QString& text, const QVari
     QVector<int> columnOrder = keyToColumnOrder(key, cols, errorMessage);
 
     if (columnOrder.isEmpty()) {
-        return CipherResult(errorMessage, QVector<CipherStep>(), "Ошибка", name(), true);
+        return CipherResult::failure(CipherStatus::InvalidParams, "ОШИБКА: " + errorMessage, name());
     }
 
     // Для дешифрования нам нужно знать, как заполнялась таблица
@@ -188,8 +189,9 @@ CipherResult ColumnTranspositionCipher::decrypt(const QString& text, const QVari
     // 1. Сначала заполнить таблицу по столбцам в порядке, определяемом ключом
     // 2. Затем прочитать по строкам с учетом направлений записи
 
-    return decryptImpl(cleanText, rows, cols, writeDirections, readDirections,
-                      rowOrder, columnOrder);
+    StepTrace trace(params);
+    return trace.finish(decryptImpl(cleanText, rows, cols, writeDirections, readDirections,
+                                    rowOrder, columnOrder, trace));
 }
 
 // Добавьте этот вспомогательный метод в класс ColumnTranspositionCipher
@@ -199,18 +201,23 @@ CipherResult ColumnTranspositionCipher::decryptImpl(const QString& text,
                                                    const QVector<Direction>& writeDirections,
                                                    const QVector<Direction>& readDirections,
                                                    const QVector<int>& rowOrder,
-                                                   const QVector<int>& columnOrder)
+                                                   const QVector<int>& columnOrder,
+                                                   StepTrace& trace)
 {
     QVector<CipherStep> steps;
 
     // Шаг 1: Очистка текста
     QString cleanText = CipherUtils::filterAlphabetOnly(text, RUSSIAN_ALPHABET);
-    steps.append(CipherStep(1, QChar(), cleanText, QStringLiteral(u"Очищенный текст (шифртекст)")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(), cleanText, QStringLiteral(u"Очищенный текст (шифртекст)")));
+    }
 
     // Шаг 2: Информация о размере таблицы
-    steps.append(CipherStep(2, QChar(),
-        QString("%1×%2").arg(rows).arg(cols),
-        QStringLiteral(u"Размер таблицы")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("%1×%2").arg(rows).arg(cols),
+            QStringLiteral(u"Размер таблицы")));
+    }
 
     // Нормализуем порядки
     QVector<int> normalizedRowOrder = normalizeOrder(rowOrder, rows, "строк");
@@ -218,8 +225,10 @@ CipherResult ColumnTranspositionCipher::decryptImpl(const QString& text,
 
     // Шаг 3: Создаем пустую таблицу нужного размера
     std::vector<std::vector<QChar>> table(rows, std::vector<QChar>(cols, QChar()));
-    steps.append(CipherStep(3, QChar(),
-        tableToString(table), QStringLiteral(u"Пустая таблица %1×%2").arg(rows).arg(cols)));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            tableToString(table), QStringLiteral(u"Пустая таблица %1×%2").arg(rows).arg(cols)));
+    }
 
     // Шаг 4: Заполняем таблицу по столбцам в порядке, определенном ключом
     // Для вертикальной перестановки при шифровании читали столбцы в порядке columnOrder
@@ -250,20 +259,24 @@ CipherResult ColumnTranspositionCipher::decryptImpl(const QString& text,
         }
 
         if (!columnChars.isEmpty()) {
-            steps.append(CipherStep(
-                steps.size() + 1,
-                QChar(),
-                columnChars,
-                QString("Заполнение столбца %1 (порядок %2): сверху вниз")
-                    .arg(colIdx + 1)
-                    .arg(orderNum)
-            ));
+            if (trace.want(TraceLevel::PerBlock)) {
+                steps.append(CipherStep(
+                    steps.size() + 1,
+                    QChar(),
+                    columnChars,
+                    QString("Заполнение столбца %1 (порядок %2): сверху вниз")
+                        .arg(colIdx + 1)
+                        .arg(orderNum)
+                ));
+            }
         }
     }
 
     // Шаг 5: Отображение заполненной таблицы
-    steps.append(CipherStep(steps.size() + 1, QChar(),
-        tableToString(table), QStringLiteral(u"Таблица, заполненная по столбцам")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(steps.size() + 1, QChar(),
+            tableToString(table), QStringLiteral(u"Таблица, заполненная по столбцам")));
+    }
 
     // Шаг 6: Чтение таблицы по строкам с учетом направлений записи
     QString decrypted;
@@ -308,21 +321,25 @@ CipherResult ColumnTranspositionCipher::decryptImpl(const QString& text,
         }
 
         if (!rowChars.isEmpty()) {
-            steps.append(CipherStep(
-                steps.size() + 1,
-                QChar(),
-                rowChars,
-                QString("Чтение строки %1 (порядок %2): %3")
-                    .arg(rowIdx + 1)
-                    .arg(orderNum)
-                    .arg(direction == LEFT_TO_RIGHT ? "слева направо" : "справа налево")
-            ));
+            if (trace.want(TraceLevel::PerBlock)) {
+                steps.append(CipherStep(
+                    steps.size() + 1,
+                    QChar(),
+                    rowChars,
+                    QString("Чтение строки %1 (порядок %2): %3")
+                        .arg(rowIdx + 1)
+                        .arg(orderNum)
+                        .arg(direction == LEFT_TO_RIGHT ? "слева направо" : "справа налево")
+                ));
+            }
         }
     }
 
     // Шаг 7: Итоговый результат
-    steps.append(CipherStep(steps.size() + 1, QChar(),
-        decrypted, QStringLiteral(u"Итоговый расшифрованный текст")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(steps.size() + 1, QChar(),
+            decrypted, QStringLiteral(u"Итоговый расшифрованный текст")));
+    }
 
     // Перенумеровываем шаги
     for (int i = 0; i < steps.size(); ++i) {
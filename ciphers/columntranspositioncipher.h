@@ -29,11 +29,12 @@ protected:
                             const QVector<Direction>& writeDirections,
                             const QVector<Direction>& readDirections,
                             const QVector<int>& rowOrder,
-                            const QVector<int>& columnOrder);
+                            const QVector<int>& columnOrder,
+                            StepTrace& trace);
 
 
 private:
-    static const QString RUSSIAN_ALPHABET;
+    static const Alphabet& RUSSIAN_ALPHABET;
 };
 
 #endif // COLUMNTRANSPOSITIONCIPHER_H
@@ -169,8 +169,9 @@ CipherResult DiffieHellmanCipher::encrypt(const QString& text, const QVariantMap
 {
     CipherResult result;
     result.cipherName = name();
-    result.result = "Протокол Диффи-Хеллмана не предназначен для шифрования.\n"
-                    "Используйте расширенные настройки для обмена ключами.";
+    result.fail(CipherStatus::Unsupported,
+                "Протокол Диффи-Хеллмана не предназначен для шифрования.\n"
+                "Используйте расширенные настройки для обмена ключами.");
     return result;
 }
 
@@ -180,8 +181,9 @@ CipherResult DiffieHellmanCipher::decrypt(const QString& text, const QVariantMap
 {
     CipherResult result;
     result.cipherName = name();
-    result.result = "Протокол Диффи-Хеллмана не предназначен для расшифрования.\n"
-                    "Используйте расширенные настройки для обмена ключами.";
+    result.fail(CipherStatus::Unsupported,
+                "Протокол Диффи-Хеллмана не предназначен для расшифрования.\n"
+                "Используйте расширенные настройки для обмена ключами.");
     return result;
 }
 
@@ -311,13 +311,16 @@ ECPoint ECCCipher::stringToPoint(const QString& str)
 
 CipherResult ECCCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = "Числа";
     result.isNumeric = true;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало шифрования ECC (Эль-Гамаль)", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало шифрования ECC (Эль-Гамаль)", "Инициализация"));
+    }
 
     // Получаем параметры
     uint64_t a = params.value("a", 0).toULongLong();
@@ -332,38 +335,44 @@ CipherResult ECCCipher::encrypt(const QString& text, const QVariantMap& params)
     // Проверяем параметры
     QString validationError;
     if (!validateParameters(a, b, p, G, cB, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: a=%1, b=%2, p=%3, G=%4, Cb=%5, k=%6")
-            .arg(a).arg(b).arg(p).arg(pointToString(G)).arg(cB).arg(k),
-        "Проверка параметров"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: a=%1, b=%2, p=%3, G=%4, Cb=%5, k=%6")
+                .arg(a).arg(b).arg(p).arg(pointToString(G)).arg(cB).arg(k),
+            "Проверка параметров"));
+    }
 
     // Получаем сообщение M (число)
     uint64_t M = text.trimmed().toULongLong();
     if (M == 0 && text.trimmed() != "0") {
-        result.result = "ОШИБКА: Введите число для шифрования";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Введите число для шифрования");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Сообщение M = %1").arg(M),
-        "Подготовка данных"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Сообщение M = %1").arg(M),
+            "Подготовка данных"));
+    }
 
     // Проверяем, что M < p
     if (M >= p) {
-        result.result = QString("ОШИБКА: M = %1 >= P = %2").arg(M).arg(p);
-        return result;
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: M = %1 >= P = %2").arg(M).arg(p));
+        return trace.finish(result);
     }
 
     // Вычисляем открытый ключ: DB = [Cb]G
     ECPoint DB = pointMultiply(G, cB, a, p);
-    steps.append(CipherStep(3, QChar(),
-        QString("Открытый ключ DB = [Cb]G = [%1]%2 = %3")
-            .arg(cB).arg(pointToString(G)).arg(pointToString(DB)),
-        "Вычисление открытого ключа"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Открытый ключ DB = [Cb]G = [%1]%2 = %3")
+                .arg(cB).arg(pointToString(G)).arg(pointToString(DB)),
+            "Вычисление открытого ключа"));
+    }
 
     // Шифрование:
     // R = [k]G
@@ -373,34 +382,41 @@ CipherResult ECCCipher::encrypt(const QString& text, const QVariantMap& params)
     // e = M * x mod p (где x - координата x точки P)
     uint64_t e = modMul(M, P.x, p);
 
-    steps.append(CipherStep(4, QChar(),
-        QString("Шифрование:\n  R = [k]G = [%1]%2 = %3\n  P = [k]DB = %4\n  e = M * x_P = %1 * %5 mod %6 = %7")
-            .arg(k).arg(pointToString(G)).arg(pointToString(R))
-            .arg(pointToString(P)).arg(P.x).arg(p).arg(e),
-        "Шифрование"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(4, QChar(),
+            QString("Шифрование:\n  R = [k]G = [%1]%2 = %3\n  P = [k]DB = %4\n  e = M * x_P = %1 * %5 mod %6 = %7")
+                .arg(k).arg(pointToString(G)).arg(pointToString(R))
+                .arg(pointToString(P)).arg(P.x).arg(p).arg(e),
+            "Шифрование"));
+    }
 
     // Формируем результат: R(x,y) и e
     QString resultStr = QString("%1 %2").arg(pointToString(R)).arg(e);
 
-    steps.append(CipherStep(5, QChar(),
-        QString("Результат: %1").arg(resultStr),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(5, QChar(),
+            QString("Результат: %1").arg(resultStr),
+            "Завершение"));
+    }
 
     result.result = resultStr;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 CipherResult ECCCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = "Числа";
     result.isNumeric = false;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало расшифрования ECC (Эль-Гамаль)", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало расшифрования ECC (Эль-Гамаль)", "Инициализация"));
+    }
 
     // Получаем параметры
     uint64_t a = params.value("a", 0).toULongLong();
@@ -414,14 +430,16 @@ CipherResult ECCCipher::decrypt(const QString& text, const QVariantMap& params)
     // Проверяем параметры
     QString validationError;
     if (!validateParameters(a, b, p, G, cB, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: a=%1, b=%2, p=%3, G=%4, Cb=%5")
-            .arg(a).arg(b).arg(p).arg(pointToString(G)).arg(cB),
-        "Проверка параметров"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: a=%1, b=%2, p=%3, G=%4, Cb=%5")
+                .arg(a).arg(b).arg(p).arg(pointToString(G)).arg(cB),
+            "Проверка параметров"));
+    }
 
     // Разбираем шифртекст: R(x,y) и e
     QString inputText = text.trimmed();
@@ -429,21 +447,23 @@ CipherResult ECCCipher::decrypt(const QString& text, const QVariantMap& params)
     QRegularExpressionMatch match = regex.match(inputText);
 
     if (!match.hasMatch()) {
-        result.result = "ОШИБКА: Неверный формат шифртекста. Ожидается: (x,y) e";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Неверный формат шифртекста. Ожидается: (x,y) e");
+        return trace.finish(result);
     }
 
     ECPoint R(match.captured(1).toULongLong(), match.captured(2).toULongLong());
     uint64_t e = match.captured(3).toULongLong();
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Получен шифртекст: R=%1, e=%2").arg(pointToString(R)).arg(e),
-        "Подготовка данных"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Получен шифртекст: R=%1, e=%2").arg(pointToString(R)).arg(e),
+            "Подготовка данных"));
+    }
 
     // Проверяем, что R лежит на кривой
     if (!isPointOnCurve(R, a, b, p)) {
-        result.result = QString("ОШИБКА: Точка R(%1, %2) не лежит на кривой").arg(R.x).arg(R.y);
-        return result;
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Точка R(%1, %2) не лежит на кривой").arg(R.x).arg(R.y));
+        return trace.finish(result);
     }
 
     // расшифрование:
@@ -453,21 +473,25 @@ CipherResult ECCCipher::decrypt(const QString& text, const QVariantMap& params)
     uint64_t xInv = modInverse(Q.x, p);
     uint64_t M = modMul(e, xInv, p);
 
-    steps.append(CipherStep(3, QChar(),
-        QString("расшифрование:\n  Q = [Cb]R = [%1]%2 = %3\n  x^(-1) = %4^(-1) mod %5 = %6\n  M = e * x^(-1) mod p = %7 * %8 mod %9 = %10")
-            .arg(cB).arg(pointToString(R)).arg(pointToString(Q))
-            .arg(Q.x).arg(p).arg(xInv)
-            .arg(e).arg(xInv).arg(p).arg(M),
-        "расшифрование"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("расшифрование:\n  Q = [Cb]R = [%1]%2 = %3\n  x^(-1) = %4^(-1) mod %5 = %6\n  M = e * x^(-1) mod p = %7 * %8 mod %9 = %10")
+                .arg(cB).arg(pointToString(R)).arg(pointToString(Q))
+                .arg(Q.x).arg(p).arg(xInv)
+                .arg(e).arg(xInv).arg(p).arg(M),
+            "расшифрование"));
+    }
 
-    steps.append(CipherStep(4, QChar(),
-        QString("Результат: M = %1").arg(M),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(4, QChar(),
+            QString("Результат: M = %1").arg(M),
+            "Завершение"));
+    }
 
     result.result = QString::number(M);
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== ECCCipherRegister Implementation ====================
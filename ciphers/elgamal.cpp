@@ -504,13 +504,16 @@ uint64_t ElGamalCipher::modPowStatic(uint64_t base, uint64_t exp, uint64_t mod)
 // Шифрование
 CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = true;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало шифрования ElGamal", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало шифрования ElGamal", "Инициализация"));
+    }
 
     // Получаем параметры
     uint64_t p = params.value("p", 0).toULongLong();
@@ -532,38 +535,44 @@ CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& para
     // Проверяем параметры
     QString validationError;
     if (!validateParameters(p, g, x, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: P=%1, G=%2, X=%3").arg(p).arg(g).arg(x),
-        "Проверка параметров"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: P=%1, G=%2, X=%3").arg(p).arg(g).arg(x),
+            "Проверка параметров"));
+    }
 
     uint64_t y = modPow(g, x, p);
-    steps.append(CipherStep(2, QChar(),
-        QString("Открытый ключ Y = G^X mod P = %1^%2 mod %3 = %4").arg(g).arg(x).arg(p).arg(y),
-        "Вычисление открытого ключа"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Открытый ключ Y = G^X mod P = %1^%2 mod %3 = %4").arg(g).arg(x).arg(p).arg(y),
+            "Вычисление открытого ключа"));
+    }
 
     const uint64_t ALPHABET_SIZE = 32;
     if (p <= ALPHABET_SIZE) {
-        result.result = QString("ОШИБКА: P = %1 должно быть больше мощности алфавита (%2). "
-                                "Выберите большее простое число P.")
-                            .arg(p).arg(ALPHABET_SIZE);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: P = %1 должно быть больше мощности алфавита (%2). "
+                                                         "Выберите большее простое число P.")
+                                                     .arg(p).arg(ALPHABET_SIZE));
+        return trace.finish(result);
     }
 
     // Фильтруем текст
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Входной текст: %1").arg(filteredText),
-        "Подготовка данных"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Входной текст: %1").arg(filteredText),
+            "Подготовка данных"));
+    }
 
     // Преобразуем текст в числа
     QVector<uint64_t> numbers = textToNumbers(filteredText);
@@ -572,8 +581,8 @@ CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& para
     for (int i = 0; i < numbers.size(); ++i) {
         QString msgError;
         if (!validateMessageNumber(numbers[i], p, msgError)) {
-            result.result = "ОШИБКА: " + msgError;
-            return result;
+            result.fail(CipherStatus::InvalidInput, "ОШИБКА: " + msgError);
+            return trace.finish(result);
         }
     }
 
@@ -584,9 +593,11 @@ CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& para
     }
     if (numbers.size() > 20) numbersStr += "...";
 
-    steps.append(CipherStep(4, QChar(),
-        QString("Преобразовано в числа 1-32: %1").arg(numbersStr),
-        "Преобразование текста"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(4, QChar(),
+            QString("Преобразовано в числа 1-32: %1").arg(numbersStr),
+            "Преобразование текста"));
+    }
 
     // Генерируем или получаем рандомизаторы
     QVector<uint64_t> randomizers;
@@ -602,21 +613,25 @@ CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& para
             randStr += QString::number(randomizers[i]) + " ";
         }
         if (randomizers.size() > 10) randStr += "...";
-        steps.append(CipherStep(5, QChar(),
-            QString("Сгенерированы рандомизаторы K: %1").arg(randStr),
-            "Генерация рандомизаторов"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(5, QChar(),
+                QString("Сгенерированы рандомизаторы K: %1").arg(randStr),
+                "Генерация рандомизаторов"));
+        }
     } else {
         // Ручной режим: циклическое использование
         if (manualRandomizers.isEmpty()) {
-            result.result = "ОШИБКА: Не указаны рандомизаторы для ручного режима";
-            return result;
+            result.fail(CipherStatus::InvalidParams, "ОШИБКА: Не указаны рандомизаторы для ручного режима");
+            return trace.finish(result);
         }
 
         if (manualRandomizers.size() < numbers.size()) {
-            steps.append(CipherStep(5, QChar(),
-                QString("ВНИМАНИЕ: Рандомизаторов (%1) меньше длины сообщения (%2). Циклическое использование!")
-                    .arg(manualRandomizers.size()).arg(numbers.size()),
-                "Предупреждение"));
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(5, QChar(),
+                    QString("ВНИМАНИЕ: Рандомизаторов (%1) меньше длины сообщения (%2). Циклическое использование!")
+                        .arg(manualRandomizers.size()).arg(numbers.size()),
+                    "Предупреждение"));
+            }
         }
 
         // Циклическое заполнение
@@ -629,17 +644,19 @@ CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& para
         for (int i = 0; i < randomizers.size(); ++i) {
             if (gcd(randomizers[i], p - 1) != 1) {
                 hasError = true;
-                steps.append(CipherStep(5 + i, QChar(),
-                    QString("ОШИБКА: Рандомизатор K%1 = %2 не взаимно прост с φ(P)=%3")
-                        .arg(i + 1).arg(randomizers[i]).arg(p - 1),
-                    "Ошибка валидации"));
+                if (trace.want(TraceLevel::Summary)) {
+                    steps.append(CipherStep(5 + i, QChar(),
+                        QString("ОШИБКА: Рандомизатор K%1 = %2 не взаимно прост с φ(P)=%3")
+                            .arg(i + 1).arg(randomizers[i]).arg(p - 1),
+                        "Ошибка валидации"));
+                }
                 break;
             }
         }
 
         if (hasError) {
-            result.result = "ОШИБКА: Рандомизатор должен быть взаимно прост с φ(P)";
-            return result;
+            result.fail(CipherStatus::InvalidParams, "ОШИБКА: Рандомизатор должен быть взаимно прост с φ(P)");
+            return trace.finish(result);
         }
 
         QString randStr;
@@ -647,9 +664,11 @@ CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& para
             randStr += QString::number(randomizers[i]) + " ";
         }
         if (randomizers.size() > 10) randStr += "...";
-        steps.append(CipherStep(6, QChar(),
-            QString("Используются рандомизаторы K (циклически): %1").arg(randStr),
-            "Рандомизаторы"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(6, QChar(),
+                QString("Используются рандомизаторы K (циклически): %1").arg(randStr),
+                "Рандомизаторы"));
+        }
     }
 
     // Шифруем каждое число
@@ -662,16 +681,18 @@ CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& para
         auto pair = encryptNumber(numbers[i], p, g, y, k);
         encryptedA.append(pair.first);
         encryptedB.append(pair.second);
-        stepDetails.append(QString("Блок %1: '%2' = %3, K=%4 → a=%5^%4 mod %6=%7, b=%8^%4×%3 mod %6=%9")
-            .arg(i + 1)
-            .arg(filteredText[i])
-            .arg(numbers[i])
-            .arg(k)
-            .arg(g)
-            .arg(p)
-            .arg(pair.first)
-            .arg(y)
-            .arg(pair.second));
+        if (i < 10 && trace.enabled(TraceLevel::PerChar)) {
+            stepDetails.append(QString("Блок %1: '%2' = %3, K=%4 → a=%5^%4 mod %6=%7, b=%8^%4×%3 mod %6=%9")
+                .arg(i + 1)
+                .arg(filteredText[i])
+                .arg(numbers[i])
+                .arg(k)
+                .arg(g)
+                .arg(p)
+                .arg(pair.first)
+                .arg(y)
+                .arg(pair.second));
+        }
     }
 
     // Формируем результат: a1 b1 a2 b2 ...
@@ -681,31 +702,38 @@ CipherResult ElGamalCipher::encrypt(const QString& text, const QVariantMap& para
         resultNumbers += QString::number(encryptedA[i]) + " " + QString::number(encryptedB[i]);
     }
 
-    steps.append(CipherStep(7, QChar(),
-        QString("Результат (a b пары): %1").arg(resultNumbers.left(100) + (resultNumbers.length() > 100 ? "..." : "")),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(7, QChar(),
+            QString("Результат (a b пары): %1").arg(resultNumbers.left(100) + (resultNumbers.length() > 100 ? "..." : "")),
+            "Завершение"));
+    }
 
     // Добавляем детальные шаги
-    for (int i = 0; i < stepDetails.size() && i < 10; ++i) {
-        steps.append(CipherStep(8 + i, QChar(), stepDetails[i], QString("Шаг %1").arg(i + 1)));
+    for (int i = 0; i < numbers.size() && i < 10; ++i) {
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(8 + i, QChar(), stepDetails[i], QString("Шаг %1").arg(i + 1)));
+        }
     }
 
     result.result = resultNumbers;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // расшифрование
 CipherResult ElGamalCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = false;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало расшифрования ElGamal", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало расшифрования ElGamal", "Инициализация"));
+    }
 
     // Получаем параметры
     uint64_t p = params.value("p", 0).toULongLong();
@@ -715,13 +743,15 @@ CipherResult ElGamalCipher::decrypt(const QString& text, const QVariantMap& para
     // Проверяем параметры
     QString validationError;
     if (!validateParameters(p, g, x, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: P=%1, G=%2, X=%3").arg(p).arg(g).arg(x),
-        "Проверка параметров"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: P=%1, G=%2, X=%3").arg(p).arg(g).arg(x),
+            "Проверка параметров"));
+    }
 
     // Разбираем входные числа (пары a b)
     QString inputText = text.trimmed();
@@ -731,8 +761,8 @@ CipherResult ElGamalCipher::decrypt(const QString& text, const QVariantMap& para
     QStringList parts = inputText.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
 
     if (parts.size() % 2 != 0) {
-        result.result = "ОШИБКА: Нечетное количество чисел (должны быть пары a b)";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Нечетное количество чисел (должны быть пары a b)");
+        return trace.finish(result);
     }
 
     QVector<QPair<uint64_t, uint64_t>> encryptedPairs;
@@ -745,9 +775,11 @@ CipherResult ElGamalCipher::decrypt(const QString& text, const QVariantMap& para
         }
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Получено %1 пар (a,b) для расшифрования").arg(encryptedPairs.size()),
-        "Подготовка данных"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Получено %1 пар (a,b) для расшифрования").arg(encryptedPairs.size()),
+            "Подготовка данных"));
+    }
 
     // расшифруем каждую пару
     QVector<uint64_t> decryptedNumbers;
@@ -759,40 +791,46 @@ CipherResult ElGamalCipher::decrypt(const QString& text, const QVariantMap& para
         uint64_t decrypted = decryptNumber(a, b, p, x);
         decryptedNumbers.append(decrypted);
 
-        uint64_t ax = modPow(a, x, p);
-        uint64_t axInv = modInverse(ax, p);
-
-        stepDetails.append(QString("Пара %1: (a=%2, b=%3) → a^x=%4^%5 mod %6=%7 → a^-x=%8 → M=%9×%10 mod %11=%12")
-            .arg(i + 1)
-            .arg(a)
-            .arg(b)
-            .arg(a)
-            .arg(x)
-            .arg(p)
-            .arg(ax)
-            .arg(axInv)
-            .arg(b)
-            .arg(axInv)
-            .arg(p)
-            .arg(decrypted));
+        if (i < 10 && trace.enabled(TraceLevel::PerChar)) {
+            uint64_t ax = modPow(a, x, p);
+            uint64_t axInv = modInverse(ax, p);
+
+            stepDetails.append(QString("Пара %1: (a=%2, b=%3) → a^x=%4^%5 mod %6=%7 → a^-x=%8 → M=%9×%10 mod %11=%12")
+                .arg(i + 1)
+                .arg(a)
+                .arg(b)
+                .arg(a)
+                .arg(x)
+                .arg(p)
+                .arg(ax)
+                .arg(axInv)
+                .arg(b)
+                .arg(axInv)
+                .arg(p)
+                .arg(decrypted));
+        }
     }
 
     // Преобразуем числа обратно в текст
     QString resultText = numbersToText(decryptedNumbers);
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Результат: %1").arg(resultText),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Результат: %1").arg(resultText),
+            "Завершение"));
+    }
 
     // Добавляем детальные шаги
-    for (int i = 0; i < stepDetails.size() && i < 10; ++i) {
-        steps.append(CipherStep(4 + i, QChar(), stepDetails[i], QString("Шаг %1").arg(i + 1)));
+    for (int i = 0; i < encryptedPairs.size() && i < 10; ++i) {
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(4 + i, QChar(), stepDetails[i], QString("Шаг %1").arg(i + 1)));
+        }
     }
 
     result.result = resultText;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== ElGamalCipherRegister Implementation ====================
@@ -147,7 +147,8 @@ bool ElGamalSignCipher::isPrimitiveRoot(uint64_t g, uint64_t p) const
 }
 
 // ==================== Хеш-функция квадратичной свертки ====================
-uint64_t ElGamalSignCipher::computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int stepOffset) const
+uint64_t ElGamalSignCipher::computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int stepOffset,
+                                        StepTrace& trace) const
 {
     QString filtered = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
@@ -156,9 +157,11 @@ uint64_t ElGamalSignCipher::computeHash(const QString& text, uint64_t p, QVector
     uint64_t h = 0;
 
     if (steps.size() > 0) {
-        steps.append(CipherStep(stepOffset, QChar(),
-            QString("Начало вычисления хеша: h0 = 0, модуль p = %1").arg(p),
-            "Хеширование"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepOffset, QChar(),
+                QString("Начало вычисления хеша: h0 = 0, модуль p = %1").arg(p),
+                "Хеширование"));
+        }
     }
 
     for (int i = 0; i < filtered.length(); ++i) {
@@ -170,19 +173,23 @@ uint64_t ElGamalSignCipher::computeHash(const QString& text, uint64_t p, QVector
         h = (sum * sum) % p;
 
         if (steps.size() > 0) {
-            steps.append(CipherStep(stepOffset + i + 1, QChar(),
-                QString("  h%1 = (h%2 + M%3)^2 mod p = (%4 + %5)^2 mod %6 = %7^2 mod %6 = %8")
-                    .arg(i + 1).arg(i).arg(i + 1)
-                    .arg(old_h).arg(Mi).arg(p)
-                    .arg(sum).arg(h),
-                QString("Хеш шаг %1: буква '%2' (№%3)").arg(i + 1).arg(filtered[i]).arg(Mi)));
+            if (trace.want(TraceLevel::PerChar)) {
+                steps.append(CipherStep(stepOffset + i + 1, QChar(),
+                    QString("  h%1 = (h%2 + M%3)^2 mod p = (%4 + %5)^2 mod %6 = %7^2 mod %6 = %8")
+                        .arg(i + 1).arg(i).arg(i + 1)
+                        .arg(old_h).arg(Mi).arg(p)
+                        .arg(sum).arg(h),
+                    QString("Хеш шаг %1: буква '%2' (№%3)").arg(i + 1).arg(filtered[i]).arg(Mi)));
+            }
         }
     }
 
     if (steps.size() > 0) {
-        steps.append(CipherStep(stepOffset + filtered.length() + 1, QChar(),
-            QString("Итоговый хеш: H = %1").arg(h),
-            "Хеш завершен"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepOffset + filtered.length() + 1, QChar(),
+                QString("Итоговый хеш: H = %1").arg(h),
+                "Хеш завершен"));
+        }
     }
 
     return h;
@@ -361,13 +368,16 @@ uint64_t ElGamalSignCipher::generateRandomKStatic(uint64_t p)
 // ==================== Шифрование с подписью ====================
 CipherResult ElGamalSignCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = true;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало подписи ElGamal", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало подписи ElGamal", "Инициализация"));
+    }
 
     uint64_t p = params.value("p", 0).toULongLong();
     uint64_t g = params.value("g", 0).toULongLong();
@@ -375,106 +385,127 @@ CipherResult ElGamalSignCipher::encrypt(const QString& text, const QVariantMap&
     uint64_t p_hash = params.value("p_hash", 0).toULongLong();
 
     if (p == 0 || g == 0 || x == 0) {
-        result.result = "ОШИБКА: Для подписи необходимо ввести P, G и X";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Для подписи необходимо ввести P, G и X");
+        return trace.finish(result);
     }
     if (p_hash == 0) {
-        result.result = "ОШИБКА: Необходимо указать модуль хеширования p (должен быть > 32)";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Необходимо указать модуль хеширования p (должен быть > 32)");
+        return trace.finish(result);
     }
 
     QString validationError;
     if (!validateParameters(p, g, x, p_hash, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
+        return trace.finish(result);
     }
 
     uint64_t y = modPow(g, x, p);
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: P=%1, G=%2, X=%3, Y=G^X mod P=%4, p_hash=%5")
-            .arg(p).arg(g).arg(x).arg(y).arg(p_hash),
-        "Вычисление ключей"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: P=%1, G=%2, X=%3, Y=G^X mod P=%4, p_hash=%5")
+                .arg(p).arg(g).arg(x).arg(y).arg(p_hash),
+            "Вычисление ключей"));
+    }
 
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Сообщение: %1").arg(filteredText),
-        "Подготовка данных"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Сообщение: %1").arg(filteredText),
+            "Подготовка данных"));
+    }
 
     // Вычисляем хеш сообщения
     int stepCounter = 3;
-    uint64_t hash = computeHash(filteredText, p_hash, steps, stepCounter);
+    uint64_t hash = computeHash(filteredText, p_hash, steps, stepCounter, trace);
     stepCounter += filteredText.length() + 2;
 
     // Генерируем случайное K, взаимно простое с P-1
     uint64_t k = generateRandomKStatic(p);
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Сгенерирован K = %1 (взаимно простое с P-1=%2)").arg(k).arg(p - 1),
-        "Генерация K"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Сгенерирован K = %1 (взаимно простое с P-1=%2)").arg(k).arg(p - 1),
+            "Генерация K"));
+    }
 
     // Вычисляем a = G^K mod P
     uint64_t a = modPow(g, k, p);
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("a = G^K mod P = %1^%2 mod %3 = %4").arg(g).arg(k).arg(p).arg(a),
-        "Вычисление a"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("a = G^K mod P = %1^%2 mod %3 = %4").arg(g).arg(k).arg(p).arg(a),
+            "Вычисление a"));
+    }
 
     // Решаем уравнение m = X*a + K*b (mod P-1)
     uint64_t phi = p - 1;
     uint64_t k_inv = modInverse(k, phi);
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("K⁻¹ mod (P-1) = %1⁻¹ mod %2 = %3").arg(k).arg(phi).arg(k_inv),
-        "Вычисление обратного K"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("K⁻¹ mod (P-1) = %1⁻¹ mod %2 = %3").arg(k).arg(phi).arg(k_inv),
+            "Вычисление обратного K"));
+    }
 
     // Вычисляем b
     uint64_t term = (hash + phi - (x * a) % phi) % phi;
     uint64_t b = (term * k_inv) % phi;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("b = (H - X*a) * K⁻¹ mod (P-1) = (%1 - %2*%3) * %4 mod %5 = %6")
-            .arg(hash).arg(x).arg(a).arg(k_inv).arg(phi).arg(b),
-        "Вычисление b"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("b = (H - X*a) * K⁻¹ mod (P-1) = (%1 - %2*%3) * %4 mod %5 = %6")
+                .arg(hash).arg(x).arg(a).arg(k_inv).arg(phi).arg(b),
+            "Вычисление b"));
+    }
 
     // ВАЖНО: Выводим ключи для проверки в лог
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("═══════════════════════════════════════════════════════════\n"
-                "  P = %1\n  G = %2\n  Y = %3 (ОТКРЫТЫЙ КЛЮЧ)\n  p_hash = %4\n"
-                "═══════════════════════════════════════════════════════════")
-            .arg(p).arg(g).arg(y).arg(p_hash),
-        "КЛЮЧИ ДЛЯ ПРОВЕРКИ ПОДПИСИ"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("═══════════════════════════════════════════════════════════\n"
+                    "  P = %1\n  G = %2\n  Y = %3 (ОТКРЫТЫЙ КЛЮЧ)\n  p_hash = %4\n"
+                    "═══════════════════════════════════════════════════════════")
+                .arg(p).arg(g).arg(y).arg(p_hash),
+            "КЛЮЧИ ДЛЯ ПРОВЕРКИ ПОДПИСИ"));
+    }
 
     // Формируем результат: только сообщение | a b
     QString signature = QString("%1 | %2 %3").arg(filteredText).arg(a).arg(b);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Подпись: (a=%1, b=%2)").arg(a).arg(b),
-        "Создание подписи"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Подпись: (a=%1, b=%2)").arg(a).arg(b),
+            "Создание подписи"));
+    }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Результат: %1 | %2 %3").arg(filteredText).arg(a).arg(b),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Результат: %1 | %2 %3").arg(filteredText).arg(a).arg(b),
+            "Завершение"));
+    }
 
     result.result = signature;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== Расшифрование с проверкой подписи ====================
 CipherResult ElGamalSignCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = false;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало проверки подписи ElGamal", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало проверки подписи ElGamal", "Инициализация"));
+    }
 
     uint64_t p = params.value("p", 0).toULongLong();
     uint64_t g = params.value("g", 0).toULongLong();
@@ -482,32 +513,34 @@ CipherResult ElGamalSignCipher::decrypt(const QString& text, const QVariantMap&
     uint64_t p_hash = params.value("p_hash", 0).toULongLong();
 
     if (p == 0 || g == 0 || y == 0) {
-        result.result = "ОШИБКА: Не указаны P, G и открытый ключ Y";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Не указаны P, G и открытый ключ Y");
+        return trace.finish(result);
     }
     if (p_hash == 0) {
-        result.result = "ОШИБКА: Необходимо указать модуль хеширования p (должен быть > 32)";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Необходимо указать модуль хеширования p (должен быть > 32)");
+        return trace.finish(result);
     }
 
     const uint64_t ALPHABET_SIZE = 32;
     if (p_hash <= ALPHABET_SIZE) {
-        result.result = QString("ОШИБКА: Модуль хеширования p = %1 должен быть больше %2")
-                            .arg(p_hash).arg(ALPHABET_SIZE);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: Модуль хеширования p = %1 должен быть больше %2")
+                                                     .arg(p_hash).arg(ALPHABET_SIZE));
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: P=%1, G=%2, Y=%3, p_hash=%4").arg(p).arg(g).arg(y).arg(p_hash),
-        "Проверка параметров"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: P=%1, G=%2, Y=%3, p_hash=%4").arg(p).arg(g).arg(y).arg(p_hash),
+            "Проверка параметров"));
+    }
 
     // Разбираем входные данные: сообщение | a b
     QString inputText = text.trimmed();
     int separatorPos = inputText.indexOf("|");
 
     if (separatorPos == -1) {
-        result.result = "ОШИБКА: Неверный формат. Ожидается: 'сообщение | a b'";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Неверный формат. Ожидается: 'сообщение | a b'");
+        return trace.finish(result);
     }
 
     QString message = inputText.left(separatorPos).trimmed();
@@ -516,8 +549,8 @@ CipherResult ElGamalSignCipher::decrypt(const QString& text, const QVariantMap&
     QStringList parts = signaturePart.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
 
     if (parts.size() < 2) {
-        result.result = "ОШИБКА: Не удалось распознать подпись (ожидается a b)";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Не удалось распознать подпись (ожидается a b)");
+        return trace.finish(result);
     }
 
     bool aOk, bOk;
@@ -525,21 +558,25 @@ CipherResult ElGamalSignCipher::decrypt(const QString& text, const QVariantMap&
     uint64_t b = parts[1].toULongLong(&bOk);
 
     if (!aOk || !bOk) {
-        result.result = "ОШИБКА: Не удалось распознать числа a и b";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Не удалось распознать числа a и b");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Получена подпись: a=%1, b=%2").arg(a).arg(b),
-        "Извлечение подписи"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Получена подпись: a=%1, b=%2").arg(a).arg(b),
+            "Извлечение подписи"));
+    }
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Сообщение: %1").arg(message),
-        "Извлечение сообщения"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Сообщение: %1").arg(message),
+            "Извлечение сообщения"));
+    }
 
     // Вычисляем хеш сообщения
     int stepCounter = 4;
-    uint64_t hash = computeHash(message, p_hash, steps, stepCounter);
+    uint64_t hash = computeHash(message, p_hash, steps, stepCounter, trace);
     stepCounter += message.length() + 2;
 
     // Вычисляем A1 = Y^a * a^b mod P
@@ -547,33 +584,41 @@ CipherResult ElGamalSignCipher::decrypt(const QString& text, const QVariantMap&
     uint64_t ab = modPow(a, b, p);
     uint64_t A1 = (ya * ab) % p;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("A1 = Y^a * a^b mod P = %1^%2 * %3^%4 mod %5 = %6 * %7 mod %5 = %8")
-            .arg(y).arg(a).arg(a).arg(b).arg(p).arg(ya).arg(ab).arg(A1),
-        "Вычисление A1"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("A1 = Y^a * a^b mod P = %1^%2 * %3^%4 mod %5 = %6 * %7 mod %5 = %8")
+                .arg(y).arg(a).arg(a).arg(b).arg(p).arg(ya).arg(ab).arg(A1),
+            "Вычисление A1"));
+    }
 
     // Вычисляем A2 = G^m mod P
     uint64_t A2 = modPow(g, hash, p);
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("A2 = G^H mod P = %1^%2 mod %3 = %4")
-            .arg(g).arg(hash).arg(p).arg(A2),
-        "Вычисление A2"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("A2 = G^H mod P = %1^%2 mod %3 = %4")
+                .arg(g).arg(hash).arg(p).arg(A2),
+            "Вычисление A2"));
+    }
 
     // Проверка
     if (A1 == A2) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("✓ Подпись ВЕРНА! A1 (%1) == A2 (%2)").arg(A1).arg(A2),
-            "Проверка подписи - УСПЕШНО"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("✓ Подпись ВЕРНА! A1 (%1) == A2 (%2)").arg(A1).arg(A2),
+                "Проверка подписи - УСПЕШНО"));
+        }
         result.result = QString("%1").arg(message);
     } else {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("✗ Подпись НЕВЕРНА! A1 = %1 != A2 = %2").arg(A1).arg(A2),
-            "Проверка подписи - ОШИБКА"));
-        result.result = QString("ОШИБКА ПОДПИСИ: A1 = %1 != A2 = %2").arg(A1).arg(A2);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("✗ Подпись НЕВЕРНА! A1 = %1 != A2 = %2").arg(A1).arg(A2),
+                "Проверка подписи - ОШИБКА"));
+        }
+        result.fail(CipherStatus::VerificationFailed, QString("ОШИБКА ПОДПИСИ: A1 = %1 != A2 = %2").arg(A1).arg(A2));
     }
 
     result.steps = steps;
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== ElGamalSignCipherRegister Implementation ====================
@@ -41,10 +41,11 @@ public:
     bool isPrimitiveRoot(uint64_t g, uint64_t p) const;
 
     // Хеш-функция квадратичной свертки
-    uint64_t computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int stepOffset) const;
+    uint64_t computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int stepOffset,
+                         StepTrace& trace) const;
 
 private:
-    const QString m_alphabet = "АБВГДЕЖЗИКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    const Alphabet& m_alphabet = Alphabet::russianWithoutShortI();
 
     // Проверка параметров
     bool validateParameters(uint64_t p, uint64_t g, uint64_t x, uint64_t p_hash, QString& errorMessage) const;
@@ -507,7 +507,8 @@ BigInt GOST34102012Cipher::parseBigInt(const QString& str) const {
 }
 
 BigInt GOST34102012Cipher::computeHash(const QString& text, const BigInt& p,
-                                        QVector<CipherStep>& steps, int& stepCounter) const {
+                                        QVector<CipherStep>& steps, int& stepCounter,
+                                        StepTrace& trace) const {
     QString filtered = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filtered.isEmpty()) return BigInt(0);
@@ -517,9 +518,11 @@ BigInt GOST34102012Cipher::computeHash(const QString& text, const BigInt& p,
 
     uint64_t h = 0;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Начало вычисления хеша: h0 = 0, модуль p = %1").arg(mod),
-        "Хеширование"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Начало вычисления хеша: h0 = 0, модуль p = %1").arg(mod),
+            "Хеширование"));
+    }
 
     for (int i = 0; i < filtered.length(); ++i) {
         int charIndex = m_alphabet.indexOf(filtered[i]);
@@ -529,17 +532,21 @@ BigInt GOST34102012Cipher::computeHash(const QString& text, const BigInt& p,
         uint64_t sum = (h + Mi) % mod;
         h = (sum * sum) % mod;
 
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("  h%1 = (h%2 + M%3)² mod p = (%4 + %5)² mod %6 = %7² mod %6 = %8")
-                .arg(i + 1).arg(i).arg(i + 1)
-                .arg(old_h).arg(Mi).arg(mod)
-                .arg(sum).arg(h),
-            QString("Хеш шаг %1: буква '%2' (№%3)").arg(i + 1).arg(filtered[i]).arg(Mi)));
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("  h%1 = (h%2 + M%3)² mod p = (%4 + %5)² mod %6 = %7² mod %6 = %8")
+                    .arg(i + 1).arg(i).arg(i + 1)
+                    .arg(old_h).arg(Mi).arg(mod)
+                    .arg(sum).arg(h),
+                QString("Хеш шаг %1: буква '%2' (№%3)").arg(i + 1).arg(filtered[i]).arg(Mi)));
+        }
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Итоговый хеш: H = %1").arg(h),
-        "Хеш завершен"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Итоговый хеш: H = %1").arg(h),
+            "Хеш завершен"));
+    }
 
     return BigInt(h);
 }
@@ -592,6 +599,7 @@ bool GOST34102012Cipher::validateParameters(const BigInt& p, const BigInt& a, co
 // ==================== Шифрование (создание подписи) ====================
 CipherResult GOST34102012Cipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -599,7 +607,9 @@ CipherResult GOST34102012Cipher::encrypt(const QString& text, const QVariantMap&
 
     QVector<CipherStep> steps;
     int stepCounter = 0;
-    steps.append(CipherStep(stepCounter++, QChar(), "Начало формирования подписи по ГОСТ Р 34.10-2012", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(), "Начало формирования подписи по ГОСТ Р 34.10-2012", "Инициализация"));
+    }
 
     // Получаем параметры из виджетов
     QString pStr = params.value("p", "").toString();
@@ -613,8 +623,8 @@ CipherResult GOST34102012Cipher::encrypt(const QString& text, const QVariantMap&
     // Проверка наличия всех параметров
     if (pStr.isEmpty() || aStr.isEmpty() || bStr.isEmpty() || qStr.isEmpty() ||
         xpStr.isEmpty() || ypStr.isEmpty() || dStr.isEmpty() || kStr.isEmpty()) {
-        result.result = "ОШИБКА: Необходимо указать все параметры (p, a, b, q, xp, yp, d, k)";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Необходимо указать все параметры (p, a, b, q, xp, yp, d, k)");
+        return trace.finish(result);
     }
 
     BigInt p = parseBigInt(pStr);
@@ -630,54 +640,66 @@ CipherResult GOST34102012Cipher::encrypt(const QString& text, const QVariantMap&
 
     ECPoint Q = pointMul(d, G, p, a);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Открытый ключ Q = d·G = (%1, %2)")
-            .arg(Q.x.toDecQString()).arg(Q.y.toDecQString()),
-        "Вычисление Q"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Открытый ключ Q = d·G = (%1, %2)")
+                .arg(Q.x.toDecQString()).arg(Q.y.toDecQString()),
+            "Вычисление Q"));
+    }
 
     // Проверка параметров
     QString validationError;
     if (!validateParameters(p, a, b, q, G, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Параметры эллиптической кривой:\n  p = %1\n  a = %2\n  b = %3\n  q = %4\n  G = (%5, %6)\n  d = %7\n  k = %8")
-            .arg(p.toDecQString()).arg(a.toDecQString()).arg(b.toDecQString())
-            .arg(q.toDecQString()).arg(xp.toDecQString()).arg(yp.toDecQString())
-            .arg(d.toDecQString()).arg(k.toDecQString()),
-        "Параметры схемы"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Параметры эллиптической кривой:\n  p = %1\n  a = %2\n  b = %3\n  q = %4\n  G = (%5, %6)\n  d = %7\n  k = %8")
+                .arg(p.toDecQString()).arg(a.toDecQString()).arg(b.toDecQString())
+                .arg(q.toDecQString()).arg(xp.toDecQString()).arg(yp.toDecQString())
+                .arg(d.toDecQString()).arg(k.toDecQString()),
+            "Параметры схемы"));
+    }
 
     // Шаг 1: Вычисляем хеш сообщения
-    BigInt hash = computeHash(text, p, steps, stepCounter);
+    BigInt hash = computeHash(text, p, steps, stepCounter, trace);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 1: h(M) = %1").arg(hash.toDecQString()),
-        "Хеш сообщения"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 1: h(M) = %1").arg(hash.toDecQString()),
+            "Хеш сообщения"));
+    }
 
     // Шаг 2: Вычисляем точку C = kG
     ECPoint C = pointMul(k, G, p, a);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 2: C = k·G = (%1, %2)").arg(C.x.toDecQString()).arg(C.y.toDecQString()),
-        "Вычисление точки C"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 2: C = k·G = (%1, %2)").arg(C.x.toDecQString()).arg(C.y.toDecQString()),
+            "Вычисление точки C"));
+    }
 
     // Шаг 3: Вычисляем r = x_C mod q
     BigInt r = C.x % q;
 
     if (r.isZero()) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            "r = 0, необходимо выбрать другое k",
-            "Ошибка: r = 0"));
-        result.result = "ОШИБКА: r = 0, выберите другое k";
-        return result;
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                "r = 0, необходимо выбрать другое k",
+                "Ошибка: r = 0"));
+        }
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: r = 0, выберите другое k");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 3: r = x_C mod q = %1 mod %2 = %3")
-            .arg(C.x.toDecQString()).arg(q.toDecQString()).arg(r.toDecQString()),
-        "Вычисление r"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 3: r = x_C mod q = %1 mod %2 = %3")
+                .arg(C.x.toDecQString()).arg(q.toDecQString()).arg(r.toDecQString()),
+            "Вычисление r"));
+    }
 
     // Шаг 4: Вычисляем s = (k·h + r·d) mod q
     BigInt kh = (k * hash) % q;
@@ -685,37 +707,44 @@ CipherResult GOST34102012Cipher::encrypt(const QString& text, const QVariantMap&
     BigInt s = (kh + rd) % q;
 
     if (s.isZero()) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            "s = 0, необходимо выбрать другое k",
-            "Ошибка: s = 0"));
-        result.result = "ОШИБКА: s = 0, выберите другое k";
-        return result;
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                "s = 0, необходимо выбрать другое k",
+                "Ошибка: s = 0"));
+        }
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: s = 0, выберите другое k");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 4: s = (k·h + r·d) mod q = (%1·%2 + %3·%4) mod %5 = %6")
-            .arg(k.toDecQString()).arg(hash.toDecQString())
-            .arg(r.toDecQString()).arg(d.toDecQString())
-            .arg(q.toDecQString()).arg(s.toDecQString()),
-        "Вычисление s"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 4: s = (k·h + r·d) mod q = (%1·%2 + %3·%4) mod %5 = %6")
+                .arg(k.toDecQString()).arg(hash.toDecQString())
+                .arg(r.toDecQString()).arg(d.toDecQString())
+                .arg(q.toDecQString()).arg(s.toDecQString()),
+            "Вычисление s"));
+    }
 
     // Формируем подпись
     QString signature = QString("(%1, %2)").arg(r.toDecQString()).arg(s.toDecQString());
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Цифровая подпись: (r, s) = %1").arg(signature),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Цифровая подпись: (r, s) = %1").arg(signature),
+            "Завершение"));
+    }
 
     result.result = signature;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== Расшифрование (проверка подписи) ====================
 
 CipherResult GOST34102012Cipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -723,7 +752,9 @@ CipherResult GOST34102012Cipher::decrypt(const QString& text, const QVariantMap&
 
     QVector<CipherStep> steps;
     int stepCounter = 0;
-    steps.append(CipherStep(stepCounter++, QChar(), "Начало проверки подписи по ГОСТ Р 34.10-2012", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(), "Начало проверки подписи по ГОСТ Р 34.10-2012", "Инициализация"));
+    }
 
     // Получаем параметры
     QString pStr = params.value("p", "").toString();
@@ -739,13 +770,13 @@ CipherResult GOST34102012Cipher::decrypt(const QString& text, const QVariantMap&
 
     if (pStr.isEmpty() || qStr.isEmpty() || xpStr.isEmpty() || ypStr.isEmpty() ||
         xqStr.isEmpty() || yqStr.isEmpty()) {
-        result.result = "ОШИБКА: Необходимо указать все параметры (p, a, b, q, xp, yp, xq, yq)";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Необходимо указать все параметры (p, a, b, q, xp, yp, xq, yq)");
+        return trace.finish(result);
     }
 
     if (message.isEmpty()) {
-        result.result = "ОШИБКА: Укажите сообщение для проверки подписи";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Укажите сообщение для проверки подписи");
+        return trace.finish(result);
     }
 
     BigInt p = parseBigInt(pStr);
@@ -760,12 +791,14 @@ CipherResult GOST34102012Cipher::decrypt(const QString& text, const QVariantMap&
     ECPoint G(xp, yp);
     ECPoint Q(xq, yq);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Параметры:\n  p = %1\n  q = %2\n  G = (%3, %4)\n  Q = (%5, %6)")
-            .arg(p.toDecQString()).arg(q.toDecQString())
-            .arg(xp.toDecQString()).arg(yp.toDecQString())
-            .arg(xq.toDecQString()).arg(yq.toDecQString()),
-        "Параметры схемы"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Параметры:\n  p = %1\n  q = %2\n  G = (%3, %4)\n  Q = (%5, %6)")
+                .arg(p.toDecQString()).arg(q.toDecQString())
+                .arg(xp.toDecQString()).arg(yp.toDecQString())
+                .arg(xq.toDecQString()).arg(yq.toDecQString()),
+            "Параметры схемы"));
+    }
 
     // Парсим подпись
     QString sig = text.trimmed();
@@ -773,68 +806,86 @@ CipherResult GOST34102012Cipher::decrypt(const QString& text, const QVariantMap&
     QStringList parts = sig.split(',');
 
     if (parts.size() != 2) {
-        result.result = "ОШИБКА: Неверный формат подписи (ожидается r,s)";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Неверный формат подписи (ожидается r,s)");
+        return trace.finish(result);
     }
 
     BigInt r = parseBigInt(parts[0].trimmed());
     BigInt s = parseBigInt(parts[1].trimmed());
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Подпись: r = %1, s = %2").arg(r.toDecQString()).arg(s.toDecQString()),
-        "Извлечение подписи"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Подпись: r = %1, s = %2").arg(r.toDecQString()).arg(s.toDecQString()),
+            "Извлечение подписи"));
+    }
 
     // Проверка 0 < r < q и 0 < s < q
     if (r.isZero() || r >= q || s.isZero() || s >= q) {
-        result.result = "ОШИБКА: Неверные значения подписи (0 < r,s < q)";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Неверные значения подписи (0 < r,s < q)");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(), "Шаг 1: 0 < r < q и 0 < s < q — выполнено", "Проверка"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(), "Шаг 1: 0 < r < q и 0 < s < q — выполнено", "Проверка"));
+    }
 
     // Хеш сообщения
-    BigInt hash = computeHash(message, p, steps, stepCounter);
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 2: h(M) = %1").arg(hash.toDecQString()), "Хеш"));
+    BigInt hash = computeHash(message, p, steps, stepCounter, trace);
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 2: h(M) = %1").arg(hash.toDecQString()), "Хеш"));
+    }
 
     // h⁻¹ mod q
     BigInt h_inv = hash.modInverse(q);
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 3: h⁻¹ mod q = %1").arg(h_inv.toDecQString()), "Обратный элемент"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 3: h⁻¹ mod q = %1").arg(h_inv.toDecQString()), "Обратный элемент"));
+    }
 
     // u1 и u2
     BigInt u1 = (s * h_inv) % q;
     BigInt u2 = (q - (r * h_inv) % q) % q;
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 4: u1 = %1, u2 = %2").arg(u1.toDecQString()).arg(u2.toDecQString()),
-        "Вычисление u1, u2"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 4: u1 = %1, u2 = %2").arg(u1.toDecQString()).arg(u2.toDecQString()),
+            "Вычисление u1, u2"));
+    }
 
     // P = u1·G + u2·Q
     ECPoint P1 = pointMul(u1, G, p, a);
     ECPoint P2 = pointMul(u2, Q, p, a);
     ECPoint P = pointAdd(P1, P2, p, a);
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 5: P = (%1, %2)").arg(P.x.toDecQString()).arg(P.y.toDecQString()),
-        "Точка P"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 5: P = (%1, %2)").arg(P.x.toDecQString()).arg(P.y.toDecQString()),
+            "Точка P"));
+    }
 
     // R = x_P mod q
     BigInt R = P.x % q;
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 6: R = %1").arg(R.toDecQString()), "Вычисление R"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 6: R = %1").arg(R.toDecQString()), "Вычисление R"));
+    }
 
     // Проверка
     if (R == r) {
-        steps.append(CipherStep(stepCounter++, QChar(), "✓ Подпись ВЕРНА!", "Успех"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(), "✓ Подпись ВЕРНА!", "Успех"));
+        }
         result.result = QString("✓ ПОДПИСЬ ВЕРНА!\n\nСообщение: %1\nr = %2\ns = %3")
             .arg(message).arg(r.toDecQString()).arg(s.toDecQString());
     } else {
-        steps.append(CipherStep(stepCounter++, QChar(), "✗ Подпись НЕВЕРНА!", "Ошибка"));
-        result.result = QString("✗ ПОДПИСЬ НЕВЕРНА!\nR = %1\nr = %2")
-            .arg(R.toDecQString()).arg(r.toDecQString());
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(), "✗ Подпись НЕВЕРНА!", "Ошибка"));
+        }
+        result.fail(CipherStatus::VerificationFailed, QString("✗ ПОДПИСЬ НЕВЕРНА!\nR = %1\nr = %2")
+            .arg(R.toDecQString()).arg(r.toDecQString()));
     }
 
     result.steps = steps;
-    return result;
+    return trace.finish(result);
 }
 // ==================== Статические методы ====================
 
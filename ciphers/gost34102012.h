@@ -98,13 +98,14 @@ public:
     static ECPoint pointMul(const BigInt& k, const ECPoint& P, const BigInt& p, const BigInt& a);
 
     // Хеш-функция квадратичной свертки
-    BigInt computeHash(const QString& text, const BigInt& p, QVector<CipherStep>& steps, int& stepCounter) const;
+    BigInt computeHash(const QString& text, const BigInt& p, QVector<CipherStep>& steps, int& stepCounter,
+                       StepTrace& trace) const;
     static void computeCurveOrder(const BigInt& p, const BigInt& a, const BigInt& b,
                                   BigInt& curveOrder, BigInt& subgroupOrder, BigInt& cofactor,
                                   QString& log);
 
 private:
-    const QString m_alphabet = "АБВГДЕЖЗИКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    const Alphabet& m_alphabet = Alphabet::russianWithoutShortI();
 
     // Преобразование текста в числа
     QVector<uint64_t> textToNumbers(const QString& text) const;
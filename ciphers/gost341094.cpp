@@ -185,7 +185,8 @@ uint64_t GOST341094Cipher::generateRandomStatic(uint64_t max)
 // ==================== Хеш-функция ====================
 
 uint64_t GOST341094Cipher::computeHash(const QString& text, uint64_t p,
-                                        QVector<CipherStep>& steps, int& stepCounter) const
+                                        QVector<CipherStep>& steps, int& stepCounter,
+                                        StepTrace& trace) const
 {
     QString filtered = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
@@ -196,9 +197,11 @@ uint64_t GOST341094Cipher::computeHash(const QString& text, uint64_t p,
 
     uint64_t h = 0;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Начало вычисления хеша: h0 = 0, модуль p = %1").arg(mod),
-        "Хеширование"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Начало вычисления хеша: h0 = 0, модуль p = %1").arg(mod),
+            "Хеширование"));
+    }
 
     for (int i = 0; i < filtered.length(); ++i) {
         int charIndex = m_alphabet.indexOf(filtered[i]);
@@ -208,16 +211,20 @@ uint64_t GOST341094Cipher::computeHash(const QString& text, uint64_t p,
         uint64_t sum = (h + Mi) % mod;
         h = (sum * sum) % mod;
 
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("  h%1 = (h%2 + M%3)² mod %4 = (%5 + %6)² mod %4 = %7² mod %4 = %8")
-                .arg(i + 1).arg(i).arg(i + 1)
-                .arg(mod).arg(old_h).arg(Mi).arg(sum).arg(h),
-            QString("Хеш шаг %1: буква '%2' (№%3)").arg(i + 1).arg(filtered[i]).arg(Mi)));
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("  h%1 = (h%2 + M%3)² mod %4 = (%5 + %6)² mod %4 = %7² mod %4 = %8")
+                    .arg(i + 1).arg(i).arg(i + 1)
+                    .arg(mod).arg(old_h).arg(Mi).arg(sum).arg(h),
+                QString("Хеш шаг %1: буква '%2' (№%3)").arg(i + 1).arg(filtered[i]).arg(Mi)));
+        }
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Итоговый хеш: H = %1").arg(h),
-        "Хеш завершен"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Итоговый хеш: H = %1").arg(h),
+            "Хеш завершен"));
+    }
 
     return h;
 }
@@ -301,6 +308,7 @@ bool GOST341094Cipher::validateParameters(uint64_t p, uint64_t q, uint64_t a, ui
 
 CipherResult GOST341094Cipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -308,7 +316,9 @@ CipherResult GOST341094Cipher::encrypt(const QString& text, const QVariantMap& p
 
     QVector<CipherStep> steps;
     int stepCounter = 0;
-    steps.append(CipherStep(stepCounter++, QChar(), "Начало формирования подписи по ГОСТ Р 34.10-94", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(), "Начало формирования подписи по ГОСТ Р 34.10-94", "Инициализация"));
+    }
 
     // Получаем параметры
     uint64_t p = params.value("p", 0).toULongLong();
@@ -319,66 +329,78 @@ CipherResult GOST341094Cipher::encrypt(const QString& text, const QVariantMap& p
     uint64_t p_hash = params.value("p_hash", 101).toULongLong();
 
     if (p == 0 || q == 0 || a == 0 || x == 0 || k == 0) {
-        result.result = "ОШИБКА: Необходимо указать все параметры (p, q, a, x, k)";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Необходимо указать все параметры (p, q, a, x, k)");
+        return trace.finish(result);
     }
 
     // Проверка параметров
     QString validationError;
     if (!validateParameters(p, q, a, x, k, p_hash, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Параметры схемы:\n  p = %1 (простое)\n  q = %2 (простое, делитель p-1)\n  a = %3 (a^q mod p = 1)\n  x = %4 (секретный ключ)\n  k = %5 (случайное число)\n  p_hash = %6 (модуль хеширования)")
-            .arg(p).arg(q).arg(a).arg(x).arg(k).arg(p_hash),
-        "Параметры схемы"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Параметры схемы:\n  p = %1 (простое)\n  q = %2 (простое, делитель p-1)\n  a = %3 (a^q mod p = 1)\n  x = %4 (секретный ключ)\n  k = %5 (случайное число)\n  p_hash = %6 (модуль хеширования)")
+                .arg(p).arg(q).arg(a).arg(x).arg(k).arg(p_hash),
+            "Параметры схемы"));
+    }
 
     // Фильтруем текст
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Сообщение: %1").arg(filteredText),
-        "Сообщение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Сообщение: %1").arg(filteredText),
+            "Сообщение"));
+    }
 
     // Шаг 1: Вычисляем хеш сообщения H(m)
-    uint64_t hash = computeHash(filteredText, p_hash, steps, stepCounter);
+    uint64_t hash = computeHash(filteredText, p_hash, steps, stepCounter, trace);
 
     // Коррекция: если H(m) mod q = 0, то H(m) = 1
     uint64_t hm = hash % q;
     if (hm == 0) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("H(m) mod q = 0, устанавливаем H(m) = 1"),
-            "Коррекция хеша"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("H(m) mod q = 0, устанавливаем H(m) = 1"),
+                "Коррекция хеша"));
+        }
         hm = 1;
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 1: H(m) = %1, H(m) mod q = %2").arg(hash).arg(hm),
-        "Вычисление хеша"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 1: H(m) = %1, H(m) mod q = %2").arg(hash).arg(hm),
+            "Вычисление хеша"));
+    }
 
     // Шаг 2: Вычисляем r = (a^k mod p) mod q
     uint64_t ak = modPow(a, k, p);
     uint64_t r = ak % q;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 2: r = (a^k mod p) mod q = (%1^%2 mod %3) mod %4 = %5 mod %6 = %7")
-            .arg(a).arg(k).arg(p).arg(q).arg(ak).arg(q).arg(r),
-        "Вычисление r"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 2: r = (a^k mod p) mod q = (%1^%2 mod %3) mod %4 = %5 mod %6 = %7")
+                .arg(a).arg(k).arg(p).arg(q).arg(ak).arg(q).arg(r),
+            "Вычисление r"));
+    }
 
     // Проверка: если r == 0, нужно выбрать другое k
     if (r == 0) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            "r = 0, необходимо выбрать другое k",
-            "Ошибка"));
-        result.result = "ОШИБКА: r = 0. Выберите другое значение k";
-        return result;
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                "r = 0, необходимо выбрать другое k",
+                "Ошибка"));
+        }
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: r = 0. Выберите другое значение k");
+        return trace.finish(result);
     }
 
     // Шаг 3: Вычисляем s = (x * r + k * H(m)) mod q
@@ -386,49 +408,60 @@ CipherResult GOST341094Cipher::encrypt(const QString& text, const QVariantMap& p
     uint64_t khm = (k * hm) % q;
     uint64_t s = (xr + khm) % q;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 3: s = (x*r + k*H(m)) mod q = (%1*%2 + %3*%4) mod %5 = (%6 + %7) mod %5 = %8")
-            .arg(x).arg(r).arg(k).arg(hm).arg(q).arg(xr).arg(khm).arg(s),
-        "Вычисление s"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 3: s = (x*r + k*H(m)) mod q = (%1*%2 + %3*%4) mod %5 = (%6 + %7) mod %5 = %8")
+                .arg(x).arg(r).arg(k).arg(hm).arg(q).arg(xr).arg(khm).arg(s),
+            "Вычисление s"));
+    }
 
     // Проверка: если s == 0, нужно выбрать другое k
     if (s == 0) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            "s = 0, необходимо выбрать другое k",
-            "Ошибка"));
-        result.result = "ОШИБКА: s = 0. Выберите другое значение k";
-        return result;
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                "s = 0, необходимо выбрать другое k",
+                "Ошибка"));
+        }
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: s = 0. Выберите другое значение k");
+        return trace.finish(result);
     }
 
     // Вычисляем y = a^x mod p (открытый ключ)
     uint64_t y = modPow(a, x, p);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Открытый ключ: y = a^x mod p = %1^%2 mod %3 = %4")
-            .arg(a).arg(x).arg(p).arg(y),
-        "Вычисление y"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Открытый ключ: y = a^x mod p = %1^%2 mod %3 = %4")
+                .arg(a).arg(x).arg(p).arg(y),
+            "Вычисление y"));
+    }
 
     // Формируем результат: подпись (r, s)
     QString signature = QString("%1 %2").arg(r).arg(s);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Цифровая подпись: (r = %1, s = %2)").arg(r).arg(s),
-        "Подпись"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Цифровая подпись: (r = %1, s = %2)").arg(r).arg(s),
+            "Подпись"));
+    }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Для проверки подписи необходимы: p=%1, q=%2, a=%3, y=%4").arg(p).arg(q).arg(a).arg(y),
-        "Информация для проверки"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Для проверки подписи необходимы: p=%1, q=%2, a=%3, y=%4").arg(p).arg(q).arg(a).arg(y),
+            "Информация для проверки"));
+    }
 
     result.result = signature;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== Расшифрование (проверка подписи) ====================
 
 CipherResult GOST341094Cipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -436,7 +469,9 @@ CipherResult GOST341094Cipher::decrypt(const QString& text, const QVariantMap& p
 
     QVector<CipherStep> steps;
     int stepCounter = 0;
-    steps.append(CipherStep(stepCounter++, QChar(), "Начало проверки подписи по ГОСТ Р 34.10-94", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(), "Начало проверки подписи по ГОСТ Р 34.10-94", "Инициализация"));
+    }
 
     // Получаем параметры
     uint64_t p = params.value("p", 0).toULongLong();
@@ -449,31 +484,35 @@ CipherResult GOST341094Cipher::decrypt(const QString& text, const QVariantMap& p
     QString message = params.value("message", "").toString();
 
     if (p == 0 || q == 0 || a == 0 || y == 0) {
-        result.result = "ОШИБКА: Необходимо указать параметры p, q, a, y";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Необходимо указать параметры p, q, a, y");
+        return trace.finish(result);
     }
 
     if (message.isEmpty()) {
-        result.result = "ОШИБКА: Для проверки подписи необходимо указать сообщение в поле 'Сообщение для проверки'";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Для проверки подписи необходимо указать сообщение в поле 'Сообщение для проверки'");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Параметры проверки:\n  p = %1\n  q = %2\n  a = %3\n  y = %4 (открытый ключ)\n  p_hash = %5")
-            .arg(p).arg(q).arg(a).arg(y).arg(p_hash),
-        "Параметры"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Параметры проверки:\n  p = %1\n  q = %2\n  a = %3\n  y = %4 (открытый ключ)\n  p_hash = %5")
+                .arg(p).arg(q).arg(a).arg(y).arg(p_hash),
+            "Параметры"));
+    }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Сообщение для проверки: %1").arg(message),
-        "Сообщение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Сообщение для проверки: %1").arg(message),
+            "Сообщение"));
+    }
 
     // Разбираем подпись (r и s)
     QString sig = text.trimmed();
     QStringList parts = sig.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
 
     if (parts.size() < 2) {
-        result.result = "ОШИБКА: Неверный формат подписи. Ожидается: r s";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Неверный формат подписи. Ожидается: r s");
+        return trace.finish(result);
     }
 
     bool rOk, sOk;
@@ -481,72 +520,88 @@ CipherResult GOST341094Cipher::decrypt(const QString& text, const QVariantMap& p
     uint64_t s = parts[1].toULongLong(&sOk);
 
     if (!rOk || !sOk) {
-        result.result = "ОШИБКА: Не удалось распознать r и s";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Не удалось распознать r и s");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Получена подпись: r = %1, s = %2").arg(r).arg(s),
-        "Извлечение подписи"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Получена подпись: r = %1, s = %2").arg(r).arg(s),
+            "Извлечение подписи"));
+    }
 
     // Шаг 1: Проверка 0 < r < q и 0 < s < q
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 1: Проверка диапазона: 0 < r < q и 0 < s < q"),
-        "Проверка диапазона"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 1: Проверка диапазона: 0 < r < q и 0 < s < q"),
+            "Проверка диапазона"));
+    }
 
     if (r == 0 || r >= q) {
-        result.result = QString("ОШИБКА: r = %1 не удовлетворяет условию 0 < r < q = %2").arg(r).arg(q);
-        return result;
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: r = %1 не удовлетворяет условию 0 < r < q = %2").arg(r).arg(q));
+        return trace.finish(result);
     }
 
     if (s == 0 || s >= q) {
-        result.result = QString("ОШИБКА: s = %1 не удовлетворяет условию 0 < s < q = %2").arg(s).arg(q);
-        return result;
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: s = %1 не удовлетворяет условию 0 < s < q = %2").arg(s).arg(q));
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        "Условия выполнены: 0 < r < q и 0 < s < q",
-        "Проверка диапазона - OK"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            "Условия выполнены: 0 < r < q и 0 < s < q",
+            "Проверка диапазона - OK"));
+    }
 
     // Шаг 2: Вычисляем хеш сообщения H(m)
-    uint64_t hash = computeHash(message, p_hash, steps, stepCounter);
+    uint64_t hash = computeHash(message, p_hash, steps, stepCounter, trace);
 
     uint64_t hm = hash % q;
     if (hm == 0) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("H(m) mod q = 0, устанавливаем H(m) = 1"),
-            "Коррекция хеша"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("H(m) mod q = 0, устанавливаем H(m) = 1"),
+                "Коррекция хеша"));
+        }
         hm = 1;
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 2: H(m) = %1, H(m) mod q = %2").arg(hash).arg(hm),
-        "Вычисление хеша"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 2: H(m) = %1, H(m) mod q = %2").arg(hash).arg(hm),
+            "Вычисление хеша"));
+    }
 
     // Шаг 3: Вычисляем v = H(m)^(q-2) mod q
     uint64_t v = modPow(hm, q - 2, q);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 3: v = H(m)^(q-2) mod q = %1^(%2-2) mod %3 = %4")
-            .arg(hm).arg(q).arg(q).arg(v),
-        "Вычисление v"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 3: v = H(m)^(q-2) mod q = %1^(%2-2) mod %3 = %4")
+                .arg(hm).arg(q).arg(q).arg(v),
+            "Вычисление v"));
+    }
 
     // Шаг 4: Вычисляем z1 = s * v mod q
     uint64_t z1 = (s * v) % q;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 4: z1 = s * v mod q = %1 * %2 mod %3 = %4")
-            .arg(s).arg(v).arg(q).arg(z1),
-        "Вычисление z1"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 4: z1 = s * v mod q = %1 * %2 mod %3 = %4")
+                .arg(s).arg(v).arg(q).arg(z1),
+            "Вычисление z1"));
+    }
 
     // Шаг 5: Вычисляем z2 = (q - r) * v mod q
     uint64_t q_minus_r = (q - r) % q;
     uint64_t z2 = (q_minus_r * v) % q;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 5: z2 = (q - r) * v mod q = (%1 - %2) * %3 mod %4 = %5 * %3 mod %4 = %6")
-            .arg(q).arg(r).arg(v).arg(q).arg(q_minus_r).arg(z2),
-        "Вычисление z2"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 5: z2 = (q - r) * v mod q = (%1 - %2) * %3 mod %4 = %5 * %3 mod %4 = %6")
+                .arg(q).arg(r).arg(v).arg(q).arg(q_minus_r).arg(z2),
+            "Вычисление z2"));
+    }
 
     // Шаг 6: Вычисляем u = (a^z1 * y^z2 mod p) mod q
     uint64_t a_z1 = modPow(a, z1, p);
@@ -554,32 +609,40 @@ CipherResult GOST341094Cipher::decrypt(const QString& text, const QVariantMap& p
     uint64_t product = (a_z1 * y_z2) % p;
     uint64_t u = product % q;
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 6:\n  a^z1 mod p = %1^%2 mod %3 = %4\n  y^z2 mod p = %5^%6 mod %7 = %8\n  (a^z1 * y^z2) mod p = %9\n  u = (%9) mod q = %10")
-            .arg(a).arg(z1).arg(p).arg(a_z1)
-            .arg(y).arg(z2).arg(p).arg(y_z2)
-            .arg(product).arg(u),
-        "Вычисление u"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 6:\n  a^z1 mod p = %1^%2 mod %3 = %4\n  y^z2 mod p = %5^%6 mod %7 = %8\n  (a^z1 * y^z2) mod p = %9\n  u = (%9) mod q = %10")
+                .arg(a).arg(z1).arg(p).arg(a_z1)
+                .arg(y).arg(z2).arg(p).arg(y_z2)
+                .arg(product).arg(u),
+            "Вычисление u"));
+    }
 
     // Шаг 7: Проверка u == r
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Шаг 7: Сравнение u и r: u = %1, r = %2").arg(u).arg(r),
-        "Проверка подписи"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Шаг 7: Сравнение u и r: u = %1, r = %2").arg(u).arg(r),
+            "Проверка подписи"));
+    }
 
     if (u == r) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("✓ Подпись ВЕРНА! u (%1) == r (%2)").arg(u).arg(r),
-            "Проверка подписи - УСПЕШНО"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("✓ Подпись ВЕРНА! u (%1) == r (%2)").arg(u).arg(r),
+                "Проверка подписи - УСПЕШНО"));
+        }
         result.result = QString("✓ ПОДПИСЬ ВЕРНА!\n\nСообщение: %1").arg(message);
     } else {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("✗ Подпись НЕВЕРНА! u = %1, r = %2").arg(u).arg(r),
-            "Проверка подписи - ОШИБКА"));
-        result.result = QString("✗ ПОДПИСЬ НЕВЕРНА!\nu = %1\nr = %2").arg(u).arg(r);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("✗ Подпись НЕВЕРНА! u = %1, r = %2").arg(u).arg(r),
+                "Проверка подписи - ОШИБКА"));
+        }
+        result.fail(CipherStatus::VerificationFailed, QString("✗ ПОДПИСЬ НЕВЕРНА!\nu = %1\nr = %2").arg(u).arg(r));
     }
 
     result.steps = steps;
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== Регистратор ====================
@@ -38,10 +38,11 @@ public:
     bool isPrime(uint64_t n, int k = 10) const;
 
     // Хеш-функция квадратичной свертки
-    uint64_t computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int& stepCounter) const;
+    uint64_t computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int& stepCounter,
+                         StepTrace& trace) const;
 
 private:
-    const QString m_alphabet = "АБВГДЕЖЗИКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    const Alphabet& m_alphabet = Alphabet::russianWithoutShortI();
 
     // Преобразование текста в числа и обратно
     int charToNumber(QChar ch) const;
@@ -1,9 +1,12 @@
 #include "kuznechik.h"
 #include "cipherfactory.h"
 #include "cipherwidgetfactory.h"
+#include "keyschedulecache.h"
+#include "hexcodec.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QComboBox>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 #include <QDebug>
@@ -43,6 +46,10 @@ const std::array<uint8_t, 16> KuznechikCipher::L_VEC = {
     148, 32, 133, 16, 194, 192, 1, 251, 1, 192, 194, 16, 133, 32, 148, 1
 };
 
+// Таблицы LS и L⁻¹S⁻¹ — строятся один раз при загрузке программы
+const KuznechikCipher::LSTable KuznechikCipher::LS_TABLE = KuznechikCipher::buildLSTable(false);
+const KuznechikCipher::LSTable KuznechikCipher::INV_LS_TABLE = KuznechikCipher::buildLSTable(true);
+
 // ==================== KuznechikHexEdit ====================
 KuznechikHexEdit::KuznechikHexEdit(QWidget* parent)
     : QLineEdit(parent)
@@ -70,6 +77,8 @@ void KuznechikHexEdit::setExpectedLength(int bytes)
     if (bytes > 0) {
         setPlaceholderText(QString("HEX (%1 байт, %2 символа)").arg(bytes).arg(bytes * 2));
         setMaxLength(bytes * 2);
+    } else {
+        setMaxLength(32767);
     }
 }
 
@@ -172,18 +181,47 @@ void KuznechikCipher::invL(std::array<uint8_t, 16>& state) const
     }
 }
 
-void KuznechikCipher::LSX(std::array<uint8_t, 16>& state, const std::array<uint8_t, 16>& key) const
+// ==================== Табличные преобразования ====================
+KuznechikCipher::LSTable KuznechikCipher::buildLSTable(bool inverse)
 {
-    X(state, key);
-    S(state);
-    L(state);
+    const KuznechikCipher cipher;
+
+    // Столбцы матрицы L (или L⁻¹): образы векторов с единицей на позиции i
+    std::array<std::array<uint8_t, 16>, 16> columns{};
+    for (int i = 0; i < 16; ++i) {
+        columns[i][i] = 1;
+        if (inverse) {
+            cipher.invL(columns[i]);
+        } else {
+            cipher.L(columns[i]);
+        }
+    }
+
+    LSTable table{};
+    for (int i = 0; i < 16; ++i) {
+        for (int b = 0; b < 256; ++b) {
+            const uint8_t s = inverse ? PI_INV[b] : PI[b];
+            uint8_t row[16];
+            for (int j = 0; j < 16; ++j) {
+                row[j] = cipher.gf256Mul(columns[i][j], s);
+            }
+            std::memcpy(&table[i][b], row, 16);
+        }
+    }
+    return table;
 }
 
-void KuznechikCipher::invLSX(std::array<uint8_t, 16>& state, const std::array<uint8_t, 16>& key) const
+void KuznechikCipher::tableRound(uint8_t state[16], const uint8_t key[16], const LSTable& table)
 {
-    invL(state);
-    invS(state);
-    X(state, key);
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    for (int i = 0; i < 16; ++i) {
+        const Block& row = table[i][state[i] ^ key[i]];
+        lo ^= row.lo;
+        hi ^= row.hi;
+    }
+    std::memcpy(state, &lo, 8);
+    std::memcpy(state + 8, &hi, 8);
 }
 
 void KuznechikCipher::F(std::array<uint8_t, 16>& out1, std::array<uint8_t, 16>& out2,
@@ -192,9 +230,7 @@ void KuznechikCipher::F(std::array<uint8_t, 16>& out1, std::array<uint8_t, 16>&
 {
     out2 = in1;
     std::array<uint8_t, 16> temp = in1;
-    X(temp, iterConst);
-    S(temp);
-    L(temp);
+    tableRound(temp.data(), iterConst.data(), LS_TABLE);
     X(temp, in2);
     out1 = temp;
 }
@@ -215,9 +251,10 @@ std::array<std::array<uint8_t, 16>, 32> KuznechikCipher::generateIterConstants()
 }
 
 // ==================== Развертывание ключа ====================
-std::array<std::array<uint8_t, 16>, 10> KuznechikCipher::expandKey(const std::array<uint8_t, 32>& masterKey) const
+KuznechikCipher::RoundKeys KuznechikCipher::expandKey(const std::array<uint8_t, 32>& masterKey) const
 {
-    std::array<std::array<uint8_t, 16>, 10> roundKeys;
+    RoundKeys schedule;
+    std::array<std::array<uint8_t, 16>, 10>& roundKeys = schedule.enc;
 
     // K1, K2
     for (int i = 0; i < 16; ++i) {
@@ -225,7 +262,8 @@ std::array<std::array<uint8_t, 16>, 10> KuznechikCipher::expandKey(const std::ar
         roundKeys[1][i] = masterKey[i + 16];
     }
 
-    std::array<std::array<uint8_t, 16>, 32> C = generateIterConstants();
+    // Итерационные константы от ключа не зависят — считаются один раз
+    static const std::array<std::array<uint8_t, 16>, 32> C = generateIterConstants();
 
     std::array<uint8_t, 16> A = roundKeys[0];  // K1
     std::array<uint8_t, 16> B = roundKeys[1];  // K2
@@ -270,269 +308,481 @@ std::array<std::array<uint8_t, 16>, 10> KuznechikCipher::expandKey(const std::ar
     roundKeys[8] = A;  // K9
     roundKeys[9] = B;  // K10
 
-    return roundKeys;
+    for (int r = 0; r < 10; ++r) {
+        schedule.dec[r] = roundKeys[r];
+        invL(schedule.dec[r]);
+    }
+
+    return schedule;
 }
 
-// ==================== Вспомогательные функции ====================
-QString KuznechikCipher::prepareHexInput(const QString& text) const
+// ==================== Конструктор ====================
+KuznechikCipher::KuznechikCipher()
 {
-    QString filtered;
-    QRegularExpression hexRegex("[0-9A-Fa-f]");
-    QRegularExpressionMatchIterator it = hexRegex.globalMatch(text);
-    while (it.hasNext()) {
-        filtered.append(it.next().captured());
-    }
-    return filtered.toUpper();
 }
 
-QString KuznechikCipher::bytesToHex(const uint8_t* data, int len) const
+// ==================== Блочные операции ====================
+bool KuznechikCipher::prepareRoundKeys(const QVariantMap& params, std::shared_ptr<const RoundKeys>& roundKeys,
+                                       QString* error) const
 {
-    QString result;
-    for (int i = 0; i < len; ++i) {
-        result.append(QString("%1").arg(data[i], 2, 16, QChar('0')).toUpper());
+    const QString keyText = params.value("key", "").toString();
+    std::array<uint8_t, 32> masterKey{};
+    qsizetype invalidAt = -1;
+    const int keyDigits = int(HexCodec::decode(keyText, masterKey.data(), qsizetype(masterKey.size()), &invalidAt));
+    if (invalidAt >= 0) {
+        KeyScheduleCache::secureZero(masterKey.data(), masterKey.size());
+        if (error) *error = HexCodec::invalidCharError("Ключ", keyText, invalidAt);
+        return false;
+    }
+
+    if (keyDigits != 64) {
+        KeyScheduleCache::secureZero(masterKey.data(), masterKey.size());
+        if (error) {
+            *error = QString("ОШИБКА: Ключ должен быть 64 HEX символа. Получено: %1")
+                     .arg(keyDigits);
+        }
+        return false;
     }
-    return result;
+
+    roundKeys = KeyScheduleCache::instance().get<RoundKeys>(
+        "kuznechik", masterKey.data(), int(masterKey.size()),
+        [&] { return expandKey(masterKey); });
+    KeyScheduleCache::secureZero(masterKey.data(), masterKey.size());
+    return true;
 }
 
-void KuznechikCipher::hexToBytes(const QString& hex, uint8_t* out, int len) const
+// E(a) = X[K10] LSX[K9] ... LSX[K1](a)
+void KuznechikCipher::encryptBlock(const uint8_t* in, uint8_t* out, const RoundKeys& roundKeys) const
 {
-    QByteArray bytes = QByteArray::fromHex(hex.toLatin1());
-    for (int i = 0; i < len && i < bytes.size(); ++i) {
-        out[i] = static_cast<uint8_t>(bytes[i]);
+    uint8_t state[16];
+    std::memcpy(state, in, 16);
+
+    for (int r = 0; r < 9; ++r) {
+        tableRound(state, roundKeys.enc[r].data(), LS_TABLE);
+    }
+    for (int i = 0; i < 16; ++i) {
+        out[i] = state[i] ^ roundKeys.enc[9][i];
     }
 }
 
-// ==================== Конструктор ====================
-KuznechikCipher::KuznechikCipher()
+// D(a) = X[K1] S⁻¹L⁻¹X[K2] ... S⁻¹L⁻¹X[K10](a).
+// L линейно: L⁻¹(x ⊕ Ki) = L⁻¹(x) ⊕ L⁻¹(Ki), поэтому в терминах w = L⁻¹S⁻¹(L⁻¹ x)
+// раунд — та же табличная операция w' = INV_LS(w ⊕ dec_i). Первое L⁻¹ берется
+// из той же таблицы через π (S⁻¹(π(b)) = b), последнее S⁻¹ — побайтно
+void KuznechikCipher::decryptBlock(const uint8_t* in, uint8_t* out, const RoundKeys& roundKeys) const
 {
+    static const uint8_t zero[16] = {0};
+
+    uint8_t state[16];
+    for (int i = 0; i < 16; ++i) {
+        state[i] = PI[in[i] ^ roundKeys.enc[9][i]];
+    }
+    tableRound(state, zero, INV_LS_TABLE);          // L⁻¹X[K10]
+    tableRound(state, zero, INV_LS_TABLE);          // L⁻¹S⁻¹
+    for (int r = 8; r >= 2; --r) {
+        tableRound(state, roundKeys.dec[r].data(), INV_LS_TABLE);
+    }
+    for (int i = 0; i < 16; ++i) {
+        out[i] = PI_INV[state[i] ^ roundKeys.dec[1][i]] ^ roundKeys.enc[0][i];
+    }
 }
 
-// ==================== Шифрование ====================
-CipherResult KuznechikCipher::encrypt(const QString& text, const QVariantMap& params)
+// ==================== Бинарный путь ====================
+// Кузнечик как блочный шифр для режимов ГОСТ Р 34.13-2015
+class KuznechikBlock : public Gost3413Block
 {
-    CipherResult result;
-    result.cipherName = name();
-    result.alphabet = m_alphabet;
-    result.isNumeric = true;
+public:
+    KuznechikBlock(const KuznechikCipher& cipher, std::shared_ptr<const KuznechikCipher::RoundKeys> roundKeys)
+        : m_cipher(cipher), m_roundKeys(std::move(roundKeys)) {}
 
-    QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало шифрования Кузнечик", "Инициализация"));
+    int blockSize() const override { return 16; }
 
-    QString keyHex = params.value("key", "").toString();
-    QString cleanedKey = prepareHexInput(keyHex);
-
-    if (cleanedKey.length() != 64) {
-        result.result = QString("ОШИБКА: Ключ должен быть 64 HEX символа. Получено: %1")
-                        .arg(cleanedKey.length());
-        return result;
-    }
-
-    steps.append(CipherStep(1, QChar(), QString("Ключ: %1").arg(cleanedKey), "Параметры"));
-
-    QString hexData = prepareHexInput(text);
-    if (hexData.isEmpty()) {
-        result.result = "ОШИБКА: Нет данных для шифрования";
-        return result;
+    void encryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) const override
+    {
+        for (qsizetype i = 0; i < blocks; ++i, in += 16, out += 16) {
+            m_cipher.encryptBlock(in, out, *m_roundKeys);
+        }
     }
 
-    // Проверка длины данных (должна быть кратна 32 HEX символам = 16 байт)
-    if (hexData.length() % 32 != 0) {
-        result.result = QString("ОШИБКА: Длина данных должна быть кратна 32 HEX символам. Получено: %1")
-                        .arg(hexData.length());
-        return result;
+    void decryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) const override
+    {
+        for (qsizetype i = 0; i < blocks; ++i, in += 16, out += 16) {
+            m_cipher.decryptBlock(in, out, *m_roundKeys);
+        }
     }
 
-    steps.append(CipherStep(2, QChar(), QString("Входные данные: %1 (длина: %2 байт)").arg(hexData).arg(hexData.length() / 2), "Данные"));
-
-    // Преобразуем ключ
-    std::array<uint8_t, 32> masterKey{};
-    hexToBytes(cleanedKey, masterKey.data(), 32);
+private:
+    KuznechikCipher m_cipher;
+    std::shared_ptr<const KuznechikCipher::RoundKeys> m_roundKeys;
+};
 
-    // Разворачиваем ключи
-    std::array<std::array<uint8_t, 16>, 10> roundKeys = expandKey(masterKey);
+Gost3413::Prepare KuznechikCipher::blockPreparer() const
+{
+    return [cipher = *this](const QVariantMap& params, std::shared_ptr<const Gost3413Block>& block,
+                            QString* error) {
+        std::shared_ptr<const RoundKeys> roundKeys;
+        if (!cipher.prepareRoundKeys(params, roundKeys, error)) {
+            return false;
+        }
+        block = std::make_shared<KuznechikBlock>(cipher, std::move(roundKeys));
+        return true;
+    };
+}
 
-    // Выводим все итерационные ключи
-    steps.append(CipherStep(3, QChar(), "Развертывание ключа:", "Развертывание ключа"));
-    for (int r = 0; r < 10; ++r) {
-        QString keyStr = bytesToHex(roundKeys[r].data(), 16);
-        steps.append(CipherStep(4 + r, QChar(),
-            QString("K%1 = %2").arg(r + 1).arg(keyStr),
-            QString("Раундовый ключ %1").arg(r + 1)));
-    }
+std::unique_ptr<CipherStream> KuznechikCipher::createStream(bool encrypt)
+{
+    return Gost3413::createStream(blockPreparer(), 16, encrypt);
+}
 
-    // Количество блоков (16 байт = 32 HEX символа)
-    int blockCount = hexData.length() / 32;
-    steps.append(CipherStep(14, QChar(),
-        QString("Количество блоков: %1").arg(blockCount),
-        "Разбиение на блоки"));
+bool KuznechikCipher::encryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    return Gost3413::processBytes(blockPreparer(), 16, in, out, params, true, error);
+}
 
-    QString encryptedHex;
-    int stepCounter = 15;
+bool KuznechikCipher::decryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    return Gost3413::processBytes(blockPreparer(), 16, in, out, params, false, error);
+}
 
-    // Обрабатываем каждый блок
-    for (int blockIdx = 0; blockIdx < blockCount; ++blockIdx) {
-        QString blockHex = hexData.mid(blockIdx * 32, 32);
+// ==================== Пораундовая трассировка ====================
+void KuznechikCipher::traceEncryptBlock(const uint8_t* block, const RoundKeys& roundKeys, int blockIdx, int blockCount,
+                                        QVector<CipherStep>& steps, int& stepCounter, StepTrace& trace) const
+{
+    std::array<uint8_t, 16> state;
+    std::memcpy(state.data(), block, 16);
 
+    if (trace.want(TraceLevel::PerBlock)) {
         steps.append(CipherStep(stepCounter++, QChar(),
-            QString("━━━ Блок %1 из %2: %3 ━━━").arg(blockIdx + 1).arg(blockCount).arg(blockHex),
+            QString("━━━ Блок %1 из %2: %3 ━━━").arg(blockIdx + 1).arg(blockCount).arg(HexCodec::encode(state.data(), 16)),
             QString("Начало блока %1").arg(blockIdx + 1)));
+    }
 
-        // Шифрование блока
-        std::array<uint8_t, 16> state{};
-        hexToBytes(blockHex, state.data(), 16);
-
+    if (trace.want(TraceLevel::PerBlock)) {
         steps.append(CipherStep(stepCounter++, QChar(),
-            QString("Начальное состояние блока %1: %2").arg(blockIdx + 1).arg(bytesToHex(state.data(), 16)),
+            QString("Начальное состояние блока %1: %2").arg(blockIdx + 1).arg(HexCodec::encode(state.data(), 16)),
             QString("Состояние блока %1").arg(blockIdx + 1)));
+    }
 
-        // Раунды 1-9: LSX[Ki]
-        for (int r = 0; r < 9; ++r) {
-            // X
-            X(state, roundKeys[r]);
+    // Раунды 1-9: LSX[Ki]
+    for (int r = 0; r < 9; ++r) {
+        // X
+        X(state, roundKeys.enc[r]);
+        if (trace.want(TraceLevel::PerChar)) {
             steps.append(CipherStep(stepCounter++, QChar(),
-                QString("  Раунд %1: X[K%2] = %3").arg(r + 1).arg(r + 1).arg(bytesToHex(state.data(), 16)),
+                QString("  Раунд %1: X[K%2] = %3").arg(r + 1).arg(r + 1).arg(HexCodec::encode(state.data(), 16)),
                 QString("Блок %1 раунд %2 - X").arg(blockIdx + 1).arg(r + 1)));
-            // S
-            S(state);
+        }
+        // S
+        S(state);
+        if (trace.want(TraceLevel::PerChar)) {
             steps.append(CipherStep(stepCounter++, QChar(),
-                QString("  Раунд %1: S = %2").arg(r + 1).arg(bytesToHex(state.data(), 16)),
+                QString("  Раунд %1: S = %2").arg(r + 1).arg(HexCodec::encode(state.data(), 16)),
                 QString("Блок %1 раунд %2 - S").arg(blockIdx + 1).arg(r + 1)));
-            // L
-            L(state);
+        }
+        // L
+        L(state);
+        if (trace.want(TraceLevel::PerChar)) {
             steps.append(CipherStep(stepCounter++, QChar(),
-                QString("  Раунд %1: L = %2").arg(r + 1).arg(bytesToHex(state.data(), 16)),
+                QString("  Раунд %1: L = %2").arg(r + 1).arg(HexCodec::encode(state.data(), 16)),
                 QString("Блок %1 раунд %2 - L").arg(blockIdx + 1).arg(r + 1)));
         }
+    }
 
-        // Финальный раунд: X[K10]
-        X(state, roundKeys[9]);
+    // Финальный раунд: X[K10]
+    X(state, roundKeys.enc[9]);
+    if (trace.want(TraceLevel::PerBlock)) {
         steps.append(CipherStep(stepCounter++, QChar(),
-            QString("Финальный X[K10] = %1").arg(bytesToHex(state.data(), 16)),
+            QString("Финальный X[K10] = %1").arg(HexCodec::encode(state.data(), 16)),
             QString("Блок %1 финальный раунд").arg(blockIdx + 1)));
+    }
 
-        encryptedHex += bytesToHex(state.data(), 16);
-
+    if (trace.want(TraceLevel::PerBlock)) {
         steps.append(CipherStep(stepCounter++, QChar(),
-            QString("Зашифрованный блок %1: %2").arg(blockIdx + 1).arg(bytesToHex(state.data(), 16)),
+            QString("Зашифрованный блок %1: %2").arg(blockIdx + 1).arg(HexCodec::encode(state.data(), 16)),
             QString("Результат блока %1").arg(blockIdx + 1)));
     }
+}
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Полный шифртекст: %1").arg(encryptedHex),
-        "Завершение"));
+void KuznechikCipher::traceDecryptBlock(const uint8_t* block, const RoundKeys& roundKeys, int blockIdx, int blockCount,
+                                        QVector<CipherStep>& steps, int& stepCounter, StepTrace& trace) const
+{
+    std::array<uint8_t, 16> state;
+    std::memcpy(state.data(), block, 16);
 
-    result.result = encryptedHex;
-    result.steps = steps;
+    if (trace.want(TraceLevel::PerBlock)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("━━━ Блок %1 из %2: %3 ━━━").arg(blockIdx + 1).arg(blockCount).arg(HexCodec::encode(state.data(), 16)),
+            QString("Начало блока %1").arg(blockIdx + 1)));
+    }
+
+    if (trace.want(TraceLevel::PerBlock)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Начальное состояние блока %1: %2").arg(blockIdx + 1).arg(HexCodec::encode(state.data(), 16)),
+            QString("Состояние блока %1").arg(blockIdx + 1)));
+    }
+
+    // X[K10]
+    X(state, roundKeys.enc[9]);
+    if (trace.want(TraceLevel::PerBlock)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("После X[K10]: %1").arg(HexCodec::encode(state.data(), 16)),
+            QString("Блок %1 начальный X").arg(blockIdx + 1)));
+    }
+
+    // Раунды 8..1: invLSX
+    for (int r = 8; r >= 0; --r) {
+        // invL
+        invL(state);
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("  Раунд %1: L⁻¹ = %2").arg(r + 1).arg(HexCodec::encode(state.data(), 16)),
+                QString("Блок %1 раунд %2 - L⁻¹").arg(blockIdx + 1).arg(r + 1)));
+        }
+        // invS
+        invS(state);
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("  Раунд %1: S⁻¹ = %2").arg(r + 1).arg(HexCodec::encode(state.data(), 16)),
+                QString("Блок %1 раунд %2 - S⁻¹").arg(blockIdx + 1).arg(r + 1)));
+        }
+        // X[Kr]
+        X(state, roundKeys.enc[r]);
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("  Раунд %1: X[K%2] = %3").arg(r + 1).arg(r + 1).arg(HexCodec::encode(state.data(), 16)),
+                QString("Блок %1 раунд %2 - X").arg(blockIdx + 1).arg(r + 1)));
+        }
+    }
 
-    return result;
+    if (trace.want(TraceLevel::PerBlock)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Расшифрованный блок %1: %2").arg(blockIdx + 1).arg(HexCodec::encode(state.data(), 16)),
+            QString("Результат блока %1").arg(blockIdx + 1)));
+    }
 }
 
-// ==================== Расшифрование ====================
-CipherResult KuznechikCipher::decrypt(const QString& text, const QVariantMap& params)
+// ==================== Шифрование ====================
+CipherResult KuznechikCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = true;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало расшифрования Кузнечик", "Инициализация"));
-
-    QString keyHex = params.value("key", "").toString();
-    QString cleanedKey = prepareHexInput(keyHex);
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало шифрования Кузнечик", "Инициализация"));
+    }
 
-    if (cleanedKey.length() != 64) {
-        result.result = QString("ОШИБКА: Ключ должен быть 64 HEX символа. Получено: %1")
-                        .arg(cleanedKey.length());
-        return result;
+    std::shared_ptr<const RoundKeys> roundKeys;
+    QString error;
+    if (!prepareRoundKeys(params, roundKeys, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(), QString("Ключ: %1").arg(cleanedKey), "Параметры"));
+    Gost3413::Mode mode;
+    Gost3413::Padding padding;
+    if (!Gost3413::parseMode(params, mode, &error) || !Gost3413::parsePadding(params, padding, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
+    }
 
-    QString hexData = prepareHexInput(text);
-    if (hexData.isEmpty()) {
-        result.result = "ОШИБКА: Нет данных для расшифрования";
-        return result;
+    QString cleanedKey = HexCodec::clean(params.value("key", "").toString());
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(), QString("Ключ: %1, режим %2").arg(cleanedKey).arg(Gost3413::modeName(mode)),
+                                "Параметры"));
     }
 
-    if (hexData.length() % 32 != 0) {
-        result.result = QString("ОШИБКА: Длина данных должна быть кратна 32 HEX символам. Получено: %1")
-                        .arg(hexData.length());
-        return result;
+    qsizetype digits = 0;
+    qsizetype invalidAt = -1;
+    const QByteArray input = HexCodec::decode(text, &digits, &invalidAt);
+    if (invalidAt >= 0) {
+        result.fail(CipherStatus::InvalidInput, HexCodec::invalidCharError("Текст", text, invalidAt));
+        return trace.finish(result);
+    }
+    if (digits == 0) {
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Нет данных для шифрования");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(2, QChar(), QString("Входные данные: %1 (длина: %2 байт)").arg(hexData).arg(hexData.length() / 2), "Данные"));
+    // ECB и CBC без дополнения — целые блоки (32 HEX символа), остальное — целые байты
+    const bool wholeBlocks = (mode == Gost3413::Mode::ECB || mode == Gost3413::Mode::CBC) && padding == Gost3413::Padding::None;
+    if (wholeBlocks && digits % 32 != 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Длина данных должна быть кратна 32 HEX символам. Получено: %1")
+                                                .arg(digits));
+        return trace.finish(result);
+    }
+    if (digits % 2 != 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Длина данных должна быть четной. Получено: %1")
+                                                .arg(digits));
+        return trace.finish(result);
+    }
 
-    std::array<uint8_t, 32> masterKey{};
-    hexToBytes(cleanedKey, masterKey.data(), 32);
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(), QString("Входные данные: %1 (длина: %2 байт)").arg(HexCodec::encode(input)).arg(input.size()), "Данные"));
+    }
 
-    std::array<std::array<uint8_t, 16>, 10> roundKeys = expandKey(masterKey);
+    QByteArray output;
+    CipherStatus status = CipherStatus::Ok;
+    if (!Gost3413::processBytes(blockPreparer(), 16, input, output, params, true, &error, &status)) {
+        result.fail(status, error);
+        return trace.finish(result);
+    }
 
-    steps.append(CipherStep(3, QChar(), "Развернуто 10 итерационных ключей", "Развертывание ключа"));
+    // Выводим все итерационные ключи
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(), "Развертывание ключа:", "Развертывание ключа"));
+    }
+    for (int r = 0; r < 10; ++r) {
+        if (trace.want(TraceLevel::Summary)) {
+            QString keyStr = HexCodec::encode(roundKeys->enc[r].data(), 16);
+            steps.append(CipherStep(4 + r, QChar(),
+                QString("K%1 = %2").arg(r + 1).arg(keyStr),
+                QString("Раундовый ключ %1").arg(r + 1)));
+        }
+    }
 
-    int blockCount = hexData.length() / 32;
-    steps.append(CipherStep(4, QChar(),
-        QString("Количество блоков: %1").arg(blockCount),
-        "Разбиение на блоки"));
+    // Количество блоков (16 байт = 32 HEX символа)
+    int blockCount = input.size() / 16;
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(14, QChar(),
+            QString("Количество блоков: %1").arg(blockCount),
+            "Разбиение на блоки"));
+    }
 
-    QString decryptedHex;
-    int stepCounter = 5;
+    int stepCounter = 15;
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(input.constData());
+    // Пораундовая трассировка — только ECB: в остальных режимах на вход шифра идет не блок данных
+    if (mode == Gost3413::Mode::ECB && trace.enabled(TraceLevel::PerBlock)) {
+        for (int blockIdx = 0; blockIdx < blockCount; ++blockIdx) {
+            traceEncryptBlock(src + blockIdx * 16, *roundKeys, blockIdx, blockCount, steps, stepCounter, trace);
+        }
+    } else if (mode == Gost3413::Mode::ECB) {
+        trace.skip(blockCount * TRACE_STEPS_PER_BLOCK);
+    }
 
-    // Обрабатываем каждый блок
-    for (int blockIdx = 0; blockIdx < blockCount; ++blockIdx) {
-        QString blockHex = hexData.mid(blockIdx * 32, 32);
+    QString encryptedHex = HexCodec::encode(output);
 
+    if (trace.want(TraceLevel::Summary)) {
         steps.append(CipherStep(stepCounter++, QChar(),
-            QString("━━━ Блок %1 из %2: %3 ━━━").arg(blockIdx + 1).arg(blockCount).arg(blockHex),
-            QString("Начало блока %1").arg(blockIdx + 1)));
+            QString(mode == Gost3413::Mode::MAC   ? "Имитовставка: %1"
+                    : mode == Gost3413::Mode::MGM ? "Шифртекст и имитовставка: %1"
+                                                  : "Полный шифртекст: %1").arg(encryptedHex),
+            "Завершение"));
+    }
 
-        std::array<uint8_t, 16> state{};
-        hexToBytes(blockHex, state.data(), 16);
+    result.result = encryptedHex;
+    result.steps = steps;
 
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("Начальное состояние блока %1: %2").arg(blockIdx + 1).arg(bytesToHex(state.data(), 16)),
-            QString("Состояние блока %1").arg(blockIdx + 1)));
+    return trace.finish(result);
+}
 
-        // X[K10]
-        X(state, roundKeys[9]);
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("После X[K10]: %1").arg(bytesToHex(state.data(), 16)),
-            QString("Блок %1 начальный X").arg(blockIdx + 1)));
+// ==================== Расшифрование ====================
+CipherResult KuznechikCipher::decrypt(const QString& text, const QVariantMap& params)
+{
+    StepTrace trace(params);
+    CipherResult result;
+    result.cipherName = name();
+    result.alphabet = m_alphabet;
+    result.isNumeric = true;
 
-        // Раунды 8..1: invLSX
-        for (int r = 8; r >= 0; --r) {
-            // invL
-            invL(state);
-            steps.append(CipherStep(stepCounter++, QChar(),
-                QString("  Раунд %1: L⁻¹ = %2").arg(r + 1).arg(bytesToHex(state.data(), 16)),
-                QString("Блок %1 раунд %2 - L⁻¹").arg(blockIdx + 1).arg(r + 1)));
-            // invS
-            invS(state);
-            steps.append(CipherStep(stepCounter++, QChar(),
-                QString("  Раунд %1: S⁻¹ = %2").arg(r + 1).arg(bytesToHex(state.data(), 16)),
-                QString("Блок %1 раунд %2 - S⁻¹").arg(blockIdx + 1).arg(r + 1)));
-            // X[Kr]
-            X(state, roundKeys[r]);
-            steps.append(CipherStep(stepCounter++, QChar(),
-                QString("  Раунд %1: X[K%2] = %3").arg(r + 1).arg(r + 1).arg(bytesToHex(state.data(), 16)),
-                QString("Блок %1 раунд %2 - X").arg(blockIdx + 1).arg(r + 1)));
+    QVector<CipherStep> steps;
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало расшифрования Кузнечик", "Инициализация"));
+    }
+
+    std::shared_ptr<const RoundKeys> roundKeys;
+    QString error;
+    if (!prepareRoundKeys(params, roundKeys, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
+    }
+
+    Gost3413::Mode mode;
+    Gost3413::Padding padding;
+    if (!Gost3413::parseMode(params, mode, &error) || !Gost3413::parsePadding(params, padding, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
+    }
+
+    QString cleanedKey = HexCodec::clean(params.value("key", "").toString());
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(), QString("Ключ: %1, режим %2").arg(cleanedKey).arg(Gost3413::modeName(mode)),
+                                "Параметры"));
+    }
+
+    qsizetype digits = 0;
+    qsizetype invalidAt = -1;
+    const QByteArray input = HexCodec::decode(text, &digits, &invalidAt);
+    if (invalidAt >= 0) {
+        result.fail(CipherStatus::InvalidInput, HexCodec::invalidCharError("Текст", text, invalidAt));
+        return trace.finish(result);
+    }
+    if (digits == 0) {
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Нет данных для расшифрования");
+        return trace.finish(result);
+    }
+
+    // ECB и CBC — целые блоки (32 HEX символа), остальные режимы — целые байты
+    const bool wholeBlocks = (mode == Gost3413::Mode::ECB || mode == Gost3413::Mode::CBC);
+    if (wholeBlocks && digits % 32 != 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Длина данных должна быть кратна 32 HEX символам. Получено: %1")
+                                                .arg(digits));
+        return trace.finish(result);
+    }
+    if (digits % 2 != 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Длина данных должна быть четной. Получено: %1")
+                                                .arg(digits));
+        return trace.finish(result);
+    }
+
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(), QString("Входные данные: %1 (длина: %2 байт)").arg(HexCodec::encode(input)).arg(input.size()), "Данные"));
+    }
+
+    QByteArray output;
+    CipherStatus status = CipherStatus::Ok;
+    if (!Gost3413::processBytes(blockPreparer(), 16, input, output, params, false, &error, &status)) {
+        result.fail(status, error);
+        return trace.finish(result);
+    }
+
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(), "Развернуто 10 итерационных ключей", "Развертывание ключа"));
+    }
+
+    int blockCount = input.size() / 16;
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(4, QChar(),
+            QString("Количество блоков: %1").arg(blockCount),
+            "Разбиение на блоки"));
+    }
+
+    int stepCounter = 5;
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(input.constData());
+    // Пораундовая трассировка — только ECB: в остальных режимах на вход шифра идет не блок данных
+    if (mode == Gost3413::Mode::ECB && trace.enabled(TraceLevel::PerBlock)) {
+        for (int blockIdx = 0; blockIdx < blockCount; ++blockIdx) {
+            traceDecryptBlock(src + blockIdx * 16, *roundKeys, blockIdx, blockCount, steps, stepCounter, trace);
         }
+    } else if (mode == Gost3413::Mode::ECB) {
+        trace.skip(blockCount * TRACE_STEPS_PER_BLOCK);
+    }
 
-        decryptedHex += bytesToHex(state.data(), 16);
+    QString decryptedHex = HexCodec::encode(output);
 
+    if (trace.want(TraceLevel::Summary)) {
         steps.append(CipherStep(stepCounter++, QChar(),
-            QString("Расшифрованный блок %1: %2").arg(blockIdx + 1).arg(bytesToHex(state.data(), 16)),
-            QString("Результат блока %1").arg(blockIdx + 1)));
+            QString("Полный расшифрованный текст: %1").arg(decryptedHex),
+            "Завершение"));
     }
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Полный расшифрованный текст: %1").arg(decryptedHex),
-        "Завершение"));
-
     result.result = decryptedHex;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== Регистратор ====================
@@ -564,6 +814,61 @@ KuznechikCipherRegister::KuznechikCipherRegister()
             keyRow->addStretch();
             vbox->addLayout(keyRow);
 
+            // Режим ГОСТ Р 34.13-2015
+            QHBoxLayout* modeRow = new QHBoxLayout();
+            QLabel* modeLabel = new QLabel("Режим:");
+            modeLabel->setFixedWidth(120);
+            QComboBox* modeCombo = new QComboBox();
+            modeCombo->addItem("ECB — простая замена", "ECB");
+            modeCombo->addItem("CTR — гаммирование", "CTR");
+            modeCombo->addItem("OFB — гаммирование с обратной связью по выходу", "OFB");
+            modeCombo->addItem("CBC — простая замена с зацеплением", "CBC");
+            modeCombo->addItem("CFB — гаммирование с обратной связью по шифртексту", "CFB");
+            modeCombo->addItem("MAC — выработка имитовставки", "MAC");
+            modeCombo->addItem("MGM — шифрование с имитовставкой (Р 1323565.1.026-2019)", "MGM");
+            modeCombo->setObjectName("mode");
+            modeRow->addWidget(modeLabel);
+            modeRow->addWidget(modeCombo);
+            modeRow->addStretch();
+            vbox->addLayout(modeRow);
+
+            QHBoxLayout* ivRow = new QHBoxLayout();
+            QLabel* ivLabel = new QLabel("IV:");
+            ivLabel->setFixedWidth(120);
+            KuznechikHexEdit* ivEdit = new KuznechikHexEdit();
+            ivEdit->setObjectName("iv");
+            ivEdit->setEnabled(false);
+            ivRow->addWidget(ivLabel);
+            ivRow->addWidget(ivEdit);
+            ivRow->addStretch();
+            vbox->addLayout(ivRow);
+
+            QHBoxLayout* aadRow = new QHBoxLayout();
+            QLabel* aadLabel = new QLabel("AAD:");
+            aadLabel->setFixedWidth(120);
+            KuznechikHexEdit* aadEdit = new KuznechikHexEdit();
+            aadEdit->setObjectName("aad");
+            aadEdit->setPlaceholderText("HEX (необязательно)");
+            aadEdit->setEnabled(false);
+            aadRow->addWidget(aadLabel);
+            aadRow->addWidget(aadEdit);
+            aadRow->addStretch();
+            vbox->addLayout(aadRow);
+
+            QHBoxLayout* paddingRow = new QHBoxLayout();
+            QLabel* paddingLabel = new QLabel("Дополнение:");
+            paddingLabel->setFixedWidth(120);
+            QComboBox* paddingCombo = new QComboBox();
+            paddingCombo->addItem("Нет (данные кратны блоку)", "");
+            paddingCombo->addItem("Процедура 1 — нулями", "1");
+            paddingCombo->addItem("Процедура 2 — 1 и нули, всегда", "2");
+            paddingCombo->addItem("Процедура 3 — 1 и нули, при неполном блоке", "3");
+            paddingCombo->setObjectName("padding");
+            paddingRow->addWidget(paddingLabel);
+            paddingRow->addWidget(paddingCombo);
+            paddingRow->addStretch();
+            vbox->addLayout(paddingRow);
+
             QLabel* infoLabel = new QLabel(
                 "Кузнечик (ГОСТ Р 34.12-2015) — блочный шифр с SP-сетью:\n"
                 "• Длина блока: 128 бит (32 HEX символа)\n"
@@ -572,7 +877,11 @@ KuznechikCipherRegister::KuznechikCipherRegister()
                 "Контрольный пример (А.1.5):\n"
                 "  Ключ: 8899aabbccddeeff0011223344556677fedcba98765432100123456789abcdef\n"
                 "  Открытый текст: 1122334455667700ffeeddccbbaa9988\n"
-                "  Ожидаемый шифртекст: 7f679d90bebc24305a468d42b9d4edcd"
+                "  Ожидаемый шифртекст: 7f679d90bebc24305a468d42b9d4edcd\n\n"
+                "Режимы ГОСТ Р 34.13-2015: IV для CTR — 16 HEX символов, для OFB, CBC и CFB —\n"
+                "кратен 32 HEX символам; дополнение применяется в ECB и CBC.\n"
+                "MGM: nonce — 32 HEX символа со старшим битом 0, к шифртексту\n"
+                "дописывается 16-байтная имитовставка, AAD только аутентифицируются"
             );
             infoLabel->setStyleSheet("color: #666; padding: 5px; background-color: #f5f5f5; border-radius: 3px;");
             infoLabel->setWordWrap(true);
@@ -581,6 +890,31 @@ KuznechikCipherRegister::KuznechikCipherRegister()
             layout->addWidget(container);
 
             widgets["key"] = keyEdit;
+            widgets["mode"] = modeCombo;
+            widgets["iv"] = ivEdit;
+            widgets["aad"] = aadEdit;
+            widgets["padding"] = paddingCombo;
+
+            // Длина IV зависит от режима: n/2 для CTR, n для MGM, z·n для OFB, CBC, CFB
+            QObject::connect(modeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                [modeCombo, ivEdit, aadEdit, paddingCombo](int) {
+                    const QString mode = modeCombo->currentData().toString();
+                    const bool needsIv = (mode != "ECB" && mode != "MAC");
+                    ivEdit->setEnabled(needsIv);
+                    aadEdit->setEnabled(mode == "MGM");
+                    paddingCombo->setEnabled(mode == "ECB" || mode == "CBC");
+                    if (mode == "CTR") {
+                        ivEdit->setExpectedLength(8);
+                        ivEdit->setHex("1234567890abcef0");
+                    } else if (mode == "MGM") {
+                        ivEdit->setExpectedLength(16);
+                        ivEdit->setHex("1122334455667700ffeeddccbbaa9988");
+                    } else if (needsIv) {
+                        ivEdit->setExpectedLength(0);
+                        ivEdit->setPlaceholderText("HEX (кратно 16 байтам)");
+                        ivEdit->setHex("1234567890abcef0a1b2c3d4e5f0011223344556677889901213141516171819");
+                    }
+                });
         }
     );
 }
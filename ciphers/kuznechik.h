@@ -3,9 +3,11 @@
 
 #include "cipherinterface.h"
 #include "ciphercore.h"
+#include "gost3413.h"
 #include <QVector>
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <QLineEdit>
 
 // Класс шифра Кузнечик (ГОСТ Р 34.12-2015)
@@ -20,7 +22,36 @@ public:
     virtual CipherResult encrypt(const QString& text, const QVariantMap& params) override;
     virtual CipherResult decrypt(const QString& text, const QVariantMap& params) override;
 
+    // Бинарный путь: ключ — HEX в params["key"], режим ГОСТ Р 34.13-2015 —
+    // params["mode"] (ECB по умолчанию, CTR, OFB, CBC, CFB, MAC) или MGM
+    // (к шифртексту дописывается имитовставка), IV, дополнение и AAD —
+    // params["iv"], params["padding"] и params["aad"] (см. Gost3413)
+    virtual bool supportsBytes() const override { return true; }
+    virtual bool encryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+    virtual bool decryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+
+    // Потоковый контекст выбранного режима: неполный блок переносится в следующий update
+    virtual std::unique_ptr<CipherStream> createStream(bool encrypt) override;
+
 private:
+    friend class KuznechikBlock;
+
+    // Итерационные ключи K1..K10; dec — L⁻¹(Ki) для табличного расшифрования
+    // (L линейно, поэтому ключ можно внести под L⁻¹ заранее)
+    struct RoundKeys {
+        std::array<std::array<uint8_t, 16>, 10> enc{};
+        std::array<std::array<uint8_t, 16>, 10> dec{};
+    };
+
+    // 128-битная строка таблицы в порядке байтов блока
+    struct Block {
+        uint64_t lo;
+        uint64_t hi;
+    };
+    using LSTable = std::array<std::array<Block, 256>, 16>;
+
     // S-блок из ГОСТ Р 34.12-2015 (раздел 4.1.1)
     static const std::array<uint8_t, 256> PI;
     static const std::array<uint8_t, 256> PI_INV;
@@ -28,6 +59,12 @@ private:
     // Коэффициенты для линейного преобразования L (раздел 4.1.2)
     static const std::array<uint8_t, 16> L_VEC;
 
+    // LS_TABLE[i][b] = L(S(b) на позиции i), INV_LS_TABLE[i][b] = L⁻¹(S⁻¹(b) на позиции i):
+    // L линейно, поэтому раунд — 16 выборок из таблицы и XOR вместо 256 умножений в GF(2^8)
+    static const LSTable LS_TABLE;
+    static const LSTable INV_LS_TABLE;
+    static LSTable buildLSTable(bool inverse);
+
     // Вспомогательные функции
     uint8_t gf256Mul(uint8_t a, uint8_t b) const;
 
@@ -39,22 +76,37 @@ private:
     void invR(std::array<uint8_t, 16>& state) const;
     void L(std::array<uint8_t, 16>& state) const;
     void invL(std::array<uint8_t, 16>& state) const;
-    void LSX(std::array<uint8_t, 16>& state, const std::array<uint8_t, 16>& key) const;
-    void invLSX(std::array<uint8_t, 16>& state, const std::array<uint8_t, 16>& key) const;
     void F(std::array<uint8_t, 16>& out1, std::array<uint8_t, 16>& out2,
            const std::array<uint8_t, 16>& in1, const std::array<uint8_t, 16>& in2,
            const std::array<uint8_t, 16>& iterConst) const;
 
+    // state = table(state ⊕ key): раунд LSX по LS_TABLE или L⁻¹S⁻¹ по INV_LS_TABLE
+    static void tableRound(uint8_t state[16], const uint8_t key[16], const LSTable& table);
+
     // Развертывание ключа (раздел 4.3)
-    std::array<std::array<uint8_t, 16>, 10> expandKey(const std::array<uint8_t, 32>& masterKey) const;
+    RoundKeys expandKey(const std::array<uint8_t, 32>& masterKey) const;
 
     // Итерационные константы C_i (раздел 4.3, формула 10)
     std::array<std::array<uint8_t, 16>, 32> generateIterConstants() const;
 
-    // Вспомогательные функции для работы с HEX
-    QString prepareHexInput(const QString& text) const;
-    QString bytesToHex(const uint8_t* data, int len) const;
-    void hexToBytes(const QString& hex, uint8_t* out, int len) const;
+    // Разбор ключа из параметров и развертывание (false + сообщение при ошибке)
+    bool prepareRoundKeys(const QVariantMap& params, std::shared_ptr<const RoundKeys>& roundKeys,
+                          QString* error) const;
+
+    // Разбор ключа для режимов ГОСТ Р 34.13-2015
+    Gost3413::Prepare blockPreparer() const;
+
+    // Шифрование/расшифрование одного 16-байтного блока по таблицам LS
+    void encryptBlock(const uint8_t* in, uint8_t* out, const RoundKeys& roundKeys) const;
+    void decryptBlock(const uint8_t* in, uint8_t* out, const RoundKeys& roundKeys) const;
+
+    // Пораундовая трассировка блока для журнала шагов
+    // (по TRACE_STEPS_PER_BLOCK шагов на блок при полной трассировке)
+    static constexpr int TRACE_STEPS_PER_BLOCK = 31;
+    void traceEncryptBlock(const uint8_t* block, const RoundKeys& roundKeys, int blockIdx, int blockCount,
+                           QVector<CipherStep>& steps, int& stepCounter, StepTrace& trace) const;
+    void traceDecryptBlock(const uint8_t* block, const RoundKeys& roundKeys, int blockIdx, int blockCount,
+                           QVector<CipherStep>& steps, int& stepCounter, StepTrace& trace) const;
 
     // Алфавит для вывода
     QString m_alphabet = "HEX";
@@ -1,23 +1,18 @@
 #include "magma_ctr.h"
 #include "cipherfactory.h"
 #include "cipherwidgetfactory.h"
+#include "cipherparallel.h"
+#include "cipherprogress.h"
+#include "keyschedulecache.h"
+#include "hexcodec.h"
+#include "magmacore.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QComboBox>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 #include <QDebug>
-#include <cstring>
-
-// ==================== S-блоки ГОСТ Р 34.12-2015 (раздел 5.1.1) ====================
-const std::array<uint8_t, 16> MagmaCTRCipher::PI0 = {12, 4, 6, 2, 10, 5, 11, 9, 14, 8, 13, 7, 0, 3, 15, 1};
-const std::array<uint8_t, 16> MagmaCTRCipher::PI1 = {6, 8, 2, 3, 9, 10, 5, 12, 1, 14, 4, 7, 11, 13, 0, 15};
-const std::array<uint8_t, 16> MagmaCTRCipher::PI2 = {11, 3, 5, 8, 2, 15, 10, 13, 14, 1, 7, 4, 12, 9, 6, 0};
-const std::array<uint8_t, 16> MagmaCTRCipher::PI3 = {12, 8, 2, 1, 13, 4, 15, 6, 7, 0, 10, 5, 3, 14, 9, 11};
-const std::array<uint8_t, 16> MagmaCTRCipher::PI4 = {7, 15, 5, 10, 8, 1, 6, 13, 0, 9, 3, 14, 11, 4, 2, 12};
-const std::array<uint8_t, 16> MagmaCTRCipher::PI5 = {5, 13, 15, 6, 9, 2, 12, 10, 11, 7, 8, 1, 4, 3, 14, 0};
-const std::array<uint8_t, 16> MagmaCTRCipher::PI6 = {8, 14, 2, 5, 6, 9, 1, 12, 15, 4, 11, 0, 13, 10, 3, 7};
-const std::array<uint8_t, 16> MagmaCTRCipher::PI7 = {1, 7, 14, 13, 0, 5, 8, 3, 4, 15, 10, 6, 9, 12, 11, 2};
 
 // ==================== MagmaCTRHexEdit ====================
 MagmaCTRHexEdit::MagmaCTRHexEdit(QWidget* parent)
@@ -74,306 +69,385 @@ MagmaCTRCipher::MagmaCTRCipher()
 {
 }
 
-QString MagmaCTRCipher::prepareHexInput(const QString& text) const
-{
-    QString filtered;
-    QRegularExpression hexRegex("[0-9A-Fa-f]");
-    QRegularExpressionMatchIterator it = hexRegex.globalMatch(text);
-    while (it.hasNext()) {
-        filtered.append(it.next().captured());
-    }
-    return filtered.toUpper();
-}
-
-QString MagmaCTRCipher::bytesToHex(const uint8_t* data, int len) const
-{
-    QString result;
-    for (int i = 0; i < len; i++) {
-        result.append(QString("%1").arg(data[i], 2, 16, QChar('0')).toUpper());
-    }
-    return result;
-}
-
-void MagmaCTRCipher::hexToBytes(const QString& hex, uint8_t* out, int len) const
+// ==================== Режим CTR (ГОСТ Р 34.13-2015, раздел 5.2) ====================
+// Начальное значение счетчика: IV (n/2 бит) дополняется нулями справа до 64 бит
+bool MagmaCTRCipher::initialCounter(const QString& ivHex, uint64_t& ctr, QString* error) const
 {
-    QByteArray bytes = QByteArray::fromHex(hex.toLatin1());
-    for (int i = 0; i < len && i < bytes.size(); i++) {
-        out[i] = static_cast<uint8_t>(bytes[i]);
+    // IV — 64-битная синхропосылка (16 HEX символов); лишние цифры отбрасываются
+    uint8_t block[8];
+    qsizetype invalidAt = -1;
+    HexCodec::decode(ivHex, block, sizeof(block), &invalidAt);
+    if (invalidAt >= 0) {
+        if (error) *error = HexCodec::invalidCharError("IV", ivHex, invalidAt);
+        return false;
     }
-}
 
-uint32_t MagmaCTRCipher::hexToUint32(const QString& hex) const
-{
-    bool ok;
-    uint32_t value = hex.toUInt(&ok, 16);
-    return ok ? value : 0;
+    // Преобразуем IV в 64-битное число (big-endian)
+    ctr = MagmaCore::loadBlock(block);
+    return true;
 }
 
-QString MagmaCTRCipher::uint32ToHex(uint32_t value) const
-{
-    return QString("%1").arg(value, 8, 16, QChar('0')).toUpper();
+namespace {
+    // Куски для CipherParallel: не меньше 256 КБ на поток; между отчетами
+    // о ходе — пачка по 4 МБ, чтобы всем потокам хватило работы
+    const qsizetype PARALLEL_MIN_BLOCKS = 32768;
+    const qsizetype PARALLEL_BATCH_BLOCKS = qsizetype(1) << 19;
 }
 
-uint64_t MagmaCTRCipher::hexToUint64(const QString& hex) const
+void MagmaCTRCipher::ctrProcess(const uint8_t* in, uint8_t* out, qsizetype len,
+                                const std::array<uint32_t, 32>& roundKeys, uint64_t ctr) const
 {
-    bool ok;
-    uint64_t value = hex.toULongLong(&ok, 16);
-    return ok ? value : 0;
+    // Блоки гаммы независимы: кусок index начинается со счетчика ctr + begin
+    // и пишет прямо в свою часть out, результат совпадает с последовательным
+    const qsizetype blocks = (len + 7) / 8;
+    const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BLOCKS);
+    CipherParallel::run(chunks, [&](int index) {
+        const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+        const qsizetype end = qMin(CipherParallel::chunkBegin(blocks, chunks, index + 1) * 8, len);
+        uint64_t counter = ctr + static_cast<uint64_t>(begin);
+
+        // Гамма = E(счетчик, ключ) пачками по BITSLICE_BLOCKS блоков: целая пачка
+        // шифруется побитово-срезовым ядром, если процессор его поддерживает
+        uint8_t gamma[MagmaCore::BITSLICE_BLOCKS * 8];
+        for (qsizetype i = begin * 8; i < end; ) {
+            const qsizetype chunk = qMin<qsizetype>(sizeof(gamma), end - i);
+            const qsizetype count = (chunk + 7) / 8;
+            for (qsizetype b = 0; b < count; ++b) {
+                // Счетчик инкрементируется по модулю 2^64
+                MagmaCore::storeBlock(gamma + b * 8, counter++);
+            }
+            MagmaCore::encryptBlocks(gamma, gamma, count, roundKeys);
+
+            // XOR гаммы с данными (последний блок может быть неполным)
+            for (qsizetype j = 0; j < chunk; ++j) {
+                out[i + j] = in[i + j] ^ gamma[j];
+            }
+            i += chunk;
+        }
+        KeyScheduleCache::secureZero(gamma, sizeof(gamma));
+    });
 }
 
-QString MagmaCTRCipher::uint64ToHex(uint64_t value) const
+// ==================== Бинарный путь ====================
+bool MagmaCTRCipher::prepareCtr(const QVariantMap& params,
+                                std::shared_ptr<const std::array<uint32_t, 32>>& roundKeys,
+                                uint64_t& ctr, QString* error) const
 {
-    return QString("%1").arg(value, 16, 16, QChar('0')).toUpper();
-}
+    QString ivHex = params.value("iv", "").toString();
 
-// ==================== Преобразование t (формула 14) ====================
-// t(a) = t(a7||...||a0) = π7(a7)||...||π0(a0)
-uint32_t MagmaCTRCipher::tTransform(uint32_t x) const
-{
-    uint32_t result = 0;
-
-    for (int i = 0; i < 8; ++i) {
-        uint8_t nibble = (x >> (4 * i)) & 0xF;
-        uint8_t substituted;
-
-        switch (i) {
-            case 0: substituted = PI0[nibble]; break;
-            case 1: substituted = PI1[nibble]; break;
-            case 2: substituted = PI2[nibble]; break;
-            case 3: substituted = PI3[nibble]; break;
-            case 4: substituted = PI4[nibble]; break;
-            case 5: substituted = PI5[nibble]; break;
-            case 6: substituted = PI6[nibble]; break;
-            case 7: substituted = PI7[nibble]; break;
-            default: substituted = nibble;
-        }
+    if (!prepareRoundKeys(params, roundKeys, error)) {
+        return false;
+    }
 
-        result |= (static_cast<uint32_t>(substituted) << (4 * i));
+    // Проверяем IV
+    if (ivHex.isEmpty()) {
+        if (error) *error = "ОШИБКА: Не указана синхропосылка (IV) (64 бита в HEX)";
+        return false;
     }
 
-    return result;
+    return initialCounter(ivHex, ctr, error);
 }
 
-// Циклический сдвиг влево на 11 бит
-uint32_t MagmaCTRCipher::leftShift11(uint32_t x) const
+bool MagmaCTRCipher::prepareRoundKeys(const QVariantMap& params,
+                                      std::shared_ptr<const std::array<uint32_t, 32>>& roundKeys,
+                                      QString* error) const
 {
-    return (x << 11) | (x >> (32 - 11));
-}
+    QString keyHex = params.value("key", "").toString();
 
-// Функция g (формула 15): g[k](a) = (t((a + k) mod 2^32)) <<< 11
-uint32_t MagmaCTRCipher::gFunction(uint32_t a, uint32_t k) const
-{
-    uint32_t sum = a + k;
-    uint32_t transformed = tTransform(sum);
-    return leftShift11(transformed);
+    // Проверяем ключ
+    if (keyHex.isEmpty()) {
+        if (error) *error = "ОШИБКА: Не указан ключ шифрования (256 бит в HEX)";
+        return false;
+    }
+
+    // Короткий ключ дополняется нулями, длинный обрезается до 256 бит;
+    // расписание то же, что у Магмы ECB, поэтому запись в кэше общая
+    std::array<uint8_t, 32> key{};
+    qsizetype invalidAt = -1;
+    HexCodec::decode(keyHex, key.data(), qsizetype(key.size()), &invalidAt);
+    if (invalidAt >= 0) {
+        KeyScheduleCache::secureZero(key.data(), key.size());
+        if (error) *error = HexCodec::invalidCharError("Ключ", keyHex, invalidAt);
+        return false;
+    }
+    roundKeys = KeyScheduleCache::instance().get<std::array<uint32_t, 32>>(
+        "magma", key.data(), int(key.size()),
+        [&] { return MagmaCore::keySchedule(key.data()); });
+    KeyScheduleCache::secureZero(key.data(), key.size());
+    return true;
 }
 
-// Раундовое преобразование G (формула 16): G[k](a1, a0) = (a0, g[k](a0) ⊕ a1)
-std::pair<uint32_t, uint32_t> MagmaCTRCipher::G(uint32_t a1, uint32_t a0, uint32_t k) const
+bool MagmaCTRCipher::parseMode(const QVariantMap& params, bool& mgm, QString* error)
 {
-    return std::make_pair(a0, gFunction(a0, k) ^ a1);
+    const QString name = params.value("mode", "CTR").toString().trimmed().toUpper();
+    if (name.isEmpty() || name == "CTR") {
+        mgm = false;
+    } else if (name == "MGM") {
+        mgm = true;
+    } else {
+        if (error) *error = QString("ОШИБКА: Неизвестный режим: %1 (ожидается CTR или MGM)").arg(name);
+        return false;
+    }
+    return true;
 }
 
-// Заключительное преобразование G* (формула 17): G*[k](a1, a0) = (g[k](a0) ⊕ a1) || a0
-uint64_t MagmaCTRCipher::GStar(uint32_t a1, uint32_t a0, uint32_t k) const
+Gost3413::Prepare MagmaCTRCipher::blockPreparer() const
 {
-    uint32_t left = gFunction(a0, k) ^ a1;
-    return (static_cast<uint64_t>(left) << 32) | static_cast<uint64_t>(a0);
+    return [cipher = *this](const QVariantMap& params, std::shared_ptr<const Gost3413Block>& block,
+                            QString* error) {
+        std::shared_ptr<const std::array<uint32_t, 32>> roundKeys;
+        if (!cipher.prepareRoundKeys(params, roundKeys, error)) {
+            return false;
+        }
+        block = std::make_shared<MagmaBlock>(std::move(roundKeys));
+        return true;
+    };
 }
 
-// ==================== Развертывание ключа (формула 18) ====================
-std::array<uint32_t, 32> MagmaCTRCipher::keySchedule(const QString& keyHex) const
+// ==================== Потоковый режим ====================
+class MagmaCTRStream : public KeystreamCipherStream
 {
-    std::array<uint32_t, 32> roundKeys;
-    roundKeys.fill(0);
-
-    QString cleanKey = prepareHexInput(keyHex);
-
-    // Ключ должен быть 64 HEX символа (256 бит)
-    if (cleanKey.length() < 64) {
-        cleanKey = cleanKey.leftJustified(64, '0', true);
-    }
-    if (cleanKey.length() > 64) {
-        cleanKey = cleanKey.left(64);
+public:
+    explicit MagmaCTRStream(const MagmaCTRCipher& cipher)
+        : KeystreamCipherStream(8), m_cipher(cipher)
+    {
+        setBatchBlocks(PARALLEL_BATCH_BLOCKS);
     }
 
-    // Разбираем 256-битный ключ на 8 32-битных частей (big-endian)
-    std::array<uint32_t, 8> keyParts;
-    for (int i = 0; i < 8; ++i) {
-        QString partHex = cleanKey.mid(i * 8, 8);
-        keyParts[i] = hexToUint32(partHex);
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        reset();
+        return m_cipher.prepareCtr(params, m_roundKeys, m_ctr, error);
     }
 
-    // Формируем 32 итерационных ключа по формуле 18:
-    // K1..K8 = ключ
-    // K9..K16 = K1..K8
-    // K17..K24 = K1..K8
-    // K25..K32 = K8..K1
-    for (int i = 0; i < 24; ++i) {
-        roundKeys[i] = keyParts[i % 8];
-    }
-    for (int i = 0; i < 8; ++i) {
-        roundKeys[24 + i] = keyParts[7 - i];
+protected:
+    void nextKeystream(uint8_t* block) override
+    {
+        uint64_t gamma = MagmaCore::encryptBlock(m_ctr++, *m_roundKeys);
+        for (int j = 0; j < 8; ++j) {
+            block[j] = static_cast<uint8_t>(gamma >> (56 - j * 8));
+        }
     }
 
-    return roundKeys;
-}
-
-// ==================== Шифрование одного блока (формула 19) ====================
-// E(a) = G*[K32] ◦ G[K31] ◦ ... ◦ G[K2] ◦ G[K1](a1, a0)
-uint64_t MagmaCTRCipher::encryptBlock(uint64_t block, const std::array<uint32_t, 32>& roundKeys) const
-{
-    // Разбиваем 64-битный блок на две 32-битные половины (big-endian)
-    uint32_t a1 = static_cast<uint32_t>(block >> 32);
-    uint32_t a0 = static_cast<uint32_t>(block & 0xFFFFFFFF);
-
-    // Раунды 1..31: G[K1]..G[K31]
-    for (int i = 0; i < 31; ++i) {
-        auto result = G(a1, a0, roundKeys[i]);
-        a1 = result.first;
-        a0 = result.second;
+    void xorBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+    {
+        m_cipher.ctrProcess(in, out, blocks * 8, *m_roundKeys, m_ctr);
+        m_ctr += static_cast<uint64_t>(blocks);
     }
 
-    // Раунд 32: G*[K32]
-    return GStar(a1, a0, roundKeys[31]);
-}
+private:
+    MagmaCTRCipher m_cipher;
+    std::shared_ptr<const std::array<uint32_t, 32>> m_roundKeys;
+    uint64_t m_ctr = 0;
+};
 
-// ==================== Режим CTR (ГОСТ Р 34.13-2015, раздел 5.2) ====================
-QByteArray MagmaCTRCipher::ctrProcess(const QByteArray& data, const QString& keyHex, const QString& ivHex) const
+// Режим выбирается в init: CTR — свой поток, MGM — общий из Gost3413
+class MagmaCTRModeStream : public CipherStream
 {
-    if (data.isEmpty()) return QByteArray();
-
-    // Разворачиваем ключ
-    std::array<uint32_t, 32> roundKeys = keySchedule(keyHex);
-
-    // IV — 64-битная синхропосылка (16 HEX символов)
-    QString cleanIV = prepareHexInput(ivHex);
-    if (cleanIV.length() < 16) {
-        cleanIV = cleanIV.leftJustified(16, '0', true);
-    } else if (cleanIV.length() > 16) {
-        cleanIV = cleanIV.left(16);
+public:
+    MagmaCTRModeStream(const MagmaCTRCipher& cipher, bool encrypt)
+        : m_cipher(cipher), m_encrypt(encrypt) {}
+
+    bool init(const QVariantMap& params, QString* error = nullptr) override
+    {
+        m_stream.reset();
+        bool mgm = false;
+        if (!MagmaCTRCipher::parseMode(params, mgm, error)) {
+            return false;
+        }
+        if (mgm) {
+            m_stream = Gost3413::createStream(m_cipher.blockPreparer(), 8, m_encrypt);
+        } else {
+            m_stream = std::make_unique<MagmaCTRStream>(m_cipher);
+        }
+        return m_stream->init(params, error);
     }
 
-    // Преобразуем IV в 64-битное число (big-endian)
-    uint64_t ctr = 0;
-    for (int i = 0; i < 8; ++i) {
-        ctr = (ctr << 8) | cleanIV.mid(i * 2, 2).toUInt(nullptr, 16);
+    bool update(const char* data, qsizetype len, QByteArray& out, QString* error = nullptr) override
+    {
+        return m_stream ? m_stream->update(data, len, out, error) : notInitialized(error);
     }
 
-    QByteArray result;
-    result.reserve(data.size());
+    bool final(QByteArray& out, QString* error = nullptr) override
+    {
+        return m_stream ? m_stream->final(out, error) : notInitialized(error);
+    }
 
-    // Обрабатываем данные блоками по 8 байт (64 бита)
-    for (int i = 0; i < data.size(); i += 8) {
-        // Текущий блок счетчика
-        uint64_t inputBlock = ctr;
+    using CipherStream::update;
 
-        // Гамма = E(счетчик, ключ)
-        uint64_t gamma = encryptBlock(inputBlock, roundKeys);
+private:
+    static bool notInitialized(QString* error)
+    {
+        if (error) *error = "ОШИБКА: Контекст режима не инициализирован";
+        return false;
+    }
 
-        // Преобразуем гамму в байты (big-endian)
-        QByteArray gammaBytes(8, 0);
-        for (int j = 0; j < 8; ++j) {
-            gammaBytes[j] = static_cast<char>((gamma >> (56 - j * 8)) & 0xFF);
-        }
+    MagmaCTRCipher m_cipher;
+    bool m_encrypt;
+    std::unique_ptr<CipherStream> m_stream;
+};
 
-        // Берем блок данных
-        QByteArray chunk = data.mid(i, 8);
+std::unique_ptr<CipherStream> MagmaCTRCipher::createStream(bool encrypt)
+{
+    return std::make_unique<MagmaCTRModeStream>(*this, encrypt);
+}
 
-        // XOR гаммы с данными
-        QByteArray encryptedBlock(8, 0);
-        for (int j = 0; j < chunk.size(); ++j) {
-            encryptedBlock[j] = chunk[j] ^ gammaBytes[j];
-        }
+bool MagmaCTRCipher::encryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    bool mgm = false;
+    if (!parseMode(params, mgm, error)) {
+        out.clear();
+        return false;
+    }
+    if (mgm) {
+        return Gost3413::processBytes(blockPreparer(), 8, in, out, params, true, error);
+    }
 
-        // Обрезаем до исходной длины для последнего блока
-        if (i + 8 > data.size()) {
-            int remaining = data.size() - i;
-            result.append(encryptedBlock.left(remaining));
-        } else {
-            result.append(encryptedBlock);
-        }
+    MagmaCTRStream stream(*this);
+    if (!stream.init(params, error)) {
+        out.clear();
+        return false;
+    }
 
-        // Инкрементируем счетчик (по модулю 2^64)
-        ctr++;
+    // Через промежуточный буфер: in и out могут быть одним объектом
+    QByteArray buffer;
+    buffer.reserve(in.size());
+    if (!stream.update(in, buffer, error) || !stream.final(buffer, error)) {
+        out.clear();
+        return false;
     }
+    out = buffer;
+    return true;
+}
 
-    return result;
+// Для режима CTR расшифрование идентично зашифрованию (XOR симметричен)
+bool MagmaCTRCipher::decryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
+{
+    bool mgm = false;
+    if (!parseMode(params, mgm, error)) {
+        out.clear();
+        return false;
+    }
+    if (mgm) {
+        return Gost3413::processBytes(blockPreparer(), 8, in, out, params, false, error);
+    }
+    return encryptBytes(in, out, params, error);
 }
 
 // ==================== Шифрование ====================
 CipherResult MagmaCTRCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    return processHex(text, params, true);
+}
+
+// ==================== Дешифрование ====================
+// Для режима CTR дешифрование идентично шифрованию (XOR симметричен),
+// в MGM дополнительно сверяется имитовставка
+CipherResult MagmaCTRCipher::decrypt(const QString& text, const QVariantMap& params)
+{
+    return processHex(text, params, false);
+}
+
+CipherResult MagmaCTRCipher::processHex(const QString& text, const QVariantMap& params, bool encrypt)
+{
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = true;
 
+    QString error;
+    bool mgm = false;
+    if (!parseMode(params, mgm, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
+    }
+    const QString modeName = mgm ? "MGM" : "CTR";
+
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало шифрования Магма (режим CTR)", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(),
+            QString("Начало %1 Магма (режим %2)").arg(encrypt ? "шифрования" : "расшифрования").arg(modeName),
+            "Инициализация"));
+    }
 
     // Получаем параметры
     QString keyHex = params.value("key", "").toString();
     QString ivHex = params.value("iv", "").toString();
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Ключ: %1").arg(keyHex.isEmpty() ? "(пустой)" : keyHex.left(16) + "..."),
-        "Параметры"));
-    steps.append(CipherStep(2, QChar(),
-        QString("Синхропосылка (IV): %1").arg(ivHex.isEmpty() ? "(пустая)" : ivHex),
-        "Параметры"));
-
-    // Проверяем ключ
-    if (keyHex.isEmpty()) {
-        result.result = "ОШИБКА: Не указан ключ шифрования (256 бит в HEX)";
-        return result;
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Ключ: %1").arg(keyHex.isEmpty() ? "(пустой)" : keyHex.left(16) + "..."),
+            "Параметры"));
+    }
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString(mgm ? "Nonce: %1" : "Синхропосылка (IV): %1").arg(ivHex.isEmpty() ? "(пустая)" : ivHex),
+            "Параметры"));
     }
 
-    // Проверяем IV
-    if (ivHex.isEmpty()) {
-        result.result = "ОШИБКА: Не указана синхропосылка (IV) (64 бита в HEX)";
-        return result;
+    // Проверяем ключ и IV (nonce MGM проверяется при обработке)
+    MagmaCTRStream stream(*this);
+    if (!mgm && !stream.init(params, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
     }
 
     // Подготавливаем входные данные
-    QString hexData = prepareHexInput(text);
-    if (hexData.isEmpty()) {
-        result.result = "ОШИБКА: Нет данных для шифрования (введите HEX-строку)";
-        return result;
+    // Преобразуем HEX-строку в байты
+    qsizetype invalidAt = -1;
+    const QByteArray data = HexCodec::decode(text, nullptr, &invalidAt);
+    if (invalidAt >= 0) {
+        result.fail(CipherStatus::InvalidInput, HexCodec::invalidCharError("Текст", text, invalidAt));
+        return trace.finish(result);
+    }
+    if (data.isEmpty()) {
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Нет данных для шифрования (введите HEX-строку)");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Входные данные (HEX): %1").arg(hexData.left(64) + (hexData.length() > 64 ? "..." : "")),
-        "Данные"));
-
-    // Преобразуем HEX-строку в байты
-    QByteArray data = QByteArray::fromHex(hexData.toLatin1());
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Входные данные (HEX): %1").arg(HexCodec::encode(data.left(32)) + (data.size() > 32 ? "..." : "")),
+            "Данные"));
+    }
 
-    steps.append(CipherStep(4, QChar(),
-        QString("Длина данных: %1 байт").arg(data.size()),
-        "Данные"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(4, QChar(),
+            QString("Длина данных: %1 байт").arg(data.size()),
+            "Данные"));
+    }
 
-    // Выполняем шифрование в режиме CTR
-    QByteArray encrypted = ctrProcess(data, keyHex, ivHex);
+    QByteArray processed;
+    if (mgm) {
+        CipherStatus status = CipherStatus::Ok;
+        if (!Gost3413::processBytes(blockPreparer(), 8, data, processed, params, encrypt, &error, &status)) {
+            result.fail(status, error);
+            return trace.finish(result);
+        }
+    } else {
+        // Выполняем шифрование в режиме CTR
+        processed.reserve(data.size());
+        if (!stream.update(data, processed, &error) || !stream.final(processed, &error)) {
+            result.fail(CipherProgress::canceled() ? CipherStatus::Canceled : CipherStatus::InvalidInput, error);
+            return trace.finish(result);
+        }
+    }
 
     // Преобразуем результат в HEX
-    QString resultHex = encrypted.toHex().toUpper();
+    QString resultHex = HexCodec::encode(processed);
 
-    steps.append(CipherStep(5, QChar(),
-        QString("Результат (HEX): %1").arg(resultHex.left(64) + (resultHex.length() > 64 ? "..." : "")),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(5, QChar(),
+            QString(mgm && encrypt ? "Шифртекст и имитовставка (HEX): %1" : "Результат (HEX): %1")
+                .arg(resultHex.left(64) + (resultHex.length() > 64 ? "..." : "")),
+            "Завершение"));
+    }
 
     result.result = resultHex;
     result.steps = steps;
 
-    return result;
-}
-
-// ==================== Дешифрование ====================
-// Для режима CTR дешифрование идентично шифрованию (XOR симметричен)
-CipherResult MagmaCTRCipher::decrypt(const QString& text, const QVariantMap& params)
-{
-    return encrypt(text, params);
+    return trace.finish(result);
 }
 
 // ==================== Регистратор ====================
@@ -408,6 +482,19 @@ MagmaCTRCipherRegister::MagmaCTRCipherRegister()
             keyRow->addStretch();
             vbox->addLayout(keyRow);
 
+            // Режим: гаммирование или MGM
+            QHBoxLayout* modeRow = new QHBoxLayout();
+            QLabel* modeLabel = new QLabel("Режим:");
+            modeLabel->setFixedWidth(120);
+            QComboBox* modeCombo = new QComboBox();
+            modeCombo->addItem("CTR — гаммирование", "CTR");
+            modeCombo->addItem("MGM — шифрование с имитовставкой", "MGM");
+            modeCombo->setObjectName("mode");
+            modeRow->addWidget(modeLabel);
+            modeRow->addWidget(modeCombo);
+            modeRow->addStretch();
+            vbox->addLayout(modeRow);
+
             // Строка для IV
             QHBoxLayout* ivRow = new QHBoxLayout();
             QLabel* ivLabel = new QLabel("Синхропосылка (IV):");
@@ -421,6 +508,19 @@ MagmaCTRCipherRegister::MagmaCTRCipherRegister()
             ivRow->addStretch();
             vbox->addLayout(ivRow);
 
+            // Дополнительные данные MGM
+            QHBoxLayout* aadRow = new QHBoxLayout();
+            QLabel* aadLabel = new QLabel("AAD:");
+            aadLabel->setFixedWidth(120);
+            MagmaCTRHexEdit* aadEdit = new MagmaCTRHexEdit();
+            aadEdit->setObjectName("aad");
+            aadEdit->setPlaceholderText("HEX (необязательно)");
+            aadEdit->setEnabled(false);
+            aadRow->addWidget(aadLabel);
+            aadRow->addWidget(aadEdit);
+            aadRow->addStretch();
+            vbox->addLayout(aadRow);
+
             // Информационная панель с контрольными примерами
             QLabel* infoLabel = new QLabel(
                 "Магма (ГОСТ Р 34.12-2015) — режим гаммирования (CTR) по ГОСТ Р 34.13-2015:\n"
@@ -432,7 +532,9 @@ MagmaCTRCipherRegister::MagmaCTRCipherRegister()
                 "  Ключ: ffeeddccbbaa99887766554433221100f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff\n"
                 "  IV: 12345678\n"
                 "  Открытый текст: 92def06b3c130a59\n"
-                "  Шифртекст: 4e98110c97b7b93c"
+                "  Шифртекст: 4e98110c97b7b93c\n\n"
+                "MGM (Р 1323565.1.026-2019): nonce — 16 HEX символов со старшим битом 0,\n"
+                "к шифртексту дописывается 8-байтная имитовставка, AAD только аутентифицируются"
             );
             infoLabel->setStyleSheet("color: #666; padding: 5px; background-color: #f5f5f5; border-radius: 3px;");
             infoLabel->setWordWrap(true);
@@ -441,7 +543,16 @@ MagmaCTRCipherRegister::MagmaCTRCipherRegister()
             layout->addWidget(container);
 
             widgets["key"] = keyEdit;
+            widgets["mode"] = modeCombo;
             widgets["iv"] = ivEdit;
+            widgets["aad"] = aadEdit;
+
+            QObject::connect(modeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                [modeCombo, ivEdit, aadEdit](int) {
+                    const bool mgm = (modeCombo->currentData().toString() == "MGM");
+                    aadEdit->setEnabled(mgm);
+                    ivEdit->setHex(mgm ? "12def06b3c130a59" : "12345678");
+                });
         }
     );
 }
@@ -3,9 +3,11 @@
 
 #include "cipherinterface.h"
 #include "ciphercore.h"
+#include "gost3413.h"
 #include <QVector>
 #include <array>
 #include <cstdint>
+#include <memory>
 
 // Класс шифра Магма в режиме гаммирования (CTR)
 // ГОСТ Р 34.12-2015 (блочный шифр) и ГОСТ Р 34.13-2015 (режим CTR)
@@ -22,43 +24,40 @@ public:
     virtual CipherResult encrypt(const QString& text, const QVariantMap& params) override;
     virtual CipherResult decrypt(const QString& text, const QVariantMap& params) override;
 
+    // Бинарный путь: данные любой длины, ключ и IV — HEX в params["key"], params["iv"].
+    // params["mode"] = "MGM" — аутентифицированное шифрование Р 1323565.1.026-2019:
+    // IV — 8-байтный nonce, AAD — params["aad"], к шифртексту дописывается имитовставка
+    virtual bool supportsBytes() const override { return true; }
+    virtual bool encryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+    virtual bool decryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+
+    // Потоковый режим: гамма продолжается с места, где остановился предыдущий update
+    virtual std::unique_ptr<CipherStream> createStream(bool encrypt) override;
+
 private:
-    // S-блоки из ГОСТ Р 34.12-2015, раздел 5.1.1 (π0'..π7')
-    static const std::array<uint8_t, 16> PI0;
-    static const std::array<uint8_t, 16> PI1;
-    static const std::array<uint8_t, 16> PI2;
-    static const std::array<uint8_t, 16> PI3;
-    static const std::array<uint8_t, 16> PI4;
-    static const std::array<uint8_t, 16> PI5;
-    static const std::array<uint8_t, 16> PI6;
-    static const std::array<uint8_t, 16> PI7;
-
-    // Преобразования (формулы 14-17)
-    uint32_t tTransform(uint32_t x) const;
-    uint32_t leftShift11(uint32_t x) const;
-    uint32_t gFunction(uint32_t a, uint32_t k) const;
-
-    // Раундовые преобразования (формулы 16-17)
-    std::pair<uint32_t, uint32_t> G(uint32_t a1, uint32_t a0, uint32_t k) const;
-    uint64_t GStar(uint32_t a1, uint32_t a0, uint32_t k) const;
-
-    // Шифрование одного 64-битного блока (формула 19)
-    uint64_t encryptBlock(uint64_t block, const std::array<uint32_t, 32>& roundKeys) const;
-
-    // Развертывание ключа (формула 18)
-    std::array<uint32_t, 32> keySchedule(const QString& keyHex) const;
+    friend class MagmaCTRStream;
+    friend class MagmaCTRModeStream;
 
     // Режим CTR (ГОСТ Р 34.13-2015, раздел 5.2)
-    QByteArray ctrProcess(const QByteArray& data, const QString& keyHex, const QString& ivHex) const;
-
-    // Вспомогательные функции
-    QString prepareHexInput(const QString& text) const;
-    QString bytesToHex(const uint8_t* data, int len) const;
-    void hexToBytes(const QString& hex, uint8_t* out, int len) const;
-    uint32_t hexToUint32(const QString& hex) const;
-    QString uint32ToHex(uint32_t value) const;
-    uint64_t hexToUint64(const QString& hex) const;
-    QString uint64ToHex(uint64_t value) const;
+    bool initialCounter(const QString& ivHex, uint64_t& ctr, QString* error) const;
+    bool prepareRoundKeys(const QVariantMap& params, std::shared_ptr<const std::array<uint32_t, 32>>& roundKeys,
+                          QString* error) const;
+    bool prepareCtr(const QVariantMap& params, std::shared_ptr<const std::array<uint32_t, 32>>& roundKeys,
+                    uint64_t& ctr, QString* error) const;
+    // len байт с гаммой от счетчика ctr; большие объемы — куски в разных потоках
+    void ctrProcess(const uint8_t* in, uint8_t* out, qsizetype len,
+                    const std::array<uint32_t, 32>& roundKeys, uint64_t ctr) const;
+
+    // Режим из params["mode"]: CTR (по умолчанию) или MGM
+    static bool parseMode(const QVariantMap& params, bool& mgm, QString* error);
+
+    // Разбор ключа для MGM поверх режимов ГОСТ Р 34.13-2015
+    Gost3413::Prepare blockPreparer() const;
+
+    // Общая часть encrypt/decrypt для QString-адаптера
+    CipherResult processHex(const QString& text, const QVariantMap& params, bool encrypt);
 
     // Алфавит для вывода
     QString m_alphabet = "HEX";
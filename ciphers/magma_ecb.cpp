@@ -1,23 +1,17 @@
 #include "magma_ecb.h"
 #include "cipherfactory.h"
 #include "cipherwidgetfactory.h"
+#include "keyschedulecache.h"
+#include "hexcodec.h"
+#include "magmacore.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QComboBox>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 #include <QDebug>
 
-// ==================== S-блоки ГОСТ Р 34.12-2015 ====================
-const std::array<uint8_t, 16> MagmaECBCipher::PI0 = {12, 4, 6, 2, 10, 5, 11, 9, 14, 8, 13, 7, 0, 3, 15, 1};
-const std::array<uint8_t, 16> MagmaECBCipher::PI1 = {6, 8, 2, 3, 9, 10, 5, 12, 1, 14, 4, 7, 11, 13, 0, 15};
-const std::array<uint8_t, 16> MagmaECBCipher::PI2 = {11, 3, 5, 8, 2, 15, 10, 13, 14, 1, 7, 4, 12, 9, 6, 0};
-const std::array<uint8_t, 16> MagmaECBCipher::PI3 = {12, 8, 2, 1, 13, 4, 15, 6, 7, 0, 10, 5, 3, 14, 9, 11};
-const std::array<uint8_t, 16> MagmaECBCipher::PI4 = {7, 15, 5, 10, 8, 1, 6, 13, 0, 9, 3, 14, 11, 4, 2, 12};
-const std::array<uint8_t, 16> MagmaECBCipher::PI5 = {5, 13, 15, 6, 9, 2, 12, 10, 11, 7, 8, 1, 4, 3, 14, 0};
-const std::array<uint8_t, 16> MagmaECBCipher::PI6 = {8, 14, 2, 5, 6, 9, 1, 12, 15, 4, 11, 0, 13, 10, 3, 7};
-const std::array<uint8_t, 16> MagmaECBCipher::PI7 = {1, 7, 14, 13, 0, 5, 8, 3, 4, 15, 10, 6, 9, 12, 11, 2};
-
 // ==================== MagmaECBHexEdit Implementation ====================
 
 MagmaECBHexEdit::MagmaECBHexEdit(QWidget* parent)
@@ -75,359 +69,194 @@ MagmaECBCipher::MagmaECBCipher()
 {
 }
 
-QString MagmaECBCipher::prepareHexInput(const QString& text) const
-{
-    QString filtered;
-    QRegularExpression hexRegex("[0-9A-Fa-f]");
-    QRegularExpressionMatchIterator it = hexRegex.globalMatch(text);
-    while (it.hasNext()) {
-        filtered.append(it.next().captured());
-    }
-    return filtered.toUpper();
-}
+// ==================== Бинарный путь ====================
+// Блок в байтах — big-endian представление 64-битного числа
 
-QString MagmaECBCipher::bytesToHex(const uint8_t* data, int len) const
+bool MagmaECBCipher::prepareRoundKeys(const QVariantMap& params,
+                                      std::shared_ptr<const std::array<uint32_t, 32>>& roundKeys,
+                                      QString* error) const
 {
-    QString result;
-    for (int i = 0; i < len; i++) {
-        result.append(QString("%1").arg(data[i], 2, 16, QChar('0')).toUpper());
+    const QString keyText = params.value("key", "").toString();
+    std::array<uint8_t, 32> key{};
+    qsizetype invalidAt = -1;
+    const int keyDigits = int(HexCodec::decode(keyText, key.data(), qsizetype(key.size()), &invalidAt));
+    if (invalidAt >= 0) {
+        KeyScheduleCache::secureZero(key.data(), key.size());
+        if (error) *error = HexCodec::invalidCharError("Ключ", keyText, invalidAt);
+        return false;
     }
-    return result;
-}
 
-void MagmaECBCipher::hexToBytes(const QString& hex, uint8_t* out, int len) const
-{
-    QByteArray bytes = QByteArray::fromHex(hex.toLatin1());
-    for (int i = 0; i < len && i < bytes.size(); i++) {
-        out[i] = static_cast<uint8_t>(bytes[i]);
+    if (keyDigits != 64) {
+        KeyScheduleCache::secureZero(key.data(), key.size());
+        if (error) {
+            *error = QString("ОШИБКА: Ключ должен быть 64 HEX символа (256 бит). Получено: %1")
+                     .arg(keyDigits);
+        }
+        return false;
     }
-}
-
-uint32_t MagmaECBCipher::hexToUint32(const QString& hex) const
-{
-    bool ok;
-    uint32_t value = hex.toUInt(&ok, 16);
-    return ok ? value : 0;
-}
-
-QString MagmaECBCipher::uint32ToHex(uint32_t value) const
-{
-    return QString("%1").arg(value, 8, 16, QChar('0')).toUpper();
-}
-
-uint64_t MagmaECBCipher::hexToUint64(const QString& hex) const
-{
-    bool ok;
-    uint64_t value = hex.toULongLong(&ok, 16);
-    return ok ? value : 0;
-}
 
-QString MagmaECBCipher::uint64ToHex(uint64_t value) const
-{
-    return QString("%1").arg(value, 16, 16, QChar('0')).toUpper();
+    // Расшифрование — те же раунды с обратным порядком ключей, поэтому
+    // достаточно одного расписания K1..K32
+    roundKeys = KeyScheduleCache::instance().get<std::array<uint32_t, 32>>(
+        "magma", key.data(), int(key.size()),
+        [&] { return MagmaCore::keySchedule(key.data()); });
+    KeyScheduleCache::secureZero(key.data(), key.size());
+    return true;
 }
 
-// Нелинейное биективное преобразование t: V32 → V32 (формула 14 ГОСТ Р 34.12-2015)
-uint32_t MagmaECBCipher::tTransform(uint32_t x) const
+Gost3413::Prepare MagmaECBCipher::blockPreparer() const
 {
-    uint32_t result = 0;
-
-    // Разбиваем на 8 полубайт (4 бита) и заменяем каждый S-блоком
-    for (int i = 0; i < 8; ++i) {
-        uint8_t nibble = (x >> (4 * i)) & 0xF;
-        uint8_t substituted;
-
-        switch (i) {
-            case 0: substituted = PI0[nibble]; break;
-            case 1: substituted = PI1[nibble]; break;
-            case 2: substituted = PI2[nibble]; break;
-            case 3: substituted = PI3[nibble]; break;
-            case 4: substituted = PI4[nibble]; break;
-            case 5: substituted = PI5[nibble]; break;
-            case 6: substituted = PI6[nibble]; break;
-            case 7: substituted = PI7[nibble]; break;
-            default: substituted = nibble;
+    return [cipher = *this](const QVariantMap& params, std::shared_ptr<const Gost3413Block>& block,
+                            QString* error) {
+        std::shared_ptr<const std::array<uint32_t, 32>> roundKeys;
+        if (!cipher.prepareRoundKeys(params, roundKeys, error)) {
+            return false;
         }
-
-        result |= (static_cast<uint32_t>(substituted) << (4 * i));
-    }
-
-    return result;
+        block = std::make_shared<MagmaBlock>(std::move(roundKeys));
+        return true;
+    };
 }
 
-// Циклический сдвиг влево на 11 бит
-uint32_t MagmaECBCipher::leftShift11(uint32_t x) const
+std::unique_ptr<CipherStream> MagmaECBCipher::createStream(bool encrypt)
 {
-    return (x << 11) | (x >> (32 - 11));
+    return Gost3413::createStream(blockPreparer(), 8, encrypt);
 }
 
-// Функция g[k](a) = (t((a + k) mod 2^32)) <<< 11 (формула 15 ГОСТ Р 34.12-2015)
-uint32_t MagmaECBCipher::g(uint32_t a, uint32_t k) const
+// ГОСТ Р 34.13-2015, раздел 5: ECB — формула (1), остальные режимы — по params["mode"]
+bool MagmaECBCipher::encryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
 {
-    uint32_t sum = a + k;  // сложение по модулю 2^32
-    uint32_t transformed = tTransform(sum);
-    return leftShift11(transformed);
+    return Gost3413::processBytes(blockPreparer(), 8, in, out, params, true, error);
 }
 
-// Развертывание ключа (формула 18 ГОСТ Р 34.12-2015)
-std::array<uint32_t, 32> MagmaECBCipher::keySchedule(const QString& keyHex) const
+bool MagmaECBCipher::decryptBytes(const QByteArray& in, QByteArray& out, const QVariantMap& params, QString* error)
 {
-    std::array<uint32_t, 32> roundKeys;
-    roundKeys.fill(0);
-
-    QString cleanKey = prepareHexInput(keyHex);
-
-    // Ключ должен быть 64 HEX символа (256 бит)
-    if (cleanKey.length() < 64) {
-        cleanKey = cleanKey.leftJustified(64, '0', true);
-    }
-    if (cleanKey.length() > 64) {
-        cleanKey = cleanKey.left(64);
-    }
-
-    // Разбираем 256-битный ключ на 8 32-битных частей (big-endian)
-    std::array<uint32_t, 8> keyParts;
-    for (int i = 0; i < 8; ++i) {
-        QString partHex = cleanKey.mid(i * 8, 8);
-        keyParts[i] = hexToUint32(partHex);
-    }
-
-    // Формируем 32 итерационных ключа по формуле 18:
-    // K1..K8 = ключ
-    // K9..K16 = K1..K8
-    // K17..K24 = K1..K8
-    // K25..K32 = K8..K1
-    for (int i = 0; i < 24; ++i) {
-        roundKeys[i] = keyParts[i % 8];
-    }
-    for (int i = 0; i < 8; ++i) {
-        roundKeys[24 + i] = keyParts[7 - i];
-    }
-
-    return roundKeys;
+    return Gost3413::processBytes(blockPreparer(), 8, in, out, params, false, error);
 }
 
-// Шифрование одного 64-битного блока (формула 19 ГОСТ Р 34.12-2015)
-uint64_t MagmaECBCipher::encryptBlock(uint64_t block, const std::array<uint32_t, 32>& roundKeys) const
-{
-    // Разбиваем блок на левую и правую части (по 32 бита)
-    // a = a1 || a0, где a1 - старшие 32 бита, a0 - младшие 32 бита
-    uint32_t a1 = static_cast<uint32_t>(block >> 32);
-    uint32_t a0 = static_cast<uint32_t>(block & 0xFFFFFFFF);
-
-    // Раунды 1..31: G[k](a1, a0) = (a0, g[k](a0) ⊕ a1)
-    for (int i = 0; i < 31; ++i) {
-        uint32_t new_a1 = a0;
-        uint32_t new_a0 = g(a0, roundKeys[i]) ^ a1;
-        a1 = new_a1;
-        a0 = new_a0;
-    }
-
-    // Раунд 32: G*[k](a1, a0) = (g[k](a0) ⊕ a1) || a0
-    uint32_t left = g(a0, roundKeys[31]) ^ a1;
-
-    // Результат: left (32 бита) || a0 (32 бита)
-    return (static_cast<uint64_t>(left) << 32) | static_cast<uint64_t>(a0);
-}
+// ==================== Шифрование / расшифрование (HEX) ====================
 
-// ==================== Шифрование (режим простой замены) ====================
-// ГОСТ Р 34.13-2015, раздел 5.1.1, формула (1)
-
-CipherResult MagmaECBCipher::encrypt(const QString& text, const QVariantMap& params)
+CipherResult MagmaECBCipher::processHex(const QString& text, const QVariantMap& params, bool encrypt)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = true;
 
-    QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало шифрования Магма (режим простой замены)", "Инициализация"));
-
-    // Получаем ключ
-    QString keyHex = params.value("key", "").toString();
-    QString cleanedKey = prepareHexInput(keyHex);
+    const QString operation = encrypt ? "шифрования" : "расшифрования";
 
-    if (cleanedKey.length() != 64) {
-        result.result = QString("ОШИБКА: Ключ должен быть 64 HEX символа (256 бит). Получено: %1")
-                        .arg(cleanedKey.length());
-        return result;
+    QString error;
+    Gost3413::Mode mode;
+    Gost3413::Padding padding;
+    if (!Gost3413::parseMode(params, mode, &error) || !Gost3413::parsePadding(params, padding, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Ключ: %1").arg(cleanedKey),
-        "Параметры"));
-
-    // Разворачиваем ключ
-    std::array<uint32_t, 32> roundKeys = keySchedule(cleanedKey);
-
-    steps.append(CipherStep(2, QChar(),
-        "Развернуто 32 итерационных ключа",
-        "Развертывание ключа"));
-
-    // Подготавливаем входные данные
-    QString hexData = prepareHexInput(text);
-    if (hexData.isEmpty()) {
-        result.result = "ОШИБКА: Нет данных для шифрования (введите HEX-строку)";
-        return result;
+    QVector<CipherStep> steps;
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(),
+            QString("Начало %1 Магма (режим %2)").arg(operation).arg(Gost3413::modeName(mode)), "Инициализация"));
     }
 
-    // Длина данных должна быть кратна 16 HEX символам (64 бита)
-    if (hexData.length() % 16 != 0) {
-        result.result = QString("ОШИБКА: Длина данных (%1 HEX символов) должна быть кратна 16 (64 бита)")
-                        .arg(hexData.length());
-        return result;
+    std::shared_ptr<const std::array<uint32_t, 32>> roundKeys;
+    if (!prepareRoundKeys(params, roundKeys, &error)) {
+        result.fail(CipherStatus::InvalidParams, error);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Входные данные (HEX): %1").arg(hexData.left(64) + (hexData.length() > 64 ? "..." : "")),
-        "Данные"));
-
-    // Шифрование блоков
-    QString encryptedHex;
-    int blockCounter = 0;
-
-    for (int i = 0; i < hexData.length(); i += 16) {
-        QString blockHex = hexData.mid(i, 16);
-        blockCounter++;
-
-        std::array<uint8_t, 8> block{};
-        hexToBytes(blockHex, block.data(), 8);
-
-        // Преобразуем 8 байт в 64-битное число (big-endian)
-        uint64_t blockNum = 0;
-        for (int j = 0; j < 8; ++j) {
-            blockNum = (blockNum << 8) | block[j];
-        }
-
-        // Шифруем блок
-        uint64_t encryptedNum = encryptBlock(blockNum, roundKeys);
-
-        // Преобразуем обратно в байты (big-endian)
-        std::array<uint8_t, 8> encryptedBlock{};
-        for (int j = 0; j < 8; ++j) {
-            encryptedBlock[j] = (encryptedNum >> (56 - j * 8)) & 0xFF;
-        }
-
-        QString encryptedBlockHex = bytesToHex(encryptedBlock.data(), 8);
-        encryptedHex.append(encryptedBlockHex);
-
-        steps.append(CipherStep(4 + blockCounter, QChar(),
-            QString("Блок %1: %2 → %3").arg(blockCounter).arg(blockHex).arg(encryptedBlockHex),
-            QString("Блок %1").arg(blockCounter)));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Ключ: %1").arg(HexCodec::clean(params.value("key", "").toString())),
+            "Параметры"));
     }
 
-    steps.append(CipherStep(5 + blockCounter, QChar(),
-        QString("Результат: %1").arg(encryptedHex.left(64) + (encryptedHex.length() > 64 ? "..." : "")),
-        "Завершение"));
-
-    result.result = encryptedHex;
-    result.steps = steps;
-
-    return result;
-}
-
-// ==================== Расшифрование (режим простой замены) ====================
-// ГОСТ Р 34.13-2015, раздел 5.1.2, формула (2)
-// Расшифрование выполняется так же, как и зашифрование, но с обратным порядком ключей
-
-CipherResult MagmaECBCipher::decrypt(const QString& text, const QVariantMap& params)
-{
-    CipherResult result;
-    result.cipherName = name();
-    result.alphabet = m_alphabet;
-    result.isNumeric = true;
-
-    QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало расшифрования Магма (режим простой замены)", "Инициализация"));
-
-    // Получаем ключ
-    QString keyHex = params.value("key", "").toString();
-    QString cleanedKey = prepareHexInput(keyHex);
-
-    if (cleanedKey.length() != 64) {
-        result.result = QString("ОШИБКА: Ключ должен быть 64 HEX символа (256 бит). Получено: %1")
-                        .arg(cleanedKey.length());
-        return result;
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            "Развернуто 32 итерационных ключа",
+            "Развертывание ключа"));
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Ключ: %1").arg(cleanedKey),
-        "Параметры"));
-
-    // Разворачиваем ключ
-    std::array<uint32_t, 32> roundKeys = keySchedule(cleanedKey);
-
-    steps.append(CipherStep(2, QChar(),
-        "Развернуто 32 итерационных ключа",
-        "Развертывание ключа"));
-
     // Подготавливаем входные данные
-    QString hexData = prepareHexInput(text);
-    if (hexData.isEmpty()) {
-        result.result = "ОШИБКА: Нет данных для расшифрования (введите HEX-строку)";
-        return result;
+    qsizetype digits = 0;
+    qsizetype invalidAt = -1;
+    const QByteArray input = HexCodec::decode(text, &digits, &invalidAt);
+    if (invalidAt >= 0) {
+        result.fail(CipherStatus::InvalidInput, HexCodec::invalidCharError("Текст", text, invalidAt));
+        return trace.finish(result);
     }
-
-    // Длина данных должна быть кратна 16 HEX символам (64 бита)
-    if (hexData.length() % 16 != 0) {
-        result.result = QString("ОШИБКА: Длина данных (%1 HEX символов) должна быть кратна 16 (64 бита)")
-                        .arg(hexData.length());
-        return result;
+    if (digits == 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Нет данных для %1 (введите HEX-строку)").arg(operation));
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Входные данные (HEX): %1").arg(hexData.left(64) + (hexData.length() > 64 ? "..." : "")),
-        "Данные"));
-
-    // Расшифрование: используем ключи в обратном порядке (K32..K1)
-    // Создаем массив ключей в обратном порядке
-    std::array<uint32_t, 32> reverseRoundKeys;
-    for (int i = 0; i < 32; ++i) {
-        reverseRoundKeys[i] = roundKeys[31 - i];
+    // ECB и CBC — целые блоки по 16 HEX символов (при зашифровании — если нет дополнения),
+    // остальные режимы — целые байты
+    const bool wholeBlocks = (mode == Gost3413::Mode::ECB || mode == Gost3413::Mode::CBC)
+                             && (!encrypt || padding == Gost3413::Padding::None);
+    if (wholeBlocks && digits % 16 != 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Длина данных (%1 HEX символов) должна быть кратна 16 (64 бита)")
+                                                .arg(digits));
+        return trace.finish(result);
+    }
+    if (digits % 2 != 0) {
+        result.fail(CipherStatus::InvalidInput, QString("ОШИБКА: Длина данных должна быть четной. Получено: %1")
+                                                .arg(digits));
+        return trace.finish(result);
     }
 
-    // Расшифрование блоков
-    QString decryptedHex;
-    int blockCounter = 0;
-
-    for (int i = 0; i < hexData.length(); i += 16) {
-        QString blockHex = hexData.mid(i, 16);
-        blockCounter++;
-
-        std::array<uint8_t, 8> block{};
-        hexToBytes(blockHex, block.data(), 8);
-
-        // Преобразуем 8 байт в 64-битное число (big-endian)
-        uint64_t blockNum = 0;
-        for (int j = 0; j < 8; ++j) {
-            blockNum = (blockNum << 8) | block[j];
-        }
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Входные данные (HEX): %1").arg(HexCodec::encode(input.left(32)) + (input.size() > 32 ? "..." : "")),
+            "Данные"));
+    }
 
-        // Расшифровываем блок (используем обратный порядок ключей)
-        uint64_t decryptedNum = encryptBlock(blockNum, reverseRoundKeys);
+    QByteArray output;
+    CipherStatus status = CipherStatus::Ok;
+    if (!Gost3413::processBytes(blockPreparer(), 8, input, output, params, encrypt, &error, &status)) {
+        result.fail(status, error);
+        return trace.finish(result);
+    }
 
-        // Преобразуем обратно в байты (big-endian)
-        std::array<uint8_t, 8> decryptedBlock{};
-        for (int j = 0; j < 8; ++j) {
-            decryptedBlock[j] = (decryptedNum >> (56 - j * 8)) & 0xFF;
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(input.constData());
+    const uint8_t* dst = reinterpret_cast<const uint8_t*>(output.constData());
+    int blockCount = input.size() / 8;
+
+    // Поблочная трассировка — только ECB без дополнения: блок входа соответствует блоку выхода
+    const bool perBlock = mode == Gost3413::Mode::ECB && padding == Gost3413::Padding::None;
+    for (int block = 0; perBlock && block < blockCount; ++block) {
+        if (trace.want(TraceLevel::PerBlock)) {
+            steps.append(CipherStep(5 + block, QChar(),
+                QString("Блок %1: %2 → %3").arg(block + 1)
+                    .arg(HexCodec::encode(src + block * 8, 8))
+                    .arg(HexCodec::encode(dst + block * 8, 8)),
+                QString("Блок %1").arg(block + 1)));
         }
+    }
 
-        QString decryptedBlockHex = bytesToHex(decryptedBlock.data(), 8);
-        decryptedHex.append(decryptedBlockHex);
+    QString resultHex = HexCodec::encode(dst, output.size());
 
-        steps.append(CipherStep(4 + blockCounter, QChar(),
-            QString("Блок %1: %2 → %3").arg(blockCounter).arg(blockHex).arg(decryptedBlockHex),
-            QString("Блок %1").arg(blockCounter)));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(5 + blockCount, QChar(),
+            QString(mode == Gost3413::Mode::MAC ? "Имитовставка: %1" : "Результат: %1")
+                .arg(resultHex.left(64) + (resultHex.length() > 64 ? "..." : "")),
+            "Завершение"));
     }
 
-    steps.append(CipherStep(5 + blockCounter, QChar(),
-        QString("Результат: %1").arg(decryptedHex.left(64) + (decryptedHex.length() > 64 ? "..." : "")),
-        "Завершение"));
-
-    result.result = decryptedHex;
+    result.result = resultHex;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
+}
+
+CipherResult MagmaECBCipher::encrypt(const QString& text, const QVariantMap& params)
+{
+    return processHex(text, params, true);
+}
+
+CipherResult MagmaECBCipher::decrypt(const QString& text, const QVariantMap& params)
+{
+    return processHex(text, params, false);
 }
 
 // ==================== MagmaECBCipherRegister Implementation ====================
@@ -436,7 +265,7 @@ MagmaECBCipherRegister::MagmaECBCipherRegister()
 {
     CipherFactory::instance().registerCipher(
         18,
-        "Магма ECB",
+        "Магма ECB/CBC/CFB/OFB/MAC",
         []() -> CipherInterface* { return new MagmaECBCipher(); },
         CipherCategory::Combinatorial
     );
@@ -461,13 +290,55 @@ MagmaECBCipherRegister::MagmaECBCipherRegister()
             keyRow->addStretch();
             vbox->addLayout(keyRow);
 
+            // Режим ГОСТ Р 34.13-2015
+            QHBoxLayout* modeRow = new QHBoxLayout();
+            QLabel* modeLabel = new QLabel("Режим:");
+            modeLabel->setFixedWidth(120);
+            QComboBox* modeCombo = new QComboBox();
+            modeCombo->addItem("ECB — простая замена", "ECB");
+            modeCombo->addItem("CBC — простая замена с зацеплением", "CBC");
+            modeCombo->addItem("CFB — гаммирование с обратной связью по шифртексту", "CFB");
+            modeCombo->addItem("OFB — гаммирование с обратной связью по выходу", "OFB");
+            modeCombo->addItem("MAC — выработка имитовставки", "MAC");
+            modeCombo->setObjectName("mode");
+            modeRow->addWidget(modeLabel);
+            modeRow->addWidget(modeCombo);
+            modeRow->addStretch();
+            vbox->addLayout(modeRow);
+
+            QHBoxLayout* ivRow = new QHBoxLayout();
+            QLabel* ivLabel = new QLabel("IV:");
+            ivLabel->setFixedWidth(120);
+            MagmaECBHexEdit* ivEdit = new MagmaECBHexEdit();
+            ivEdit->setObjectName("iv");
+            ivEdit->setEnabled(false);
+            ivRow->addWidget(ivLabel);
+            ivRow->addWidget(ivEdit);
+            ivRow->addStretch();
+            vbox->addLayout(ivRow);
+
+            QHBoxLayout* paddingRow = new QHBoxLayout();
+            QLabel* paddingLabel = new QLabel("Дополнение:");
+            paddingLabel->setFixedWidth(120);
+            QComboBox* paddingCombo = new QComboBox();
+            paddingCombo->addItem("Нет (данные кратны блоку)", "");
+            paddingCombo->addItem("Процедура 1 — нулями", "1");
+            paddingCombo->addItem("Процедура 2 — 1 и нули, всегда", "2");
+            paddingCombo->addItem("Процедура 3 — 1 и нули, при неполном блоке", "3");
+            paddingCombo->setObjectName("padding");
+            paddingRow->addWidget(paddingLabel);
+            paddingRow->addWidget(paddingCombo);
+            paddingRow->addStretch();
+            vbox->addLayout(paddingRow);
+
             // Информационная панель
             QLabel* infoLabel = new QLabel(
-                "Магма (ГОСТ Р 34.12-2015) — режим простой замены (ECB):\n"
+                "Магма (ГОСТ Р 34.12-2015) — режимы ГОСТ Р 34.13-2015:\n"
                 "• Длина блока: 64 бита (16 HEX символов)\n"
                 "• Длина ключа: 256 бит (64 HEX символа)\n"
                 "• Количество раундов: 32\n"
-                "• Вход/выход: HEX-строки (длина кратна 16 символам)\n"
+                "• Вход/выход: HEX-строки; в ECB и CBC без дополнения длина кратна 16 символам\n"
+                "• IV для CBC, CFB и OFB — кратен 16 HEX символам; MAC выдает 4-байтную имитовставку\n"
                 "• Контрольный пример (А.2.1):\n"
                 "  Ключ: ffeeddccbbaa99887766554433221100f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff\n"
                 "  Открытый текст: 92def06b3c130a59\n"
@@ -480,6 +351,22 @@ MagmaECBCipherRegister::MagmaECBCipherRegister()
             layout->addWidget(container);
 
             widgets["key"] = keyEdit;
+            widgets["mode"] = modeCombo;
+            widgets["iv"] = ivEdit;
+            widgets["padding"] = paddingCombo;
+
+            // IV нужен только режимам с обратной связью: z·n байт, z ≥ 1
+            QObject::connect(modeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                [modeCombo, ivEdit, paddingCombo](int) {
+                    const QString mode = modeCombo->currentData().toString();
+                    const bool needsIv = (mode == "CBC" || mode == "CFB" || mode == "OFB");
+                    ivEdit->setEnabled(needsIv);
+                    paddingCombo->setEnabled(mode == "ECB" || mode == "CBC");
+                    if (needsIv && ivEdit->text().isEmpty()) {
+                        ivEdit->setPlaceholderText("HEX (кратно 8 байтам)");
+                        ivEdit->setHex("1234567890abcdef234567890abcdef1");
+                    }
+                });
         }
     );
 }
@@ -3,52 +3,50 @@
 
 #include "cipherinterface.h"
 #include "ciphercore.h"
+#include "gost3413.h"
 #include <QVector>
 #include <array>
 #include <cstdint>
+#include <memory>
 
-// Класс шифра Магма в режиме простой замены (ECB)
+// Класс шифра Магма в режимах ГОСТ Р 34.13-2015 (по умолчанию — простая замена, ECB)
 class MagmaECBCipher : public CipherInterface
 {
 public:
     MagmaECBCipher();
     virtual ~MagmaECBCipher() = default;
 
-    virtual QString name() const override { return "Магма (ГОСТ Р 34.12-2015) - ECB"; }
-    virtual QString description() const override { return "Блочный шифр с длиной блока 64 бит, режим простой замены (ГОСТ Р 34.13-2015)"; }
+    virtual QString name() const override { return "Магма (ГОСТ Р 34.12-2015) - ECB/CBC/CFB/OFB/MAC"; }
+    virtual QString description() const override {
+        return "Блочный шифр с длиной блока 64 бит, режимы ГОСТ Р 34.13-2015: простая замена, "
+               "простая замена с зацеплением, гаммирование с обратной связью и имитовставка";
+    }
     virtual CipherResult encrypt(const QString& text, const QVariantMap& params) override;
     virtual CipherResult decrypt(const QString& text, const QVariantMap& params) override;
 
-private:
-    // S-блоки ГОСТ Р 34.12-2015 (раздел 5.1.1)
-    static const std::array<uint8_t, 16> PI0;
-    static const std::array<uint8_t, 16> PI1;
-    static const std::array<uint8_t, 16> PI2;
-    static const std::array<uint8_t, 16> PI3;
-    static const std::array<uint8_t, 16> PI4;
-    static const std::array<uint8_t, 16> PI5;
-    static const std::array<uint8_t, 16> PI6;
-    static const std::array<uint8_t, 16> PI7;
+    // Бинарный путь: ключ — HEX в params["key"], режим, IV, дополнение и длина
+    // имитовставки — params["mode"], ["iv"], ["padding"], ["macLength"] (см. Gost3413).
+    // ECB и CBC без дополнения требуют данных, кратных 8 байтам
+    virtual bool supportsBytes() const override { return true; }
+    virtual bool encryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
+    virtual bool decryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params, QString* error = nullptr) override;
 
-    // Базовые преобразования
-    uint32_t tTransform(uint32_t x) const;
-    uint32_t leftShift11(uint32_t x) const;
-    uint32_t g(uint32_t a, uint32_t k) const;
+    // Потоковый режим: контекст режима из Gost3413, неполный блок переносится в следующий update
+    virtual std::unique_ptr<CipherStream> createStream(bool encrypt) override;
 
-    // Шифрование одного 64-битного блока
-    uint64_t encryptBlock(uint64_t block, const std::array<uint32_t, 32>& roundKeys) const;
+private:
+    // Разбор ключа из параметров (false + сообщение при ошибке); расписание
+    // K1..K32 общее с Магмой CTR и хранится в KeyScheduleCache
+    bool prepareRoundKeys(const QVariantMap& params,
+                          std::shared_ptr<const std::array<uint32_t, 32>>& roundKeys, QString* error) const;
 
-    // Развертывание ключа (key schedule) по ГОСТ Р 34.12-2015
-    std::array<uint32_t, 32> keySchedule(const QString& keyHex) const;
+    // Разбор ключа для режимов ГОСТ Р 34.13-2015
+    Gost3413::Prepare blockPreparer() const;
 
-    // Вспомогательные функции
-    QString prepareHexInput(const QString& text) const;
-    QString bytesToHex(const uint8_t* data, int len) const;
-    void hexToBytes(const QString& hex, uint8_t* out, int len) const;
-    uint32_t hexToUint32(const QString& hex) const;
-    QString uint32ToHex(uint32_t value) const;
-    uint64_t hexToUint64(const QString& hex) const;
-    QString uint64ToHex(uint64_t value) const;
+    // Общая часть encrypt/decrypt для QString-адаптера
+    CipherResult processHex(const QString& text, const QVariantMap& params, bool encrypt);
 
     // Алфавит для вывода
     QString m_alphabet = "HEX";
@@ -83,7 +83,7 @@ QString MagmaSBlock16Cipher::process8HexBlock(const QString& block8, bool encryp
 
 CipherResult MagmaSBlock16Cipher::encrypt(const QString& text, const QVariantMap& params)
 {
-    Q_UNUSED(params);
+    StepTrace trace(params);
 
     CipherResult result;
     result.cipherName = name();
@@ -93,23 +93,25 @@ CipherResult MagmaSBlock16Cipher::encrypt(const QString& text, const QVariantMap
     QString filteredText = CipherUtils::filterAlphabetOnly(text.toUpper(), m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет hex-символов для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет hex-символов для преобразования");
         return result;
     }
 
     // Проверяем, что длина кратна 8 (32 бита)
     if (filteredText.length() % 8 != 0) {
-        result.result = QString("Ошибка: длина текста (%1 символов) должна быть кратна 8 (для 32-битных блоков)")
-                       .arg(filteredText.length());
+        result.fail(CipherStatus::InvalidInput, QString("Ошибка: длина текста (%1 символов) должна быть кратна 8 (для 32-битных блоков)")
+                                               .arg(filteredText.length()));
         return result;
     }
 
-    CipherStep step1;
-    step1.index = 0;
-    step1.originalChar = QChar('T');
-    step1.resultValue = QString("%1 hex-символов").arg(filteredText.length());
-    step1.description = QString("Исходный текст: %1").arg(filteredText);
-    result.steps.append(step1);
+    if (trace.want(TraceLevel::Summary)) {
+        CipherStep step1;
+        step1.index = 0;
+        step1.originalChar = QChar('T');
+        step1.resultValue = QString("%1 hex-символов").arg(filteredText.length());
+        step1.description = QString("Исходный текст: %1").arg(filteredText);
+        result.steps.append(step1);
+    }
 
     // Разбиваем на блоки по 8 hex-символов (32 бита)
     QString encrypted;
@@ -124,29 +126,33 @@ CipherResult MagmaSBlock16Cipher::encrypt(const QString& text, const QVariantMap
         encrypted.append(processedBlock);
 
         // Добавляем шаг для этого блока
-        CipherStep blockStep;
-        blockStep.index = blockCounter;
-        blockStep.originalChar = QChar('0' + (blockCounter % 10));
-        blockStep.resultValue = processedBlock;
-        blockStep.description = QString("Блок %1: %2 → %3 (S-блоки π7-π0)")
-                              .arg(blockCounter).arg(block8).arg(processedBlock);
-        result.steps.append(blockStep);
+        if (trace.want(TraceLevel::PerBlock)) {
+            CipherStep blockStep;
+            blockStep.index = blockCounter;
+            blockStep.originalChar = QChar('0' + (blockCounter % 10));
+            blockStep.resultValue = processedBlock;
+            blockStep.description = QString("Блок %1: %2 → %3 (S-блоки π7-π0)")
+                                  .arg(blockCounter).arg(block8).arg(processedBlock);
+            result.steps.append(blockStep);
+        }
     }
 
-    CipherStep finalStep;
-    finalStep.index = 999;
-    finalStep.originalChar = QChar('R');
-    finalStep.resultValue = encrypted;
-    finalStep.description = QString("Зашифрованный текст: %1").arg(encrypted);
-    result.steps.append(finalStep);
+    if (trace.want(TraceLevel::Summary)) {
+        CipherStep finalStep;
+        finalStep.index = 999;
+        finalStep.originalChar = QChar('R');
+        finalStep.resultValue = encrypted;
+        finalStep.description = QString("Зашифрованный текст: %1").arg(encrypted);
+        result.steps.append(finalStep);
+    }
 
     result.result = encrypted;
-    return result;
+    return trace.finish(result);
 }
 
 CipherResult MagmaSBlock16Cipher::decrypt(const QString& text, const QVariantMap& params)
 {
-    Q_UNUSED(params);
+    StepTrace trace(params);
 
     CipherResult result;
     result.cipherName = name();
@@ -156,23 +162,25 @@ CipherResult MagmaSBlock16Cipher::decrypt(const QString& text, const QVariantMap
     QString filteredText = CipherUtils::filterAlphabetOnly(text.toUpper(), m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет hex-символов для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет hex-символов для преобразования");
         return result;
     }
 
     // Проверяем, что длина кратна 8 (32 бита)
     if (filteredText.length() % 8 != 0) {
-        result.result = QString("Ошибка: длина текста (%1 символов) должна быть кратна 8 (для 32-битных блоков)")
-                       .arg(filteredText.length());
+        result.fail(CipherStatus::InvalidInput, QString("Ошибка: длина текста (%1 символов) должна быть кратна 8 (для 32-битных блоков)")
+                                               .arg(filteredText.length()));
         return result;
     }
 
-    CipherStep step1;
-    step1.index = 0;
-    step1.originalChar = QChar('T');
-    step1.resultValue = QString("%1 hex-символов").arg(filteredText.length());
-    step1.description = QString("Зашифрованный текст: %1").arg(filteredText);
-    result.steps.append(step1);
+    if (trace.want(TraceLevel::Summary)) {
+        CipherStep step1;
+        step1.index = 0;
+        step1.originalChar = QChar('T');
+        step1.resultValue = QString("%1 hex-символов").arg(filteredText.length());
+        step1.description = QString("Зашифрованный текст: %1").arg(filteredText);
+        result.steps.append(step1);
+    }
 
     // Разбиваем на блоки по 8 hex-символов (32 бита)
     QString decrypted;
@@ -186,24 +194,28 @@ CipherResult MagmaSBlock16Cipher::decrypt(const QString& text, const QVariantMap
         QString processedBlock = process8HexBlock(block8, false);
         decrypted.append(processedBlock);
 
-        CipherStep blockStep;
-        blockStep.index = blockCounter;
-        blockStep.originalChar = QChar('0' + (blockCounter % 10));
-        blockStep.resultValue = processedBlock;
-        blockStep.description = QString("Блок %1: %2 → %3 (обратные S-блоки π7-π0)")
-                              .arg(blockCounter).arg(block8).arg(processedBlock);
-        result.steps.append(blockStep);
+        if (trace.want(TraceLevel::PerBlock)) {
+            CipherStep blockStep;
+            blockStep.index = blockCounter;
+            blockStep.originalChar = QChar('0' + (blockCounter % 10));
+            blockStep.resultValue = processedBlock;
+            blockStep.description = QString("Блок %1: %2 → %3 (обратные S-блоки π7-π0)")
+                                  .arg(blockCounter).arg(block8).arg(processedBlock);
+            result.steps.append(blockStep);
+        }
     }
 
-    CipherStep finalStep;
-    finalStep.index = 999;
-    finalStep.originalChar = QChar('R');
-    finalStep.resultValue = decrypted;
-    finalStep.description = QString("Расшифрованный текст: %1").arg(decrypted);
-    result.steps.append(finalStep);
+    if (trace.want(TraceLevel::Summary)) {
+        CipherStep finalStep;
+        finalStep.index = 999;
+        finalStep.originalChar = QChar('R');
+        finalStep.resultValue = decrypted;
+        finalStep.description = QString("Расшифрованный текст: %1").arg(decrypted);
+        result.steps.append(finalStep);
+    }
 
     result.result = decrypted;
-    return result;
+    return trace.finish(result);
 }
 
 MagmaSBlock16CipherRegister::MagmaSBlock16CipherRegister()
@@ -21,7 +21,7 @@ public:
     }
 
 private:
-    QString m_alphabet = QStringLiteral(u"0123456789ABCDEF");
+    const Alphabet& m_alphabet = Alphabet::hex();
 
     // Таблицы замены S-блоков (индексы 0-7 соответствуют таблицам 1-8)
     QVector<QVector<int>> m_sBlocks;
@@ -18,28 +18,37 @@
 #include <QGroupBox>
 #include <QFrame>
 
-const QString MatrixCipher::ALPHABET = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+const Alphabet& MatrixCipher::ALPHABET = Alphabet::russian();
 
 MatrixCipher::MatrixCipher() {}
 
 CipherResult MatrixCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало шифрования", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало шифрования", "Инициализация"));
+    }
 
     try {
         // Шаг 1: Получение и проверка матрицы
         if (!params.contains("matrix")) {
-            steps.append(CipherStep(1, QChar(), "Ошибка: матрица не задана", "Проверка параметров"));
-            return CipherResult("", steps, "Матричный шифр (ошибка)", name(), true);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(1, QChar(), "Ошибка: матрица не задана", "Проверка параметров"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (ошибка)", name(), true)
+                .fail(CipherStatus::InvalidParams, "ОШИБКА: Матрица не задана"));
         }
 
         QString matrixStr = params["matrix"].toString();
         QVector<QVector<int>> matrix;
 
         if (!parseMatrix(matrixStr, matrix)) {
-            steps.append(CipherStep(1, QChar(), "Ошибка: некорректный формат матрицы", "Парсинг матрицы"));
-            return CipherResult("", steps, "Матричный шифр (ошибка)", name(), true);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(1, QChar(), "Ошибка: некорректный формат матрицы", "Парсинг матрицы"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (ошибка)", name(), true)
+                .fail(CipherStatus::InvalidParams, "ОШИБКА: Некорректный формат матрицы"));
         }
 
         int size = matrix.size();
@@ -55,28 +64,38 @@ CipherResult MatrixCipher::encrypt(const QString& text, const QVariantMap& param
             matrixDisplay += "]\n";
         }
 
-        steps.append(CipherStep(1, QChar(),
-            QString("Ключевая матрица %1x%1:\n%2").arg(size).arg(matrixDisplay),
-            "Загрузка матрицы"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(1, QChar(),
+                QString("Ключевая матрица %1x%1:\n%2").arg(size).arg(matrixDisplay),
+                "Загрузка матрицы"));
+        }
 
         // Шаг 2: Проверка обратимости и вычисление определителя
         int det;
         if (!isInvertible(matrix, det)) {
-            steps.append(CipherStep(2, QChar(),
-                QString("Ошибка: матрица необратима (det = %1)").arg(det),
-                "Проверка обратимости"));
-            return CipherResult("", steps, "Матричный шифр (ошибка)", name(), true);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(2, QChar(),
+                    QString("Ошибка: матрица необратима (det = %1)").arg(det),
+                    "Проверка обратимости"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (ошибка)", name(), true)
+                .fail(CipherStatus::InvalidParams, QString("ОШИБКА: Матрица необратима (det = %1)").arg(det)));
         }
 
-        steps.append(CipherStep(2, QChar(),
-            QString("Определитель матрицы: det = %1").arg(det),
-            "Вычисление определителя"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(2, QChar(),
+                QString("Определитель матрицы: det = %1").arg(det),
+                "Вычисление определителя"));
+        }
 
         // Шаг 3: Вычисление обратной матрицы
         QVector<QVector<double>> inverseMatrix;
         if (!calculateInverse(matrix, inverseMatrix, det)) {
-            steps.append(CipherStep(3, QChar(), "Ошибка: не удалось вычислить обратную матрицу", "Вычисление обратной матрицы"));
-            return CipherResult("", steps, "Матричный шифр (ошибка)", name(), true);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(3, QChar(), "Ошибка: не удалось вычислить обратную матрицу", "Вычисление обратной матрицы"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (ошибка)", name(), true)
+                .fail(CipherStatus::InvalidParams, "ОШИБКА: Не удалось вычислить обратную матрицу"));
         }
 
         // Форматируем обратную матрицу для вывода
@@ -91,30 +110,37 @@ CipherResult MatrixCipher::encrypt(const QString& text, const QVariantMap& param
             inverseDisplay += "]\n";
         }
 
-        steps.append(CipherStep(3, QChar(),
-            QString("Обратная матрица %1x%1 (вычислена для дешифрования):\n%2").arg(size).arg(inverseDisplay),
-            "Вычисление обратной матрицы"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(3, QChar(),
+                QString("Обратная матрица %1x%1 (вычислена для дешифрования):\n%2").arg(size).arg(inverseDisplay),
+                "Вычисление обратной матрицы"));
+        }
 
         // Шаг 4: Преобразование текста в числа
         QString cleanText = CipherUtils::filterAlphabetOnly(text, ALPHABET);
 
         if (cleanText.isEmpty()) {
-            steps.append(CipherStep(4, QChar(), "Ошибка: текст не содержит букв алфавита", "Преобразование текста"));
-            return CipherResult("", steps, "Матричный шифр (ошибка)", name(), true);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(4, QChar(), "Ошибка: текст не содержит букв алфавита", "Преобразование текста"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (ошибка)", name(), true)
+                .fail(CipherStatus::InvalidInput, "ОШИБКА: Текст не содержит букв алфавита"));
         }
 
         QVector<int> numbers = textToNumbers(cleanText); // Здесь А=0, Б=1, ..., Я=31
 
-        // Для вывода показываем числа как А=1, Б=2, ..., Я=32
-        QString numbersStr;
-        for (int i = 0; i < numbers.size(); i++) {
-            numbersStr += QString::number(numbers[i] + 1);
-            if (i < numbers.size() - 1) numbersStr += " ";
-        }
+        if (trace.want(TraceLevel::Summary)) {
+            // Для вывода показываем числа как А=1, Б=2, ..., Я=32
+            QString numbersStr;
+            for (int i = 0; i < numbers.size(); i++) {
+                numbersStr += QString::number(numbers[i] + 1);
+                if (i < numbers.size() - 1) numbersStr += " ";
+            }
 
-        steps.append(CipherStep(4, QChar(),
-            QString("Текст → числа (%1 чисел): %2").arg(numbers.size()).arg(numbersStr),
-            "Преобразование текста"));
+            steps.append(CipherStep(4, QChar(),
+                QString("Текст → числа (%1 чисел): %2").arg(numbers.size()).arg(numbersStr),
+                "Преобразование текста"));
+        }
 
         // Шаг 5: Дополнение до кратного размеру блока
         int remainder = numbers.size() % size;
@@ -132,9 +158,11 @@ CipherResult MatrixCipher::encrypt(const QString& text, const QVariantMap& param
             }
 
             QString paddingLetter = ALPHABET[paddingChar];
-            steps.append(CipherStep(5, QChar(),
-                QString("Добавлено %1 букв '%2' для выравнивания").arg(paddingCount).arg(paddingLetter),
-                "Дополнение блока"));
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(5, QChar(),
+                    QString("Добавлено %1 букв '%2' для выравнивания").arg(paddingCount).arg(paddingLetter),
+                    "Дополнение блока"));
+            }
         }
 
         // Шаг 6: Шифрование блоков
@@ -144,44 +172,55 @@ CipherResult MatrixCipher::encrypt(const QString& text, const QVariantMap& param
         for (int block = 0; block < blockCount; block++) {
             // Извлекаем блок для математических операций (индексы 0-31)
             QVector<int> blockVector;
-            QString blockStr = "Блок " + QString::number(block + 1) + ": [";
-
             for (int i = 0; i < size; i++) {
                 int num = numbers[block * size + i]; // num в диапазоне 0-31
                 // ДЛЯ УМНОЖЕНИЯ ИСПОЛЬЗУЕМ num + 1 (А=1, Б=2, ...)
                 blockVector.append(num + 1); // ← ИСПРАВЛЕНО: добавляем 1 для умножения
-                // Для вывода показываем num + 1
-                blockStr += QString::number(num + 1);
-                if (i < size - 1) blockStr += " ";
             }
-            blockStr += "]";
 
-            steps.append(CipherStep(6 + block * 2, QChar(),
-                blockStr,
-                QString("Блок %1 (вектор B%2)").arg(block + 1).arg(block + 1)));
+            if (trace.want(TraceLevel::PerBlock)) {
+                // Для вывода показываем num + 1
+                QString blockStr = "Блок " + QString::number(block + 1) + ": [";
+                for (int i = 0; i < size; i++) {
+                    blockStr += QString::number(blockVector[i]);
+                    if (i < size - 1) blockStr += " ";
+                }
+                blockStr += "]";
+
+                steps.append(CipherStep(6 + block * 2, QChar(),
+                    blockStr,
+                    QString("Блок %1 (вектор B%2)").arg(block + 1).arg(block + 1)));
+            }
 
             // Умножаем матрицу на вектор (используем индексы 1-32)
             QVector<int> encryptedBlock = multiplyMatrixVector(matrix, blockVector);
 
-            QString encryptedStr = "→ [";
             for (int i = 0; i < size; i++) {
                 encryptedNumbers.append(encryptedBlock[i]);
-                encryptedStr += QString::number(encryptedBlock[i]);
-                if (i < size - 1) encryptedStr += " ";
             }
-            encryptedStr += "]";
 
-            steps.append(CipherStep(7 + block * 2, QChar(),
-                encryptedStr,
-                QString("Блок %1 после умножения на матрицу (C%2 = A × B%2)").arg(block + 1).arg(block + 1)));
+            if (trace.want(TraceLevel::PerBlock)) {
+                QString encryptedStr = "→ [";
+                for (int i = 0; i < size; i++) {
+                    encryptedStr += QString::number(encryptedBlock[i]);
+                    if (i < size - 1) encryptedStr += " ";
+                }
+                encryptedStr += "]";
+
+                steps.append(CipherStep(7 + block * 2, QChar(),
+                    encryptedStr,
+                    QString("Блок %1 после умножения на матрицу (C%2 = A × B%2)").arg(block + 1).arg(block + 1)));
+            }
         }
 
         // Шаг 7: Форматирование результата с ведущими нулями
         QString result = formatNumbers(encryptedNumbers);
 
-        steps.append(CipherStep(6 + blockCount * 2, QChar(),
-            "Зашифрованные числа: " + result,
-            "Объединение блоков и форматирование"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(6 + blockCount * 2, QChar(),
+                "Зашифрованные числа: " + result,
+                "Объединение блоков и форматирование"));
+        }
 
         // Формируем описание
         QString description = QString("Матричный шифр\n"
@@ -198,35 +237,47 @@ CipherResult MatrixCipher::encrypt(const QString& text, const QVariantMap& param
                             .arg(blockCount)
                             .arg(paddingCount);
 
-        return CipherResult(result, steps, description, name(), true);
+        return trace.finish(CipherResult(result, steps, description, name(), true));
 
     } catch (const std::exception& e) {
-        steps.append(CipherStep(99, QChar(),
-            QString("Исключение: %1").arg(e.what()),
-            "Ошибка выполнения"));
-        return CipherResult("", steps, "Матричный шифр (ошибка)", name(), true);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(99, QChar(),
+                QString("Исключение: %1").arg(e.what()),
+                "Ошибка выполнения"));
+        }
+        return trace.finish(CipherResult("", steps, "Матричный шифр (ошибка)", name(), true)
+            .fail(CipherStatus::InternalError, QString("ОШИБКА: Исключение: %1").arg(e.what())));
     }
 }
 
 CipherResult MatrixCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало дешифрования", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало дешифрования", "Инициализация"));
+    }
 
 
     try {
         // Шаг 1: Получение и проверка матрицы
         if (!params.contains("matrix")) {
-            steps.append(CipherStep(1, QChar(), "Ошибка: матрица не задана", "Проверка параметров"));
-            return CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(1, QChar(), "Ошибка: матрица не задана", "Проверка параметров"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false)
+                .fail(CipherStatus::InvalidParams, "ОШИБКА: Матрица не задана"));
         }
 
         QString matrixStr = params["matrix"].toString();
         QVector<QVector<int>> matrix;
 
         if (!parseMatrix(matrixStr, matrix)) {
-            steps.append(CipherStep(1, QChar(), "Ошибка: некорректный формат матрицы", "Парсинг матрицы"));
-            return CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(1, QChar(), "Ошибка: некорректный формат матрицы", "Парсинг матрицы"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false)
+                .fail(CipherStatus::InvalidParams, "ОШИБКА: Некорректный формат матрицы"));
         }
 
         int size = matrix.size();
@@ -242,28 +293,38 @@ CipherResult MatrixCipher::decrypt(const QString& text, const QVariantMap& param
             matrixDisplay += "]\n";
         }
 
-        steps.append(CipherStep(1, QChar(),
-            QString("Ключевая матрица %1x%1:\n%2").arg(size).arg(matrixDisplay),
-            "Загрузка матрицы"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(1, QChar(),
+                QString("Ключевая матрица %1x%1:\n%2").arg(size).arg(matrixDisplay),
+                "Загрузка матрицы"));
+        }
 
         // Шаг 2: Проверка обратимости и вычисление определителя
         int det;
         if (!isInvertible(matrix, det)) {
-            steps.append(CipherStep(2, QChar(),
-                QString("Ошибка: матрица необратима (det = %1)").arg(det),
-                "Проверка обратимости"));
-            return CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(2, QChar(),
+                    QString("Ошибка: матрица необратима (det = %1)").arg(det),
+                    "Проверка обратимости"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false)
+                .fail(CipherStatus::InvalidParams, QString("ОШИБКА: Матрица необратима (det = %1)").arg(det)));
         }
 
-        steps.append(CipherStep(2, QChar(),
-            QString("Определитель матрицы: det = %1").arg(det),
-            "Вычисление определителя"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(2, QChar(),
+                QString("Определитель матрицы: det = %1").arg(det),
+                "Вычисление определителя"));
+        }
 
         // Шаг 3: Вычисление обратной матрицы
         QVector<QVector<double>> inverseMatrix;
         if (!calculateInverse(matrix, inverseMatrix, det)) {
-            steps.append(CipherStep(3, QChar(), "Ошибка: не удалось вычислить обратную матрицу", "Вычисление обратной матрицы"));
-            return CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(3, QChar(), "Ошибка: не удалось вычислить обратную матрицу", "Вычисление обратной матрицы"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false)
+                .fail(CipherStatus::InvalidParams, "ОШИБКА: Не удалось вычислить обратную матрицу"));
         }
 
         // Форматируем обратную матрицу для вывода
@@ -278,36 +339,46 @@ CipherResult MatrixCipher::decrypt(const QString& text, const QVariantMap& param
             inverseDisplay += "]\n";
         }
 
-        steps.append(CipherStep(3, QChar(),
-            QString("Обратная матрица %1x%1 (A⁻¹):\n%2").arg(size).arg(inverseDisplay),
-            "Вычисление обратной матрицы"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(3, QChar(),
+                QString("Обратная матрица %1x%1 (A⁻¹):\n%2").arg(size).arg(inverseDisplay),
+                "Вычисление обратной матрицы"));
+        }
 
         // Шаг 4: Парсинг чисел из текста (с учетом ведущих нулей)
         QVector<int> numbers = parseNumbers(text);
         if (numbers.isEmpty()) {
-            steps.append(CipherStep(4, QChar(),
-                "Ошибка: не удалось распарсить числа",
-                "Парсинг чисел"));
-            return CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(4, QChar(),
+                    "Ошибка: не удалось распарсить числа",
+                    "Парсинг чисел"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false)
+                .fail(CipherStatus::InvalidInput, "ОШИБКА: Не удалось распарсить числа"));
         }
 
         if (numbers.size() % size != 0) {
-            steps.append(CipherStep(4, QChar(),
-                QString("Ошибка: количество чисел (%1) не кратно размеру блока (%2)").arg(numbers.size()).arg(size),
-                "Проверка кратности"));
-            return CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(4, QChar(),
+                    QString("Ошибка: количество чисел (%1) не кратно размеру блока (%2)").arg(numbers.size()).arg(size),
+                    "Проверка кратности"));
+            }
+            return trace.finish(CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false)
+                .fail(CipherStatus::InvalidInput, QString("ОШИБКА: Количество чисел (%1) не кратно размеру блока (%2)").arg(numbers.size()).arg(size)));
         }
 
-        QString numbersStr;
-        for (int i = 0; i < qMin(10, numbers.size()); i++) {
-            numbersStr += QString::number(numbers[i]);
-            if (i < qMin(10, numbers.size()) - 1) numbersStr += " ";
-        }
-        if (numbers.size() > 10) numbersStr += " ...";
+        if (trace.want(TraceLevel::Summary)) {
+            QString numbersStr;
+            for (int i = 0; i < qMin(10, numbers.size()); i++) {
+                numbersStr += QString::number(numbers[i]);
+                if (i < qMin(10, numbers.size()) - 1) numbersStr += " ";
+            }
+            if (numbers.size() > 10) numbersStr += " ...";
 
-        steps.append(CipherStep(4, QChar(),
-            QString("Загружено %1 чисел: %2").arg(numbers.size()).arg(numbersStr),
-            "Парсинг чисел"));
+            steps.append(CipherStep(4, QChar(),
+                QString("Загружено %1 чисел: %2").arg(numbers.size()).arg(numbersStr),
+                "Парсинг чисел"));
+        }
 
         // Шаг 5: Дешифрование блоков
         QVector<int> decryptedNumbers;
@@ -316,50 +387,61 @@ CipherResult MatrixCipher::decrypt(const QString& text, const QVariantMap& param
         for (int block = 0; block < blockCount; block++) {
             // Извлекаем блок
             QVector<int> blockVector;
-            QString blockStr = "Блок " + QString::number(block + 1) + ": [";
             for (int i = 0; i < size; i++) {
-                int num = numbers[block * size + i];
-                blockVector.append(num);
-                blockStr += QString::number(num);
-                if (i < size - 1) blockStr += " ";
+                blockVector.append(numbers[block * size + i]);
             }
-            blockStr += "]";
 
-            steps.append(CipherStep(5 + block * 2, QChar(),
-                blockStr,
-                QString("Блок %1 (вектор C%2)").arg(block + 1).arg(block + 1)));
+            if (trace.want(TraceLevel::PerBlock)) {
+                QString blockStr = "Блок " + QString::number(block + 1) + ": [";
+                for (int i = 0; i < size; i++) {
+                    blockStr += QString::number(blockVector[i]);
+                    if (i < size - 1) blockStr += " ";
+                }
+                blockStr += "]";
+
+                steps.append(CipherStep(5 + block * 2, QChar(),
+                    blockStr,
+                    QString("Блок %1 (вектор C%2)").arg(block + 1).arg(block + 1)));
+            }
 
             // Умножаем на обратную матрицу (double)
             QVector<double> decryptedBlockDouble = multiplyMatrixVectorDouble(inverseMatrix, blockVector);
 
-            // Форматируем промежуточный результат с плавающей точкой
-            QString doubleStr = "→ [";
-            for (int i = 0; i < size; i++) {
-                doubleStr += QString::number(decryptedBlockDouble[i], 'f', 3);
-                if (i < size - 1) doubleStr += " ";
+            if (trace.want(TraceLevel::PerBlock)) {
+                // Форматируем промежуточный результат с плавающей точкой
+                QString doubleStr = "→ [";
+                for (int i = 0; i < size; i++) {
+                    doubleStr += QString::number(decryptedBlockDouble[i], 'f', 3);
+                    if (i < size - 1) doubleStr += " ";
+                }
+                doubleStr += "] (до округления)";
+
+                steps.append(CipherStep(6 + block * 2 - 1, QChar(),
+                    doubleStr,
+                    QString("Блок %1 после умножения на A⁻¹").arg(block + 1)));
             }
-            doubleStr += "] (до округления)";
-
-            steps.append(CipherStep(6 + block * 2 - 1, QChar(),
-                doubleStr,
-                QString("Блок %1 после умножения на A⁻¹").arg(block + 1)));
 
             // Округляем до целых чисел
             QVector<int> decryptedBlock = roundToInt(decryptedBlockDouble);
 
-            QString decryptedStr = "→ [";
             for (int i = 0; i < size; i++) {
                 // ВАЖНО: Вычитаем 1, чтобы получить индексы 0-31 для преобразования в текст
                 decryptedNumbers.append(decryptedBlock[i] - 1); // ← ИСПРАВЛЕНО: вычитаем 1
-                // Для вывода показываем как есть (без вычитания)
-                decryptedStr += QString::number(decryptedBlock[i]);
-                if (i < size - 1) decryptedStr += " ";
             }
-            decryptedStr += "] (после округления)";
 
-            steps.append(CipherStep(6 + block * 2, QChar(),
-                decryptedStr,
-                QString("Блок %1 расшифрован (B%2 = A⁻¹ × C%2)").arg(block + 1).arg(block + 1)));
+            if (trace.want(TraceLevel::PerBlock)) {
+                // Для вывода показываем как есть (без вычитания)
+                QString decryptedStr = "→ [";
+                for (int i = 0; i < size; i++) {
+                    decryptedStr += QString::number(decryptedBlock[i]);
+                    if (i < size - 1) decryptedStr += " ";
+                }
+                decryptedStr += "] (после округления)";
+
+                steps.append(CipherStep(6 + block * 2, QChar(),
+                    decryptedStr,
+                    QString("Блок %1 расшифрован (B%2 = A⁻¹ × C%2)").arg(block + 1).arg(block + 1)));
+            }
         }
 
         // Шаг 6: Преобразование чисел в текст
@@ -377,10 +459,12 @@ CipherResult MatrixCipher::decrypt(const QString& text, const QVariantMap& param
             }
         }
 
-        steps.append(CipherStep(9, QChar(),
-            QString("Расшифрованный текст: %1 (удалено %2 добавленных букв '%3')")
-                .arg(decryptedText).arg(paddingRemoved).arg(lastChar),
-            "Преобразование чисел в текст"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(9, QChar(),
+                QString("Расшифрованный текст: %1 (удалено %2 добавленных букв '%3')")
+                    .arg(decryptedText).arg(paddingRemoved).arg(lastChar),
+                "Преобразование чисел в текст"));
+        }
         // Формируем описание
         QString description = QString("Дешифрование матричного шифра\n"
                                     "════════════════════════════════════════\n"
@@ -393,13 +477,16 @@ CipherResult MatrixCipher::decrypt(const QString& text, const QVariantMap& param
                             .arg(blockCount)
                             .arg(decryptedText.length());
 
-        return CipherResult(decryptedText, steps, description, name() + " (дешифрование)", false);
+        return trace.finish(CipherResult(decryptedText, steps, description, name() + " (дешифрование)", false));
 
     } catch (const std::exception& e) {
-        steps.append(CipherStep(99, QChar(),
-            QString("Исключение: %1").arg(e.what()),
-            "Ошибка выполнения"));
-        return CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(99, QChar(),
+                QString("Исключение: %1").arg(e.what()),
+                "Ошибка выполнения"));
+        }
+        return trace.finish(CipherResult("", steps, "Матричный шифр (дешифрование, ошибка)", name() + " (дешифрование)", false)
+            .fail(CipherStatus::InternalError, QString("ОШИБКА: Исключение: %1").arg(e.what())));
     }
 }
 QString MatrixCipher::name() const {
@@ -16,7 +16,7 @@ public:
     virtual QString description() const override;
 
     // Константы
-    static const QString ALPHABET;
+    static const Alphabet& ALPHABET;
     static const int ALPHABET_SIZE = 32;
 
     // Вспомогательные методы (публичные для доступа из регистратора)
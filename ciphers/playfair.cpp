@@ -408,14 +408,20 @@ QChar getFillerFromParams(const QVariantMap& params, const QChar& defaultValue)
 
 CipherResult PlayfairCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), QStringLiteral("Начало шифрования"), QStringLiteral("Инициализация")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), QStringLiteral("Начало шифрования"), QStringLiteral("Инициализация")));
+    }
 
     try {
         // Шаг 1: Получение параметров
         if (!params.contains("slogan") || !params.contains("matrixSize")) {
-            steps.append(CipherStep(1, QChar(), QStringLiteral("Ошибка: не заданы параметры шифрования"), QStringLiteral("Проверка параметров")));
-            return CipherResult("", steps, QStringLiteral("Шифр Плейфера (ошибка)"), name(), true);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(1, QChar(), QStringLiteral("Ошибка: не заданы параметры шифрования"), QStringLiteral("Проверка параметров")));
+            }
+            return trace.finish(CipherResult("", steps, QStringLiteral("Шифр Плейфера (ошибка)"), name(), true)
+                .fail(CipherStatus::InvalidParams, QStringLiteral("ОШИБКА: Не заданы параметры шифрования")));
         }
 
         QString slogan = params["slogan"].toString();
@@ -431,7 +437,9 @@ CipherResult PlayfairCipher::encrypt(const QString& text, const QVariantMap& par
                           QStringLiteral("', фиктивная буква='") + QString(filler) +
                           QStringLiteral("'");
 
-        steps.append(CipherStep(1, QChar(), paramMsg, QStringLiteral("Загрузка параметров")));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(1, QChar(), paramMsg, QStringLiteral("Загрузка параметров")));
+        }
 
         // Шаг 2: Создание таблицы
         QVector<QVector<QChar>> table = createTable(slogan, size);
@@ -445,35 +453,44 @@ CipherResult PlayfairCipher::encrypt(const QString& text, const QVariantMap& par
             tableDisplay += QStringLiteral("\n");
         }
 
-        steps.append(CipherStep(2, QChar(),
-            QString(QStringLiteral("Создана таблица %1x%2 по лозунгу:\n%3"))
-                .arg(table.size()).arg(table[0].size()).arg(tableDisplay),
-            QStringLiteral("Генерация таблицы")));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(2, QChar(),
+                QString(QStringLiteral("Создана таблица %1x%2 по лозунгу:\n%3"))
+                    .arg(table.size()).arg(table[0].size()).arg(tableDisplay),
+                QStringLiteral("Генерация таблицы")));
+        }
 
         // Шаг 3: Подготовка текста
         QString preparedText = prepareText(text, size, filler, true);
 
         if (preparedText.isEmpty()) {
-            steps.append(CipherStep(3, QChar(), QStringLiteral("Ошибка: текст не содержит допустимых символов"), QStringLiteral("Подготовка текста")));
-            return CipherResult("", steps, QStringLiteral("Шифр Плейфера (ошибка)"), name(), true);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(3, QChar(), QStringLiteral("Ошибка: текст не содержит допустимых символов"), QStringLiteral("Подготовка текста")));
+            }
+            return trace.finish(CipherResult("", steps, QStringLiteral("Шифр Плейфера (ошибка)"), name(), true)
+                .fail(CipherStatus::InvalidInput, QStringLiteral("ОШИБКА: Текст не содержит допустимых символов")));
         }
 
-        steps.append(CipherStep(3, QChar(),
-            QString(QStringLiteral("Исходный текст после обработки: %1")).arg(preparedText),
-            QStringLiteral("Подготовка текста")));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(3, QChar(),
+                QString(QStringLiteral("Исходный текст после обработки: %1")).arg(preparedText),
+                QStringLiteral("Подготовка текста")));
+        }
 
         // Шаг 4: Разбивка на биграммы
         QStringList bigrams = splitIntoBigrams(preparedText, filler);
 
-        QString bigramsStr;
-        for (int i = 0; i < bigrams.size(); i++) {
-            bigramsStr += bigrams[i];
-            if (i < bigrams.size() - 1) bigramsStr += QStringLiteral(" ");
-        }
+        if (trace.want(TraceLevel::Summary)) {
+            QString bigramsStr;
+            for (int i = 0; i < bigrams.size(); i++) {
+                bigramsStr += bigrams[i];
+                if (i < bigrams.size() - 1) bigramsStr += QStringLiteral(" ");
+            }
 
-        steps.append(CipherStep(4, QChar(),
-            QString(QStringLiteral("Разбито на %1 биграмм: %2")).arg(bigrams.size()).arg(bigramsStr),
-            QStringLiteral("Разбивка на биграммы")));
+            steps.append(CipherStep(4, QChar(),
+                QString(QStringLiteral("Разбито на %1 биграмм: %2")).arg(bigrams.size()).arg(bigramsStr),
+                QStringLiteral("Разбивка на биграммы")));
+        }
 
         // Шаг 5: Шифрование каждой биграммы
         QStringList encryptedBigrams;
@@ -481,36 +498,42 @@ CipherResult PlayfairCipher::encrypt(const QString& text, const QVariantMap& par
         for (int i = 0; i < bigrams.size(); i++) {
             const QString& bigram = bigrams[i];
 
-            steps.append(CipherStep(5 + i * 2, QChar(),
-                QString(QStringLiteral("Биграмма %1: '%2'")).arg(i + 1).arg(bigram),
-                QString(QStringLiteral("Обработка биграммы %1")).arg(i + 1)));
-
-            Position pos1 = findPosition(table, bigram[0]);
-            Position pos2 = findPosition(table, bigram[1]);
-
-            QString rule;
-            if (pos1.row == pos2.row) {
-                rule = QStringLiteral("одна строка → сдвиг вправо");
-            } else if (pos1.col == pos2.col) {
-                rule = QStringLiteral("один столбец → сдвиг вниз");
-            } else {
-                rule = QStringLiteral("прямоугольник → обмен столбцами");
+            if (trace.want(TraceLevel::PerChar)) {
+                steps.append(CipherStep(5 + i * 2, QChar(),
+                    QString(QStringLiteral("Биграмма %1: '%2'")).arg(i + 1).arg(bigram),
+                    QString(QStringLiteral("Обработка биграммы %1")).arg(i + 1)));
             }
 
             QString encrypted = processBigram(table, bigram, true);
             encryptedBigrams.append(encrypted);
 
-            steps.append(CipherStep(6 + i * 2, QChar(),
-                QString(QStringLiteral("→ '%1' (%2)")).arg(encrypted).arg(rule),
-                QString(QStringLiteral("Результат биграммы %1")).arg(i + 1)));
+            if (trace.want(TraceLevel::PerChar)) {
+                Position pos1 = findPosition(table, bigram[0]);
+                Position pos2 = findPosition(table, bigram[1]);
+
+                QString rule;
+                if (pos1.row == pos2.row) {
+                    rule = QStringLiteral("одна строка → сдвиг вправо");
+                } else if (pos1.col == pos2.col) {
+                    rule = QStringLiteral("один столбец → сдвиг вниз");
+                } else {
+                    rule = QStringLiteral("прямоугольник → обмен столбцами");
+                }
+
+                steps.append(CipherStep(6 + i * 2, QChar(),
+                    QString(QStringLiteral("→ '%1' (%2)")).arg(encrypted).arg(rule),
+                    QString(QStringLiteral("Результат биграммы %1")).arg(i + 1)));
+            }
         }
 
         // Шаг 6: Формирование результата
         QString result = formatResult(encryptedBigrams);
 
-        steps.append(CipherStep(5 + bigrams.size() * 2, QChar(),
-            QString(QStringLiteral("Зашифрованный текст: %1")).arg(result),
-            QStringLiteral("Формирование результата")));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(5 + bigrams.size() * 2, QChar(),
+                QString(QStringLiteral("Зашифрованный текст: %1")).arg(result),
+                QStringLiteral("Формирование результата")));
+        }
 
         // Формируем описание
         QString description = QStringLiteral("Шифр Плейфера\n"
@@ -522,26 +545,35 @@ CipherResult PlayfairCipher::encrypt(const QString& text, const QVariantMap& par
                                     QStringLiteral("\nИсходный текст: ") + QString::number(preparedText.length()) +
                                     QStringLiteral(" символов\nБиграмм: ") + QString::number(bigrams.size());
 
-        return CipherResult(result, steps, description, name(), true);
+        return trace.finish(CipherResult(result, steps, description, name(), true));
 
     } catch (const std::exception& e) {
-        steps.append(CipherStep(99, QChar(),
-            QString(QStringLiteral("Исключение: %1")).arg(e.what()),
-            QStringLiteral("Ошибка выполнения")));
-        return CipherResult("", steps, QStringLiteral("Шифр Плейфера (ошибка)"), name(), true);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(99, QChar(),
+                QString(QStringLiteral("Исключение: %1")).arg(e.what()),
+                QStringLiteral("Ошибка выполнения")));
+        }
+        return trace.finish(CipherResult("", steps, QStringLiteral("Шифр Плейфера (ошибка)"), name(), true)
+            .fail(CipherStatus::InternalError, QString("ОШИБКА: Исключение: %1").arg(e.what())));
     }
 }
 
 CipherResult PlayfairCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), QStringLiteral("Начало дешифрования"), QStringLiteral("Инициализация")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), QStringLiteral("Начало дешифрования"), QStringLiteral("Инициализация")));
+    }
 
     try {
         // Шаг 1: Получение параметров
         if (!params.contains("slogan") || !params.contains("matrixSize")) {
-            steps.append(CipherStep(1, QChar(), QStringLiteral("Ошибка: не заданы параметры дешифрования"), QStringLiteral("Проверка параметров")));
-            return CipherResult("", steps, QStringLiteral("Шифр Плейфера (дешифрование, ошибка)"), name() + QStringLiteral(" (дешифрование)"), false);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(1, QChar(), QStringLiteral("Ошибка: не заданы параметры дешифрования"), QStringLiteral("Проверка параметров")));
+            }
+            return trace.finish(CipherResult("", steps, QStringLiteral("Шифр Плейфера (дешифрование, ошибка)"), name() + QStringLiteral(" (дешифрование)"), false)
+                .fail(CipherStatus::InvalidParams, QStringLiteral("ОШИБКА: Не заданы параметры дешифрования")));
         }
 
         QString slogan = params["slogan"].toString();
@@ -556,7 +588,9 @@ CipherResult PlayfairCipher::decrypt(const QString& text, const QVariantMap& par
                           QStringLiteral("', фиктивная буква='") + QString(filler) +
                           QStringLiteral("'");
 
-        steps.append(CipherStep(1, QChar(), paramMsg, QStringLiteral("Загрузка параметров")));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(1, QChar(), paramMsg, QStringLiteral("Загрузка параметров")));
+        }
 
         // Шаг 2: Создание таблицы
         QVector<QVector<QChar>> table = createTable(slogan, size);
@@ -570,25 +604,32 @@ CipherResult PlayfairCipher::decrypt(const QString& text, const QVariantMap& par
             tableDisplay += QStringLiteral("\n");
         }
 
-        steps.append(CipherStep(2, QChar(),
-            QString(QStringLiteral("Создана таблица %1x%2 по лозунгу:\n%3"))
-                .arg(table.size()).arg(table[0].size()).arg(tableDisplay),
-            QStringLiteral("Генерация таблицы")));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(2, QChar(),
+                QString(QStringLiteral("Создана таблица %1x%2 по лозунгу:\n%3"))
+                    .arg(table.size()).arg(table[0].size()).arg(tableDisplay),
+                QStringLiteral("Генерация таблицы")));
+        }
 
         // Шаг 3: Разбор зашифрованного текста на биграммы
         QStringList encryptedBigrams = parseEncryptedText(text);
 
         if (encryptedBigrams.isEmpty()) {
-            steps.append(CipherStep(3, QChar(), QStringLiteral("Ошибка: не удалось разобрать зашифрованный текст"), QStringLiteral("Разбор биграмм")));
-            return CipherResult("", steps, QStringLiteral("Шифр Плейфера (дешифрование, ошибка)"), name() + QStringLiteral(" (дешифрование)"), false);
+            if (trace.want(TraceLevel::Summary)) {
+                steps.append(CipherStep(3, QChar(), QStringLiteral("Ошибка: не удалось разобрать зашифрованный текст"), QStringLiteral("Разбор биграмм")));
+            }
+            return trace.finish(CipherResult("", steps, QStringLiteral("Шифр Плейфера (дешифрование, ошибка)"), name() + QStringLiteral(" (дешифрование)"), false)
+                .fail(CipherStatus::InvalidInput, QStringLiteral("ОШИБКА: Не удалось разобрать зашифрованный текст")));
         }
 
-        QString bigramsStr = encryptedBigrams.join(' ');
+        if (trace.want(TraceLevel::Summary)) {
+            QString bigramsStr = encryptedBigrams.join(' ');
 
-        steps.append(CipherStep(3, QChar(),
-            QString(QStringLiteral("Зашифрованный текст разбит на %1 биграмм: %2"))
-                .arg(encryptedBigrams.size()).arg(bigramsStr),
-            QStringLiteral("Разбор биграмм")));
+            steps.append(CipherStep(3, QChar(),
+                QString(QStringLiteral("Зашифрованный текст разбит на %1 биграмм: %2"))
+                    .arg(encryptedBigrams.size()).arg(bigramsStr),
+                QStringLiteral("Разбор биграмм")));
+        }
 
         // Шаг 4: Расшифрование каждой биграммы
         QStringList decryptedBigrams;
@@ -596,28 +637,32 @@ CipherResult PlayfairCipher::decrypt(const QString& text, const QVariantMap& par
         for (int i = 0; i < encryptedBigrams.size(); i++) {
             const QString& bigram = encryptedBigrams[i];
 
-            steps.append(CipherStep(4 + i * 2, QChar(),
-                QString(QStringLiteral("Биграмма %1: '%2'")).arg(i + 1).arg(bigram),
-                QString(QStringLiteral("Обработка биграммы %1")).arg(i + 1)));
-
-            Position pos1 = findPosition(table, bigram[0]);
-            Position pos2 = findPosition(table, bigram[1]);
-
-            QString rule;
-            if (pos1.row == pos2.row) {
-                rule = QStringLiteral("одна строка → сдвиг влево");
-            } else if (pos1.col == pos2.col) {
-                rule = QStringLiteral("один столбец → сдвиг вверх");
-            } else {
-                rule = QStringLiteral("прямоугольник → обмен столбцами");
+            if (trace.want(TraceLevel::PerChar)) {
+                steps.append(CipherStep(4 + i * 2, QChar(),
+                    QString(QStringLiteral("Биграмма %1: '%2'")).arg(i + 1).arg(bigram),
+                    QString(QStringLiteral("Обработка биграммы %1")).arg(i + 1)));
             }
 
             QString decrypted = processBigram(table, bigram, false);
             decryptedBigrams.append(decrypted);
 
-            steps.append(CipherStep(5 + i * 2, QChar(),
-                QString(QStringLiteral("→ '%1' (%2)")).arg(decrypted).arg(rule),
-                QString(QStringLiteral("Результат биграммы %1")).arg(i + 1)));
+            if (trace.want(TraceLevel::PerChar)) {
+                Position pos1 = findPosition(table, bigram[0]);
+                Position pos2 = findPosition(table, bigram[1]);
+
+                QString rule;
+                if (pos1.row == pos2.row) {
+                    rule = QStringLiteral("одна строка → сдвиг влево");
+                } else if (pos1.col == pos2.col) {
+                    rule = QStringLiteral("один столбец → сдвиг вверх");
+                } else {
+                    rule = QStringLiteral("прямоугольник → обмен столбцами");
+                }
+
+                steps.append(CipherStep(5 + i * 2, QChar(),
+                    QString(QStringLiteral("→ '%1' (%2)")).arg(decrypted).arg(rule),
+                    QString(QStringLiteral("Результат биграммы %1")).arg(i + 1)));
+            }
         }
 
         // Шаг 5: Объединение результата
@@ -631,9 +676,11 @@ CipherResult PlayfairCipher::decrypt(const QString& text, const QVariantMap& par
             }
         }
 
-        steps.append(CipherStep(4 + encryptedBigrams.size() * 2, QChar(),
-            QString(QStringLiteral("Расшифрованный текст (после удаления фиктивных букв): %1")).arg(result),
-            QStringLiteral("Формирование результата")));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(4 + encryptedBigrams.size() * 2, QChar(),
+                QString(QStringLiteral("Расшифрованный текст (после удаления фиктивных букв): %1")).arg(result),
+                QStringLiteral("Формирование результата")));
+        }
 
         // Формируем описание
         QString description = QStringLiteral("Дешифрование шифра Плейфера\n"
@@ -645,13 +692,16 @@ CipherResult PlayfairCipher::decrypt(const QString& text, const QVariantMap& par
                                     QStringLiteral("\nБиграмм в шифртексте: ") + QString::number(encryptedBigrams.size()) +
                                     QStringLiteral("\nПолучено символов: ") + QString::number(result.length());
 
-        return CipherResult(result, steps, description, name() + QStringLiteral(" (дешифрование)"), false);
+        return trace.finish(CipherResult(result, steps, description, name() + QStringLiteral(" (дешифрование)"), false));
 
     } catch (const std::exception& e) {
-        steps.append(CipherStep(99, QChar(),
-            QString(QStringLiteral("Исключение: %1")).arg(e.what()),
-            QStringLiteral("Ошибка выполнения")));
-        return CipherResult("", steps, QStringLiteral("Шифр Плейфера (дешифрование, ошибка)"), name() + QStringLiteral(" (дешифрование)"), false);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(99, QChar(),
+                QString(QStringLiteral("Исключение: %1")).arg(e.what()),
+                QStringLiteral("Ошибка выполнения")));
+        }
+        return trace.finish(CipherResult("", steps, QStringLiteral("Шифр Плейфера (дешифрование, ошибка)"), name() + QStringLiteral(" (дешифрование)"), false)
+            .fail(CipherStatus::InternalError, QString("ОШИБКА: Исключение: %1").arg(e.what())));
     }
 }
 
@@ -28,7 +28,7 @@ void PolybiusSquareCipher::initializeMaps()
 
 CipherResult PolybiusSquareCipher::encrypt(const QString& text, const QVariantMap& params)
 {
-    Q_UNUSED(params);
+    StepTrace trace(params);
 
     CipherResult result;
     result.cipherName = name();
@@ -38,7 +38,7 @@ CipherResult PolybiusSquareCipher::encrypt(const QString& text, const QVariantMa
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -52,24 +52,26 @@ CipherResult PolybiusSquareCipher::encrypt(const QString& text, const QVariantMa
             encryptedText.append(coords);
 
             // Добавляем шаг для детализации
-            CipherStep step;
-            step.index = i;
-            step.originalChar = originalChar;
-            step.resultValue = coords;
-            step.description = QString("Шифрование: %1 → %2")
-                              .arg(originalChar)
-                              .arg(coords);
-            result.steps.append(step);
+            if (trace.want(TraceLevel::PerChar)) {
+                CipherStep step;
+                step.index = i;
+                step.originalChar = originalChar;
+                step.resultValue = coords;
+                step.description = QString("Шифрование: %1 → %2")
+                                  .arg(originalChar)
+                                  .arg(coords);
+                result.steps.append(step);
+            }
         }
     }
 
     result.result = encryptedText;
-    return result;
+    return trace.finish(result);
 }
 
 CipherResult PolybiusSquareCipher::decrypt(const QString& text, const QVariantMap& params)
 {
-    Q_UNUSED(params);
+    StepTrace trace(params);
 
     CipherResult result;
     result.cipherName = name();
@@ -107,14 +109,16 @@ CipherResult PolybiusSquareCipher::decrypt(const QString& text, const QVariantMa
                 }
 
                 // Добавляем шаг для детализации
-                CipherStep step;
-                step.index = i / 2;  // Индекс в расшифрованном тексте
-                step.originalChar = twoDigits[0];  // Первая цифра координаты
-                step.resultValue = decryptedChar;
-                step.description = QString("Дешифрование: %1 → %2")
-                                  .arg(twoDigits)
-                                  .arg(decryptedChar);
-                result.steps.append(step);
+                if (trace.want(TraceLevel::PerChar)) {
+                    CipherStep step;
+                    step.index = i / 2;  // Индекс в расшифрованном тексте
+                    step.originalChar = twoDigits[0];  // Первая цифра координаты
+                    step.resultValue = decryptedChar;
+                    step.description = QString("Дешифрование: %1 → %2")
+                                      .arg(twoDigits)
+                                      .arg(decryptedChar);
+                    result.steps.append(step);
+                }
 
                 i += 2;
                 continue;
@@ -126,19 +130,21 @@ CipherResult PolybiusSquareCipher::decrypt(const QString& text, const QVariantMa
         //decryptedText.append(skippedChar);
 
         // Добавляем шаг для пропущенного символа
-        CipherStep step;
-        step.index = i;
-        step.originalChar = skippedChar;
-        step.resultValue = skippedChar;
-        step.description = QString("Пропуск: символ '%1' не является валидными координатами")
-                          .arg(skippedChar);
-        result.steps.append(step);
+        if (trace.want(TraceLevel::PerChar)) {
+            CipherStep step;
+            step.index = i;
+            step.originalChar = skippedChar;
+            step.resultValue = skippedChar;
+            step.description = QString("Пропуск: символ '%1' не является валидными координатами")
+                              .arg(skippedChar);
+            result.steps.append(step);
+        }
 
         i += 1;
     }
 
     result.result = decryptedText;
-    return result;
+    return trace.finish(result);
 }
 
 PolybiusSquareCipherRegister::PolybiusSquareCipherRegister()
@@ -17,22 +17,26 @@ CipherResult RouteCipher::encryptImpl(const QString& text,
                                      const QVector<Direction>& writeDirections,
                                      const QVector<Direction>& readDirections,
                                      const QVector<int>& rowOrder,
-                                     const QVector<int>& columnOrder) {
+                                     const QVector<int>& columnOrder,
+                                     StepTrace& trace) {
     QVector<CipherStep> steps;
 
     // Шаг 1: Очистка текста
-    QString cleanText = CipherUtils::filterAlphabetOnly(text,
-        QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"));
+    QString cleanText = CipherUtils::filterAlphabetOnly(text, Alphabet::russian());
 
-    steps.append(CipherStep(1, QChar(), cleanText, QStringLiteral(u"Очищенный текст")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(), cleanText, QStringLiteral(u"Очищенный текст")));
+    }
 
     // Шаг 2: Определение размера таблицы
     int actualRows = rows, actualCols = cols;
     calculateOptimalSize(cleanText.length(), actualRows, actualCols);
 
-    steps.append(CipherStep(2, QChar(),
-        QString("%1×%2").arg(actualRows).arg(actualCols),
-        QStringLiteral(u"Размер таблицы")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("%1×%2").arg(actualRows).arg(actualCols),
+            QStringLiteral(u"Размер таблицы")));
+    }
 
     rows = actualRows;
     cols = actualCols;
@@ -44,7 +48,7 @@ CipherResult RouteCipher::encryptImpl(const QString& text,
     // Шаг 3: Заполнение таблицы
     QVector<CipherStep> fillSteps;
     std::vector<std::vector<QChar>> table = fillTable(cleanText, writeDirections,
-                                                     normalizedRowOrder, cols, fillSteps);
+                                                     normalizedRowOrder, cols, fillSteps, trace);
 
     // Добавляем шаги заполнения
     for (const auto& step : fillSteps) {
@@ -52,12 +56,14 @@ CipherResult RouteCipher::encryptImpl(const QString& text,
     }
 
     // Шаг 4: Отображение таблицы
-    steps.append(CipherStep(steps.size() + 1, QChar(),
-        tableToString(table), QStringLiteral(u"Заполненная таблица")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(steps.size() + 1, QChar(),
+            tableToString(table), QStringLiteral(u"Заполненная таблица")));
+    }
 
     // Шаг 5: Чтение таблицы
     QVector<CipherStep> readSteps;
-    QString encrypted = readTable(table, readDirections, normalizedColumnOrder, readSteps);
+    QString encrypted = readTable(table, readDirections, normalizedColumnOrder, readSteps, trace);
 
     // Добавляем шаги чтения
     for (const auto& step : readSteps) {
@@ -65,8 +71,10 @@ CipherResult RouteCipher::encryptImpl(const QString& text,
     }
 
     // Шаг 6: Итоговый результат
-    steps.append(CipherStep(steps.size() + 1, QChar(),
-        encrypted, QStringLiteral(u"Итоговый шифртекст")));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(steps.size() + 1, QChar(),
+            encrypted, QStringLiteral(u"Итоговый шифртекст")));
+    }
 
     // Перенумеровываем шаги
     for (int i = 0; i < steps.size(); ++i) {
@@ -117,8 +125,7 @@ QVector<Direction> RouteCipher::getDefaultReadDirections(int cols) const
 CipherResult RouteCipher::encrypt(const QString& text, const QVariantMap& params)
 {
     // Очищаем текст
-    QString cleanText = CipherUtils::filterAlphabetOnly(text,
-        QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"));
+    QString cleanText = CipherUtils::filterAlphabetOnly(text, Alphabet::russian());
 
     // Получаем размеры из параметров
     int rows = params.value("rows", 0).toInt();
@@ -170,23 +177,28 @@ CipherResult RouteCipher::encrypt(const QString& text, const QVariantMap& params
     }
 
     // Выполняем шифрование с полученными параметрами
-    return encryptImpl(cleanText, rows, cols, writeDirections, readDirections,
-                      rowOrder, columnOrder);
+    StepTrace trace(params);
+    return trace.finish(encryptImpl(cleanText, rows, cols, writeDirections, readDirections,
+                                    rowOrder, columnOrder, trace));
 }
 
 CipherResult RouteCipher::decrypt(const QString& text, const QVariantMap& params)
 {
-    Q_UNUSED(params);
+    StepTrace trace(params);
     Q_UNUSED(text);
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(1, QChar(),
-        "Дешифрование RouteCipher",
-        "Еще не реализовано"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            "Дешифрование RouteCipher",
+            "Еще не реализовано"));
+    }
 
-    return CipherResult(QString(), steps,
-                       "Дешифрование RouteCipher",
-                       name() + " (дешифрование)", false);
+    CipherResult result(QString(), steps,
+                        "Дешифрование RouteCipher",
+                        name() + " (дешифрование)", false);
+    result.fail(CipherStatus::Unsupported, "Дешифрование маршрутной перестановки еще не реализовано");
+    return trace.finish(result);
 }
 
 // Вспомогательные методы
@@ -328,7 +340,8 @@ std::vector<std::vector<QChar>> RouteCipher::fillTable(const QString& text,
                                                       const QVector<Direction>& writeDirections,
                                                       const QVector<int>& rowOrder,
                                                       int cols,
-                                                      QVector<CipherStep>& steps) const {
+                                                      QVector<CipherStep>& steps,
+                                                      StepTrace& trace) const {
     int rows = rowOrder.size();
     if (rows == 0) return std::vector<std::vector<QChar>>();
 
@@ -372,15 +385,17 @@ std::vector<std::vector<QChar>> RouteCipher::fillTable(const QString& text,
         }
 
         if (!rowChars.isEmpty()) {
-            steps.append(CipherStep(
-                steps.size() + 1,
-                QChar(),
-                rowChars,
-                QString("Запись строки %1 (порядок %2): %3")
-                    .arg(rowIdx + 1)
-                    .arg(orderNum)
-                    .arg(direction == LEFT_TO_RIGHT ? "слева направо" : "справа налево")
-            ));
+            if (trace.want(TraceLevel::PerBlock)) {
+                steps.append(CipherStep(
+                    steps.size() + 1,
+                    QChar(),
+                    rowChars,
+                    QString("Запись строки %1 (порядок %2): %3")
+                        .arg(rowIdx + 1)
+                        .arg(orderNum)
+                        .arg(direction == LEFT_TO_RIGHT ? "слева направо" : "справа налево")
+                ));
+            }
         }
     }
 
@@ -390,7 +405,8 @@ std::vector<std::vector<QChar>> RouteCipher::fillTable(const QString& text,
 QString RouteCipher::readTable(const std::vector<std::vector<QChar>>& table,
                               const QVector<Direction>& readDirections,
                               const QVector<int>& columnOrder,
-                              QVector<CipherStep>& steps) const {
+                              QVector<CipherStep>& steps,
+                              StepTrace& trace) const {
     int rows = static_cast<int>(table.size());
     if (rows == 0) return QString();
 
@@ -436,15 +452,17 @@ QString RouteCipher::readTable(const std::vector<std::vector<QChar>>& table,
         }
 
         if (!columnChars.isEmpty()) {
-            steps.append(CipherStep(
-                steps.size() + 1,
-                QChar(),
-                columnChars,
-                QString("Чтение столбца %1 (порядок %2): %3")
-                    .arg(colIdx + 1)
-                    .arg(orderNum)
-                    .arg(direction == TOP_TO_BOTTOM ? "сверху вниз" : "снизу вверх")
-            ));
+            if (trace.want(TraceLevel::PerBlock)) {
+                steps.append(CipherStep(
+                    steps.size() + 1,
+                    QChar(),
+                    columnChars,
+                    QString("Чтение столбца %1 (порядок %2): %3")
+                        .arg(colIdx + 1)
+                        .arg(orderNum)
+                        .arg(direction == TOP_TO_BOTTOM ? "сверху вниз" : "снизу вверх")
+                ));
+            }
         }
     }
 
@@ -25,12 +25,14 @@ private:
                                              const QVector<Direction>& writeDirections,
                                              const QVector<int>& rowOrder,
                                              int cols,
-                                             QVector<CipherStep>& steps) const;
+                                             QVector<CipherStep>& steps,
+                                             StepTrace& trace) const;
 
     QString readTable(const std::vector<std::vector<QChar>>& table,
                      const QVector<Direction>& readDirections,
                      const QVector<int>& columnOrder,
-                     QVector<CipherStep>& steps) const;
+                     QVector<CipherStep>& steps,
+                     StepTrace& trace) const;
     void calculateOptimalSize(int textLength, int& optimalRows, int& optimalCols) const;
 
 
@@ -41,7 +43,8 @@ protected:
                             const QVector<Direction>& writeDirections,
                             const QVector<Direction>& readDirections,
                             const QVector<int>& rowOrder,
-                            const QVector<int>& columnOrder);
+                            const QVector<int>& columnOrder,
+                            StepTrace& trace);
     // Фиксированные настройки по умолчанию
     QVector<Direction> getDefaultWriteDirections(int rows) const;
     QVector<Direction> getDefaultReadDirections(int cols) const;
@@ -348,13 +348,16 @@ QString RSACipher::numbersToText(const QVector<uint64_t>& numbers) const
 // Шифрование
 CipherResult RSACipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = true;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало шифрования RSA", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало шифрования RSA", "Инициализация"));
+    }
 
     // Получаем параметры
     uint64_t p = params.value("p", 0).toULongLong();
@@ -362,56 +365,62 @@ CipherResult RSACipher::encrypt(const QString& text, const QVariantMap& params)
     uint64_t e = params.value("e", 0).toULongLong();
 
     if (p == 0 || q == 0 || e == 0) {
-        result.result = "ОШИБКА: Для шифрования необходимо ввести P, Q и E";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Для шифрования необходимо ввести P, Q и E");
+        return trace.finish(result);
     }
 
     // Проверяем параметры
     QString validationError;
     if (!validateParameters(p, q, e, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: P=%1, Q=%2, E=%3").arg(p).arg(q).arg(e),
-        "Проверка параметров"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: P=%1, Q=%2, E=%3").arg(p).arg(q).arg(e),
+            "Проверка параметров"));
+    }
 
     uint64_t n = p * q;
     uint64_t phi = (p - 1) * (q - 1);
     uint64_t d = modInverse(e, phi);
 
     if (e == d) {
-         result.result = "ОШИБКА: Открытый ключ E равен закрытому ключу D! "
-                         "Выберите другие простые числа P и Q или другую экспоненту E.\n"
-                         "Это происходит, когда E² ≡ 1 (mod φ(N)).";
-         return result;
+         result.fail(CipherStatus::InvalidParams, "ОШИБКА: Открытый ключ E равен закрытому ключу D! "
+                                                  "Выберите другие простые числа P и Q или другую экспоненту E.\n"
+                                                  "Это происходит, когда E² ≡ 1 (mod φ(N)).");
+         return trace.finish(result);
      }
 
 
     const uint64_t ALPHABET_SIZE = 32;
     if (n <= ALPHABET_SIZE) {
-        result.result = QString("ОШИБКА: N = P × Q = %1 должно быть больше мощности алфавита (%2). "
-                                "Увеличьте P и Q или выберите другие простые числа.")
-                            .arg(n).arg(ALPHABET_SIZE);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: N = P × Q = %1 должно быть больше мощности алфавита (%2). "
+                                                         "Увеличьте P и Q или выберите другие простые числа.")
+                                                     .arg(n).arg(ALPHABET_SIZE));
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("N=%1, φ(N)=%2, D=%3").arg(n).arg(phi).arg(d),
-        "Вычисление ключей"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("N=%1, φ(N)=%2, D=%3").arg(n).arg(phi).arg(d),
+            "Вычисление ключей"));
+    }
 
     // Фильтруем текст
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Входной текст: %1").arg(filteredText),
-        "Подготовка данных"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Входной текст: %1").arg(filteredText),
+            "Подготовка данных"));
+    }
 
     // Преобразуем текст в числа (каждая буква -> число 0-31)
     QVector<uint64_t> numbers = textToNumbers(filteredText);
@@ -423,9 +432,11 @@ CipherResult RSACipher::encrypt(const QString& text, const QVariantMap& params)
     }
     if (numbers.size() > 20) numbersStr += "...";
 
-    steps.append(CipherStep(4, QChar(),
-        QString("Преобразовано в числа 0-31: %1").arg(numbersStr),
-        "Преобразование текста"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(4, QChar(),
+            QString("Преобразовано в числа 0-31: %1").arg(numbersStr),
+            "Преобразование текста"));
+    }
 
     // Шифруем каждое число
     QVector<uint64_t> encryptedNumbers;
@@ -434,13 +445,15 @@ CipherResult RSACipher::encrypt(const QString& text, const QVariantMap& params)
     for (int i = 0; i < numbers.size(); ++i) {
         uint64_t encrypted = encryptNumber(numbers[i], e, n);
         encryptedNumbers.append(encrypted);
-        stepDetails.append(QString("Буква %1: '%2' = %3 → %3^%4 mod %5 = %6")
-            .arg(i + 1)
-            .arg(filteredText[i])
-            .arg(numbers[i])
-            .arg(e)
-            .arg(n)
-            .arg(encrypted));
+        if (i < 10 && trace.enabled(TraceLevel::PerChar)) {
+            stepDetails.append(QString("Буква %1: '%2' = %3 → %3^%4 mod %5 = %6")
+                .arg(i + 1)
+                .arg(filteredText[i])
+                .arg(numbers[i])
+                .arg(e)
+                .arg(n)
+                .arg(encrypted));
+        }
     }
 
     // Формируем результат: просто склеиваем числа через пробел
@@ -451,37 +464,46 @@ CipherResult RSACipher::encrypt(const QString& text, const QVariantMap& params)
         resultNumbers += QString::number(encryptedNumbers[i]);
     }
 
-    steps.append(CipherStep(5, QChar(),
-        QString("Результат: %1").arg(resultNumbers.left(100) + (resultNumbers.length() > 100 ? "..." : "")),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(5, QChar(),
+            QString("Результат: %1").arg(resultNumbers.left(100) + (resultNumbers.length() > 100 ? "..." : "")),
+            "Завершение"));
+    }
 
     // Добавляем детальные шаги (первые 10)
-    for (int i = 0; i < stepDetails.size() && i < 10; ++i) {
-        steps.append(CipherStep(6 + i, QChar(), stepDetails[i], QString("Шаг %1").arg(i + 1)));
+    for (int i = 0; i < numbers.size() && i < 10; ++i) {
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(6 + i, QChar(), stepDetails[i], QString("Шаг %1").arg(i + 1)));
+        }
     }
 
-    if (stepDetails.size() > 10) {
-        steps.append(CipherStep(6 + stepDetails.size(), QChar(),
-            QString("... и еще %1 шагов").arg(stepDetails.size() - 10),
-            "Пропущенные шаги"));
+    if (numbers.size() > 10) {
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(6 + numbers.size(), QChar(),
+                QString("... и еще %1 шагов").arg(numbers.size() - 10),
+                "Пропущенные шаги"));
+        }
     }
 
     result.result = resultNumbers;  // Числа через пробел
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // расшифрование
 CipherResult RSACipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = false;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало расшифрования RSA", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало расшифрования RSA", "Инициализация"));
+    }
 
     // Получаем параметры - для расшифрования нужны N и D
     uint64_t n = params.value("n", 0).toULongLong();
@@ -489,13 +511,15 @@ CipherResult RSACipher::decrypt(const QString& text, const QVariantMap& params)
 
     // Проверяем наличие ключей
     if (n == 0 || d == 0) {
-        result.result = "ОШИБКА: Не указаны закрытый ключ D и модуль N";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Не указаны закрытый ключ D и модуль N");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: N=%1, D=%2").arg(n).arg(d),
-        "Проверка параметров"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: N=%1, D=%2").arg(n).arg(d),
+            "Проверка параметров"));
+    }
 
     // Разбираем входные числа (разделены пробелами или запятыми)
     QString inputText = text.trimmed();
@@ -513,9 +537,11 @@ CipherResult RSACipher::decrypt(const QString& text, const QVariantMap& params)
         }
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Получено %1 чисел для расшифрования").arg(encryptedNumbers.size()),
-        "Подготовка данных"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Получено %1 чисел для расшифрования").arg(encryptedNumbers.size()),
+            "Подготовка данных"));
+    }
 
     // Расшифровываем каждое число
     QVector<uint64_t> decryptedNumbers;
@@ -524,12 +550,14 @@ CipherResult RSACipher::decrypt(const QString& text, const QVariantMap& params)
     for (int i = 0; i < encryptedNumbers.size(); ++i) {
         uint64_t decrypted = decryptNumber(encryptedNumbers[i], d, n);
         decryptedNumbers.append(decrypted);
-        stepDetails.append(QString("Число %1: %2^%3 mod %4 = %5")
-            .arg(i + 1)
-            .arg(encryptedNumbers[i])
-            .arg(d)
-            .arg(n)
-            .arg(decrypted));
+        if (i < 10 && trace.enabled(TraceLevel::PerChar)) {
+            stepDetails.append(QString("Число %1: %2^%3 mod %4 = %5")
+                .arg(i + 1)
+                .arg(encryptedNumbers[i])
+                .arg(d)
+                .arg(n)
+                .arg(decrypted));
+        }
     }
 
     // Показываем расшифрованные числа
@@ -539,32 +567,40 @@ CipherResult RSACipher::decrypt(const QString& text, const QVariantMap& params)
     }
     if (decryptedNumbers.size() > 20) decryptedStr += "...";
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Расшифрованные числа: %1").arg(decryptedStr),
-        "Расшифрованные числа"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Расшифрованные числа: %1").arg(decryptedStr),
+            "Расшифрованные числа"));
+    }
 
     // Преобразуем числа обратно в текст
     QString resultText = numbersToText(decryptedNumbers);
 
-    steps.append(CipherStep(4, QChar(),
-        QString("Результат: %1").arg(resultText),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(4, QChar(),
+            QString("Результат: %1").arg(resultText),
+            "Завершение"));
+    }
 
     // Добавляем детальные шаги (первые 10)
-    for (int i = 0; i < stepDetails.size() && i < 10; ++i) {
-        steps.append(CipherStep(5 + i, QChar(), stepDetails[i], QString("Шаг %1").arg(i + 1)));
+    for (int i = 0; i < encryptedNumbers.size() && i < 10; ++i) {
+        if (trace.want(TraceLevel::PerChar)) {
+            steps.append(CipherStep(5 + i, QChar(), stepDetails[i], QString("Шаг %1").arg(i + 1)));
+        }
     }
 
-    if (stepDetails.size() > 10) {
-        steps.append(CipherStep(5 + stepDetails.size(), QChar(),
-            QString("... и еще %1 шагов").arg(stepDetails.size() - 10),
-            "Пропущенные шаги"));
+    if (encryptedNumbers.size() > 10) {
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(5 + encryptedNumbers.size(), QChar(),
+                QString("... и еще %1 шагов").arg(encryptedNumbers.size() - 10),
+                "Пропущенные шаги"));
+        }
     }
 
     result.result = resultText;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== RSACipherRegister Implementation ====================
@@ -32,7 +32,7 @@ public:
 
 private:
     // Алфавит для преобразования текста в числа
-    QString m_alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& m_alphabet = Alphabet::russian();
 
     // Вспомогательные математические функции
     bool isPrime(uint64_t n, int k = 5) const;
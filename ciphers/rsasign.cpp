@@ -204,7 +204,8 @@ uint64_t RSASignCipher::modInverse(uint64_t e, uint64_t phi) const
 }
 
 // ==================== Хеш-функция квадратичной свертки ====================
-uint64_t RSASignCipher::computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int stepOffset) const
+uint64_t RSASignCipher::computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int stepOffset,
+                                    StepTrace& trace) const
 {
     QString filtered = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
@@ -213,9 +214,11 @@ uint64_t RSASignCipher::computeHash(const QString& text, uint64_t p, QVector<Cip
     uint64_t h = 0;
 
     if (steps.size() > 0) {
-        steps.append(CipherStep(stepOffset, QChar(),
-            QString("Начало вычисления хеша: h0 = 0, модуль p = %1").arg(p),
-            "Хеширование"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepOffset, QChar(),
+                QString("Начало вычисления хеша: h0 = 0, модуль p = %1").arg(p),
+                "Хеширование"));
+        }
     }
 
     for (int i = 0; i < filtered.length(); ++i) {
@@ -227,19 +230,23 @@ uint64_t RSASignCipher::computeHash(const QString& text, uint64_t p, QVector<Cip
         h = (sum * sum) % p;
 
         if (steps.size() > 0) {
-            steps.append(CipherStep(stepOffset + i + 1, QChar(),
-                QString("  h%1 = (h%2 + M%3)^2 mod p = (%4 + %5)^2 mod %6 = %7^2 mod %6 = %8")
-                    .arg(i + 1).arg(i).arg(i + 1)
-                    .arg(old_h).arg(Mi).arg(p)
-                    .arg(sum).arg(h),
-                QString("Хеш шаг %1: буква '%2' (№%3)").arg(i + 1).arg(filtered[i]).arg(Mi)));
+            if (trace.want(TraceLevel::PerChar)) {
+                steps.append(CipherStep(stepOffset + i + 1, QChar(),
+                    QString("  h%1 = (h%2 + M%3)^2 mod p = (%4 + %5)^2 mod %6 = %7^2 mod %6 = %8")
+                        .arg(i + 1).arg(i).arg(i + 1)
+                        .arg(old_h).arg(Mi).arg(p)
+                        .arg(sum).arg(h),
+                    QString("Хеш шаг %1: буква '%2' (№%3)").arg(i + 1).arg(filtered[i]).arg(Mi)));
+            }
         }
     }
 
     if (steps.size() > 0) {
-        steps.append(CipherStep(stepOffset + filtered.length() + 1, QChar(),
-            QString("Итоговый хеш: H = %1").arg(h),
-            "Хеш завершен"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepOffset + filtered.length() + 1, QChar(),
+                QString("Итоговый хеш: H = %1").arg(h),
+                "Хеш завершен"));
+        }
     }
 
     return h;
@@ -372,53 +379,56 @@ QString RSASignCipher::numbersToText(const QVector<uint64_t>& numbers) const
 // ==================== Шифрование с подписью ====================
 CipherResult RSASignCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = false;  // результат - текст, а не числа
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало подписания RSA", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало подписания RSA", "Инициализация"));
+    }
 
     uint64_t p = params.value("p", 0).toULongLong();
     uint64_t q = params.value("q", 0).toULongLong();
     uint64_t e = params.value("e", 0).toULongLong();
 
     if (p == 0 || q == 0 || e == 0) {
-        result.result = "ОШИБКА: Для подписания необходимо ввести P, Q и E";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Для подписания необходимо ввести P, Q и E");
+        return trace.finish(result);
     }
 
     // Проверка простоты P и Q
     if (!isPrime(p)) {
-        result.result = QString("ОШИБКА: P = %1 не является простым числом").arg(p);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: P = %1 не является простым числом").arg(p));
+        return trace.finish(result);
     }
     if (!isPrime(q)) {
-        result.result = QString("ОШИБКА: Q = %1 не является простым числом").arg(q);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: Q = %1 не является простым числом").arg(q));
+        return trace.finish(result);
     }
     if (p == q) {
-        result.result = "ОШИБКА: P и Q должны быть разными числами";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: P и Q должны быть разными числами");
+        return trace.finish(result);
     }
 
     uint64_t n = p * q;
     const uint64_t ALPHABET_SIZE = 32;
     if (n <= ALPHABET_SIZE) {
-        result.result = QString("ОШИБКА: N = P × Q = %1 должно быть больше %2")
-                           .arg(n).arg(ALPHABET_SIZE);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: N = P × Q = %1 должно быть больше %2")
+                                                    .arg(n).arg(ALPHABET_SIZE));
+        return trace.finish(result);
     }
 
     uint64_t phi = (p - 1) * (q - 1);
     if (e <= 1 || e >= phi) {
-        result.result = QString("ОШИБКА: E должно быть в диапазоне 1 < E < φ(N) = %1").arg(phi);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: E должно быть в диапазоне 1 < E < φ(N) = %1").arg(phi));
+        return trace.finish(result);
     }
     if (gcd(e, phi) != 1) {
-        result.result = QString("ОШИБКА: E и φ(N) = %1 не являются взаимно простыми").arg(phi);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: E и φ(N) = %1 не являются взаимно простыми").arg(phi));
+        return trace.finish(result);
     }
 
     uint64_t d = modInverse(e, phi);
@@ -426,89 +436,102 @@ CipherResult RSASignCipher::encrypt(const QString& text, const QVariantMap& para
 
     // Проверка: e и d не должны быть равны
     if (e == d) {
-        result.result = QString("ОШИБКА: Открытый ключ E (%1) равен закрытому ключу D (%2)! "
-                                "Выберите другие простые числа P и Q или другую экспоненту E.\n"
-                                "Это происходит, когда E² ≡ 1 (mod φ(N)).")
-                            .arg(e).arg(d);
-        return result;
+        result.fail(CipherStatus::InvalidParams, QString("ОШИБКА: Открытый ключ E (%1) равен закрытому ключу D (%2)! "
+                                                         "Выберите другие простые числа P и Q или другую экспоненту E.\n"
+                                                         "Это происходит, когда E² ≡ 1 (mod φ(N)).")
+                                                     .arg(e).arg(d));
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: P=%1, Q=%2, E=%3, N=%4, φ(N)=%5, D=%6")
-            .arg(p).arg(q).arg(e).arg(n).arg(phi).arg(d),
-        "Вычисление ключей"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: P=%1, Q=%2, E=%3, N=%4, φ(N)=%5, D=%6")
+                .arg(p).arg(q).arg(e).arg(n).arg(phi).arg(d),
+            "Вычисление ключей"));
+    }
 
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Сообщение: %1").arg(filteredText),
-        "Подготовка данных"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Сообщение: %1").arg(filteredText),
+            "Подготовка данных"));
+    }
 
     // Вычисляем хеш с использованием N как модуля хеширования
     int stepCounter = 3;
-    uint64_t hash = computeHash(filteredText, n, steps, stepCounter);
+    uint64_t hash = computeHash(filteredText, n, steps, stepCounter, trace);
     stepCounter += filteredText.length() + 2;
 
     // Вычисляем подпись
     uint64_t signature = modPow(hash, d, n);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Подпись: S = H^D mod N = %1^%2 mod %3 = %4")
-            .arg(hash).arg(d).arg(n).arg(signature),
-        "Создание подписи"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Подпись: S = H^D mod N = %1^%2 mod %3 = %4")
+                .arg(hash).arg(d).arg(n).arg(signature),
+            "Создание подписи"));
+    }
 
     // Формируем результат: само сообщение и подпись через разделитель
     QString finalResult = filteredText + " | " + QString::number(signature);
 
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Результат: %1 | %2").arg(filteredText).arg(signature),
-        "Завершение"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Результат: %1 | %2").arg(filteredText).arg(signature),
+            "Завершение"));
+    }
 
     result.result = finalResult;
     result.steps = steps;
 
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== Расшифрование с проверкой подписи ====================
 CipherResult RSASignCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
     result.isNumeric = false;
 
     QVector<CipherStep> steps;
-    steps.append(CipherStep(0, QChar(), "Начало проверки подписи RSA", "Инициализация"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(0, QChar(), "Начало проверки подписи RSA", "Инициализация"));
+    }
 
     uint64_t n = params.value("n", 0).toULongLong();
     uint64_t e = params.value("e", 0).toULongLong();
 
     if (n == 0) {
-        result.result = "ОШИБКА: Не указан модуль N";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Не указан модуль N");
+        return trace.finish(result);
     }
     if (e == 0) {
-        result.result = "ОШИБКА: Не указан открытый ключ E для проверки подписи";
-        return result;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: Не указан открытый ключ E для проверки подписи");
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(1, QChar(),
-        QString("Параметры: N=%1, E=%2").arg(n).arg(e),
-        "Проверка параметров"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(1, QChar(),
+            QString("Параметры: N=%1, E=%2").arg(n).arg(e),
+            "Проверка параметров"));
+    }
 
     // Разбираем входные данные: сообщение | подпись
     QString inputText = text.trimmed();
     int separatorPos = inputText.lastIndexOf("|");
 
     if (separatorPos == -1) {
-        result.result = "ОШИБКА: Неверный формат. Ожидается: 'сообщение | подпись'";
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Неверный формат. Ожидается: 'сообщение | подпись'");
+        return trace.finish(result);
     }
 
     QString message = inputText.left(separatorPos).trimmed();
@@ -517,45 +540,55 @@ CipherResult RSASignCipher::decrypt(const QString& text, const QVariantMap& para
     bool sigOk;
     uint64_t signature = signaturePart.toULongLong(&sigOk);
     if (!sigOk) {
-        result.result = "ОШИБКА: Не удалось распознать подпись: " + signaturePart;
-        return result;
+        result.fail(CipherStatus::InvalidInput, "ОШИБКА: Не удалось распознать подпись: " + signaturePart);
+        return trace.finish(result);
     }
 
-    steps.append(CipherStep(2, QChar(),
-        QString("Получено сообщение: %1").arg(message),
-        "Извлечение сообщения"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(2, QChar(),
+            QString("Получено сообщение: %1").arg(message),
+            "Извлечение сообщения"));
+    }
 
-    steps.append(CipherStep(3, QChar(),
-        QString("Получена подпись: %1").arg(signature),
-        "Извлечение подписи"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(3, QChar(),
+            QString("Получена подпись: %1").arg(signature),
+            "Извлечение подписи"));
+    }
 
     // Вычисляем хеш сообщения
     int stepCounter = 4;
-    uint64_t computedHash = computeHash(message, n, steps, stepCounter);
+    uint64_t computedHash = computeHash(message, n, steps, stepCounter, trace);
     stepCounter += message.length() + 2;
 
     // Расшифровываем подпись (получаем хеш)
     uint64_t decryptedHash = modPow(signature, e, n);
-    steps.append(CipherStep(stepCounter++, QChar(),
-        QString("Расшифрованная подпись: H2 = S^E mod N = %1^%2 mod %3 = %4")
-            .arg(signature).arg(e).arg(n).arg(decryptedHash),
-        "Расшифрование подписи"));
+    if (trace.want(TraceLevel::Summary)) {
+        steps.append(CipherStep(stepCounter++, QChar(),
+            QString("Расшифрованная подпись: H2 = S^E mod N = %1^%2 mod %3 = %4")
+                .arg(signature).arg(e).arg(n).arg(decryptedHash),
+            "Расшифрование подписи"));
+    }
 
     // Проверка
     if (computedHash == decryptedHash) {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("✓ Подпись ВЕРНА! H1 (%1) == H2 (%2)").arg(computedHash).arg(decryptedHash),
-            "Проверка подписи - УСПЕШНО"));
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("✓ Подпись ВЕРНА! H1 (%1) == H2 (%2)").arg(computedHash).arg(decryptedHash),
+                "Проверка подписи - УСПЕШНО"));
+        }
         result.result = QString("✓ ПОДПИСЬ ВЕРНА!\n\nСообщение: %1").arg(message);
     } else {
-        steps.append(CipherStep(stepCounter++, QChar(),
-            QString("✗ Подпись НЕВЕРНА! H1 = %1 != H2 = %2").arg(computedHash).arg(decryptedHash),
-            "Проверка подписи - ОШИБКА"));
-        result.result = QString("ОШИБКА ПОДПИСИ: H1 = %1 != H2 = %2").arg(computedHash).arg(decryptedHash);
+        if (trace.want(TraceLevel::Summary)) {
+            steps.append(CipherStep(stepCounter++, QChar(),
+                QString("✗ Подпись НЕВЕРНА! H1 = %1 != H2 = %2").arg(computedHash).arg(decryptedHash),
+                "Проверка подписи - ОШИБКА"));
+        }
+        result.fail(CipherStatus::VerificationFailed, QString("ОШИБКА ПОДПИСИ: H1 = %1 != H2 = %2").arg(computedHash).arg(decryptedHash));
     }
 
     result.steps = steps;
-    return result;
+    return trace.finish(result);
 }
 
 // ==================== RSASignCipherRegister Implementation ====================
@@ -58,10 +58,11 @@ public:
     uint64_t modPow(uint64_t base, uint64_t exp, uint64_t mod) const;
 
     // Хеш-функция квадратичной свертки
-    uint64_t computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int stepOffset) const;
+    uint64_t computeHash(const QString& text, uint64_t p, QVector<CipherStep>& steps, int stepOffset,
+                         StepTrace& trace) const;
 
 private:
-    const QString m_alphabet = "АБВГДЕЖЗИКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    const Alphabet& m_alphabet = Alphabet::russianWithoutShortI();
 
     // Проверка параметров (с учетом p_hash)
     bool validateParameters(uint64_t p, uint64_t q, uint64_t e, uint64_t p_hash, QString& errorMessage) const;
@@ -135,6 +135,7 @@ QVector<int> ShannonPadCipher::generateGamma(int length, int t0, int a, int c)
 
 CipherResult ShannonPadCipher::process(const QString& text, const QVariantMap& params, bool encrypt)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -147,7 +148,7 @@ CipherResult ShannonPadCipher::process(const QString& text, const QVariantMap& p
     // Валидация параметров
     QString validationError;
     if (!validateParameters(t0, a, c, validationError)) {
-        result.result = "ОШИБКА: " + validationError;
+        result.fail(CipherStatus::InvalidParams, "ОШИБКА: " + validationError);
         return result;
     }
 
@@ -155,7 +156,7 @@ CipherResult ShannonPadCipher::process(const QString& text, const QVariantMap& p
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -186,38 +187,39 @@ CipherResult ShannonPadCipher::process(const QString& text, const QVariantMap& p
         QChar newChar = m_alphabet[newPos];
         transformed.append(newChar);
 
-        // Формируем описание шага
-        QString stepDesc = QString("Шаг %1: %2[%3] %4 гамма[%5] = %6[%7] (T%8 = %9)")
-            .arg(i + 1)
-            .arg(ch).arg(textPos)
-            .arg(operation)
-            .arg(gammaValue)
-            .arg(newChar).arg(newPos)
-            .arg(i).arg(gammaValue);
-
-        CipherStep step;
-        step.index = i;
-        step.originalChar = ch;
-        step.resultValue = QString(newChar);
-        step.description = stepDesc;
-        result.steps.append(step);
+        if (trace.want(TraceLevel::PerChar)) {
+            CipherStep step;
+            step.index = i;
+            step.originalChar = ch;
+            step.resultValue = QString(newChar);
+            step.description = QString("Шаг %1: %2[%3] %4 гамма[%5] = %6[%7] (T%8 = %9)")
+                .arg(i + 1)
+                .arg(ch).arg(textPos)
+                .arg(operation)
+                .arg(gammaValue)
+                .arg(newChar).arg(newPos)
+                .arg(i).arg(gammaValue);
+            result.steps.append(step);
+        }
     }
 
     // Добавляем информацию о гамме в результат
-    QString gammaStr;
-    for (int val : gamma) {
-        gammaStr += QString::number(val) + " ";
-    }
+    if (trace.want(TraceLevel::Summary)) {
+        QString gammaStr;
+        for (int val : gamma) {
+            gammaStr += QString::number(val) + " ";
+        }
 
-    CipherStep gammaStep;
-    gammaStep.index = -1;
-    gammaStep.originalChar = QChar();
-    gammaStep.resultValue = gammaStr.trimmed();
-    gammaStep.description = QString("Сгенерированная гамма (T0=%1, a=%2, c=%3):").arg(t0).arg(a).arg(c);
-    result.steps.prepend(gammaStep);
+        CipherStep gammaStep;
+        gammaStep.index = -1;
+        gammaStep.originalChar = QChar();
+        gammaStep.resultValue = gammaStr.trimmed();
+        gammaStep.description = QString("Сгенерированная гамма (T0=%1, a=%2, c=%3):").arg(t0).arg(a).arg(c);
+        result.steps.prepend(gammaStep);
+    }
 
     result.result = transformed;
-    return result;
+    return trace.finish(result);
 }
 
 // shannonpad.cpp - только исправленная регистрация
@@ -19,6 +19,7 @@ int TrithemiusCipher::normalizeShift(int shift) const {
 
 CipherResult TrithemiusCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -29,7 +30,7 @@ CipherResult TrithemiusCipher::encrypt(const QString& text, const QVariantMap& p
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -47,23 +48,26 @@ CipherResult TrithemiusCipher::encrypt(const QString& text, const QVariantMap& p
         QChar newChar = m_alphabet[newPos];
         encrypted.append(newChar);
 
-        CipherStep step;
-        step.index = i;
-        step.originalChar = ch;
-        step.resultValue = QString(newChar);
-        step.description = QString("%1[%2] + (%3+%4) = %5[%6]")
-                          .arg(ch).arg(pos)
-                          .arg(startShift).arg(i)  // startShift + i
-                          .arg(newChar).arg(newPos);
-        result.steps.append(step);
+        if (trace.want(TraceLevel::PerChar)) {
+            CipherStep step;
+            step.index = i;
+            step.originalChar = ch;
+            step.resultValue = QString(newChar);
+            step.description = QString("%1[%2] + (%3+%4) = %5[%6]")
+                              .arg(ch).arg(pos)
+                              .arg(startShift).arg(i)  // startShift + i
+                              .arg(newChar).arg(newPos);
+            result.steps.append(step);
+        }
     }
 
     result.result = encrypted;
-    return result;
+    return trace.finish(result);
 }
 
 CipherResult TrithemiusCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -75,7 +79,7 @@ CipherResult TrithemiusCipher::decrypt(const QString& text, const QVariantMap& p
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -93,19 +97,21 @@ CipherResult TrithemiusCipher::decrypt(const QString& text, const QVariantMap& p
         QChar newChar = m_alphabet[newPos];
         decrypted.append(newChar);
 
-        CipherStep step;
-        step.index = i;
-        step.originalChar = ch;
-        step.resultValue = QString(newChar);
-        step.description = QString("%1[%2] - (%3+%4) = %5[%6]")
-                          .arg(ch).arg(pos)
-                          .arg(startShift).arg(i)  // startShift + i
-                          .arg(newChar).arg(newPos);
-        result.steps.append(step);
+        if (trace.want(TraceLevel::PerChar)) {
+            CipherStep step;
+            step.index = i;
+            step.originalChar = ch;
+            step.resultValue = QString(newChar);
+            step.description = QString("%1[%2] - (%3+%4) = %5[%6]")
+                              .arg(ch).arg(pos)
+                              .arg(startShift).arg(i)  // startShift + i
+                              .arg(newChar).arg(newPos);
+            result.steps.append(step);
+        }
     }
 
     result.result = decrypted;
-    return result;
+    return trace.finish(result);
 }
 
 TrithemiusCipherRegister::TrithemiusCipherRegister()
@@ -20,6 +20,7 @@ QString VigenereAutoCipher::generateEncryptionKey(const QString& text, QChar key
 
 CipherResult VigenereAutoCipher::encrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -28,7 +29,7 @@ CipherResult VigenereAutoCipher::encrypt(const QString& text, const QVariantMap&
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -48,32 +49,35 @@ CipherResult VigenereAutoCipher::encrypt(const QString& text, const QVariantMap&
         QChar newChar = m_alphabet[newPos];
         encrypted.append(newChar);
 
-        CipherStep step;
-        step.index = i;
-        step.originalChar = ch;
-        step.resultValue = QString(newChar);
-
-        if (i == 0) {
-            step.description = QString("%1[%2] + %3[%4] = %5[%6] (начальная буква ключа)")
-                              .arg(ch).arg(textPos)
-                              .arg(keyChar).arg(keyPos)
-                              .arg(newChar).arg(newPos);
-        } else {
-            step.description = QString("%1[%2] + %3[%4] = %5[%6] (ключ из предыдущей буквы текста)")
-                              .arg(ch).arg(textPos)
-                              .arg(keyChar).arg(keyPos)
-                              .arg(newChar).arg(newPos);
+        if (trace.want(TraceLevel::PerChar)) {
+            CipherStep step;
+            step.index = i;
+            step.originalChar = ch;
+            step.resultValue = QString(newChar);
+
+            if (i == 0) {
+                step.description = QString("%1[%2] + %3[%4] = %5[%6] (начальная буква ключа)")
+                                  .arg(ch).arg(textPos)
+                                  .arg(keyChar).arg(keyPos)
+                                  .arg(newChar).arg(newPos);
+            } else {
+                step.description = QString("%1[%2] + %3[%4] = %5[%6] (ключ из предыдущей буквы текста)")
+                                  .arg(ch).arg(textPos)
+                                  .arg(keyChar).arg(keyPos)
+                                  .arg(newChar).arg(newPos);
+            }
+
+            result.steps.append(step);
         }
-
-        result.steps.append(step);
     }
 
     result.result = encrypted;
-    return result;
+    return trace.finish(result);
 }
 
 CipherResult VigenereAutoCipher::decrypt(const QString& text, const QVariantMap& params)
 {
+    StepTrace trace(params);
     CipherResult result;
     result.cipherName = name();
     result.alphabet = m_alphabet;
@@ -82,7 +86,7 @@ CipherResult VigenereAutoCipher::decrypt(const QString& text, const QVariantMap&
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -98,15 +102,17 @@ CipherResult VigenereAutoCipher::decrypt(const QString& text, const QVariantMap&
     QChar firstNewChar = m_alphabet[firstNewPos];
     decrypted.append(firstNewChar);
 
-    CipherStep firstStep;
-    firstStep.index = 0;
-    firstStep.originalChar = firstCh;
-    firstStep.resultValue = QString(firstNewChar);
-    firstStep.description = QString("%1[%2] - %3[%4] = %5[%6] (начальная буква ключа)")
-                          .arg(firstCh).arg(firstTextPos)
-                          .arg(keyLetter).arg(firstKeyPos)
-                          .arg(firstNewChar).arg(firstNewPos);
-    result.steps.append(firstStep);
+    if (trace.want(TraceLevel::PerChar)) {
+        CipherStep firstStep;
+        firstStep.index = 0;
+        firstStep.originalChar = firstCh;
+        firstStep.resultValue = QString(firstNewChar);
+        firstStep.description = QString("%1[%2] - %3[%4] = %5[%6] (начальная буква ключа)")
+                              .arg(firstCh).arg(firstTextPos)
+                              .arg(keyLetter).arg(firstKeyPos)
+                              .arg(firstNewChar).arg(firstNewPos);
+        result.steps.append(firstStep);
+    }
 
     // Остальные буквы: используем предыдущие расшифрованные буквы как ключ
     for (int i = 1; i < filteredText.length(); ++i) {
@@ -120,19 +126,21 @@ CipherResult VigenereAutoCipher::decrypt(const QString& text, const QVariantMap&
         QChar newChar = m_alphabet[newPos];
         decrypted.append(newChar);
 
-        CipherStep step;
-        step.index = i;
-        step.originalChar = ch;
-        step.resultValue = QString(newChar);
-        step.description = QString("%1[%2] - %3[%4] = %5[%6] (ключ из предыдущей расшифрованной буквы)")
-                          .arg(ch).arg(textPos)
-                          .arg(keyChar).arg(keyPos)
-                          .arg(newChar).arg(newPos);
-        result.steps.append(step);
+        if (trace.want(TraceLevel::PerChar)) {
+            CipherStep step;
+            step.index = i;
+            step.originalChar = ch;
+            step.resultValue = QString(newChar);
+            step.description = QString("%1[%2] - %3[%4] = %5[%6] (ключ из предыдущей расшифрованной буквы)")
+                              .arg(ch).arg(textPos)
+                              .arg(keyChar).arg(keyPos)
+                              .arg(newChar).arg(newPos);
+            result.steps.append(step);
+        }
     }
 
     result.result = decrypted;
-    return result;
+    return trace.finish(result);
 }
 
 VigenereAutoCipherRegister::VigenereAutoCipherRegister()
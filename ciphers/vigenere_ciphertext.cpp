@@ -9,16 +9,19 @@ VigenereCiphertextCipher::VigenereCiphertextCipher()
 CipherResult VigenereCiphertextCipher::encrypt(const QString& text, const QVariantMap& params)
 {
     QChar keyLetter = params.value("keyLetter", "А").toChar();
-    return process(text, keyLetter, true);
+    StepTrace trace(params);
+    return trace.finish(process(text, keyLetter, true, trace));
 }
 
 CipherResult VigenereCiphertextCipher::decrypt(const QString& text, const QVariantMap& params)
 {
     QChar keyLetter = params.value("keyLetter", "А").toChar();
-    return process(text, keyLetter, false);
+    StepTrace trace(params);
+    return trace.finish(process(text, keyLetter, false, trace));
 }
 
-CipherResult VigenereCiphertextCipher::process(const QString& text, QChar keyLetter, bool encrypt)
+CipherResult VigenereCiphertextCipher::process(const QString& text, QChar keyLetter, bool encrypt,
+                                               StepTrace& trace)
 {
     CipherResult result;
     result.cipherName = name();
@@ -28,7 +31,7 @@ CipherResult VigenereCiphertextCipher::process(const QString& text, QChar keyLet
     QString filteredText = CipherUtils::filterAlphabetOnly(text, m_alphabet);
 
     if (filteredText.isEmpty()) {
-        result.result = "Нет букв для преобразования";
+        result.fail(CipherStatus::InvalidInput, "Нет букв для преобразования");
         return result;
     }
 
@@ -63,29 +66,31 @@ CipherResult VigenereCiphertextCipher::process(const QString& text, QChar keyLet
         // Обновляем ключ
         currentKey = encrypt ? newChar : ch;
 
-        // Формируем описание
-        QString stepDesc;
-        if (i == 0) {
-            stepDesc = QString("%1[%2] %3 %4[%5] = %6[%7] (начальный ключ)")
-                .arg(ch).arg(textPos)
-                .arg(operation)
-                .arg(keyLetter).arg(keyPos)
-                .arg(newChar).arg(newPos);
-        } else {
-            QChar prevChar = encrypt ? transformed[i-1] : filteredText[i-1];
-            stepDesc = QString("%1[%2] %3 %4[%5] = %6[%7] (ключ из шифротекста)")
-                .arg(ch).arg(textPos)
-                .arg(operation)
-                .arg(prevChar).arg(m_alphabet.indexOf(prevChar))
-                .arg(newChar).arg(newPos);
+        if (trace.want(TraceLevel::PerChar)) {
+            // Формируем описание
+            QString stepDesc;
+            if (i == 0) {
+                stepDesc = QString("%1[%2] %3 %4[%5] = %6[%7] (начальный ключ)")
+                    .arg(ch).arg(textPos)
+                    .arg(operation)
+                    .arg(keyLetter).arg(keyPos)
+                    .arg(newChar).arg(newPos);
+            } else {
+                QChar prevChar = encrypt ? transformed[i-1] : filteredText[i-1];
+                stepDesc = QString("%1[%2] %3 %4[%5] = %6[%7] (ключ из шифротекста)")
+                    .arg(ch).arg(textPos)
+                    .arg(operation)
+                    .arg(prevChar).arg(m_alphabet.indexOf(prevChar))
+                    .arg(newChar).arg(newPos);
+            }
+
+            CipherStep step;
+            step.index = i;
+            step.originalChar = ch;
+            step.resultValue = QString(newChar);
+            step.description = stepDesc;
+            result.steps.append(step);
         }
-
-        CipherStep step;
-        step.index = i;
-        step.originalChar = ch;
-        step.resultValue = QString(newChar);
-        step.description = stepDesc;
-        result.steps.append(step);
     }
 
     result.result = transformed;
@@ -17,9 +17,9 @@ public:
     }
 
 private:
-    QString m_alphabet = QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ");
+    const Alphabet& m_alphabet = Alphabet::russian();
 
-    CipherResult process(const QString& text, QChar keyLetter, bool encrypt);
+    CipherResult process(const QString& text, QChar keyLetter, bool encrypt, StepTrace& trace);
 };
 
 class VigenereCiphertextCipherRegister {
@@ -0,0 +1,418 @@
+#include "batchrunner.h"
+#include "cipherfactory.h"
+#include "formatter.h"
+#include <QCommandLineParser>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <cstdio>
+#include <memory>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+namespace {
+    void printErr(const QString& text)
+    {
+        if (text.isEmpty()) return;
+        QByteArray bytes = text.toUtf8();
+        if (!bytes.endsWith('\n')) bytes.append('\n');
+        std::fwrite(bytes.constData(), 1, size_t(bytes.size()), stderr);
+    }
+}
+
+// ==================== Разбор командной строки ====================
+bool BatchRunner::parseArguments(const QStringList& arguments, BatchOptions& options,
+                                 QString* error, QString* helpText)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Пакетное шифрование без графического интерфейса.\n"
+        "Для запуска GUI используйте: cryptoApp --gui");
+    parser.addHelpOption();
+
+    QCommandLineOption cipherOption({"c", "cipher"}, "ID шифра (см. --list).", "id");
+    QCommandLineOption decryptOption({"d", "decrypt"}, "Расшифрование вместо шифрования.");
+    QCommandLineOption binaryOption({"b", "binary"},
+        "Сырые байты без HEX (только блочные и поточные шифры), потоковая обработка.");
+    QCommandLineOption paramOption({"p", "param"}, "Параметр шифра, можно повторять.", "ключ=значение");
+    QCommandLineOption paramsFileOption("params", "Параметры шифра из JSON-объекта.", "file.json");
+    QCommandLineOption outputOption({"o", "output-dir"},
+        "Каталог для результатов (<имя>.enc / <имя>.dec). Без него — стандартный вывод.", "dir");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Число потоков обработки файлов.", "n");
+    QCommandLineOption traceOption({"t", "trace"},
+        "Уровень трассировки шагов в stderr: none, summary, block, char (по умолчанию none).", "level");
+    QCommandLineOption listOption({"l", "list"}, "Список доступных шифров.");
+
+    parser.addOptions({cipherOption, decryptOption, binaryOption, paramOption, paramsFileOption,
+                       outputOption, jobsOption, traceOption, listOption});
+    parser.addPositionalArgument("files", "Входные файлы; без них или \"-\" — стандартный ввод.", "[files...]");
+
+    if (helpText) {
+        *helpText = parser.helpText();
+    }
+
+    if (!parser.parse(arguments)) {
+        if (error) *error = "ОШИБКА: " + parser.errorText();
+        return false;
+    }
+
+    // Без аргументов и по --help — только справка
+    if (parser.isSet("help") || arguments.size() <= 1) {
+        if (error) error->clear();
+        return false;
+    }
+
+    options.listCiphers = parser.isSet(listOption);
+    if (options.listCiphers) {
+        return true;
+    }
+
+    bool ok = false;
+    options.cipherId = parser.value(cipherOption).toInt(&ok);
+    if (!ok) {
+        if (error) *error = "ОШИБКА: Не указан ID шифра (--cipher)";
+        return false;
+    }
+
+    options.decrypt = parser.isSet(decryptOption);
+    options.binary = parser.isSet(binaryOption);
+    options.outputDir = parser.value(outputOption);
+    options.inputs = parser.positionalArguments();
+
+    if (parser.isSet(jobsOption)) {
+        options.jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || options.jobs < 1) {
+            if (error) *error = "ОШИБКА: Число потоков должно быть положительным";
+            return false;
+        }
+    }
+
+    // Параметры: сначала JSON-файл, затем -p поверх него
+    if (parser.isSet(paramsFileOption)) {
+        QFile file(parser.value(paramsFileOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            if (error) *error = QString("ОШИБКА: Не удалось открыть %1: %2")
+                                    .arg(file.fileName(), file.errorString());
+            return false;
+        }
+
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+            if (error) *error = QString("ОШИБКА: %1 не является JSON-объектом (%2)")
+                                    .arg(file.fileName(), parseError.errorString());
+            return false;
+        }
+        options.params = doc.object().toVariantMap();
+    }
+
+    for (const QString& pair : parser.values(paramOption)) {
+        int eq = pair.indexOf('=');
+        if (eq <= 0) {
+            if (error) *error = QString("ОШИБКА: Параметр \"%1\" должен иметь вид ключ=значение").arg(pair);
+            return false;
+        }
+        options.params.insert(pair.left(eq), pair.mid(eq + 1));
+    }
+
+    // В пакетном режиме шаги по умолчанию не собираются
+    if (parser.isSet(traceOption)) {
+        options.params.insert("traceLevel", parser.value(traceOption));
+    } else if (!options.params.contains("traceLevel")) {
+        options.params.insert("traceLevel", "none");
+    }
+
+    return true;
+}
+
+int BatchRunner::run(const QStringList& arguments)
+{
+    BatchOptions options;
+    QString error;
+    QString helpText;
+
+    if (!parseArguments(arguments, options, &error, &helpText)) {
+        if (error.isEmpty()) {
+            QByteArray help = helpText.toUtf8();
+            std::fwrite(help.constData(), 1, size_t(help.size()), stdout);
+            return 0;
+        }
+        printErr(error);
+        return 2;
+    }
+
+    if (options.listCiphers) {
+        listCiphers();
+        return 0;
+    }
+
+    return BatchRunner(options).exec();
+}
+
+void BatchRunner::listCiphers()
+{
+    const CipherFactory& factory = CipherFactory::instance();
+    QByteArray text;
+    for (int id : factory.availableCipherIds()) {
+        text += QString("%1\t%2\n").arg(id).arg(factory.displayNameFromId(id)).toUtf8();
+    }
+    std::fwrite(text.constData(), 1, size_t(text.size()), stdout);
+}
+
+// ==================== Выполнение ====================
+BatchRunner::BatchRunner(const BatchOptions& options)
+    : m_options(options)
+{
+}
+
+int BatchRunner::exec()
+{
+    CipherFactory& factory = CipherFactory::instance();
+    if (!factory.hasCipher(m_options.cipherId)) {
+        printErr(QString("ОШИБКА: Шифр с ID %1 не найден (см. --list)").arg(m_options.cipherId));
+        return 2;
+    }
+
+    if (m_options.binary) {
+        std::unique_ptr<CipherInterface> probe = factory.createCipher(m_options.cipherId);
+        if (!probe || !probe->supportsBytes()) {
+            printErr(QString("ОШИБКА: %1 не поддерживает бинарный режим")
+                         .arg(factory.displayNameFromId(m_options.cipherId)));
+            return 2;
+        }
+    }
+
+    if (!m_options.outputDir.isEmpty() && !QDir().mkpath(m_options.outputDir)) {
+        printErr(QString("ОШИБКА: Не удалось создать каталог %1").arg(m_options.outputDir));
+        return 2;
+    }
+
+    // Стандартный ввод → стандартный вывод
+    if (m_options.inputs.isEmpty() ||
+        (m_options.inputs.size() == 1 && m_options.inputs.first() == "-")) {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        QFile in;
+        QFile out;
+        in.open(stdin, QIODevice::ReadOnly);
+        out.open(stdout, QIODevice::WriteOnly);
+
+        QString log;
+        bool ok = processDevice(in, out, log);
+        out.flush();
+        printErr(log);
+        return ok ? 0 : 1;
+    }
+
+    if (m_options.inputs.contains("-")) {
+        printErr("ОШИБКА: Стандартный ввод нельзя сочетать с файлами");
+        return 2;
+    }
+
+    // Каждый файл — отдельная задача пула; свой экземпляр шифра на задачу
+    const int count = m_options.inputs.size();
+    const int threads = m_options.jobs > 0 ? m_options.jobs : QThread::idealThreadCount();
+    QVector<QByteArray> outputs(count);
+    QVector<QString> logs(count);
+    QVector<char> succeeded(count, 0);
+    QVector<char> done(count, 0);
+
+    // Без каталога результатов вывод файла копится в памяти, пока не выведены
+    // все предыдущие: в работе и в очереди на вывод не больше window файлов
+    const int window = m_options.outputDir.isEmpty() ? 2 * threads : count;
+
+    QMutex mutex;
+    QWaitCondition finished;
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    // Вывод — в порядке файлов в командной строке, по мере готовности
+    QFile out;
+    out.open(stdout, QIODevice::WriteOnly);
+    int failed = 0;
+    int started = 0;
+    for (int next = 0; next < count; ++next) {
+        while (started < count && started < next + window) {
+            const int i = started++;
+            pool.start([this, i, &outputs, &logs, &succeeded, &done, &mutex, &finished]() {
+                const bool ok = processFile(m_options.inputs[i], outputs[i], logs[i]);
+                QMutexLocker lock(&mutex);
+                succeeded[i] = ok ? 1 : 0;
+                done[i] = 1;
+                finished.wakeAll();
+            });
+        }
+
+        {
+            QMutexLocker lock(&mutex);
+            while (!done[next]) {
+                finished.wait(&mutex);
+            }
+        }
+
+        if (!outputs[next].isEmpty()) {
+            out.write(outputs[next]);
+            out.flush();
+            outputs[next] = QByteArray();
+        }
+        if (!logs[next].isEmpty()) {
+            printErr(m_options.inputs[next] + ": " + logs[next]);
+        }
+        if (!succeeded[next]) ++failed;
+    }
+    pool.waitForDone();
+
+    return failed == 0 ? 0 : 1;
+}
+
+QString BatchRunner::outputPath(const QString& inputPath) const
+{
+    QString suffix = m_options.decrypt ? ".dec" : ".enc";
+    return QDir(m_options.outputDir).filePath(QFileInfo(inputPath).fileName() + suffix);
+}
+
+bool BatchRunner::processFile(const QString& path, QByteArray& buffered, QString& log) const
+{
+    QFile in(path);
+    if (!in.open(QIODevice::ReadOnly)) {
+        log = QString("ОШИБКА: Не удалось открыть %1: %2").arg(path, in.errorString());
+        return false;
+    }
+
+    // Без каталога результатов вывод копится до завершения пула
+    if (m_options.outputDir.isEmpty()) {
+        QBuffer out(&buffered);
+        out.open(QIODevice::WriteOnly);
+        bool ok = processDevice(in, out, log);
+        if (!ok) buffered.clear();
+        return ok;
+    }
+
+    QSaveFile out(outputPath(path));
+    if (!out.open(QIODevice::WriteOnly)) {
+        log = QString("ОШИБКА: Не удалось создать %1: %2").arg(out.fileName(), out.errorString());
+        return false;
+    }
+
+    if (!processDevice(in, out, log)) {
+        out.cancelWriting();
+        return false;
+    }
+
+    if (!out.commit()) {
+        log = QString("ОШИБКА: Не удалось записать %1: %2").arg(out.fileName(), out.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool BatchRunner::processDevice(QIODevice& in, QIODevice& out, QString& log) const
+{
+    return m_options.binary ? processStream(in, out, log) : processWhole(in, out, log);
+}
+
+// Бинарный режим: порции по CHUNK_SIZE через потоковый контекст шифра
+bool BatchRunner::processStream(QIODevice& in, QIODevice& out, QString& log) const
+{
+    std::unique_ptr<CipherInterface> cipher = CipherFactory::instance().createCipher(m_options.cipherId);
+    std::unique_ptr<CipherStream> stream = cipher->createStream(!m_options.decrypt);
+
+    // Шифр без потокового контекста — сообщение целиком
+    if (!stream) {
+        QByteArray data = in.readAll();
+        QByteArray result;
+        bool ok = m_options.decrypt ? cipher->decryptBytes(data, result, m_options.params, &log)
+                                    : cipher->encryptBytes(data, result, m_options.params, &log);
+        if (!ok) {
+            return false;
+        }
+        if (out.write(result) != result.size()) {
+            log = "ОШИБКА: Ошибка записи: " + out.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    if (!stream->init(m_options.params, &log)) {
+        return false;
+    }
+
+    QByteArray chunk(CHUNK_SIZE, Qt::Uninitialized);
+    QByteArray result;
+    result.reserve(CHUNK_SIZE);
+
+    for (;;) {
+        qint64 n = in.read(chunk.data(), CHUNK_SIZE);
+        if (n < 0) {
+            log = "ОШИБКА: Ошибка чтения: " + in.errorString();
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+
+        result.resize(0);
+        if (!stream->update(chunk.constData(), n, result, &log)) {
+            return false;
+        }
+        if (out.write(result) != result.size()) {
+            log = "ОШИБКА: Ошибка записи: " + out.errorString();
+            return false;
+        }
+    }
+
+    result.resize(0);
+    if (!stream->final(result, &log)) {
+        return false;
+    }
+    if (out.write(result) != result.size()) {
+        log = "ОШИБКА: Ошибка записи: " + out.errorString();
+        return false;
+    }
+    return true;
+}
+
+// Текстовый режим: вход — UTF-8 текст (или HEX для блочных шифров), как в окне программы
+bool BatchRunner::processWhole(QIODevice& in, QIODevice& out, QString& log) const
+{
+    QString text = QString::fromUtf8(in.readAll());
+
+    // Завершающий перевод строки из конвейера не относится к сообщению
+    while (text.endsWith('\n') || text.endsWith('\r')) {
+        text.chop(1);
+    }
+
+    std::unique_ptr<CipherInterface> cipher = CipherFactory::instance().createCipher(m_options.cipherId);
+    CipherResult result = m_options.decrypt ? cipher->decrypt(text, m_options.params)
+                                            : cipher->encrypt(text, m_options.params);
+
+    if (!result.ok()) {
+        log = QString("%1 [%2]").arg(result.message, CipherUtils::statusName(result.status));
+        return false;
+    }
+
+    // При traceLevel=none пропускается каждый шаг, и счетчик пропущенных ненулевой
+    // всегда — журнал только при собранных шагах или явно запрошенной трассировке
+    const bool traceRequested = CipherUtils::traceLevel(m_options.params) != TraceLevel::None;
+    if (!result.steps.isEmpty() || (traceRequested && result.suppressedSteps > 0)) {
+        log = StepFormatter::formatStepsOnly(result);
+    }
+
+    QByteArray bytes = result.result.toUtf8();
+    bytes.append('\n');
+    return out.write(bytes) == bytes.size();
+}
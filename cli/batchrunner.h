@@ -0,0 +1,54 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QByteArray>
+#include <QIODevice>
+
+// Параметры пакетного запуска (разбор командной строки)
+struct BatchOptions {
+    int cipherId = 0;
+    bool decrypt = false;
+    bool binary = false;          // Сырые байты через encryptBytes/createStream
+    QVariantMap params;           // Параметры шифра (--params JSON + -p ключ=значение)
+    QStringList inputs;           // Пусто или "-" — стандартный ввод
+    QString outputDir;            // Пусто — результат в стандартный вывод
+    int jobs = 0;                 // 0 — по числу ядер
+    bool listCiphers = false;
+};
+
+// Консольный драйвер: шифр из CipherFactory, данные из stdin или файлов.
+// Работает без QApplication — только QtCore, файлы обрабатываются пулом потоков.
+class BatchRunner
+{
+public:
+    // Точка входа консольного режима; возвращает код завершения процесса
+    static int run(const QStringList& arguments);
+
+    static bool parseArguments(const QStringList& arguments, BatchOptions& options,
+                               QString* error, QString* helpText = nullptr);
+
+    explicit BatchRunner(const BatchOptions& options);
+
+    int exec();
+
+private:
+    // Размер порции при потоковой обработке
+    static const int CHUNK_SIZE = 64 * 1024;
+
+    // Обработка одного источника; err — сообщения для stderr
+    bool processDevice(QIODevice& in, QIODevice& out, QString& err) const;
+    bool processStream(QIODevice& in, QIODevice& out, QString& err) const;
+    bool processWhole(QIODevice& in, QIODevice& out, QString& err) const;
+
+    bool processFile(const QString& path, QByteArray& buffered, QString& err) const;
+    QString outputPath(const QString& inputPath) const;
+
+    static void listCiphers();
+
+    BatchOptions m_options;
+};
+
+#endif // BATCHRUNNER_H
@@ -1 +1,323 @@
 #include "ciphercore.h"
+#include "cpufeatures.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <iterator>
+
+#if defined(CRYPTOAPP_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+    const char16_t YO_UPPER = 0x0401;   // Ё
+    const char16_t YO_LOWER = 0x0451;   // ё
+    const char16_t IE_UPPER = 0x0415;   // Е
+    const char16_t CASE_OFFSET = 0x20;  // а - А, a - A
+
+#if defined(CRYPTOAPP_X86)
+    // Параметры векторного фильтра для алфавита-диапазона
+    struct RangeParams {
+        char16_t first;
+        char16_t span;
+        bool foldYo;
+    };
+
+    // Маски pshufb, сжимающие оставленные 16-битные символы к началу регистра:
+    // для каждой 8-битной маски «оставить» — перестановка байтов
+    struct CompactTable {
+        alignas(16) quint8 shuffle[256][16];
+
+        CompactTable() {
+            for (int mask = 0; mask < 256; ++mask) {
+                int k = 0;
+                for (int lane = 0; lane < 8; ++lane) {
+                    if (mask & (1 << lane)) {
+                        shuffle[mask][k++] = quint8(2 * lane);
+                        shuffle[mask][k++] = quint8(2 * lane + 1);
+                    }
+                }
+                while (k < 16) {
+                    shuffle[mask][k++] = 0x80;
+                }
+            }
+        }
+    };
+
+    const CompactTable& compactTable()
+    {
+        static const CompactTable table;
+        return table;
+    }
+
+    // Обрабатывает блоки по 8 символов, пока в блоке нет символов вне таблиц
+    // (не ASCII и не кириллица). Возвращает число обработанных символов.
+    CRYPTOAPP_TARGET("sse2")
+    qsizetype filterRangeSse2(const char16_t* in, qsizetype len, char16_t*& out,
+                              const RangeParams& p)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i first = _mm_set1_epi16(short(p.first));
+        const __m128i firstLower = _mm_set1_epi16(short(p.first + CASE_OFFSET));
+        const __m128i span = _mm_set1_epi16(short(p.span));
+        const __m128i caseOffset = _mm_set1_epi16(short(CASE_OFFSET));
+        const __m128i asciiLast = _mm_set1_epi16(0x7F);
+        const __m128i cyrillicFirst = _mm_set1_epi16(0x0400);
+        const __m128i cyrillicSpan = _mm_set1_epi16(0xFF);
+        const __m128i yoUpper = _mm_set1_epi16(short(YO_UPPER));
+        const __m128i yoLower = _mm_set1_epi16(short(YO_LOWER));
+        const __m128i ieUpper = _mm_set1_epi16(short(IE_UPPER));
+
+        qsizetype i = 0;
+        for (; i + 8 <= len; i += 8) {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+            // Беззнаковое x <= y для 16-битных слов: subs_epu16(x, y) == 0
+            const __m128i inTable = _mm_or_si128(
+                _mm_cmpeq_epi16(_mm_subs_epu16(c, asciiLast), zero),
+                _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(c, cyrillicFirst), cyrillicSpan), zero));
+            if (_mm_movemask_epi8(inTable) != 0xFFFF) {
+                break;
+            }
+
+            if (p.foldYo) {
+                const __m128i isYo = _mm_or_si128(_mm_cmpeq_epi16(c, yoUpper),
+                                                  _mm_cmpeq_epi16(c, yoLower));
+                c = _mm_or_si128(_mm_andnot_si128(isYo, c), _mm_and_si128(isYo, ieUpper));
+            }
+
+            const __m128i isUpper = _mm_cmpeq_epi16(
+                _mm_subs_epu16(_mm_sub_epi16(c, first), span), zero);
+            const __m128i isLower = _mm_cmpeq_epi16(
+                _mm_subs_epu16(_mm_sub_epi16(c, firstLower), span), zero);
+            const __m128i folded = _mm_sub_epi16(c, _mm_and_si128(isLower, caseOffset));
+            const __m128i keep = _mm_or_si128(isUpper, isLower);
+
+            unsigned mask = unsigned(_mm_movemask_epi8(_mm_packs_epi16(keep, zero))) & 0xFF;
+            if (mask == 0xFF) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), folded);
+                out += 8;
+            } else if (mask != 0) {
+                alignas(16) char16_t lanes[8];
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes), folded);
+                while (mask != 0) {
+                    *out++ = lanes[qCountTrailingZeroBits(mask)];
+                    mask &= mask - 1;
+                }
+            }
+        }
+        return i;
+    }
+
+    // То же блоками по 16 символов; сжатие половин регистра через pshufb
+    CRYPTOAPP_TARGET("avx2")
+    qsizetype filterRangeAvx2(const char16_t* in, qsizetype len, char16_t*& out,
+                              const RangeParams& p)
+    {
+        const CompactTable& table = compactTable();
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i first = _mm256_set1_epi16(short(p.first));
+        const __m256i firstLower = _mm256_set1_epi16(short(p.first + CASE_OFFSET));
+        const __m256i span = _mm256_set1_epi16(short(p.span));
+        const __m256i caseOffset = _mm256_set1_epi16(short(CASE_OFFSET));
+        const __m256i asciiLast = _mm256_set1_epi16(0x7F);
+        const __m256i cyrillicFirst = _mm256_set1_epi16(0x0400);
+        const __m256i cyrillicSpan = _mm256_set1_epi16(0xFF);
+        const __m256i yoUpper = _mm256_set1_epi16(short(YO_UPPER));
+        const __m256i yoLower = _mm256_set1_epi16(short(YO_LOWER));
+        const __m256i ieUpper = _mm256_set1_epi16(short(IE_UPPER));
+
+        qsizetype i = 0;
+        for (; i + 16 <= len; i += 16) {
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+
+            const __m256i inTable = _mm256_or_si256(
+                _mm256_cmpeq_epi16(_mm256_subs_epu16(c, asciiLast), zero),
+                _mm256_cmpeq_epi16(_mm256_subs_epu16(_mm256_sub_epi16(c, cyrillicFirst),
+                                                     cyrillicSpan), zero));
+            if (unsigned(_mm256_movemask_epi8(inTable)) != 0xFFFFFFFFu) {
+                break;
+            }
+
+            if (p.foldYo) {
+                const __m256i isYo = _mm256_or_si256(_mm256_cmpeq_epi16(c, yoUpper),
+                                                     _mm256_cmpeq_epi16(c, yoLower));
+                c = _mm256_blendv_epi8(c, ieUpper, isYo);
+            }
+
+            const __m256i isUpper = _mm256_cmpeq_epi16(
+                _mm256_subs_epu16(_mm256_sub_epi16(c, first), span), zero);
+            const __m256i isLower = _mm256_cmpeq_epi16(
+                _mm256_subs_epu16(_mm256_sub_epi16(c, firstLower), span), zero);
+            const __m256i folded = _mm256_sub_epi16(c, _mm256_and_si256(isLower, caseOffset));
+            const __m256i keep = _mm256_or_si256(isUpper, isLower);
+
+            // packs работает внутри 128-битных половин: биты 0..7 — младшие 8 символов,
+            // биты 16..23 — старшие
+            const unsigned mask = unsigned(_mm256_movemask_epi8(_mm256_packs_epi16(keep, zero)));
+            if (mask == 0x00FF00FFu) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), folded);
+                out += 16;
+                continue;
+            }
+
+            const unsigned lowMask = mask & 0xFF;
+            const unsigned highMask = (mask >> 16) & 0xFF;
+
+            // Запись полных 16 байт безопасна: out не обгоняет in + i, а блок целиком прочитан
+            const __m128i low = _mm_shuffle_epi8(
+                _mm256_castsi256_si128(folded),
+                _mm_load_si128(reinterpret_cast<const __m128i*>(table.shuffle[lowMask])));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), low);
+            out += qPopulationCount(lowMask);
+
+            const __m128i high = _mm_shuffle_epi8(
+                _mm256_extracti128_si256(folded, 1),
+                _mm_load_si128(reinterpret_cast<const __m128i*>(table.shuffle[highMask])));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), high);
+            out += qPopulationCount(highMask);
+        }
+        return i;
+    }
+#endif
+}
+
+Alphabet::Alphabet(const QString& letters)
+    : m_letters(letters)
+{
+    std::fill(std::begin(m_index), std::end(m_index), qint16(-1));
+
+    // При повторах действует первое вхождение — как у QString::indexOf
+    for (int i = int(m_letters.size()) - 1; i >= 0; --i) {
+        const unsigned code = m_letters.at(i).unicode();
+        if (code < ASCII_SIZE) {
+            m_index[code] = qint16(i);
+        } else if (code - CYRILLIC_FIRST < CYRILLIC_SIZE) {
+            m_index[ASCII_SIZE + (code - CYRILLIC_FIRST)] = qint16(i);
+        } else {
+            m_hasOutOfTable = true;
+        }
+    }
+
+    // Свёртка регистра для символов таблицы: та же семантика, что у
+    // text.toUpper() с последующей проверкой contains()
+    for (unsigned t = 0; t < ASCII_SIZE + CYRILLIC_SIZE; ++t) {
+        const char16_t code = char16_t(t < ASCII_SIZE ? t : CYRILLIC_FIRST + (t - ASCII_SIZE));
+        const QChar upper = QChar(code).toUpper();
+        m_fold[t] = contains(upper) ? upper.unicode() : char16_t(0);
+    }
+    m_foldYo = m_fold[ASCII_SIZE + (IE_UPPER - CYRILLIC_FIRST)];
+
+    if (m_letters.isEmpty()) {
+        return;
+    }
+
+    // Векторный фильтр допустим, если таблица свёртки совпадает с правилом
+    // «диапазон [first, last] плюс строчные на 0x20 выше» для всех символов таблицы
+    const auto [minIt, maxIt] = std::minmax_element(m_letters.cbegin(), m_letters.cend());
+    const unsigned first = minIt->unicode();
+    const unsigned last = maxIt->unicode();
+    const unsigned span = last - first;
+    const bool inAscii = last + CASE_OFFSET < ASCII_SIZE;
+    const bool inCyrillic = first >= CYRILLIC_FIRST &&
+                            last + CASE_OFFSET < CYRILLIC_FIRST + CYRILLIC_SIZE;
+    if (span + 1 != unsigned(m_letters.size()) || !(inAscii || inCyrillic)) {
+        return;
+    }
+
+    for (unsigned t = 0; t < ASCII_SIZE + CYRILLIC_SIZE; ++t) {
+        const unsigned code = t < ASCII_SIZE ? t : CYRILLIC_FIRST + (t - ASCII_SIZE);
+        unsigned expected = 0;
+        if (code - first <= span) {
+            expected = code;
+        } else if (code - (first + CASE_OFFSET) <= span) {
+            expected = code - CASE_OFFSET;
+        }
+        if (m_fold[t] != expected) {
+            return;
+        }
+    }
+
+    m_isRange = true;
+    m_rangeFirst = char16_t(first);
+    m_rangeSpan = char16_t(span);
+}
+
+const Alphabet& Alphabet::russian()
+{
+    static const Alphabet alphabet(QStringLiteral(u"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"));
+    return alphabet;
+}
+
+const Alphabet& Alphabet::russianWithoutShortI()
+{
+    static const Alphabet alphabet(QStringLiteral(u"АБВГДЕЖЗИКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"));
+    return alphabet;
+}
+
+const Alphabet& Alphabet::hex()
+{
+    static const Alphabet alphabet(QStringLiteral(u"0123456789ABCDEF"));
+    return alphabet;
+}
+
+char16_t Alphabet::foldedLetter(char16_t code, int flags) const
+{
+    if (code < ASCII_SIZE) {
+        return m_fold[code];
+    }
+    if (unsigned(code) - CYRILLIC_FIRST < CYRILLIC_SIZE) {
+        if ((flags & FoldYo) && (code == YO_UPPER || code == YO_LOWER)) {
+            return m_foldYo;
+        }
+        return m_fold[ASCII_SIZE + (code - CYRILLIC_FIRST)];
+    }
+
+    const QChar upper = QChar(code).toUpper();
+    return contains(upper) ? upper.unicode() : char16_t(0);
+}
+
+qsizetype Alphabet::filterScalar(const char16_t* in, qsizetype len, char16_t* out,
+                                 int flags) const
+{
+    char16_t* const start = out;
+    for (qsizetype i = 0; i < len; ++i) {
+        const char16_t letter = foldedLetter(in[i], flags);
+        if (letter != 0) {
+            *out++ = letter;
+        }
+    }
+    return out - start;
+}
+
+qsizetype Alphabet::filter(const QChar* in, qsizetype len, QChar* out, int flags) const
+{
+    const char16_t* src = reinterpret_cast<const char16_t*>(in);
+    char16_t* dst = reinterpret_cast<char16_t*>(out);
+    char16_t* const start = dst;
+
+#if defined(CRYPTOAPP_X86)
+    const CpuFeatures& cpu = CpuFeatures::get();
+    if (m_isRange && (cpu.avx2 || cpu.sse2)) {
+        const RangeParams params{m_rangeFirst, m_rangeSpan, (flags & FoldYo) != 0};
+        const qsizetype width = cpu.avx2 ? 16 : 8;
+
+        while (len >= width) {
+            const qsizetype done = cpu.avx2 ? filterRangeAvx2(src, len, dst, params)
+                                            : filterRangeSse2(src, len, dst, params);
+            src += done;
+            len -= done;
+
+            // Ядро остановилось на блоке с редкими символами — его разбираем скалярно
+            if (len >= width) {
+                dst += filterScalar(src, width, dst, flags);
+                src += width;
+                len -= width;
+            }
+        }
+    }
+#endif
+
+    dst += filterScalar(src, len, dst, flags);
+    return dst - start;
+}
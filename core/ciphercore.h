@@ -4,6 +4,7 @@
 #include <QString>
 #include <QVector>
 #include <QChar>
+#include <QVariantMap>
 #include <QLineEdit>
 #include <QKeyEvent>
 
@@ -26,6 +27,25 @@ struct CipherStep {
     {}
 };
 
+// Уровень детализации шагов (параметр "traceLevel")
+enum class TraceLevel {
+    None = 0,       // шаги не формируются
+    Summary = 1,    // только общие шаги: параметры, ключи, итог
+    PerBlock = 2,   // + шаг на каждый блок
+    PerChar = 3     // + шаги по символам и раундам (по умолчанию)
+};
+
+// Код завершения операции шифра
+enum class CipherStatus {
+    Ok = 0,
+    InvalidParams,          // параметры не заданы или некорректны (ключ, модуль, матрица)
+    InvalidInput,           // входные данные не подходят (формат, длина, нет букв алфавита)
+    VerificationFailed,     // подпись не прошла проверку
+    Unsupported,            // операция не предусмотрена шифром
+    Canceled,               // операция отменена
+    InternalError           // исключение или непредвиденный сбой
+};
+
 // Полный результат шифрования
 struct CipherResult {
     QString result;
@@ -33,6 +53,9 @@ struct CipherResult {
     QString alphabet;
     QString cipherName;
     bool isNumeric;
+    int suppressedSteps;    // Шаги, пропущенные из-за уровня трассировки
+    CipherStatus status;    // Решение об успехе принимается только по нему
+    QString message;        // Текст ошибки для пользователя (status != Ok)
 
     CipherResult(const QString& res = QString(),
                  const QVector<CipherStep>& st = QVector<CipherStep>(),
@@ -43,23 +66,190 @@ struct CipherResult {
           steps(st),
           alphabet(alph),
           cipherName(name),
-          isNumeric(numeric)
+          isNumeric(numeric),
+          suppressedSteps(0),
+          status(CipherStatus::Ok)
     {}
+
+    bool ok() const { return status == CipherStatus::Ok; }
+
+    // Помечает результат как ошибочный; шаги и имя шифра сохраняются
+    CipherResult& fail(CipherStatus code, const QString& text) {
+        status = code;
+        message = text;
+        result.clear();
+        return *this;
+    }
+
+    static CipherResult failure(CipherStatus code, const QString& text,
+                                const QString& name = QString()) {
+        CipherResult failed;
+        failed.cipherName = name;
+        failed.fail(code, text);
+        return failed;
+    }
+};
+
+// Неизменяемый алфавит с поиском символа за O(1): индексы букв лежат в плотной
+// таблице над ASCII и кириллическим блоком (U+0400..U+04FF), символы вне этих
+// диапазонов ищутся линейно. Шифры используют общие экземпляры russian() и т.д.
+class Alphabet {
+public:
+    // Флаги нормализации для filter()
+    enum FilterFlag {
+        NoFilterFlags = 0,
+        FoldYo = 0x1        // Ё/ё заменяются на Е (если Е есть в алфавите)
+    };
+
+    explicit Alphabet(const QString& letters);
+
+    static const Alphabet& russian();               // 32 буквы А..Я без Ё
+    static const Alphabet& russianWithoutShortI();  // 31 буква, без Ё и Й
+    static const Alphabet& hex();                   // 0..9, A..F
+
+    int indexOf(QChar ch) const {
+        const unsigned code = ch.unicode();
+        int index = -1;
+        if (code < ASCII_SIZE) {
+            index = m_index[code];
+        } else if (code - CYRILLIC_FIRST < CYRILLIC_SIZE) {
+            index = m_index[ASCII_SIZE + (code - CYRILLIC_FIRST)];
+        } else if (m_hasOutOfTable) {
+            index = int(m_letters.indexOf(ch));
+        }
+        return index;
+    }
+
+    bool contains(QChar ch) const { return indexOf(ch) >= 0; }
+
+    QChar at(int index) const { return m_letters.at(index); }
+    QChar operator[](int index) const { return m_letters.at(index); }
+
+    int size() const { return int(m_letters.size()); }
+    int length() const { return size(); }
+
+    const QString& letters() const { return m_letters; }
+    operator const QString&() const { return m_letters; }
+
+    // Однопроходная нормализация: перевод в верхний регистр и удаление символов
+    // вне алфавита. Пишет в out (не меньше len символов, может совпадать с in),
+    // возвращает число записанных символов. Для алфавитов-диапазонов (А..Я, A..Z)
+    // работает векторно (SSE2/AVX2), иначе — по таблице свёртки регистра.
+    qsizetype filter(const QChar* in, qsizetype len, QChar* out,
+                     int flags = NoFilterFlags) const;
+
+private:
+    static const unsigned ASCII_SIZE = 0x80;
+    static const unsigned CYRILLIC_FIRST = 0x0400;
+    static const unsigned CYRILLIC_SIZE = 0x100;
+
+    // Буква алфавита для символа после свёртки регистра, 0 — символ отбрасывается
+    char16_t foldedLetter(char16_t code, int flags) const;
+    qsizetype filterScalar(const char16_t* in, qsizetype len, char16_t* out, int flags) const;
+
+    QString m_letters;
+    qint16 m_index[ASCII_SIZE + CYRILLIC_SIZE];
+    char16_t m_fold[ASCII_SIZE + CYRILLIC_SIZE];
+    char16_t m_foldYo = 0;          // во что сворачивается Ё при FoldYo
+    bool m_hasOutOfTable = false;
+
+    // Алфавит — непрерывный диапазон [m_rangeFirst, m_rangeFirst + m_rangeSpan],
+    // строчные буквы которого лежат на 0x20 выше (кириллица А..Я, латиница A..Z)
+    bool m_isRange = false;
+    char16_t m_rangeFirst = 0;
+    char16_t m_rangeSpan = 0;
 };
 
 namespace CipherUtils {
     // Убирает все неалфавитные символы (только русские буквы)
-    static QString filterAlphabetOnly(const QString& text, const QString& alphabet) {
-        QString result;
-        for (QChar ch : text.toUpper()) {
-            if (alphabet.contains(ch)) {
-                result.append(ch);
-            }
-        }
+    static QString filterAlphabetOnly(const QString& text, const Alphabet& alphabet,
+                                      int flags = Alphabet::NoFilterFlags) {
+        QString result(text.size(), Qt::Uninitialized);
+        result.truncate(alphabet.filter(text.constData(), text.size(), result.data(), flags));
         return result;
     }
+
+    static QString filterAlphabetOnly(const QString& text, const QString& alphabet,
+                                      int flags = Alphabet::NoFilterFlags) {
+        return filterAlphabetOnly(text, Alphabet(alphabet), flags);
+    }
+
+    // "traceLevel": число 0..3 или строка none / summary / block / char
+    static TraceLevel traceLevel(const QVariantMap& params) {
+        const QVariant value = params.value("traceLevel");
+        if (!value.isValid()) {
+            return TraceLevel::PerChar;
+        }
+
+        const QString name = value.toString().trimmed().toLower();
+        if (name == "none") return TraceLevel::None;
+        if (name == "summary") return TraceLevel::Summary;
+        if (name == "block") return TraceLevel::PerBlock;
+        if (name == "char" || name == "full") return TraceLevel::PerChar;
+
+        bool ok = false;
+        const int level = name.toInt(&ok);
+        if (!ok) {
+            return TraceLevel::PerChar;
+        }
+        return static_cast<TraceLevel>(qBound(0, level, 3));
+    }
+
+    // Короткое имя кода для журналов и отчётов пакетного режима
+    static QString statusName(CipherStatus status) {
+        switch (status) {
+        case CipherStatus::Ok: return QStringLiteral("ok");
+        case CipherStatus::InvalidParams: return QStringLiteral("invalid-params");
+        case CipherStatus::InvalidInput: return QStringLiteral("invalid-input");
+        case CipherStatus::VerificationFailed: return QStringLiteral("verification-failed");
+        case CipherStatus::Unsupported: return QStringLiteral("unsupported");
+        case CipherStatus::Canceled: return QStringLiteral("canceled");
+        case CipherStatus::InternalError: return QStringLiteral("internal-error");
+        }
+        return QStringLiteral("unknown");
+    }
 }
 
+// Фильтр шагов по уровню трассировки. Проверка ставится перед созданием шага,
+// поэтому при выключенной трассировке строки описаний не формируются:
+//     if (trace.want(TraceLevel::PerChar)) steps.append(CipherStep(...));
+class StepTrace {
+public:
+    explicit StepTrace(const QVariantMap& params)
+        : m_level(CipherUtils::traceLevel(params)) {}
+    explicit StepTrace(TraceLevel level)
+        : m_level(level) {}
+
+    TraceLevel level() const { return m_level; }
+
+    // Проверка без подсчёта — для данных, общих для нескольких шагов
+    bool enabled(TraceLevel detail) const { return m_level >= detail; }
+
+    // true — шаг нужен; иначе шаг учитывается как пропущенный
+    bool want(TraceLevel detail) {
+        if (enabled(detail)) {
+            return true;
+        }
+        ++m_suppressed;
+        return false;
+    }
+
+    // Учесть сразу count пропущенных шагов (цикл трассировки не выполнялся)
+    void skip(int count) { m_suppressed += count; }
+
+    int suppressed() const { return m_suppressed; }
+
+    // Переносит счётчик пропущенных шагов в результат
+    CipherResult finish(CipherResult result) const {
+        result.suppressedSteps += m_suppressed;
+        return result;
+    }
+
+private:
+    TraceLevel m_level;
+    int m_suppressed = 0;
+};
+
 
 
 enum Direction {
@@ -3,7 +3,10 @@
 
 #include <QString>
 #include <QVariant>
+#include <QByteArray>
+#include <memory>
 #include "ciphercore.h"
+#include "cipherstream.h"
 
 class CipherInterface
 {
@@ -16,8 +19,45 @@ public:
     virtual QString name() const = 0;
     virtual QString description() const = 0;
 
-
-
+    // Бинарный путь: байты на входе и выходе, без HEX/QString-преобразований.
+    // Реализуется блочными, поточными шифрами и шифрами гаммирования; для них
+    // encrypt/decrypt — адаптеры над encryptBytes/decryptBytes.
+    // Внешний буфер можно передать без копирования через QByteArray::fromRawData.
+    virtual bool supportsBytes() const { return false; }
+
+    virtual bool encryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params = {}, QString* error = nullptr)
+    {
+        Q_UNUSED(in)
+        Q_UNUSED(params)
+        out.clear();
+        if (error) {
+            *error = QString("ОШИБКА: %1 не поддерживает бинарный режим").arg(name());
+        }
+        return false;
+    }
+
+    // Шифр, совпадающий со своим обратным (гаммирование), переопределяет
+    // decryptBytes явно — по умолчанию зашифрование за расшифрование не выдается
+    virtual bool decryptBytes(const QByteArray& in, QByteArray& out,
+                              const QVariantMap& params = {}, QString* error = nullptr)
+    {
+        Q_UNUSED(in)
+        Q_UNUSED(params)
+        out.clear();
+        if (error) {
+            *error = QString("ОШИБКА: %1 не поддерживает бинарный режим").arg(name());
+        }
+        return false;
+    }
+
+    // Потоковый контекст (init/update/final) для данных, не помещающихся
+    // в память целиком. nullptr — шифр работает только с сообщением целиком.
+    virtual std::unique_ptr<CipherStream> createStream(bool encrypt)
+    {
+        Q_UNUSED(encrypt)
+        return nullptr;
+    }
 };
 
 #endif // CIPHERINTERFACE_H
@@ -0,0 +1,75 @@
+#include "cipherparallel.h"
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace {
+    struct RunState {
+        const std::function<void(int)>* fn = nullptr;
+        int chunks = 0;
+        std::atomic<int> next{0};
+        int helpers = 0;                // под mutex
+        std::mutex mutex;
+        std::condition_variable done;
+
+        void work()
+        {
+            for (int index = next.fetch_add(1); index < chunks; index = next.fetch_add(1)) {
+                (*fn)(index);
+            }
+        }
+    };
+}
+
+int CipherParallel::chunkCount(qsizetype count, qsizetype minChunk)
+{
+    if (minChunk <= 0 || count < 2 * minChunk) {
+        return 1;
+    }
+    const int threads = qMax(1, QThread::idealThreadCount());
+    return int(qMin<qsizetype>(threads, count / minChunk));
+}
+
+void CipherParallel::run(int chunks, const std::function<void(int index)>& fn)
+{
+    if (chunks <= 1) {
+        if (chunks == 1) {
+            fn(0);
+        }
+        return;
+    }
+
+    // Состояние живет, пока его держит хотя бы один помощник
+    auto state = std::make_shared<RunState>();
+    state->fn = &fn;
+    state->chunks = chunks;
+
+    QThreadPool* pool = QThreadPool::globalInstance();
+    for (int i = 1; i < chunks; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            ++state->helpers;
+        }
+        bool started = pool->tryStart([state] {
+            state->work();
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (--state->helpers == 0) {
+                state->done.notify_all();
+            }
+        });
+        if (!started) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            --state->helpers;
+            break;
+        }
+    }
+
+    state->work();
+
+    // fn принадлежит вызывающему — ждем, пока помощники перестанут его вызывать
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state] { return state->helpers == 0; });
+}
@@ -0,0 +1,29 @@
+#ifndef CIPHERPARALLEL_H
+#define CIPHERPARALLEL_H
+
+#include <QtGlobal>
+#include <functional>
+
+// Разбиение большого объема независимой работы (блоки CTR, расшифрование CBC,
+// частичные суммы GHASH) на куски, которые выполняются параллельно.
+// Помощники берутся из QThreadPool::globalInstance() только если поток свободен
+// прямо сейчас; вызывающий поток сам разбирает куски, поэтому вызов из рабочего
+// потока пула не может зависнуть в ожидании занятого пула.
+class CipherParallel
+{
+public:
+    // Сколько кусков имеет смысл для count элементов: не больше числа потоков
+    // и не меньше minChunk элементов в куске (1 — выполнять в текущем потоке)
+    static int chunkCount(qsizetype count, qsizetype minChunk);
+
+    // Начало куска index из chunks при равном делении count; конец — начало следующего
+    static qsizetype chunkBegin(qsizetype count, int chunks, int index)
+    {
+        return qsizetype((qint64(count) * index) / chunks);
+    }
+
+    // fn(index) для index = 0..chunks-1; возвращает после завершения всех кусков
+    static void run(int chunks, const std::function<void(int index)>& fn);
+};
+
+#endif // CIPHERPARALLEL_H
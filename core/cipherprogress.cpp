@@ -0,0 +1,39 @@
+#include "cipherprogress.h"
+
+thread_local CipherProgress::Scope* CipherProgress::s_current = nullptr;
+
+CipherProgress::Scope::Scope(const std::atomic<bool>* cancelFlag, Callback callback)
+    : m_cancelFlag(cancelFlag), m_callback(std::move(callback)), m_previous(s_current)
+{
+    s_current = this;
+}
+
+CipherProgress::Scope::~Scope()
+{
+    s_current = m_previous;
+}
+
+bool CipherProgress::report(qint64 done, qint64 total)
+{
+    Scope* scope = s_current;
+    if (!scope) {
+        return true;
+    }
+
+    // Обратный вызов — только при смене процента, чтобы не засыпать очередь событий
+    if (scope->m_callback && total > 0) {
+        int percent = int(qBound<qint64>(0, done * 100 / total, 100));
+        if (percent != scope->m_lastPercent) {
+            scope->m_lastPercent = percent;
+            scope->m_callback(done, total);
+        }
+    }
+
+    return !canceled();
+}
+
+bool CipherProgress::canceled()
+{
+    Scope* scope = s_current;
+    return scope && scope->m_cancelFlag && scope->m_cancelFlag->load(std::memory_order_relaxed);
+}
@@ -0,0 +1,48 @@
+#ifndef CIPHERPROGRESS_H
+#define CIPHERPROGRESS_H
+
+#include <QString>
+#include <atomic>
+#include <functional>
+
+// Ход выполнения и отмена длительной операции шифра.
+// Контекст потоко-локальный: исполнитель (окно, пакетный режим) ставит его
+// на время вызова encrypt/decrypt, а шифр лишь периодически вызывает report().
+// Без установленного контекста report() ничего не делает и возвращает true.
+class CipherProgress
+{
+public:
+    using Callback = std::function<void(qint64 done, qint64 total)>;
+
+    // Устанавливает контекст текущего потока до конца области видимости
+    class Scope
+    {
+    public:
+        Scope(const std::atomic<bool>* cancelFlag, Callback callback);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const std::atomic<bool>* m_cancelFlag;
+        Callback m_callback;
+        int m_lastPercent = -1;
+        Scope* m_previous;
+
+        friend class CipherProgress;
+    };
+
+    // Обработано done из total единиц (байт, блоков, символов).
+    // false — операция отменена, шифр должен прекратить работу.
+    static bool report(qint64 done, qint64 total);
+
+    static bool canceled();
+
+    static QString canceledMessage() { return "ОШИБКА: Операция отменена"; }
+
+private:
+    static thread_local Scope* s_current;
+};
+
+#endif // CIPHERPROGRESS_H
@@ -0,0 +1,163 @@
+#include "cipherstream.h"
+#include "cipherprogress.h"
+#include <cstring>
+
+// Целые блоки обрабатываются пачками (по умолчанию PROGRESS_BLOCKS);
+// между пачками — отчёт о ходе и проверка отмены
+static const qsizetype PROGRESS_BLOCKS = 4096;
+
+static bool reportCanceled(QString* error)
+{
+    if (error) {
+        *error = CipherProgress::canceledMessage();
+    }
+    return false;
+}
+
+BlockCipherStream::BlockCipherStream(int blockSize)
+    : m_blockSize(blockSize), m_batchBlocks(PROGRESS_BLOCKS)
+{
+    Q_ASSERT(blockSize > 0 && blockSize <= MAX_BLOCK_SIZE);
+}
+
+bool BlockCipherStream::update(const char* data, qsizetype len, QByteArray& out,
+                               QString* error)
+{
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+
+    // Дописываем неполный блок, оставшийся от прошлого вызова
+    if (m_buffered > 0) {
+        qsizetype take = qMin<qsizetype>(m_blockSize - m_buffered, len);
+        std::memcpy(m_buffer + m_buffered, in, take);
+        m_buffered += int(take);
+        in += take;
+        len -= take;
+
+        if (m_buffered < m_blockSize) {
+            return true;
+        }
+
+        processBlocks(m_buffer, m_buffer, 1);
+        out.append(reinterpret_cast<const char*>(m_buffer), m_blockSize);
+        m_buffered = 0;
+    }
+
+    // Целые блоки — сразу в выходной буфер
+    qsizetype blocks = len / m_blockSize;
+    if (blocks > 0) {
+        qsizetype bytes = blocks * m_blockSize;
+        qsizetype offset = out.size();
+        out.resize(offset + bytes);
+        uint8_t* dst = reinterpret_cast<uint8_t*>(out.data()) + offset;
+
+        for (qsizetype done = 0; done < blocks; ) {
+            qsizetype batch = qMin(blocks - done, m_batchBlocks);
+            processBlocks(in + done * m_blockSize, dst + done * m_blockSize, batch);
+            done += batch;
+            if (!CipherProgress::report(done * m_blockSize, len)) {
+                out.resize(offset);
+                return reportCanceled(error);
+            }
+        }
+        in += bytes;
+        len -= bytes;
+    }
+
+    if (len > 0) {
+        std::memcpy(m_buffer, in, len);
+        m_buffered = int(len);
+    }
+
+    return true;
+}
+
+bool BlockCipherStream::final(QByteArray& out, QString* error)
+{
+    Q_UNUSED(out)
+    int rest = m_buffered;
+    m_buffered = 0;
+
+    if (rest != 0) {
+        if (error) {
+            *error = QString("ОШИБКА: Длина данных должна быть кратна %1 байтам (остаток %2)")
+                         .arg(m_blockSize).arg(rest);
+        }
+        return false;
+    }
+    return true;
+}
+
+KeystreamCipherStream::KeystreamCipherStream(int blockSize)
+    : m_blockSize(blockSize), m_used(blockSize), m_batchBlocks(PROGRESS_BLOCKS)
+{
+    Q_ASSERT(blockSize > 0 && blockSize <= MAX_BLOCK_SIZE);
+}
+
+void KeystreamCipherStream::xorBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks)
+{
+    uint8_t gamma[MAX_BLOCK_SIZE];
+    for (qsizetype b = 0; b < blocks; ++b) {
+        nextKeystream(gamma);
+        for (int i = 0; i < m_blockSize; ++i) {
+            out[i] = in[i] ^ gamma[i];
+        }
+        in += m_blockSize;
+        out += m_blockSize;
+    }
+}
+
+bool KeystreamCipherStream::update(const char* data, qsizetype len, QByteArray& out,
+                                   QString* error)
+{
+    if (len <= 0) {
+        return true;
+    }
+
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+    qsizetype offset = out.size();
+    out.resize(offset + len);
+    uint8_t* dst = reinterpret_cast<uint8_t*>(out.data()) + offset;
+
+    // Остаток гаммы от прошлого вызова
+    while (m_used < m_blockSize && len > 0) {
+        *dst++ = *in++ ^ m_gamma[m_used++];
+        --len;
+    }
+
+    qsizetype blocks = len / m_blockSize;
+    if (blocks > 0) {
+        const qsizetype total = len;
+        for (qsizetype done = 0; done < blocks; ) {
+            qsizetype batch = qMin(blocks - done, m_batchBlocks);
+            xorBlocks(in, dst, batch);
+            in += batch * m_blockSize;
+            dst += batch * m_blockSize;
+            done += batch;
+            if (!CipherProgress::report(done * m_blockSize, total)) {
+                out.resize(offset);
+                return reportCanceled(error);
+            }
+        }
+        len -= blocks * m_blockSize;
+    }
+
+    // Хвост: вырабатываем блок гаммы, неиспользованная часть ждёт следующего update
+    if (len > 0) {
+        nextKeystream(m_gamma);
+        m_used = 0;
+        while (len > 0) {
+            *dst++ = *in++ ^ m_gamma[m_used++];
+            --len;
+        }
+    }
+
+    return true;
+}
+
+bool KeystreamCipherStream::final(QByteArray& out, QString* error)
+{
+    Q_UNUSED(out)
+    Q_UNUSED(error)
+    m_used = m_blockSize;
+    return true;
+}
@@ -0,0 +1,106 @@
+#ifndef CIPHERSTREAM_H
+#define CIPHERSTREAM_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVariantMap>
+#include <cstdint>
+
+// Потоковый контекст шифрования: init → update (сколько угодно раз) → final.
+// update принимает куски произвольной длины; неполный блок и позиция гаммы
+// переносятся между вызовами, поэтому расход памяти не зависит от длины
+// сообщения. Готовые байты дописываются в конец out.
+class CipherStream
+{
+public:
+    virtual ~CipherStream() = default;
+
+    // Ключ, IV и прочие параметры — те же, что у encryptBytes/decryptBytes
+    virtual bool init(const QVariantMap& params, QString* error = nullptr) = 0;
+
+    virtual bool update(const char* data, qsizetype len, QByteArray& out,
+                        QString* error = nullptr) = 0;
+
+    bool update(const QByteArray& in, QByteArray& out, QString* error = nullptr)
+    {
+        return update(in.constData(), in.size(), out, error);
+    }
+
+    // Завершение сообщения; после final контекст можно снова инициализировать
+    virtual bool final(QByteArray& out, QString* error = nullptr) = 0;
+};
+
+// Блочный шифр в режиме простой замены: копит неполный блок между вызовами
+// update, целые блоки обрабатывает прямо из входного буфера
+class BlockCipherStream : public CipherStream
+{
+public:
+    static const int MAX_BLOCK_SIZE = 16;
+
+    explicit BlockCipherStream(int blockSize);
+
+    bool update(const char* data, qsizetype len, QByteArray& out,
+                QString* error = nullptr) override;
+    bool final(QByteArray& out, QString* error = nullptr) override;
+
+    using CipherStream::update;
+
+protected:
+    // Обработка blocks целых блоков (in и out могут совпадать)
+    virtual void processBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) = 0;
+
+    // Вызывается из init наследника
+    void reset() { m_buffered = 0; }
+
+    int blockSize() const { return m_blockSize; }
+
+    // Сколько блоков за один вызов processBlocks между отчетами о ходе;
+    // наследник, делящий пачку между потоками, может увеличить
+    void setBatchBlocks(qsizetype blocks) { m_batchBlocks = qMax<qsizetype>(1, blocks); }
+
+private:
+    int m_blockSize;
+    int m_buffered = 0;
+    qsizetype m_batchBlocks;
+    uint8_t m_buffer[MAX_BLOCK_SIZE];
+};
+
+// Шифр гаммирования: гамма вырабатывается блоками, недоиспользованный
+// остаток блока гаммы переходит в следующий update
+class KeystreamCipherStream : public CipherStream
+{
+public:
+    static const int MAX_BLOCK_SIZE = 16;
+
+    explicit KeystreamCipherStream(int blockSize);
+
+    bool update(const char* data, qsizetype len, QByteArray& out,
+                QString* error = nullptr) override;
+    bool final(QByteArray& out, QString* error = nullptr) override;
+
+    using CipherStream::update;
+
+protected:
+    // Следующий блок гаммы
+    virtual void nextKeystream(uint8_t* block) = 0;
+
+    // Наложение гаммы на blocks целых блоков; наследник может заменить
+    // поблочный вариант более быстрым
+    virtual void xorBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks);
+
+    // Вызывается из init наследника: остаток гаммы сбрасывается
+    void reset() { m_used = m_blockSize; }
+
+    int blockSize() const { return m_blockSize; }
+
+    // Сколько блоков за один вызов xorBlocks между отчетами о ходе
+    void setBatchBlocks(qsizetype blocks) { m_batchBlocks = qMax<qsizetype>(1, blocks); }
+
+private:
+    int m_blockSize;
+    int m_used;
+    qsizetype m_batchBlocks;
+    uint8_t m_gamma[MAX_BLOCK_SIZE];
+};
+
+#endif // CIPHERSTREAM_H
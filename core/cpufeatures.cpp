@@ -0,0 +1,100 @@
+#include "cpufeatures.h"
+#include <QtGlobal>
+#include <atomic>
+
+#if defined(CRYPTOAPP_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace {
+    // regs: eax, ebx, ecx, edx
+    void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4])
+    {
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuidex(r, int(leaf), int(subleaf));
+        for (int i = 0; i < 4; ++i) {
+            regs[i] = unsigned(r[i]);
+        }
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    // Какие регистры сохраняет ОС при переключении контекста (XCR0)
+    quint64 xgetbv0()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned lo, hi;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (quint64(hi) << 32) | lo;
+#endif
+    }
+
+    CpuFeatures detect()
+    {
+        CpuFeatures features;
+        unsigned regs[4];
+
+        cpuid(0, 0, regs);
+        const unsigned maxLeaf = regs[0];
+        if (maxLeaf < 1) {
+            return features;
+        }
+
+        cpuid(1, 0, regs);
+        features.sse2 = (regs[3] >> 26) & 1;
+        features.ssse3 = (regs[2] >> 9) & 1;
+        features.pclmul = (regs[2] >> 1) & 1;
+        features.aesni = (regs[2] >> 25) & 1;
+
+        // AVX2 годится, только если ОС сохраняет регистры XMM и YMM
+        const bool osxsave = (regs[2] >> 27) & 1;
+        const bool avx = (regs[2] >> 28) & 1;
+        const bool ymmEnabled = osxsave && (xgetbv0() & 0x6) == 0x6;
+
+        if (maxLeaf >= 7) {
+            cpuid(7, 0, regs);
+            features.avx2 = avx && ymmEnabled && ((regs[1] >> 5) & 1);
+        }
+        return features;
+    }
+}
+#endif
+
+namespace {
+    std::atomic<bool> g_enabled{!qEnvironmentVariableIsSet("CRYPTOAPP_NO_SIMD")};
+}
+
+const CpuFeatures& CpuFeatures::detected()
+{
+    static const CpuFeatures features = [] {
+        CpuFeatures result;
+#if defined(CRYPTOAPP_X86)
+        result = detect();
+#endif
+        return result;
+    }();
+    return features;
+}
+
+const CpuFeatures& CpuFeatures::get()
+{
+    static const CpuFeatures none;
+    return g_enabled.load(std::memory_order_relaxed) ? detected() : none;
+}
+
+void CpuFeatures::setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool CpuFeatures::isEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
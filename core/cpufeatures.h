@@ -0,0 +1,40 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+// Возможности процессора для выбора SIMD-реализаций во время выполнения.
+// Быстрые ядра компилируются с атрибутом CRYPTOAPP_TARGET("...") и вызываются
+// только после проверки соответствующего флага, поэтому сборка не требует
+// -mavx2 и т.п., а программа работает и на старых процессорах.
+// Переменная окружения CRYPTOAPP_NO_SIMD или setEnabled(false) отключает все
+// ускоренные пути (удобно для сравнения в бенчмарке).
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CRYPTOAPP_X86 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CRYPTOAPP_TARGET(features) __attribute__((target(features)))
+#else
+#define CRYPTOAPP_TARGET(features)
+#endif
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool avx2 = false;
+    bool aesni = false;     // AESENC/AESDEC/AESKEYGENASSIST
+    bool pclmul = false;    // PCLMULQDQ (умножение без переносов)
+
+    // Набор для выбора пути: определяется один раз при первом обращении,
+    // при отключенном ускорении — пустой
+    static const CpuFeatures& get();
+
+    // Что умеет процессор, независимо от setEnabled и CRYPTOAPP_NO_SIMD
+    static const CpuFeatures& detected();
+
+    // Включение/отключение ускоренных путей во время работы
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+};
+
+#endif // CPUFEATURES_H
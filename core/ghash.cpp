@@ -0,0 +1,235 @@
+#include "ghash.h"
+#include "cpufeatures.h"
+#include "keyschedulecache.h"
+#include <cstring>
+
+#if defined(CRYPTOAPP_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Редукция по x^128 + x^7 + x^2 + x + 1 для четырех выдвинутых битов
+    const quint64 LAST4[16] = {
+        0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+        0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+    };
+
+    inline quint64 loadBe64(const uint8_t* p)
+    {
+        quint64 v = 0;
+        for (int i = 0; i < 8; ++i) {
+            v = (v << 8) | p[i];
+        }
+        return v;
+    }
+
+    inline void storeBe64(uint8_t* p, quint64 v)
+    {
+        for (int i = 7; i >= 0; --i) {
+            p[i] = uint8_t(v);
+            v >>= 8;
+        }
+    }
+
+    // Побитовое умножение (SP 800-38D, алгоритм 1) — для степеней H без PCLMULQDQ
+    void multiplyBitwise(uint8_t x[16], const uint8_t y[16])
+    {
+        quint64 zh = 0, zl = 0;
+        quint64 vh = loadBe64(y), vl = loadBe64(y + 8);
+
+        for (int i = 0; i < 128; ++i) {
+            if ((x[i / 8] >> (7 - i % 8)) & 1) {
+                zh ^= vh;
+                zl ^= vl;
+            }
+            const bool lsb = vl & 1;
+            vl = (vh << 63) | (vl >> 1);
+            vh >>= 1;
+            if (lsb) {
+                vh ^= quint64(0xE1) << 56;
+            }
+        }
+
+        storeBe64(x, zh);
+        storeBe64(x + 8, zl);
+    }
+
+#if defined(CRYPTOAPP_X86)
+    CRYPTOAPP_TARGET("ssse3")
+    inline __m128i byteSwap(__m128i x)
+    {
+        return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+
+    // Умножение с разворотом байтов (Intel, «Carry-Less Multiplication and Its
+    // Usage for Computing the GCM Mode», алгоритм 5): 4 PCLMULQDQ + сдвиг на бит
+    // для отраженного порядка + редукция
+    CRYPTOAPP_TARGET("pclmul,sse2")
+    inline __m128i clmulMultiply(__m128i a, __m128i b)
+    {
+        __m128i lo = _mm_clmulepi64_si128(a, b, 0x00);
+        __m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+        __m128i hi = _mm_clmulepi64_si128(a, b, 0x11);
+        lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+        hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+        // Сдвиг 256-битного произведения на 1 влево
+        __m128i loCarry = _mm_srli_epi32(lo, 31);
+        __m128i hiCarry = _mm_srli_epi32(hi, 31);
+        lo = _mm_slli_epi32(lo, 1);
+        hi = _mm_slli_epi32(hi, 1);
+        __m128i cross = _mm_srli_si128(loCarry, 12);
+        hiCarry = _mm_slli_si128(hiCarry, 4);
+        loCarry = _mm_slli_si128(loCarry, 4);
+        lo = _mm_or_si128(lo, loCarry);
+        hi = _mm_or_si128(_mm_or_si128(hi, hiCarry), cross);
+
+        // Редукция: первая фаза
+        __m128i t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)),
+                                  _mm_slli_epi32(lo, 25));
+        __m128i carry = _mm_srli_si128(t, 4);
+        lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+
+        // Вторая фаза
+        __m128i r = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)),
+                                  _mm_srli_epi32(lo, 7));
+        r = _mm_xor_si128(r, carry);
+        lo = _mm_xor_si128(lo, r);
+        return _mm_xor_si128(hi, lo);
+    }
+
+    CRYPTOAPP_TARGET("pclmul,ssse3,sse2")
+    void clmulUpdate(uint8_t y[16], const uint8_t h[16], const uint8_t* data, qsizetype blocks)
+    {
+        const __m128i hv = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h)));
+        __m128i acc = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y)));
+        for (qsizetype b = 0; b < blocks; ++b, data += 16) {
+            __m128i x = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+            acc = clmulMultiply(_mm_xor_si128(acc, x), hv);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y), byteSwap(acc));
+    }
+
+    CRYPTOAPP_TARGET("pclmul,ssse3,sse2")
+    void clmulMultiplyBytes(uint8_t x[16], const uint8_t y[16])
+    {
+        __m128i a = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+        __m128i b = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(x), byteSwap(clmulMultiply(a, b)));
+    }
+#endif
+}
+
+GHash::GHash(const uint8_t h[16])
+{
+    std::memcpy(m_h, h, 16);
+
+    const CpuFeatures& cpu = CpuFeatures::get();
+    m_clmul = cpu.pclmul && cpu.ssse3;
+
+    // Таблицы Шоупа: m_hh/m_hl[i] = i·H для 4-битных i (бит 3 — старший коэффициент)
+    quint64 vh = loadBe64(h);
+    quint64 vl = loadBe64(h + 8);
+    m_hl[0] = 0;
+    m_hh[0] = 0;
+    m_hl[8] = vl;
+    m_hh[8] = vh;
+    for (int i = 4; i > 0; i >>= 1) {
+        const quint64 t = (vl & 1) * 0xe1000000U;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ (t << 32);
+        m_hl[i] = vl;
+        m_hh[i] = vh;
+    }
+    for (int i = 2; i <= 8; i *= 2) {
+        for (int j = 1; j < i; ++j) {
+            m_hh[i + j] = m_hh[i] ^ m_hh[j];
+            m_hl[i + j] = m_hl[i] ^ m_hl[j];
+        }
+    }
+}
+
+GHash::~GHash()
+{
+    KeyScheduleCache::secureZero(m_h, sizeof(m_h));
+    KeyScheduleCache::secureZero(m_hl, sizeof(m_hl));
+    KeyScheduleCache::secureZero(m_hh, sizeof(m_hh));
+}
+
+void GHash::multiplyTable(uint8_t x[16]) const
+{
+    int lo = x[15] & 0x0f;
+    quint64 zh = m_hh[lo];
+    quint64 zl = m_hl[lo];
+
+    for (int i = 15; i >= 0; --i) {
+        lo = x[i] & 0x0f;
+        const int hi = (x[i] >> 4) & 0x0f;
+
+        if (i != 15) {
+            const int rem = int(zl & 0x0f);
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (LAST4[rem] << 48);
+            zh ^= m_hh[lo];
+            zl ^= m_hl[lo];
+        }
+
+        const int rem = int(zl & 0x0f);
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ (LAST4[rem] << 48);
+        zh ^= m_hh[hi];
+        zl ^= m_hl[hi];
+    }
+
+    storeBe64(x, zh);
+    storeBe64(x + 8, zl);
+}
+
+void GHash::multiply(uint8_t x[16], const uint8_t y[16], bool clmul)
+{
+#if defined(CRYPTOAPP_X86)
+    if (clmul) {
+        clmulMultiplyBytes(x, y);
+        return;
+    }
+#else
+    Q_UNUSED(clmul)
+#endif
+    multiplyBitwise(x, y);
+}
+
+void GHash::update(uint8_t y[16], const uint8_t* data, qsizetype blocks) const
+{
+#if defined(CRYPTOAPP_X86)
+    if (m_clmul) {
+        clmulUpdate(y, m_h, data, blocks);
+        return;
+    }
+#endif
+    for (qsizetype b = 0; b < blocks; ++b, data += 16) {
+        for (int i = 0; i < 16; ++i) {
+            y[i] ^= data[i];
+        }
+        multiplyTable(y);
+    }
+}
+
+void GHash::multiplyByPower(uint8_t y[16], quint64 n) const
+{
+    // Двоичное возведение: y·H^n = y·H^(2^k1)·H^(2^k2)...
+    uint8_t power[16];
+    std::memcpy(power, m_h, 16);
+    while (n > 0) {
+        if (n & 1) {
+            multiply(y, power, m_clmul);
+        }
+        n >>= 1;
+        if (n > 0) {
+            uint8_t square[16];
+            std::memcpy(square, power, 16);
+            multiply(square, power, m_clmul);
+            std::memcpy(power, square, 16);
+        }
+    }
+    KeyScheduleCache::secureZero(power, sizeof(power));
+}
@@ -0,0 +1,36 @@
+#ifndef GHASH_H
+#define GHASH_H
+
+#include <QtGlobal>
+#include <cstdint>
+
+// GHASH из режима GCM (NIST SP 800-38D): умножение в GF(2^128) на H = E_K(0^128)
+// в «отраженном» битовом порядке GCM. С PCLMULQDQ (и SSSE3 для разворота
+// байтов) умножение аппаратное, иначе — 4-битные таблицы Шоупа (16 + 16 слов).
+class GHash
+{
+public:
+    explicit GHash(const uint8_t h[16]);
+    ~GHash();
+
+    GHash(const GHash&) = delete;
+    GHash& operator=(const GHash&) = delete;
+
+    // y = (...((y ⊕ X1)·H ⊕ X2)·H ... ⊕ Xn)·H по blocks целым блокам data
+    void update(uint8_t y[16], const uint8_t* data, qsizetype blocks) const;
+
+    // y = y·H^n — склейка частичных сумм кусков, посчитанных независимо:
+    // GHASH(A || B) = GHASH(A)·H^|B| ⊕ GHASH(B)
+    void multiplyByPower(uint8_t y[16], quint64 n) const;
+
+private:
+    void multiplyTable(uint8_t x[16]) const;
+    static void multiply(uint8_t x[16], const uint8_t y[16], bool clmul);
+
+    uint8_t m_h[16];
+    quint64 m_hl[16];
+    quint64 m_hh[16];
+    bool m_clmul;
+};
+
+#endif // GHASH_H
@@ -0,0 +1,959 @@
+#include "gost3413.h"
+#include "cipherparallel.h"
+#include "cipherprogress.h"
+#include "hexcodec.h"
+#include "keyschedulecache.h"
+#include "mgm.h"
+#include <cstring>
+
+namespace {
+    // Не меньше 256 КБ на поток; между отчетами о ходе — пачка по 4 МБ
+    const qsizetype PARALLEL_MIN_BYTES = 256 * 1024;
+    const qsizetype PARALLEL_BATCH_BYTES = 4 * 1024 * 1024;
+
+    // Байт гаммы, вырабатываемых за один вызов encryptBlocks: 128 блоков Кузнечика
+    // или 256 блоков Магмы — целая пачка ее побитово-срезового ядра
+    const int BUFFER_BYTES = 2048;
+    const int MAX_BLOCK_SIZE = 16;
+
+    // counter += value: весь блок — big-endian число по модулю 2^(8·size) (CTR, раздел 5.2)
+    void addCounter(uint8_t* counter, int size, quint64 value)
+    {
+        for (int i = size - 1; i >= 0 && value != 0; --i) {
+            const quint64 sum = quint64(counter[i]) + (value & 0xFF);
+            counter[i] = uint8_t(sum);
+            value = (value >> 8) + (sum >> 8);
+        }
+    }
+
+    inline void xorBytes(uint8_t* out, const uint8_t* a, const uint8_t* b, int len)
+    {
+        for (int i = 0; i < len; ++i) {
+            out[i] = a[i] ^ b[i];
+        }
+    }
+
+    bool reportCanceled(QString* error)
+    {
+        if (error) {
+            *error = CipherProgress::canceledMessage();
+        }
+        return false;
+    }
+
+    // Регистр R из z блоков (OFB, CBC, CFB): MSB_n(R) — блок head, сдвиг
+    // R = LSB_{m-n}(R) || Y — запись Y на место head и переход к следующему
+    class ShiftRegister
+    {
+    public:
+        ShiftRegister(const QByteArray& iv, int blockSize)
+            : m_data(iv), m_blockSize(blockSize), m_blocks(int(iv.size()) / blockSize) {}
+
+        ~ShiftRegister() { KeyScheduleCache::secureZero(m_data.data(), size_t(m_data.size())); }
+
+        const uint8_t* front() const { return at(0); }
+
+        // Блок, который окажется старшим через offset сдвигов
+        const uint8_t* at(qsizetype offset) const
+        {
+            return reinterpret_cast<const uint8_t*>(m_data.constData())
+                   + ((m_head + offset) % m_blocks) * m_blockSize;
+        }
+
+        void push(const uint8_t* block)
+        {
+            std::memcpy(m_data.data() + m_head * m_blockSize, block, m_blockSize);
+            m_head = (m_head + 1) % m_blocks;
+        }
+
+        // Сдвиг сразу на blocks блоков подряд из data: в регистре остаются последние z
+        void pushBlocks(const uint8_t* data, qsizetype blocks)
+        {
+            for (qsizetype b = qMax<qsizetype>(0, blocks - m_blocks); b < blocks; ++b) {
+                std::memcpy(m_data.data() + ((m_head + b) % m_blocks) * m_blockSize,
+                            data + b * m_blockSize, m_blockSize);
+            }
+            m_head = int((m_head + blocks) % m_blocks);
+        }
+
+        int blocks() const { return m_blocks; }
+
+    private:
+        QByteArray m_data;
+        int m_blockSize;
+        int m_blocks;
+        int m_head = 0;
+    };
+
+    // Дополнение сообщения длины length (раздел 4.1)
+    QByteArray paddingBytes(qsizetype length, int blockSize, Gost3413::Padding padding)
+    {
+        const int rest = int(length % blockSize);
+        switch (padding) {
+        case Gost3413::Padding::Zero:
+            return rest == 0 ? QByteArray() : QByteArray(blockSize - rest, '\0');
+        case Gost3413::Padding::BitIfNeeded:
+            if (rest == 0) {
+                return QByteArray();
+            }
+            Q_FALLTHROUGH();
+        case Gost3413::Padding::Bit: {
+            QByteArray tail(blockSize - rest, '\0');
+            tail[0] = char(0x80);
+            return tail;
+        }
+        case Gost3413::Padding::None:
+            break;
+        }
+        return QByteArray();
+    }
+
+    // ==================== ECB (раздел 5.1) ====================
+
+    class EcbStream : public BlockCipherStream
+    {
+    public:
+        EcbStream(std::shared_ptr<const Gost3413Block> block, bool encrypt)
+            : BlockCipherStream(block->blockSize()), m_block(std::move(block)), m_encrypt(encrypt)
+        {
+            setBatchBlocks(PARALLEL_BATCH_BYTES / blockSize());
+        }
+
+        bool init(const QVariantMap&, QString* = nullptr) override
+        {
+            reset();
+            return true;
+        }
+
+    protected:
+        void processBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+        {
+            const int n = blockSize();
+            const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BYTES / n);
+            CipherParallel::run(chunks, [&](int index) {
+                const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+                const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+                if (m_encrypt) {
+                    m_block->encryptBlocks(in + begin * n, out + begin * n, end - begin);
+                } else {
+                    m_block->decryptBlocks(in + begin * n, out + begin * n, end - begin);
+                }
+            });
+        }
+
+    private:
+        std::shared_ptr<const Gost3413Block> m_block;
+        bool m_encrypt;
+    };
+
+    // ==================== CBC (раздел 5.4) ====================
+    // C_i = E(P_i ⊕ MSB_n(R)); при расшифровании P_i = D(C_i) ⊕ C_{i-z} —
+    // блоки независимы и расшифровываются параллельно
+
+    class CbcStream : public BlockCipherStream
+    {
+    public:
+        CbcStream(std::shared_ptr<const Gost3413Block> block, const QByteArray& iv, bool encrypt)
+            : BlockCipherStream(block->blockSize()), m_block(std::move(block)), m_register(iv, blockSize()),
+              m_encrypt(encrypt)
+        {
+            setBatchBlocks(PARALLEL_BATCH_BYTES / blockSize());
+        }
+
+        bool init(const QVariantMap&, QString* = nullptr) override
+        {
+            reset();
+            return true;
+        }
+
+    protected:
+        void processBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+        {
+            const int n = blockSize();
+            uint8_t x[MAX_BLOCK_SIZE];
+
+            if (m_encrypt) {
+                for (qsizetype b = 0; b < blocks; ++b, in += n, out += n) {
+                    xorBytes(x, in, m_register.front(), n);
+                    m_block->encryptBlocks(x, out, 1);
+                    m_register.push(out);
+                }
+                KeyScheduleCache::secureZero(x, sizeof(x));
+                return;
+            }
+
+            if (in == out) {
+                // На месте: шифртекст блока сохраняем до того, как его затрет результат
+                for (qsizetype b = 0; b < blocks; ++b, out += n) {
+                    std::memcpy(x, out, n);
+                    m_block->decryptBlocks(out, out, 1);
+                    xorBytes(out, out, m_register.front(), n);
+                    m_register.push(x);
+                }
+                return;
+            }
+
+            const int z = m_register.blocks();
+            const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BYTES / n);
+            CipherParallel::run(chunks, [&](int index) {
+                const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+                const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+                m_block->decryptBlocks(in + begin * n, out + begin * n, end - begin);
+                for (qsizetype b = begin; b < end; ++b) {
+                    const uint8_t* prev = (b < z) ? m_register.at(b) : in + (b - z) * n;
+                    xorBytes(out + b * n, out + b * n, prev, n);
+                }
+            });
+            m_register.pushBlocks(in, blocks);
+        }
+
+    private:
+        std::shared_ptr<const Gost3413Block> m_block;
+        ShiftRegister m_register;
+        bool m_encrypt;
+    };
+
+    // ==================== CTR (раздел 5.2) ====================
+    // CTR_1 = IV || 0^{n/2}, гамма — E(CTR_i); куски пачки шифруются
+    // в разных потоках со своим смещением счетчика
+
+    class CtrStream : public KeystreamCipherStream
+    {
+    public:
+        CtrStream(std::shared_ptr<const Gost3413Block> block, const QByteArray& iv)
+            : KeystreamCipherStream(block->blockSize()), m_block(std::move(block))
+        {
+            std::memset(m_counter, 0, sizeof(m_counter));
+            std::memcpy(m_counter, iv.constData(), iv.size());
+            setBatchBlocks(PARALLEL_BATCH_BYTES / blockSize());
+        }
+
+        ~CtrStream() override { KeyScheduleCache::secureZero(m_counter, sizeof(m_counter)); }
+
+        bool init(const QVariantMap&, QString* = nullptr) override
+        {
+            reset();
+            return true;
+        }
+
+    protected:
+        void nextKeystream(uint8_t* block) override
+        {
+            m_block->encryptBlocks(m_counter, block, 1);
+            addCounter(m_counter, blockSize(), 1);
+        }
+
+        void xorBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) override
+        {
+            const int n = blockSize();
+            const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BYTES / n);
+            CipherParallel::run(chunks, [&](int index) {
+                const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+                const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+
+                uint8_t counter[MAX_BLOCK_SIZE];
+                std::memcpy(counter, m_counter, n);
+                addCounter(counter, n, quint64(begin));
+
+                uint8_t gamma[BUFFER_BYTES];
+                for (qsizetype b = begin; b < end; ) {
+                    const int count = int(qMin<qsizetype>(end - b, BUFFER_BYTES / n));
+                    for (int i = 0; i < count; ++i) {
+                        std::memcpy(gamma + i * n, counter, n);
+                        addCounter(counter, n, 1);
+                    }
+                    m_block->encryptBlocks(gamma, gamma, count);
+                    xorBytes(out + b * n, in + b * n, gamma, count * n);
+                    b += count;
+                }
+                KeyScheduleCache::secureZero(gamma, sizeof(gamma));
+            });
+            addCounter(m_counter, n, quint64(blocks));
+        }
+
+    private:
+        std::shared_ptr<const Gost3413Block> m_block;
+        uint8_t m_counter[MAX_BLOCK_SIZE];
+    };
+
+    // ==================== OFB (раздел 5.3) ====================
+    // Y_i = E(MSB_n(R)), R = LSB_{m-n}(R) || Y_i — гамма от данных не зависит,
+    // но каждый блок зависит от предыдущего, поэтому только последовательно
+
+    class OfbStream : public KeystreamCipherStream
+    {
+    public:
+        OfbStream(std::shared_ptr<const Gost3413Block> block, const QByteArray& iv)
+            : KeystreamCipherStream(block->blockSize()), m_block(std::move(block)), m_register(iv, blockSize()) {}
+
+        bool init(const QVariantMap&, QString* = nullptr) override
+        {
+            reset();
+            return true;
+        }
+
+    protected:
+        void nextKeystream(uint8_t* block) override
+        {
+            m_block->encryptBlocks(m_register.front(), block, 1);
+            m_register.push(block);
+        }
+
+    private:
+        std::shared_ptr<const Gost3413Block> m_block;
+        ShiftRegister m_register;
+    };
+
+    // ==================== CFB (раздел 5.5, s = n) ====================
+    // C_i = P_i ⊕ E(MSB_n(R)), R = LSB_{m-n}(R) || C_i. При расшифровании гамма
+    // блока i — E(C_{i-z}), шифртекст известен заранее, поэтому параллельно
+
+    class CfbStream : public CipherStream
+    {
+    public:
+        CfbStream(std::shared_ptr<const Gost3413Block> block, const QByteArray& iv, bool encrypt)
+            : m_block(std::move(block)), m_register(iv, m_block->blockSize()), m_encrypt(encrypt),
+              m_blockSize(m_block->blockSize()), m_used(m_blockSize) {}
+
+        ~CfbStream() override
+        {
+            KeyScheduleCache::secureZero(m_gamma, sizeof(m_gamma));
+            KeyScheduleCache::secureZero(m_cipherBlock, sizeof(m_cipherBlock));
+        }
+
+        bool init(const QVariantMap&, QString* = nullptr) override
+        {
+            m_used = m_blockSize;
+            return true;
+        }
+
+        bool update(const char* data, qsizetype len, QByteArray& out, QString* error = nullptr) override
+        {
+            if (len <= 0) {
+                return true;
+            }
+
+            const int n = m_blockSize;
+            const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+            const qsizetype offset = out.size();
+            out.resize(offset + len);
+            uint8_t* dst = reinterpret_cast<uint8_t*>(out.data()) + offset;
+
+            // Остаток блока от прошлого вызова
+            while (m_used < n && len > 0) {
+                consumeByte(*in++, *dst++);
+                --len;
+            }
+
+            const qsizetype blocks = len / n;
+            const qsizetype batchBlocks = PARALLEL_BATCH_BYTES / n;
+            for (qsizetype done = 0; done < blocks; ) {
+                const qsizetype batch = qMin(blocks - done, batchBlocks);
+                if (m_encrypt) {
+                    encryptBlocks(in, dst, batch);
+                } else {
+                    decryptBlocks(in, dst, batch);
+                }
+                in += batch * n;
+                dst += batch * n;
+                done += batch;
+                if (!CipherProgress::report(done * n, blocks * n)) {
+                    out.resize(offset);
+                    return reportCanceled(error);
+                }
+            }
+            len -= blocks * n;
+
+            // Хвост: гамма блока вырабатывается сейчас, регистр сдвинется, когда блок заполнится
+            if (len > 0) {
+                m_block->encryptBlocks(m_register.front(), m_gamma, 1);
+                m_used = 0;
+                while (len > 0) {
+                    consumeByte(*in++, *dst++);
+                    --len;
+                }
+            }
+            return true;
+        }
+
+        bool final(QByteArray& out, QString* error = nullptr) override
+        {
+            Q_UNUSED(out)
+            Q_UNUSED(error)
+            m_used = m_blockSize;
+            return true;
+        }
+
+    private:
+        void consumeByte(uint8_t in, uint8_t& out)
+        {
+            out = in ^ m_gamma[m_used];
+            m_cipherBlock[m_used++] = m_encrypt ? out : in;
+            if (m_used == m_blockSize) {
+                m_register.push(m_cipherBlock);
+            }
+        }
+
+        void encryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks)
+        {
+            const int n = m_blockSize;
+            for (qsizetype b = 0; b < blocks; ++b, in += n, out += n) {
+                m_block->encryptBlocks(m_register.front(), m_gamma, 1);
+                xorBytes(out, in, m_gamma, n);
+                m_register.push(out);
+            }
+        }
+
+        void decryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks)
+        {
+            const int n = m_blockSize;
+            const int z = m_register.blocks();
+            const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BYTES / n);
+            CipherParallel::run(chunks, [&](int index) {
+                const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+                const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+
+                uint8_t gamma[BUFFER_BYTES];
+                for (qsizetype b = begin; b < end; ) {
+                    const int count = int(qMin<qsizetype>(end - b, BUFFER_BYTES / n));
+                    for (int i = 0; i < count; ++i) {
+                        const qsizetype j = b + i;
+                        std::memcpy(gamma + i * n, (j < z) ? m_register.at(j) : in + (j - z) * n, n);
+                    }
+                    m_block->encryptBlocks(gamma, gamma, count);
+                    xorBytes(out + b * n, in + b * n, gamma, count * n);
+                    b += count;
+                }
+                KeyScheduleCache::secureZero(gamma, sizeof(gamma));
+            });
+            m_register.pushBlocks(in, blocks);
+        }
+
+        std::shared_ptr<const Gost3413Block> m_block;
+        ShiftRegister m_register;
+        bool m_encrypt;
+        int m_blockSize;
+        int m_used;                                 // m_blockSize — неполного блока нет
+        uint8_t m_gamma[MAX_BLOCK_SIZE];
+        uint8_t m_cipherBlock[MAX_BLOCK_SIZE];      // шифртекст неполного блока для регистра
+    };
+
+    // ==================== Имитовставка (раздел 5.6) ====================
+    // C_i = E(C_{i-1} ⊕ P_i); последний блок складывается с K1 (полный) или,
+    // после дополнения процедурой 3, с K2. Последний блок придерживается до final
+
+    class MacStream : public CipherStream
+    {
+    public:
+        MacStream(std::shared_ptr<const Gost3413Block> block, int macLength)
+            : m_block(std::move(block)), m_blockSize(m_block->blockSize()), m_macLength(macLength) {}
+
+        ~MacStream() override { clear(); }
+
+        bool init(const QVariantMap&, QString* = nullptr) override
+        {
+            clear();
+            return true;
+        }
+
+        bool update(const char* data, qsizetype len, QByteArray& out, QString* error = nullptr) override
+        {
+            Q_UNUSED(out)
+            const int n = m_blockSize;
+            const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+
+            // Придержанный блок обрабатывается, только когда за ним есть данные
+            if (len > 0 && m_pending == n) {
+                absorb(m_buffer, 1);
+                m_pending = 0;
+            }
+            if (m_pending > 0) {
+                const qsizetype take = qMin<qsizetype>(n - m_pending, len);
+                std::memcpy(m_buffer + m_pending, in, take);
+                m_pending += int(take);
+                in += take;
+                len -= take;
+                if (len > 0) {
+                    absorb(m_buffer, 1);
+                    m_pending = 0;
+                }
+            }
+
+            // Целые блоки, кроме последнего
+            const qsizetype blocks = (len - 1) / n;
+            const qsizetype batchBlocks = PARALLEL_BATCH_BYTES / n;
+            for (qsizetype done = 0; len > 0 && done < blocks; ) {
+                const qsizetype batch = qMin(blocks - done, batchBlocks);
+                absorb(in, batch);
+                in += batch * n;
+                done += batch;
+                if (!CipherProgress::report(done * n, blocks * n)) {
+                    return reportCanceled(error);
+                }
+            }
+            if (len > 0) {
+                len -= blocks * n;
+                std::memcpy(m_buffer, in, len);
+                m_pending = int(len);
+            }
+            return true;
+        }
+
+        bool final(QByteArray& out, QString* error = nullptr) override
+        {
+            Q_UNUSED(error)
+            const int n = m_blockSize;
+
+            // R = E(0^n), K1 = R·x, K2 = K1·x в GF(2^n) (B_128 = 0x87, B_64 = 0x1B)
+            uint8_t key[MAX_BLOCK_SIZE] = {0};
+            m_block->encryptBlocks(key, key, 1);
+            const int doublings = (m_pending == n) ? 1 : 2;
+            for (int d = 0; d < doublings; ++d) {
+                const bool carry = key[0] & 0x80;
+                for (int i = 0; i < n - 1; ++i) {
+                    key[i] = uint8_t((key[i] << 1) | (key[i + 1] >> 7));
+                }
+                key[n - 1] = uint8_t(key[n - 1] << 1);
+                if (carry) {
+                    key[n - 1] ^= (n == 16) ? 0x87 : 0x1B;
+                }
+            }
+
+            if (m_pending < n) {
+                m_buffer[m_pending] = 0x80;
+                std::memset(m_buffer + m_pending + 1, 0, n - m_pending - 1);
+            }
+            xorBytes(m_buffer, m_buffer, key, n);
+            absorb(m_buffer, 1);
+            out.append(reinterpret_cast<const char*>(m_state), m_macLength);
+
+            KeyScheduleCache::secureZero(key, sizeof(key));
+            clear();
+            return true;
+        }
+
+    private:
+        void absorb(const uint8_t* data, qsizetype blocks)
+        {
+            const int n = m_blockSize;
+            for (qsizetype b = 0; b < blocks; ++b, data += n) {
+                xorBytes(m_state, m_state, data, n);
+                m_block->encryptBlocks(m_state, m_state, 1);
+            }
+        }
+
+        void clear()
+        {
+            KeyScheduleCache::secureZero(m_state, sizeof(m_state));
+            KeyScheduleCache::secureZero(m_buffer, sizeof(m_buffer));
+            m_pending = 0;
+        }
+
+        std::shared_ptr<const Gost3413Block> m_block;
+        int m_blockSize;
+        int m_macLength;
+        int m_pending = 0;
+        uint8_t m_state[MAX_BLOCK_SIZE] = {0};
+        uint8_t m_buffer[MAX_BLOCK_SIZE] = {0};
+    };
+
+    // ==================== Дополнение ====================
+    // Обертка над ECB/CBC: при зашифровании дописывает дополнение в final,
+    // при расшифровании придерживает последний блок и снимает дополнение процедуры 2
+
+    class PaddingStream : public CipherStream
+    {
+    public:
+        PaddingStream(std::unique_ptr<CipherStream> inner, int blockSize, Gost3413::Padding padding, bool encrypt)
+            : m_inner(std::move(inner)), m_blockSize(blockSize), m_padding(padding), m_encrypt(encrypt) {}
+
+        bool init(const QVariantMap& params, QString* error = nullptr) override
+        {
+            m_total = 0;
+            m_held.clear();
+            return m_inner->init(params, error);
+        }
+
+        bool update(const char* data, qsizetype len, QByteArray& out, QString* error = nullptr) override
+        {
+            if (m_encrypt) {
+                m_total += len;
+                return m_inner->update(data, len, out, error);
+            }
+
+            const qsizetype start = out.size();
+            out.append(m_held);
+            m_held.clear();
+            if (!m_inner->update(data, len, out, error)) {
+                out.resize(start);
+                return false;
+            }
+            const qsizetype keep = qMin<qsizetype>(m_blockSize, out.size() - start);
+            m_held = out.right(keep);
+            out.chop(keep);
+            return true;
+        }
+
+        bool final(QByteArray& out, QString* error = nullptr) override
+        {
+            if (m_encrypt) {
+                const QByteArray tail = paddingBytes(m_total, m_blockSize, m_padding);
+                m_total = 0;
+                return m_inner->update(tail, out, error) && m_inner->final(out, error);
+            }
+
+            QByteArray tail = m_held;
+            m_held.clear();
+            if (!m_inner->final(tail, error) || !Gost3413::unpad(tail, m_blockSize, m_padding, error)) {
+                return false;
+            }
+            out.append(tail);
+            return true;
+        }
+
+    private:
+        std::unique_ptr<CipherStream> m_inner;
+        int m_blockSize;
+        Gost3413::Padding m_padding;
+        bool m_encrypt;
+        qsizetype m_total = 0;
+        QByteArray m_held;
+    };
+
+    // ==================== Выбор режима ====================
+
+    class ModeStream : public CipherStream
+    {
+    public:
+        ModeStream(Gost3413::Prepare prepare, int blockSize, bool encrypt)
+            : m_prepare(std::move(prepare)), m_blockSize(blockSize), m_encrypt(encrypt) {}
+
+        bool init(const QVariantMap& params, QString* error = nullptr) override
+        {
+            m_stream.reset();
+            m_mgm = nullptr;
+
+            Gost3413::Mode mode;
+            Gost3413::Padding padding;
+            if (!Gost3413::parseMode(params, mode, error) || !Gost3413::parsePadding(params, padding, error)) {
+                return false;
+            }
+            if (mode == Gost3413::Mode::MAC && !m_encrypt) {
+                if (error) {
+                    *error = "ОШИБКА: Имитовставка только вычисляется — используйте зашифрование";
+                }
+                return false;
+            }
+
+            const int n = m_blockSize;
+            const bool authenticated = (mode == Gost3413::Mode::MAC || mode == Gost3413::Mode::MGM);
+            int macLength = (mode == Gost3413::Mode::MGM) ? n : n / 2;
+            if (authenticated && params.contains("macLength")) {
+                bool ok = false;
+                macLength = params.value("macLength").toInt(&ok);
+                if (!ok || macLength < 1 || macLength > n) {
+                    if (error) {
+                        *error = QString("ОШИБКА: Длина имитовставки должна быть от 1 до %1 байт").arg(n);
+                    }
+                    return false;
+                }
+            }
+
+            QByteArray iv;
+            QByteArray aad;
+            if (!parseIv(params, mode, iv, error)) {
+                return false;
+            }
+            if (mode == Gost3413::Mode::MGM && !parseAad(params, aad, error)) {
+                KeyScheduleCache::secureZero(iv.data(), size_t(iv.size()));
+                return false;
+            }
+
+            std::shared_ptr<const Gost3413Block> block;
+            if (!m_prepare(params, block, error)) {
+                KeyScheduleCache::secureZero(iv.data(), size_t(iv.size()));
+                KeyScheduleCache::secureZero(aad.data(), size_t(aad.size()));
+                return false;
+            }
+
+            std::unique_ptr<CipherStream> stream;
+            switch (mode) {
+            case Gost3413::Mode::ECB:
+                stream = std::make_unique<EcbStream>(block, m_encrypt);
+                break;
+            case Gost3413::Mode::CBC:
+                stream = std::make_unique<CbcStream>(block, iv, m_encrypt);
+                break;
+            case Gost3413::Mode::CTR:
+                stream = std::make_unique<CtrStream>(block, iv);
+                break;
+            case Gost3413::Mode::OFB:
+                stream = std::make_unique<OfbStream>(block, iv);
+                break;
+            case Gost3413::Mode::CFB:
+                stream = std::make_unique<CfbStream>(block, iv, m_encrypt);
+                break;
+            case Gost3413::Mode::MAC:
+                stream = std::make_unique<MacStream>(block, macLength);
+                break;
+            case Gost3413::Mode::MGM: {
+                auto mgm = std::make_unique<MgmStream>(block, iv, aad, macLength, m_encrypt);
+                m_mgm = mgm.get();
+                stream = std::move(mgm);
+                break;
+            }
+            }
+            KeyScheduleCache::secureZero(iv.data(), size_t(iv.size()));
+            KeyScheduleCache::secureZero(aad.data(), size_t(aad.size()));
+
+            // Дополнение — только для ECB и CBC; снять при расшифровании можно лишь процедуру 2
+            const bool blockMode = (mode == Gost3413::Mode::ECB || mode == Gost3413::Mode::CBC);
+            if (blockMode && padding != Gost3413::Padding::None
+                && (m_encrypt || padding == Gost3413::Padding::Bit)) {
+                stream = std::make_unique<PaddingStream>(std::move(stream), n, padding, m_encrypt);
+            }
+
+            m_stream = std::move(stream);
+            return m_stream->init(params, error);
+        }
+
+        bool update(const char* data, qsizetype len, QByteArray& out, QString* error = nullptr) override
+        {
+            return m_stream ? m_stream->update(data, len, out, error) : notInitialized(error);
+        }
+
+        bool final(QByteArray& out, QString* error = nullptr) override
+        {
+            return m_stream ? m_stream->final(out, error) : notInitialized(error);
+        }
+
+        using CipherStream::update;
+
+        // final отказал из-за несовпадения имитовставки MGM
+        bool tagMismatch() const { return m_mgm && m_mgm->tagMismatch(); }
+
+    private:
+        static bool notInitialized(QString* error)
+        {
+            if (error) {
+                *error = "ОШИБКА: Контекст режима не инициализирован";
+            }
+            return false;
+        }
+
+        bool parseIv(const QVariantMap& params, Gost3413::Mode mode, QByteArray& iv, QString* error) const
+        {
+            const int n = m_blockSize;
+            if (mode == Gost3413::Mode::ECB || mode == Gost3413::Mode::MAC) {
+                return true;
+            }
+
+            const QString ivText = params.value("iv", "").toString();
+            uint8_t buffer[Gost3413::MAX_IV_BYTES];
+            qsizetype invalidAt = -1;
+            const int digits = int(HexCodec::decode(ivText, buffer, Gost3413::MAX_IV_BYTES, &invalidAt));
+            if (invalidAt >= 0) {
+                KeyScheduleCache::secureZero(buffer, sizeof(buffer));
+                if (error) *error = HexCodec::invalidCharError("IV", ivText, invalidAt);
+                return false;
+            }
+            bool ok;
+            QString expected;
+            if (mode == Gost3413::Mode::CTR) {
+                ok = (digits == n);
+                expected = QString("%1 HEX символов").arg(n);
+            } else if (mode == Gost3413::Mode::MGM) {
+                ok = (digits == 2 * n) && !(buffer[0] & 0x80);
+                expected = QString("%1 HEX символа со старшим битом 0").arg(2 * n);
+            } else {
+                ok = digits > 0 && digits % (2 * n) == 0 && digits <= 2 * Gost3413::MAX_IV_BYTES;
+                expected = QString("кратен %1 HEX символам (не больше %2)").arg(2 * n).arg(2 * Gost3413::MAX_IV_BYTES);
+            }
+            if (!ok) {
+                KeyScheduleCache::secureZero(buffer, sizeof(buffer));
+                if (error) {
+                    *error = QString("ОШИБКА: IV для режима %1 должен быть %2. Получено: %3")
+                             .arg(Gost3413::modeName(mode)).arg(expected).arg(digits);
+                }
+                return false;
+            }
+
+            iv = QByteArray(reinterpret_cast<const char*>(buffer), digits / 2);
+            KeyScheduleCache::secureZero(buffer, sizeof(buffer));
+            return true;
+        }
+
+        // Дополнительные данные MGM: HEX любой четной длины, пустые допустимы
+        static bool parseAad(const QVariantMap& params, QByteArray& aad, QString* error)
+        {
+            const QString aadText = params.value("aad", "").toString();
+            qsizetype digits = 0;
+            qsizetype invalidAt = -1;
+            aad = HexCodec::decode(aadText, &digits, &invalidAt);
+            if (invalidAt >= 0) {
+                if (error) *error = HexCodec::invalidCharError("AAD", aadText, invalidAt);
+                return false;
+            }
+            if (digits % 2 != 0) {
+                if (error) {
+                    *error = QString("ОШИБКА: AAD должен быть HEX-строкой четной длины. Получено: %1")
+                             .arg(digits);
+                }
+                return false;
+            }
+            return true;
+        }
+
+        Gost3413::Prepare m_prepare;
+        int m_blockSize;
+        bool m_encrypt;
+        std::unique_ptr<CipherStream> m_stream;
+        MgmStream* m_mgm = nullptr;
+    };
+}
+
+bool Gost3413::parseMode(const QVariantMap& params, Mode& mode, QString* error)
+{
+    const QString name = params.value("mode", "ECB").toString().trimmed().toUpper();
+    if (name.isEmpty() || name == "ECB") {
+        mode = Mode::ECB;
+    } else if (name == "CTR") {
+        mode = Mode::CTR;
+    } else if (name == "OFB") {
+        mode = Mode::OFB;
+    } else if (name == "CBC") {
+        mode = Mode::CBC;
+    } else if (name == "CFB") {
+        mode = Mode::CFB;
+    } else if (name == "MAC") {
+        mode = Mode::MAC;
+    } else if (name == "MGM") {
+        mode = Mode::MGM;
+    } else {
+        if (error) {
+            *error = QString("ОШИБКА: Неизвестный режим: %1 (ожидается ECB, CTR, OFB, CBC, CFB, MAC или MGM)").arg(name);
+        }
+        return false;
+    }
+    return true;
+}
+
+QString Gost3413::modeName(Mode mode)
+{
+    switch (mode) {
+    case Mode::CTR: return "CTR";
+    case Mode::OFB: return "OFB";
+    case Mode::CBC: return "CBC";
+    case Mode::CFB: return "CFB";
+    case Mode::MAC: return "MAC";
+    case Mode::MGM: return "MGM";
+    case Mode::ECB: break;
+    }
+    return "ECB";
+}
+
+bool Gost3413::parsePadding(const QVariantMap& params, Padding& padding, QString* error)
+{
+    const QString name = params.value("padding", "").toString().trimmed();
+    if (name.isEmpty() || name == "0") {
+        padding = Padding::None;
+    } else if (name == "1") {
+        padding = Padding::Zero;
+    } else if (name == "2") {
+        padding = Padding::Bit;
+    } else if (name == "3") {
+        padding = Padding::BitIfNeeded;
+    } else {
+        if (error) {
+            *error = QString("ОШИБКА: Неизвестная процедура дополнения: %1 (ожидается 1, 2 или 3)").arg(name);
+        }
+        return false;
+    }
+    return true;
+}
+
+void Gost3413::pad(QByteArray& data, int blockSize, Padding padding)
+{
+    data.append(paddingBytes(data.size(), blockSize, padding));
+}
+
+bool Gost3413::unpad(QByteArray& data, int blockSize, Padding padding, QString* error)
+{
+    if (padding != Padding::Bit) {
+        return true;
+    }
+
+    // Процедура 2: последний ненулевой байт последнего блока — 0x80
+    qsizetype pos = data.size() - 1;
+    const qsizetype limit = qMax<qsizetype>(0, data.size() - blockSize);
+    while (pos >= limit && data[pos] == '\0') {
+        --pos;
+    }
+    if (pos < limit || uint8_t(data[pos]) != 0x80) {
+        if (error) {
+            *error = "ОШИБКА: Неверное дополнение (процедура 2) — данные или ключ неверны";
+        }
+        return false;
+    }
+    data.truncate(pos);
+    return true;
+}
+
+std::unique_ptr<CipherStream> Gost3413::createStream(Prepare prepare, int blockSize, bool encrypt)
+{
+    return std::make_unique<ModeStream>(std::move(prepare), blockSize, encrypt);
+}
+
+bool Gost3413::processBytes(const Prepare& prepare, int blockSize, const QByteArray& in, QByteArray& out,
+                            const QVariantMap& params, bool encrypt, QString* error, CipherStatus* status)
+{
+    auto setStatus = [status](CipherStatus value) {
+        if (status) {
+            *status = value;
+        }
+    };
+    setStatus(CipherStatus::InvalidParams);
+
+    Mode mode;
+    Padding padding;
+    if (!parseMode(params, mode, error) || !parsePadding(params, padding, error)) {
+        out.clear();
+        return false;
+    }
+    if (mode == Mode::MAC && !encrypt) {
+        setStatus(CipherStatus::Unsupported);
+    }
+
+    ModeStream stream(prepare, blockSize, encrypt);
+    if (!stream.init(params, error)) {
+        out.clear();
+        return false;
+    }
+
+    const bool blockMode = (mode == Mode::ECB || mode == Mode::CBC);
+    if (blockMode && in.size() % blockSize != 0 && (!encrypt || padding == Padding::None)) {
+        setStatus(CipherStatus::InvalidInput);
+        if (error) {
+            *error = QString("ОШИБКА: Длина данных (%1 байт) должна быть кратна %2 байтам%3")
+                     .arg(in.size()).arg(blockSize)
+                     .arg(encrypt ? " — задайте процедуру дополнения 1, 2 или 3" : "");
+        }
+        out.clear();
+        return false;
+    }
+
+    // Через промежуточный буфер: in и out могут быть одним объектом
+    QByteArray buffer;
+    buffer.reserve(in.size() + blockSize);
+    if (!stream.update(in, buffer, error) || !stream.final(buffer, error)) {
+        setStatus(CipherProgress::canceled() ? CipherStatus::Canceled
+                  : stream.tagMismatch()     ? CipherStatus::VerificationFailed
+                                             : CipherStatus::InvalidInput);
+        KeyScheduleCache::secureZero(buffer.data(), size_t(buffer.size()));
+        out.clear();
+        return false;
+    }
+    out = buffer;
+    setStatus(CipherStatus::Ok);
+    return true;
+}
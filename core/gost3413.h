@@ -0,0 +1,73 @@
+#ifndef GOST3413_H
+#define GOST3413_H
+
+#include "cipherstream.h"
+#include "ciphercore.h"
+#include <QByteArray>
+#include <QString>
+#include <QVariantMap>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Блочный шифр, над которым строятся режимы ГОСТ Р 34.13-2015:
+// n = 16 байт (Кузнечик) или 8 байт (Магма). Методы вызываются из нескольких
+// потоков одновременно, поэтому реализация не должна менять свое состояние.
+class Gost3413Block
+{
+public:
+    virtual ~Gost3413Block() = default;
+
+    virtual int blockSize() const = 0;
+
+    // blocks блоков подряд; in и out могут совпадать
+    virtual void encryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) const = 0;
+    virtual void decryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) const = 0;
+};
+
+// Режимы работы блочных шифров по ГОСТ Р 34.13-2015.
+// Параметры (те же params, что у шифра):
+//   mode      — ECB (по умолчанию), CTR, OFB, CBC, CFB, MAC, а также
+//               MGM (Р 1323565.1.026-2019, см. MgmStream);
+//   iv        — HEX: n/2 байт для CTR, z·n байт (z ≥ 1) для OFB, CBC, CFB,
+//               n байт со старшим битом 0 (nonce) для MGM;
+//   aad       — HEX, дополнительные аутентифицируемые данные MGM;
+//   padding   — процедура дополнения 1, 2 или 3 (раздел 4.1) для ECB и CBC,
+//               по умолчанию без дополнения. При расшифровании снимается только
+//               дополнение процедурой 2 — для 1 и 3 оно неоднозначно;
+//   macLength — длина имитовставки s в байтах, 1..n (по умолчанию n/2 для MAC, n для MGM).
+// CTR, OFB, CFB и MGM работают с данными любой длины (s = n, последний блок усекается).
+// MAC при зашифровании выдает имитовставку вместо шифртекста, MGM дописывает
+// ее к шифртексту и сверяет при расшифровании.
+class Gost3413
+{
+public:
+    enum class Mode { ECB, CTR, OFB, CBC, CFB, MAC, MGM };
+    enum class Padding { None, Zero, Bit, BitIfNeeded };   // без, процедуры 1, 2, 3
+
+    static const int MAX_IV_BYTES = 64;
+
+    // Разбор ключа конкретного шифра: готовый блочный шифр или false + сообщение
+    using Prepare = std::function<bool(const QVariantMap& params,
+                                       std::shared_ptr<const Gost3413Block>& block,
+                                       QString* error)>;
+
+    static bool parseMode(const QVariantMap& params, Mode& mode, QString* error);
+    static QString modeName(Mode mode);
+    static bool parsePadding(const QVariantMap& params, Padding& padding, QString* error);
+
+    // Процедуры дополнения 1-3 (раздел 4.1) и снятие дополнения процедурой 2
+    static void pad(QByteArray& data, int blockSize, Padding padding);
+    static bool unpad(QByteArray& data, int blockSize, Padding padding, QString* error);
+
+    // Потоковый контекст: режим, IV и ключ берутся из params в init
+    static std::unique_ptr<CipherStream> createStream(Prepare prepare, int blockSize, bool encrypt);
+
+    // Сообщение целиком: проверка длины, дополнение, поток; status отличает
+    // ошибки параметров, данных, несовпадение имитовставки MGM и неподдерживаемую операцию
+    static bool processBytes(const Prepare& prepare, int blockSize, const QByteArray& in, QByteArray& out,
+                             const QVariantMap& params, bool encrypt, QString* error,
+                             CipherStatus* status = nullptr);
+};
+
+#endif // GOST3413_H
@@ -0,0 +1,305 @@
+#include "hexcodec.h"
+#include "cpufeatures.h"
+#include <cstring>
+
+#if defined(CRYPTOAPP_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Значение HEX-цифры или -1
+    inline int nibbleOf(char16_t c)
+    {
+        if (c >= u'0' && c <= u'9') {
+            return c - u'0';
+        }
+        const char16_t lower = c | 0x20;
+        if (lower >= u'a' && lower <= u'f') {
+            return lower - u'a' + 10;
+        }
+        return -1;
+    }
+
+    // '0'..'9', 'A'..'F' без таблицы: после '9' в ASCII еще 7 символов до 'A'
+    inline char16_t digitOf(int nibble)
+    {
+        return char16_t(u'0' + nibble + (nibble > 9 ? 7 : 0));
+    }
+
+    // По одному символу: HEX-цифры в верхнем регистре в out, пробельные символы
+    // пропускаются. Возвращает число записанных цифр; invalid — индекс первого
+    // недопустимого символа (на нем разбор останавливается) или -1
+    qsizetype cleanScalar(const char16_t* in, qsizetype len, char16_t* out, qsizetype& invalid)
+    {
+        char16_t* const start = out;
+        invalid = -1;
+        for (qsizetype i = 0; i < len; ++i) {
+            const int nibble = nibbleOf(in[i]);
+            if (nibble >= 0) {
+                *out++ = digitOf(nibble);
+            } else if (!QChar::isSpace(in[i])) {
+                invalid = i;
+                break;
+            }
+        }
+        return out - start;
+    }
+
+    // По одному символу: полубайты дописываются к out, digits — сколько их уже есть.
+    // В out пишутся только первые capacity байт, цифры сверх них лишь считаются.
+    // Возвращает индекс первого недопустимого символа или -1
+    qsizetype decodeScalar(const char16_t* in, qsizetype len, uint8_t* out, qsizetype capacity,
+                           qsizetype& digits)
+    {
+        for (qsizetype i = 0; i < len; ++i) {
+            const int nibble = nibbleOf(in[i]);
+            if (nibble < 0) {
+                if (QChar::isSpace(in[i])) {
+                    continue;
+                }
+                return i;
+            }
+            if (digits / 2 < capacity) {
+                if (digits % 2 == 0) {
+                    out[digits / 2] = uint8_t(nibble << 4);
+                } else {
+                    out[digits / 2] |= uint8_t(nibble);
+                }
+            }
+            ++digits;
+        }
+        return -1;
+    }
+
+#if defined(CRYPTOAPP_X86)
+    const qsizetype SSE2_CHARS = 16;
+
+    // Маска HEX-цифр среди 16 байт ASCII (байты ≥ 0x80 отрицательны и в диапазоны
+    // не попадают) и маска букв a-f/A-F
+    CRYPTOAPP_TARGET("sse2")
+    inline __m128i hexMask8(__m128i c, __m128i& letters)
+    {
+        const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+        const __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                             _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+        letters = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+        return _mm_or_si128(digits, letters);
+    }
+
+    // 16 символов UTF-16 в 16 байт; символы > 0xFF насыщаются до 0xFF и не проходят проверку
+    CRYPTOAPP_TARGET("sse2")
+    inline __m128i loadChars16(const char16_t* in)
+    {
+        return _mm_packus_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)),
+                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8)));
+    }
+
+    // Байты ASCII в символы UTF-16
+    CRYPTOAPP_TARGET("sse2")
+    inline void storeChars16(char16_t* out, __m128i c)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(c, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(c, zero));
+    }
+
+    // Блоки по 16 символов, пока в блоке только HEX-цифры; возвращает число символов
+    CRYPTOAPP_TARGET("sse2")
+    qsizetype cleanSse2(const char16_t* in, qsizetype len, char16_t* out)
+    {
+        qsizetype i = 0;
+        for (; i + SSE2_CHARS <= len; i += SSE2_CHARS) {
+            const __m128i c = loadChars16(in + i);
+            __m128i letters;
+            if (_mm_movemask_epi8(hexMask8(c, letters)) != 0xFFFF) {
+                break;
+            }
+            // Строчные буквы — в заглавные: сброс бита 0x20 только у букв
+            storeChars16(out + i, _mm_andnot_si128(_mm_and_si128(letters, _mm_set1_epi8(0x20)), c));
+        }
+        return i;
+    }
+
+    // 16 HEX-цифр → 8 байт: полубайт = (c & 0x0F) + 9 для букв
+    CRYPTOAPP_TARGET("sse2")
+    qsizetype decodeSse2(const char16_t* in, qsizetype len, uint8_t* out)
+    {
+        qsizetype i = 0;
+        for (; i + SSE2_CHARS <= len; i += SSE2_CHARS, out += SSE2_CHARS / 2) {
+            const __m128i c = loadChars16(in + i);
+            __m128i letters;
+            if (_mm_movemask_epi8(hexMask8(c, letters)) != 0xFFFF) {
+                break;
+            }
+            const __m128i nibbles = _mm_add_epi8(_mm_and_si128(c, _mm_set1_epi8(0x0F)),
+                                                 _mm_and_si128(letters, _mm_set1_epi8(9)));
+            // Пара (старший, младший) — 16-битное слово младший·256 + старший
+            const __m128i bytes = _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0x00F0)),
+                _mm_srli_epi16(nibbles, 8));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(bytes, bytes));
+        }
+        return i;
+    }
+
+    // 16 байт → 32 символа
+    CRYPTOAPP_TARGET("sse2")
+    qsizetype encodeSse2(const uint8_t* in, qsizetype len, char16_t* out)
+    {
+        const __m128i low = _mm_set1_epi8(0x0F);
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i zeroChar = _mm_set1_epi8('0');
+        const __m128i letterGap = _mm_set1_epi8(7);
+
+        qsizetype i = 0;
+        for (; i + 16 <= len; i += 16, out += 32) {
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), low);
+            const __m128i lo = _mm_and_si128(b, low);
+
+            __m128i first = _mm_unpacklo_epi8(hi, lo);
+            __m128i second = _mm_unpackhi_epi8(hi, lo);
+            first = _mm_add_epi8(_mm_add_epi8(first, zeroChar),
+                                 _mm_and_si128(_mm_cmpgt_epi8(first, nine), letterGap));
+            second = _mm_add_epi8(_mm_add_epi8(second, zeroChar),
+                                  _mm_and_si128(_mm_cmpgt_epi8(second, nine), letterGap));
+            storeChars16(out, first);
+            storeChars16(out + 16, second);
+        }
+        return i;
+    }
+#endif
+
+    // Разбор в out емкостью capacity байт; возвращает число цифр, invalidAt —
+    // позиция первого недопустимого символа в text или -1
+    qsizetype decodeInto(const QString& text, uint8_t* out, qsizetype capacity, qsizetype* invalidAt)
+    {
+        const char16_t* const base = reinterpret_cast<const char16_t*>(text.constData());
+        const char16_t* in = base;
+        qsizetype len = text.size();
+        qsizetype count = 0;
+        qsizetype invalid = -1;
+
+#if defined(CRYPTOAPP_X86)
+        if (CpuFeatures::get().sse2) {
+            while (len >= SSE2_CHARS && invalid < 0) {
+                // Векторный путь — только с границы байта и пока есть место в out
+                if (count % 2 == 0) {
+                    const qsizetype room = (capacity - count / 2) * 2;
+                    const qsizetype done = decodeSse2(in, qMin(len, room), out + count / 2);
+                    in += done;
+                    count += done;
+                    len -= done;
+                }
+                if (len >= SSE2_CHARS) {
+                    invalid = decodeScalar(in, SSE2_CHARS, out, capacity, count);
+                    if (invalid >= 0) {
+                        invalid += in - base;
+                        break;
+                    }
+                    in += SSE2_CHARS;
+                    len -= SSE2_CHARS;
+                }
+            }
+        }
+#endif
+
+        if (invalid < 0) {
+            invalid = decodeScalar(in, len, out, capacity, count);
+            if (invalid >= 0) {
+                invalid += in - base;
+            }
+        }
+        if (invalidAt) {
+            *invalidAt = invalid;
+        }
+        return count;
+    }
+}
+
+QString HexCodec::clean(const QString& text, qsizetype* invalidAt)
+{
+    const char16_t* const base = reinterpret_cast<const char16_t*>(text.constData());
+    const char16_t* in = base;
+    qsizetype len = text.size();
+    QString result(len, Qt::Uninitialized);
+    char16_t* out = reinterpret_cast<char16_t*>(result.data());
+    char16_t* const start = out;
+    qsizetype invalid = -1;
+
+#if defined(CRYPTOAPP_X86)
+    if (CpuFeatures::get().sse2) {
+        while (len >= SSE2_CHARS) {
+            const qsizetype done = cleanSse2(in, len, out);
+            in += done;
+            out += done;
+            len -= done;
+
+            // Блок с пробелами — скалярно
+            if (len >= SSE2_CHARS) {
+                out += cleanScalar(in, SSE2_CHARS, out, invalid);
+                if (invalid >= 0) {
+                    break;
+                }
+                in += SSE2_CHARS;
+                len -= SSE2_CHARS;
+            }
+        }
+    }
+#endif
+
+    if (invalid < 0) {
+        out += cleanScalar(in, len, out, invalid);
+    }
+    if (invalid >= 0) {
+        invalid += in - base;
+    }
+    if (invalidAt) {
+        *invalidAt = invalid;
+    }
+    result.truncate(out - start);
+    return result;
+}
+
+QByteArray HexCodec::decode(const QString& text, qsizetype* digits, qsizetype* invalidAt)
+{
+    QByteArray result((text.size() + 1) / 2, Qt::Uninitialized);
+    const qsizetype count = decodeInto(text, reinterpret_cast<uint8_t*>(result.data()), result.size(), invalidAt);
+    result.truncate((count + 1) / 2);
+    if (digits) {
+        *digits = count;
+    }
+    return result;
+}
+
+qsizetype HexCodec::decode(const QString& text, uint8_t* out, qsizetype maxBytes, qsizetype* invalidAt)
+{
+    std::memset(out, 0, size_t(maxBytes));
+    return decodeInto(text, out, maxBytes, invalidAt);
+}
+
+QString HexCodec::invalidCharError(const QString& what, const QString& text, qsizetype pos)
+{
+    return QString("ОШИБКА: %1 содержит недопустимый символ '%2' в позиции %3 (ожидаются HEX-цифры)")
+        .arg(what, QString(text.at(pos))).arg(pos + 1);
+}
+
+QString HexCodec::encode(const uint8_t* data, qsizetype len)
+{
+    QString result(len * 2, Qt::Uninitialized);
+    char16_t* out = reinterpret_cast<char16_t*>(result.data());
+    qsizetype i = 0;
+
+#if defined(CRYPTOAPP_X86)
+    if (CpuFeatures::get().sse2) {
+        i = encodeSse2(data, len, out);
+    }
+#endif
+
+    for (; i < len; ++i) {
+        out[2 * i] = digitOf(data[i] >> 4);
+        out[2 * i + 1] = digitOf(data[i] & 0x0F);
+    }
+    return result;
+}
@@ -0,0 +1,41 @@
+#ifndef HEXCODEC_H
+#define HEXCODEC_H
+
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+
+// HEX-представление двоичных данных для шифров с HEX-вводом (AES, Кузнечик, Магма).
+// Пробельные символы (пробелы, табуляции, переводы строк) пропускаются, а прочие
+// символы, не являющиеся HEX-цифрами, останавливают разбор — в том же проходе.
+// Позиция такого символа возвращается через invalidAt (-1, если вход корректен).
+// Участки из HEX-цифр подряд обрабатываются SSE2 по 16 символов — полубайты
+// вычисляются арифметикой, без таблиц; остальное — по символу.
+class HexCodec
+{
+public:
+    // Только HEX-цифры из text, в верхнем регистре
+    static QString clean(const QString& text, qsizetype* invalidAt = nullptr);
+
+    // Байты из HEX-цифр text; digits — число найденных цифр (если нужно проверить длину).
+    // При нечетном числе цифр последняя становится старшим полубайтом последнего байта
+    static QByteArray decode(const QString& text, qsizetype* digits = nullptr,
+                             qsizetype* invalidAt = nullptr);
+
+    // Разбор ключа или IV без промежуточных буферов: в out — первые maxBytes байт
+    // (недостающие — нули), возвращает число HEX-цифр для проверки длины
+    static qsizetype decode(const QString& text, uint8_t* out, qsizetype maxBytes,
+                            qsizetype* invalidAt = nullptr);
+
+    // Сообщение об ошибке для недопустимого символа в позиции pos поля what
+    static QString invalidCharError(const QString& what, const QString& text, qsizetype pos);
+
+    // HEX-строка в верхнем регистре, по два символа на байт
+    static QString encode(const uint8_t* data, qsizetype len);
+    static QString encode(const QByteArray& data)
+    {
+        return encode(reinterpret_cast<const uint8_t*>(data.constData()), data.size());
+    }
+};
+
+#endif // HEXCODEC_H
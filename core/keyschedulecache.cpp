@@ -0,0 +1,138 @@
+#include "keyschedulecache.h"
+#include <cstring>
+#include <mutex>
+
+KeyScheduleCache& KeyScheduleCache::instance()
+{
+    static KeyScheduleCache cache;
+    return cache;
+}
+
+KeyScheduleCache::KeyScheduleCache(int capacity)
+    : m_capacity(capacity > 0 ? capacity : 0)
+{
+}
+
+KeyScheduleCache::~KeyScheduleCache()
+{
+    clear();
+}
+
+void KeyScheduleCache::setCapacity(int capacity)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_capacity = capacity > 0 ? capacity : 0;
+    while (int(m_entries.size()) > m_capacity) {
+        evictOldest();
+    }
+}
+
+int KeyScheduleCache::capacity() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_capacity;
+}
+
+int KeyScheduleCache::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return int(m_entries.size());
+}
+
+void KeyScheduleCache::clear()
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    for (auto& item : m_entries) {
+        wipe(*item.second);
+    }
+    m_entries.clear();
+}
+
+void KeyScheduleCache::secureZero(void* data, size_t size)
+{
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>(data);
+    while (size--) {
+        *bytes++ = 0;
+    }
+}
+
+std::string KeyScheduleCache::makeId(const char* cipherTag, const uint8_t* key, int keyLen)
+{
+    const size_t tagLen = std::strlen(cipherTag);
+    std::string id;
+    id.reserve(tagLen + 1 + size_t(keyLen));
+    id.append(cipherTag, tagLen);
+    id.push_back('\0');
+    id.append(reinterpret_cast<const char*>(key), size_t(keyLen));
+    return id;
+}
+
+std::shared_ptr<const void> KeyScheduleCache::find(const std::string& id)
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_entries.find(std::string_view(id));
+    if (it == m_entries.end()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    // Метка времени атомарна, поэтому обновляется без исключительной блокировки
+    it->second->lastUse.store(++m_clock, std::memory_order_relaxed);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return it->second->schedule;
+}
+
+std::shared_ptr<const void> KeyScheduleCache::insert(const std::string& id,
+                                                     std::shared_ptr<const void> schedule)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_entries.find(std::string_view(id));
+    if (it != m_entries.end()) {
+        it->second->lastUse.store(++m_clock, std::memory_order_relaxed);
+        return it->second->schedule;
+    }
+
+    if (m_capacity == 0) {
+        return schedule;
+    }
+    while (int(m_entries.size()) >= m_capacity) {
+        evictOldest();
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->id = id;
+    entry->schedule = schedule;
+    entry->lastUse.store(++m_clock, std::memory_order_relaxed);
+    const std::string_view key(entry->id);
+    m_entries.emplace(key, std::move(entry));
+    return schedule;
+}
+
+void KeyScheduleCache::evictOldest()
+{
+    // Записей немного (DEFAULT_CAPACITY), линейный проход дешевле списка LRU,
+    // который пришлось бы переставлять под исключительной блокировкой на каждом попадании
+    auto oldest = m_entries.end();
+    quint64 oldestUse = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        const quint64 use = it->second->lastUse.load(std::memory_order_relaxed);
+        if (oldest == m_entries.end() || use < oldestUse) {
+            oldest = it;
+            oldestUse = use;
+        }
+    }
+    if (oldest == m_entries.end()) {
+        return;
+    }
+
+    std::unique_ptr<Entry> entry = std::move(oldest->second);
+    m_entries.erase(oldest);
+    wipe(*entry);
+}
+
+void KeyScheduleCache::wipe(Entry& entry)
+{
+    // Само расписание затирает удалитель из get(), когда его отпустит последний владелец
+    secureZero(&entry.id[0], entry.id.size());
+    entry.schedule.reset();
+}
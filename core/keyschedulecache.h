@@ -0,0 +1,108 @@
+#ifndef KEYSCHEDULECACHE_H
+#define KEYSCHEDULECACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Кэш развёрнутых ключей блочных шифров (AES, Кузнечик, Магма).
+// Запись ищется по метке шифра и байтам ключа, число записей ограничено,
+// при переполнении вытесняется дольше всех не использовавшаяся (LRU).
+// Поиск идёт под разделяемой блокировкой — параллельные потоки с одним
+// ключом друг друга не ждут; вставка и вытеснение — под исключительной.
+// При вытеснении байты ключа затираются сразу, развёрнутый ключ — когда его
+// отпустит последний поток, который им ещё шифрует.
+class KeyScheduleCache
+{
+public:
+    static const int DEFAULT_CAPACITY = 64;
+
+    static KeyScheduleCache& instance();
+
+    explicit KeyScheduleCache(int capacity = DEFAULT_CAPACITY);
+    ~KeyScheduleCache();
+
+    KeyScheduleCache(const KeyScheduleCache&) = delete;
+    KeyScheduleCache& operator=(const KeyScheduleCache&) = delete;
+
+    // Развёрнутый ключ; build() вызывается только при промахе и вне блокировки
+    template<class Schedule, class Build>
+    std::shared_ptr<const Schedule> get(const char* cipherTag, const uint8_t* key, int keyLen,
+                                        Build&& build);
+
+    // 0 — кэш отключён, каждый вызов get() разворачивает ключ заново
+    void setCapacity(int capacity);
+    int capacity() const;
+    int size() const;
+
+    // Вытесняет все записи (с затиранием)
+    void clear();
+
+    quint64 hits() const { return m_hits.load(std::memory_order_relaxed); }
+    quint64 misses() const { return m_misses.load(std::memory_order_relaxed); }
+
+    // Обнуление, которое компилятор не выбросит как запись в «мёртвую» память
+    static void secureZero(void* data, size_t size);
+
+private:
+    struct Entry {
+        std::string id;                         // метка шифра + '\0' + байты ключа
+        std::shared_ptr<const void> schedule;
+        std::atomic<quint64> lastUse{0};
+    };
+
+    static std::string makeId(const char* cipherTag, const uint8_t* key, int keyLen);
+
+    std::shared_ptr<const void> find(const std::string& id);
+    std::shared_ptr<const void> insert(const std::string& id, std::shared_ptr<const void> schedule);
+    void evictOldest();
+    static void wipe(Entry& entry);
+
+    template<class T>
+    static void wipeSchedule(T& schedule) {
+        static_assert(std::is_trivially_copyable<T>::value, "расписание должно быть POD-массивом");
+        secureZero(&schedule, sizeof(T));
+    }
+
+    template<class T>
+    static void wipeSchedule(std::vector<T>& schedule) {
+        static_assert(std::is_trivially_copyable<T>::value, "расписание должно быть POD-массивом");
+        secureZero(schedule.data(), schedule.size() * sizeof(T));
+    }
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::string_view, std::unique_ptr<Entry>> m_entries;
+    int m_capacity;
+    std::atomic<quint64> m_clock{0};
+    std::atomic<quint64> m_hits{0};
+    std::atomic<quint64> m_misses{0};
+};
+
+template<class Schedule, class Build>
+std::shared_ptr<const Schedule> KeyScheduleCache::get(const char* cipherTag, const uint8_t* key,
+                                                      int keyLen, Build&& build)
+{
+    std::string id = makeId(cipherTag, key, keyLen);
+
+    std::shared_ptr<const void> schedule = find(id);
+    if (!schedule) {
+        // Удалитель затирает расписание, когда его отпустит последний владелец
+        std::shared_ptr<Schedule> built(new Schedule(build()), [](Schedule* expanded) {
+            wipeSchedule(*expanded);
+            delete expanded;
+        });
+        // При гонке двух промахов остаётся запись, вставленная первой
+        schedule = insert(id, std::move(built));
+    }
+
+    secureZero(&id[0], id.size());
+    return std::static_pointer_cast<const Schedule>(schedule);
+}
+
+#endif // KEYSCHEDULECACHE_H
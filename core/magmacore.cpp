@@ -0,0 +1,290 @@
+#include "magmacore.h"
+#include "cpufeatures.h"
+#include "keyschedulecache.h"
+
+#if defined(CRYPTOAPP_X86)
+#include <immintrin.h>
+#endif
+
+const MagmaCore::Tables MagmaCore::TABLES = MagmaCore::buildTables();
+
+// t(a7||...||a0) = π7(a7)||...||π0(a0)
+uint32_t MagmaCore::t(uint32_t a)
+{
+    uint32_t result = 0;
+    for (int i = 0; i < 8; ++i) {
+        result |= uint32_t(PI[i][(a >> (4 * i)) & 0xF]) << (4 * i);
+    }
+    return result;
+}
+
+MagmaCore::Tables MagmaCore::buildTables()
+{
+    Tables tables{};
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 256; ++b) {
+            const uint32_t s = (uint32_t(PI[2 * i + 1][b >> 4]) << 4) | PI[2 * i][b & 0xF];
+            const uint32_t v = s << (8 * i);
+            tables[i][b] = (v << 11) | (v >> (32 - 11));
+        }
+    }
+    return tables;
+}
+
+MagmaCore::RoundKeys MagmaCore::keySchedule(const uint8_t key[32])
+{
+    // K1..K8 — ключ (big-endian), K9..K24 — повтор K1..K8, K25..K32 = K8..K1
+    RoundKeys roundKeys;
+    for (int i = 0; i < 8; ++i) {
+        const uint32_t part = (uint32_t(key[i * 4]) << 24) | (uint32_t(key[i * 4 + 1]) << 16)
+                            | (uint32_t(key[i * 4 + 2]) << 8) | uint32_t(key[i * 4 + 3]);
+        roundKeys[i] = part;
+        roundKeys[8 + i] = part;
+        roundKeys[16 + i] = part;
+        roundKeys[31 - i] = part;
+    }
+    return roundKeys;
+}
+
+// Два раунда G подряд из (a1, a0): a1 ⊕= g(a0), a0 ⊕= g(a1) — половины не меняются
+// местами; после 30 раундов — G[K31] и G*[K32] с тем же приемом
+template<class Key>
+uint64_t MagmaCore::rounds(uint64_t block, Key key)
+{
+    uint32_t a1 = uint32_t(block >> 32);
+    uint32_t a0 = uint32_t(block);
+    for (int i = 0; i < 32; i += 2) {
+        a1 ^= g(a0, key(i));
+        a0 ^= g(a1, key(i + 1));
+    }
+    return (uint64_t(a0) << 32) | a1;
+}
+
+uint64_t MagmaCore::encryptBlock(uint64_t block, const RoundKeys& roundKeys)
+{
+    return rounds(block, [&](int i) { return roundKeys[i]; });
+}
+
+uint64_t MagmaCore::decryptBlock(uint64_t block, const RoundKeys& roundKeys)
+{
+    return rounds(block, [&](int i) { return roundKeys[31 - i]; });
+}
+
+// ==================== Побитово-срезовое ядро (AVX2) ====================
+// 256 блоков раскладываются в 64 регистра: регистр c — бит c всех блоков
+// (64-битная полоса регистра — четверть пачки). Раскладка — транспонирование
+// матрицы 64×64 бит в каждой полосе, обратная раскладка — оно же.
+// Раунд: x = a0 + k — сумматор с переносом по 32 срезам, t(x) — 8 булевых схем
+// по 4 среза, сдвиг <<< 11 — перенумерация срезов, a1 ^= g — 32 XOR.
+
+#if defined(CRYPTOAPP_X86)
+namespace {
+    // Коэффициенты алгебраической нормальной формы бита bit S-блока π_box:
+    // бит m — коэффициент монома ∏ x_i по битам i числа m (преобразование Мебиуса)
+    constexpr uint16_t anfMask(int box, int bit)
+    {
+        uint16_t mask = 0;
+        for (int x = 0; x < 16; ++x) {
+            if ((MagmaCore::PI[box][x] >> bit) & 1) {
+                mask |= uint16_t(1 << x);
+            }
+        }
+        for (int step = 1; step < 16; step <<= 1) {
+            for (int x = 0; x < 16; ++x) {
+                if ((x & step) && ((mask >> (x ^ step)) & 1)) {
+                    mask ^= uint16_t(1 << x);
+                }
+            }
+        }
+        return mask;
+    }
+
+    // Сумма мономов из Mask: XOR нулевого регистра компилятор выбрасывает
+    template<uint16_t Mask, int M = 0>
+    CRYPTOAPP_TARGET("avx2")
+    inline __m256i anfSum(const __m256i* mono)
+    {
+        if constexpr (M == 16) {
+            return _mm256_setzero_si256();
+        } else if constexpr (((Mask >> M) & 1) != 0) {
+            return _mm256_xor_si256(mono[M], anfSum<Mask, M + 1>(mono));
+        } else {
+            return anfSum<Mask, M + 1>(mono);
+        }
+    }
+
+    // π_Box над срезами x[0..3] (младший бит — x[0]); выходной бит j полубайта Box
+    // после сдвига <<< 11 попадает в бит (4·Box + j + 11) mod 32 слова g
+    template<int Box>
+    CRYPTOAPP_TARGET("avx2")
+    inline void sboxAvx2(const __m256i* x, __m256i* a1)
+    {
+        __m256i mono[16];
+        mono[0] = _mm256_set1_epi32(-1);
+        mono[1] = x[0];
+        mono[2] = x[1];
+        mono[3] = _mm256_and_si256(x[0], x[1]);
+        mono[4] = x[2];
+        mono[5] = _mm256_and_si256(x[0], x[2]);
+        mono[6] = _mm256_and_si256(x[1], x[2]);
+        mono[7] = _mm256_and_si256(mono[3], x[2]);
+        mono[8] = x[3];
+        mono[9] = _mm256_and_si256(x[0], x[3]);
+        mono[10] = _mm256_and_si256(x[1], x[3]);
+        mono[11] = _mm256_and_si256(mono[3], x[3]);
+        mono[12] = _mm256_and_si256(x[2], x[3]);
+        mono[13] = _mm256_and_si256(mono[5], x[3]);
+        mono[14] = _mm256_and_si256(mono[6], x[3]);
+        mono[15] = _mm256_and_si256(mono[7], x[3]);
+
+        constexpr int base = 4 * Box + 11;
+        a1[(base + 0) % 32] = _mm256_xor_si256(a1[(base + 0) % 32], anfSum<anfMask(Box, 0)>(mono));
+        a1[(base + 1) % 32] = _mm256_xor_si256(a1[(base + 1) % 32], anfSum<anfMask(Box, 1)>(mono));
+        a1[(base + 2) % 32] = _mm256_xor_si256(a1[(base + 2) % 32], anfSum<anfMask(Box, 2)>(mono));
+        a1[(base + 3) % 32] = _mm256_xor_si256(a1[(base + 3) % 32], anfSum<anfMask(Box, 3)>(mono));
+    }
+
+    // a1 ^= g[k](a0); keyMask[i] — бит i ключа раунда, размноженный на 32 бита
+    CRYPTOAPP_TARGET("avx2")
+    inline void roundAvx2(const __m256i* a0, __m256i* a1, const uint32_t* keyMask)
+    {
+        // Сумма по модулю 2^32: перенос — мажоритарная функция (a, k, c)
+        __m256i x[32];
+        __m256i k = _mm256_set1_epi32(int(keyMask[0]));
+        x[0] = _mm256_xor_si256(a0[0], k);
+        __m256i carry = _mm256_and_si256(a0[0], k);
+        for (int i = 1; i < 32; ++i) {
+            k = _mm256_set1_epi32(int(keyMask[i]));
+            const __m256i ac = _mm256_xor_si256(a0[i], carry);
+            x[i] = _mm256_xor_si256(ac, k);
+            carry = _mm256_xor_si256(_mm256_and_si256(ac, _mm256_xor_si256(k, carry)), carry);
+        }
+
+        sboxAvx2<0>(x + 0, a1);
+        sboxAvx2<1>(x + 4, a1);
+        sboxAvx2<2>(x + 8, a1);
+        sboxAvx2<3>(x + 12, a1);
+        sboxAvx2<4>(x + 16, a1);
+        sboxAvx2<5>(x + 20, a1);
+        sboxAvx2<6>(x + 24, a1);
+        sboxAvx2<7>(x + 28, a1);
+    }
+
+    // Шаг транспонирования: обмен блоков J×J между строками k и k + J
+    template<int J>
+    CRYPTOAPP_TARGET("avx2")
+    inline void transposeStep(__m256i* s, uint64_t mask)
+    {
+        const __m256i m = _mm256_set1_epi64x(qint64(mask));
+        for (int k = 0; k < 64; k = ((k | J) + 1) & ~J) {
+            const __m256i t = _mm256_and_si256(
+                _mm256_xor_si256(_mm256_srli_epi64(s[k], J), s[k | J]), m);
+            s[k | J] = _mm256_xor_si256(s[k | J], t);
+            s[k] = _mm256_xor_si256(s[k], _mm256_slli_epi64(t, J));
+        }
+    }
+
+    // В каждой 64-битной полосе: бит c строки r ↔ бит r строки c
+    CRYPTOAPP_TARGET("avx2")
+    void transpose64(__m256i* s)
+    {
+        transposeStep<32>(s, 0x00000000FFFFFFFFull);
+        transposeStep<16>(s, 0x0000FFFF0000FFFFull);
+        transposeStep<8>(s, 0x00FF00FF00FF00FFull);
+        transposeStep<4>(s, 0x0F0F0F0F0F0F0F0Full);
+        transposeStep<2>(s, 0x3333333333333333ull);
+        transposeStep<1>(s, 0x5555555555555555ull);
+    }
+
+    // groups пачек по 256 блоков; keyMask[r][i] — бит i ключа раунда r (0 или ~0)
+    CRYPTOAPP_TARGET("avx2")
+    void bitsliceAvx2(const uint8_t* in, uint8_t* out, qsizetype groups, const uint32_t (*keyMask)[32])
+    {
+        const int quarter = MagmaCore::BITSLICE_BLOCKS / 4;
+        __m256i s[64];
+        for (qsizetype group = 0; group < groups; ++group) {
+            const uint8_t* src = in + group * MagmaCore::BITSLICE_BLOCKS * 8;
+            uint8_t* dst = out + group * MagmaCore::BITSLICE_BLOCKS * 8;
+
+            for (int r = 0; r < 64; ++r) {
+                s[r] = _mm256_set_epi64x(qint64(MagmaCore::loadBlock(src + (3 * quarter + r) * 8)),
+                                         qint64(MagmaCore::loadBlock(src + (2 * quarter + r) * 8)),
+                                         qint64(MagmaCore::loadBlock(src + (quarter + r) * 8)),
+                                         qint64(MagmaCore::loadBlock(src + r * 8)));
+            }
+            transpose64(s);
+
+            // a0 — срезы 0..31, a1 — 32..63; по два раунда без перестановки половин
+            __m256i* a0 = s;
+            __m256i* a1 = s + 32;
+            for (int round = 0; round < 32; round += 2) {
+                roundAvx2(a0, a1, keyMask[round]);
+                roundAvx2(a1, a0, keyMask[round + 1]);
+            }
+
+            // Результат a0 || a1: половины меняются местами
+            for (int c = 0; c < 32; ++c) {
+                const __m256i t = s[c];
+                s[c] = s[32 + c];
+                s[32 + c] = t;
+            }
+            transpose64(s);
+
+            alignas(32) uint64_t lanes[4];
+            for (int r = 0; r < 64; ++r) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), s[r]);
+                for (int lane = 0; lane < 4; ++lane) {
+                    MagmaCore::storeBlock(dst + (lane * quarter + r) * 8, lanes[lane]);
+                }
+            }
+        }
+        KeyScheduleCache::secureZero(s, sizeof(s));
+    }
+
+    // Целые пачки через AVX2; возвращает число обработанных блоков
+    qsizetype bitsliceBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks,
+                             const MagmaCore::RoundKeys& roundKeys, bool reverse)
+    {
+        const qsizetype groups = blocks / MagmaCore::BITSLICE_BLOCKS;
+        if (groups == 0 || !CpuFeatures::get().avx2) {
+            return 0;
+        }
+        uint32_t keyMask[32][32];
+        for (int round = 0; round < 32; ++round) {
+            const uint32_t key = roundKeys[reverse ? 31 - round : round];
+            for (int i = 0; i < 32; ++i) {
+                keyMask[round][i] = 0u - ((key >> i) & 1u);
+            }
+        }
+        bitsliceAvx2(in, out, groups, keyMask);
+        KeyScheduleCache::secureZero(keyMask, sizeof(keyMask));
+        return groups * MagmaCore::BITSLICE_BLOCKS;
+    }
+}
+#endif
+
+void MagmaCore::encryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks, const RoundKeys& roundKeys)
+{
+#if defined(CRYPTOAPP_X86)
+    const qsizetype done = bitsliceBlocks(in, out, blocks, roundKeys, false);
+    in += done * 8;
+    out += done * 8;
+    blocks -= done;
+#endif
+    for (qsizetype b = 0; b < blocks; ++b, in += 8, out += 8) {
+        storeBlock(out, encryptBlock(loadBlock(in), roundKeys));
+    }
+}
+
+void MagmaCore::decryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks, const RoundKeys& roundKeys)
+{
+#if defined(CRYPTOAPP_X86)
+    const qsizetype done = bitsliceBlocks(in, out, blocks, roundKeys, true);
+    in += done * 8;
+    out += done * 8;
+    blocks -= done;
+#endif
+    for (qsizetype b = 0; b < blocks; ++b, in += 8, out += 8) {
+        storeBlock(out, decryptBlock(loadBlock(in), roundKeys));
+    }
+}
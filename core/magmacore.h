@@ -0,0 +1,127 @@
+#ifndef MAGMACORE_H
+#define MAGMACORE_H
+
+#include "gost3413.h"
+#include <QtGlobal>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Блочный шифр Магма (ГОСТ Р 34.12-2015, раздел 5) — общее ядро для
+// MagmaECBCipher, MagmaCTRCipher и FeistelCipher. Блок — 64-битное число,
+// в байтах — big-endian, как в контрольных примерах стандарта.
+// g[k] считается по четырем таблицам на 256 слов: в TABLES[i][b] уже применены
+// пара S-блоков π_{2i}, π_{2i+1} к байту b на позиции i и сдвиг <<< 11
+// (сдвиг линеен относительно XOR), поэтому раунд — четыре выборки и XOR.
+// На процессорах с AVX2 пачки по BITSLICE_BLOCKS блоков шифруются побитово-срезово
+// (bit-slicing): бит i всех 256 блоков — один регистр, S-блоки — булевы схемы,
+// сложение с ключом — сумматор с переносом. Такое ядро не обращается к таблицам
+// по данным, поэтому не дает утечек через время доступа к кэшу.
+class MagmaCore
+{
+public:
+    using RoundKeys = std::array<uint32_t, 32>;
+
+    // S-блоки π0'..π7' (раздел 5.1.1)
+    static constexpr std::array<std::array<uint8_t, 16>, 8> PI = {{
+        {12, 4, 6, 2, 10, 5, 11, 9, 14, 8, 13, 7, 0, 3, 15, 1},
+        {6, 8, 2, 3, 9, 10, 5, 12, 1, 14, 4, 7, 11, 13, 0, 15},
+        {11, 3, 5, 8, 2, 15, 10, 13, 14, 1, 7, 4, 12, 9, 6, 0},
+        {12, 8, 2, 1, 13, 4, 15, 6, 7, 0, 10, 5, 3, 14, 9, 11},
+        {7, 15, 5, 10, 8, 1, 6, 13, 0, 9, 3, 14, 11, 4, 2, 12},
+        {5, 13, 15, 6, 9, 2, 12, 10, 11, 7, 8, 1, 4, 3, 14, 0},
+        {8, 14, 2, 5, 6, 9, 1, 12, 15, 4, 11, 0, 13, 10, 3, 7},
+        {1, 7, 14, 13, 0, 5, 8, 3, 4, 15, 10, 6, 9, 12, 11, 2}
+    }};
+
+    // Блоков за один проход побитово-срезового ядра; encryptBlocks и decryptBlocks
+    // выгоднее вызывать с числом блоков, кратным этому значению
+    static const int BITSLICE_BLOCKS = 256;
+
+    // Преобразование t (формула 14) — по полубайтам, для пояснений и проверки таблиц
+    static uint32_t t(uint32_t a);
+
+    // g[k](a) = (t((a + k) mod 2^32)) <<< 11 (формула 15)
+    static uint32_t g(uint32_t a, uint32_t k)
+    {
+        const uint32_t x = a + k;
+        return TABLES[0][x & 0xFF] ^ TABLES[1][(x >> 8) & 0xFF]
+             ^ TABLES[2][(x >> 16) & 0xFF] ^ TABLES[3][x >> 24];
+    }
+
+    // G[k](a1, a0) = (a0, g[k](a0) ⊕ a1) и G*[k](a1, a0) = (g[k](a0) ⊕ a1) || a0 (формулы 16, 17)
+    static std::pair<uint32_t, uint32_t> G(uint32_t a1, uint32_t a0, uint32_t k)
+    {
+        return std::make_pair(a0, g(a0, k) ^ a1);
+    }
+    static uint64_t GStar(uint32_t a1, uint32_t a0, uint32_t k)
+    {
+        return (uint64_t(g(a0, k) ^ a1) << 32) | a0;
+    }
+
+    // Итерационные ключи K1..K32 из 256-битного ключа (формула 18)
+    static RoundKeys keySchedule(const uint8_t key[32]);
+
+    // E (формула 19) и D (формула 20) — те же раунды с ключами K32..K1
+    static uint64_t encryptBlock(uint64_t block, const RoundKeys& roundKeys);
+    static uint64_t decryptBlock(uint64_t block, const RoundKeys& roundKeys);
+
+    // blocks блоков по 8 байт; in и out могут совпадать. Целые пачки по
+    // BITSLICE_BLOCKS при наличии AVX2 идут через побитово-срезовое ядро
+    static void encryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks, const RoundKeys& roundKeys);
+    static void decryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks, const RoundKeys& roundKeys);
+
+    static uint64_t loadBlock(const uint8_t* p)
+    {
+        uint64_t v = 0;
+        for (int j = 0; j < 8; ++j) {
+            v = (v << 8) | p[j];
+        }
+        return v;
+    }
+
+    static void storeBlock(uint8_t* p, uint64_t v)
+    {
+        for (int j = 0; j < 8; ++j) {
+            p[j] = static_cast<uint8_t>(v >> (56 - j * 8));
+        }
+    }
+
+private:
+    using Tables = std::array<std::array<uint32_t, 256>, 4>;
+
+    static const Tables TABLES;
+    static Tables buildTables();
+
+    // 32 раунда с ключами k(0)..k(31): по два раунда за шаг без перестановки половин
+    template<class Key>
+    static uint64_t rounds(uint64_t block, Key key);
+};
+
+// Магма как блочный шифр для режимов ГОСТ Р 34.13-2015 (n = 8) — общий для
+// MagmaECBCipher и MagmaCTRCipher. ECB, расшифрование CBC и пачки гаммы
+// делятся между потоками в Gost3413
+class MagmaBlock : public Gost3413Block
+{
+public:
+    explicit MagmaBlock(std::shared_ptr<const MagmaCore::RoundKeys> roundKeys)
+        : m_roundKeys(std::move(roundKeys)) {}
+
+    int blockSize() const override { return 8; }
+
+    void encryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) const override
+    {
+        MagmaCore::encryptBlocks(in, out, blocks, *m_roundKeys);
+    }
+
+    void decryptBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks) const override
+    {
+        MagmaCore::decryptBlocks(in, out, blocks, *m_roundKeys);
+    }
+
+private:
+    std::shared_ptr<const MagmaCore::RoundKeys> m_roundKeys;
+};
+
+#endif // MAGMACORE_H
@@ -0,0 +1,540 @@
+#include "mgm.h"
+#include "cipherparallel.h"
+#include "cipherprogress.h"
+#include "cpufeatures.h"
+#include "keyschedulecache.h"
+#include <cstring>
+#include <vector>
+
+#if defined(CRYPTOAPP_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Не меньше 256 КБ на поток; между отчетами о ходе — пачка по 4 МБ
+    const qsizetype PARALLEL_MIN_BYTES = 256 * 1024;
+    const qsizetype PARALLEL_BATCH_BYTES = 4 * 1024 * 1024;
+
+    // Блоков Y и Z, шифруемых за один вызов encryptBlocks
+    const int BUFFER_BLOCKS = 32;
+
+    inline quint64 loadBe64(const uint8_t* p)
+    {
+        quint64 v = 0;
+        for (int i = 0; i < 8; ++i) {
+            v = (v << 8) | p[i];
+        }
+        return v;
+    }
+
+    inline void storeBe64(uint8_t* p, quint64 v)
+    {
+        for (int i = 7; i >= 0; --i) {
+            p[i] = uint8_t(v);
+            v >>= 8;
+        }
+    }
+
+    inline void xorBytes(uint8_t* out, const uint8_t* a, const uint8_t* b, qsizetype len)
+    {
+        for (qsizetype i = 0; i < len; ++i) {
+            out[i] = a[i] ^ b[i];
+        }
+    }
+
+    // Инкремент половины блока как big-endian числа по модулю 2^(4·size):
+    // incr_r — правая половина (счетчик Y), incr_l — левая (счетчик Z)
+    void addHalf(uint8_t* block, int size, bool left, quint64 value)
+    {
+        const int half = size / 2;
+        uint8_t* p = left ? block : block + half;
+        for (int i = half - 1; i >= 0 && value != 0; --i) {
+            const quint64 sum = quint64(p[i]) + (value & 0xFF);
+            p[i] = uint8_t(sum);
+            value = (value >> 8) + (sum >> 8);
+        }
+    }
+
+    // Младшие 64 бита произведения без переносов через обычное умножение:
+    // у сомножителей оставлен каждый 4-й бит, поэтому суммы в каждой позиции
+    // не больше 15 и до соседних значащих битов не доходят (прием из BearSSL)
+    inline quint64 bmul64(quint64 x, quint64 y)
+    {
+        const quint64 m0 = 0x1111111111111111ULL;
+        const quint64 m1 = m0 << 1, m2 = m0 << 2, m3 = m0 << 3;
+        const quint64 x0 = x & m0, x1 = x & m1, x2 = x & m2, x3 = x & m3;
+        const quint64 y0 = y & m0, y1 = y & m1, y2 = y & m2, y3 = y & m3;
+        const quint64 z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+        const quint64 z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+        const quint64 z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+        const quint64 z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+        return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+    }
+
+    inline quint64 reverse64(quint64 x)
+    {
+        x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+        x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+        return (x >> 32) | (x << 32);
+    }
+
+    // 128-битное произведение без переносов; старшая половина — младшая
+    // у произведения развернутых сомножителей, развернутая обратно
+    inline void clmul64(quint64 x, quint64 y, quint64& lo, quint64& hi)
+    {
+        lo = bmul64(x, y);
+        hi = reverse64(bmul64(reverse64(x), reverse64(y))) >> 1;
+    }
+
+    void portableAccumulate128(MgmStream::Accumulator& acc, const uint8_t* h, const uint8_t* x, qsizetype blocks)
+    {
+        quint64 w0 = acc.w[0], w1 = acc.w[1], w2 = acc.w[2], w3 = acc.w[3];
+        for (qsizetype b = 0; b < blocks; ++b, h += 16, x += 16) {
+            const quint64 a1 = loadBe64(h), a0 = loadBe64(h + 8);
+            const quint64 b1 = loadBe64(x), b0 = loadBe64(x + 8);
+
+            // Карацуба: (a1·b1)·x^128 ⊕ ((a0 ⊕ a1)(b0 ⊕ b1) ⊕ a0·b0 ⊕ a1·b1)·x^64 ⊕ a0·b0
+            quint64 lo0, hi0, lo1, hi1, lo2, hi2;
+            clmul64(a0, b0, lo0, hi0);
+            clmul64(a1, b1, lo1, hi1);
+            clmul64(a0 ^ a1, b0 ^ b1, lo2, hi2);
+            lo2 ^= lo0 ^ lo1;
+            hi2 ^= hi0 ^ hi1;
+            w0 ^= lo0;
+            w1 ^= hi0 ^ lo2;
+            w2 ^= lo1 ^ hi2;
+            w3 ^= hi1;
+        }
+        acc.w[0] = w0;
+        acc.w[1] = w1;
+        acc.w[2] = w2;
+        acc.w[3] = w3;
+    }
+
+    void portableAccumulate64(MgmStream::Accumulator& acc, const uint8_t* h, const uint8_t* x, qsizetype blocks)
+    {
+        for (qsizetype b = 0; b < blocks; ++b, h += 8, x += 8) {
+            quint64 lo, hi;
+            clmul64(loadBe64(h), loadBe64(x), lo, hi);
+            acc.w[0] ^= lo;
+            acc.w[1] ^= hi;
+        }
+    }
+
+#if defined(CRYPTOAPP_X86)
+    CRYPTOAPP_TARGET("ssse3")
+    inline __m128i byteSwap(__m128i x)
+    {
+        return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+
+    // Средние произведения копятся отдельно и сдвигаются на 64 бита один раз в конце
+    CRYPTOAPP_TARGET("pclmul,ssse3,sse2")
+    void clmulAccumulate128(MgmStream::Accumulator& acc, const uint8_t* h, const uint8_t* x, qsizetype blocks)
+    {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc.w));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc.w + 2));
+        __m128i mid = _mm_setzero_si128();
+        for (qsizetype b = 0; b < blocks; ++b, h += 16, x += 16) {
+            const __m128i a = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h)));
+            const __m128i c = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+            lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, c, 0x00));
+            hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, c, 0x11));
+            mid = _mm_xor_si128(mid, _mm_xor_si128(_mm_clmulepi64_si128(a, c, 0x10),
+                                                   _mm_clmulepi64_si128(a, c, 0x01)));
+        }
+        lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+        hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc.w), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc.w + 2), hi);
+    }
+
+    CRYPTOAPP_TARGET("pclmul,ssse3,sse2")
+    void clmulAccumulate64(MgmStream::Accumulator& acc, const uint8_t* h, const uint8_t* x, qsizetype blocks)
+    {
+        const __m128i swap = _mm_set_epi8(15, 14, 13, 12, 11, 10, 9, 8, 0, 1, 2, 3, 4, 5, 6, 7);
+        __m128i sum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc.w));
+        for (qsizetype b = 0; b < blocks; ++b, h += 8, x += 8) {
+            const __m128i a = _mm_shuffle_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(h)), swap);
+            const __m128i c = _mm_shuffle_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x)), swap);
+            sum = _mm_xor_si128(sum, _mm_clmulepi64_si128(a, c, 0x00));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc.w), sum);
+    }
+#endif
+
+    // Редукция: x^128 ≡ x^7 + x^2 + x + 1, старшие слова сворачиваются по одному
+    void reduce128(const MgmStream::Accumulator& acc, uint8_t out[16])
+    {
+        quint64 w0 = acc.w[0], w1 = acc.w[1], w2 = acc.w[2];
+        const quint64 w3 = acc.w[3];
+        w1 ^= w3 ^ (w3 << 1) ^ (w3 << 2) ^ (w3 << 7);
+        w2 ^= (w3 >> 63) ^ (w3 >> 62) ^ (w3 >> 57);
+        w0 ^= w2 ^ (w2 << 1) ^ (w2 << 2) ^ (w2 << 7);
+        w1 ^= (w2 >> 63) ^ (w2 >> 62) ^ (w2 >> 57);
+        storeBe64(out, w1);
+        storeBe64(out + 8, w0);
+    }
+
+    // x^64 ≡ x^4 + x^3 + x + 1; выдвинутые за x^64 не больше 4 бит сворачиваются повторно
+    void reduce64(const MgmStream::Accumulator& acc, uint8_t out[8])
+    {
+        const quint64 w1 = acc.w[1];
+        const quint64 over = (w1 >> 63) ^ (w1 >> 61) ^ (w1 >> 60);
+        quint64 w0 = acc.w[0] ^ w1 ^ (w1 << 1) ^ (w1 << 3) ^ (w1 << 4);
+        w0 ^= over ^ (over << 1) ^ (over << 3) ^ (over << 4);
+        storeBe64(out, w0);
+    }
+
+    // len(A) и len(C) записываются в n/2 бит: для Магмы — меньше 2^32 бит (512 МБ),
+    // этим же ограничено и число блоков на половинных счетчиках
+    quint64 maxMessageBytes(int blockSize)
+    {
+        return (blockSize == 16) ? ~quint64(0) / 8 : ((quint64(1) << 32) - 1) / 8;
+    }
+
+    void addAccumulator(MgmStream::Accumulator& acc, const MgmStream::Accumulator& other)
+    {
+        for (int i = 0; i < 4; ++i) {
+            acc.w[i] ^= other.w[i];
+        }
+    }
+}
+
+MgmStream::MgmStream(std::shared_ptr<const Gost3413Block> block, const QByteArray& nonce, const QByteArray& aad,
+                     int tagLength, bool encrypt)
+    : m_block(std::move(block)), m_blockSize(m_block->blockSize()), m_tagLength(tagLength),
+      m_encrypt(encrypt), m_nonce(nonce), m_aad(aad)
+{
+    const CpuFeatures& cpu = CpuFeatures::get();
+    m_clmul = cpu.pclmul && cpu.ssse3;
+}
+
+MgmStream::~MgmStream()
+{
+    clear();
+    KeyScheduleCache::secureZero(m_nonce.data(), size_t(m_nonce.size()));
+    KeyScheduleCache::secureZero(m_aad.data(), size_t(m_aad.size()));
+}
+
+bool MgmStream::init(const QVariantMap& params, QString* error)
+{
+    Q_UNUSED(params)
+    clear();
+    const int n = m_blockSize;
+    if (m_nonce.size() != n || (uint8_t(m_nonce[0]) & 0x80)) {
+        if (error) {
+            *error = QString("ОШИБКА: Nonce для режима MGM — %1 байт со старшим битом 0").arg(n);
+        }
+        return false;
+    }
+
+    if (quint64(m_aad.size()) > maxMessageBytes(n)) {
+        if (error) {
+            *error = "ОШИБКА: Превышен допустимый для MGM объем дополнительных данных";
+        }
+        return false;
+    }
+
+    // Y1 = E(0 || nonce), Z1 = E(1 || nonce)
+    std::memcpy(m_y, m_nonce.constData(), n);
+    std::memcpy(m_z, m_nonce.constData(), n);
+    m_z[0] |= 0x80;
+    m_block->encryptBlocks(m_y, m_y, 1);
+    m_block->encryptBlocks(m_z, m_z, 1);
+
+    // Дополнительные данные: целые блоки пачкой, хвост дополняется нулями
+    const uint8_t* aad = reinterpret_cast<const uint8_t*>(m_aad.constData());
+    const qsizetype aadBlocks = m_aad.size() / n;
+    processBlocks(aad, nullptr, aadBlocks);
+    const int rest = int(m_aad.size() % n);
+    if (rest > 0) {
+        uint8_t last[MAX_BLOCK_SIZE] = {0};
+        std::memcpy(last, aad + aadBlocks * n, rest);
+        absorbBlock(last);
+        KeyScheduleCache::secureZero(last, sizeof(last));
+    }
+
+    m_ready = true;
+    return true;
+}
+
+bool MgmStream::update(const char* data, qsizetype len, QByteArray& out, QString* error)
+{
+    if (!m_ready) {
+        if (error) {
+            *error = "ОШИБКА: Контекст MGM не инициализирован";
+        }
+        return false;
+    }
+    if (m_encrypt) {
+        return process(reinterpret_cast<const uint8_t*>(data), len, out, error);
+    }
+
+    // Последние s байт могут оказаться имитовставкой — придерживаем их
+    const qsizetype total = m_held + len;
+    if (total <= m_tagLength) {
+        std::memcpy(m_tail + m_held, data, len);
+        m_held = int(total);
+        return true;
+    }
+
+    qsizetype release = total - m_tagLength;
+    const qsizetype fromHeld = qMin<qsizetype>(release, m_held);
+    if (fromHeld > 0) {
+        if (!process(m_tail, fromHeld, out, error)) {
+            return false;
+        }
+        std::memmove(m_tail, m_tail + fromHeld, m_held - fromHeld);
+        m_held -= int(fromHeld);
+        release -= fromHeld;
+    }
+    if (release > 0 && !process(reinterpret_cast<const uint8_t*>(data), release, out, error)) {
+        return false;
+    }
+    std::memcpy(m_tail + m_held, data + release, len - release);
+    m_held += int(len - release);
+    return true;
+}
+
+bool MgmStream::final(QByteArray& out, QString* error)
+{
+    if (!m_ready) {
+        if (error) {
+            *error = "ОШИБКА: Контекст MGM не инициализирован";
+        }
+        return false;
+    }
+    if (!m_encrypt && m_held < m_tagLength) {
+        clear();
+        if (error) {
+            *error = QString("ОШИБКА: Нет имитовставки MGM: данные короче %1 байт").arg(m_tagLength);
+        }
+        return false;
+    }
+
+    const int n = m_blockSize;
+    if (m_partial > 0) {
+        std::memset(m_partialBlock + m_partial, 0, n - m_partial);
+        absorbBlock(m_partialBlock);
+    }
+
+    // len(A) || len(C) в битах, по n/2 бит на каждую длину
+    uint8_t lengths[MAX_BLOCK_SIZE];
+    const quint64 aadBits = quint64(m_aad.size()) * 8;
+    const quint64 dataBits = m_dataBytes * 8;
+    if (n == 16) {
+        storeBe64(lengths, aadBits);
+        storeBe64(lengths + 8, dataBits);
+    } else {
+        storeBe64(lengths, (aadBits << 32) | (dataBits & 0xFFFFFFFFU));
+    }
+    absorbBlock(lengths);
+
+    uint8_t tag[MAX_BLOCK_SIZE];
+    if (n == 16) {
+        reduce128(m_sum, tag);
+    } else {
+        reduce64(m_sum, tag);
+    }
+    m_block->encryptBlocks(tag, tag, 1);
+
+    bool ok = true;
+    if (m_encrypt) {
+        out.append(reinterpret_cast<const char*>(tag), m_tagLength);
+    } else {
+        // Сравнение за постоянное время
+        uint8_t diff = 0;
+        for (int i = 0; i < m_tagLength; ++i) {
+            diff |= uint8_t(tag[i] ^ m_tail[i]);
+        }
+        ok = (diff == 0);
+        if (!ok && error) {
+            *error = "ОШИБКА: Имитовставка MGM не совпадает — данные, AAD, nonce или ключ неверны";
+        }
+    }
+
+    KeyScheduleCache::secureZero(tag, sizeof(tag));
+    clear();
+    m_tagMismatch = !ok;
+    return ok;
+}
+
+void MgmStream::accumulate(Accumulator& acc, const uint8_t* h, const uint8_t* x, qsizetype blocks) const
+{
+#if defined(CRYPTOAPP_X86)
+    if (m_clmul) {
+        if (m_blockSize == 16) {
+            clmulAccumulate128(acc, h, x, blocks);
+        } else {
+            clmulAccumulate64(acc, h, x, blocks);
+        }
+        return;
+    }
+#endif
+    if (m_blockSize == 16) {
+        portableAccumulate128(acc, h, x, blocks);
+    } else {
+        portableAccumulate64(acc, h, x, blocks);
+    }
+}
+
+void MgmStream::absorbBlock(const uint8_t* block)
+{
+    uint8_t h[MAX_BLOCK_SIZE];
+    m_block->encryptBlocks(m_z, h, 1);
+    addHalf(m_z, m_blockSize, true, 1);
+    accumulate(m_sum, h, block, 1);
+    KeyScheduleCache::secureZero(h, sizeof(h));
+}
+
+// Куски пачки независимы: у каждого свое смещение счетчиков Y и Z и своя
+// несокращенная сумма, суммы кусков складываются
+void MgmStream::processBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks)
+{
+    if (blocks <= 0) {
+        return;
+    }
+    const int n = m_blockSize;
+    const int chunks = CipherParallel::chunkCount(blocks, PARALLEL_MIN_BYTES / n);
+    std::vector<Accumulator> sums(chunks);
+    CipherParallel::run(chunks, [&](int index) {
+        const qsizetype begin = CipherParallel::chunkBegin(blocks, chunks, index);
+        const qsizetype end = CipherParallel::chunkBegin(blocks, chunks, index + 1);
+
+        uint8_t y[MAX_BLOCK_SIZE], z[MAX_BLOCK_SIZE];
+        std::memcpy(y, m_y, n);
+        std::memcpy(z, m_z, n);
+        addHalf(y, n, false, quint64(begin));
+        addHalf(z, n, true, quint64(begin));
+
+        // В буфере сначала count блоков гаммы E(Y_i), за ними count множителей E(Z_i):
+        // один вызов encryptBlocks на обе последовательности
+        uint8_t buffer[2 * BUFFER_BLOCKS * MAX_BLOCK_SIZE];
+        for (qsizetype b = begin; b < end; ) {
+            const int count = int(qMin<qsizetype>(end - b, BUFFER_BLOCKS));
+            uint8_t* gamma = buffer;
+            uint8_t* h = buffer + count * n;
+            int fill = 0;
+            if (out) {
+                for (int i = 0; i < count; ++i, fill += n) {
+                    std::memcpy(buffer + fill, y, n);
+                    addHalf(y, n, false, 1);
+                }
+            } else {
+                h = buffer;
+            }
+            for (int i = 0; i < count; ++i, fill += n) {
+                std::memcpy(buffer + fill, z, n);
+                addHalf(z, n, true, 1);
+            }
+            m_block->encryptBlocks(buffer, buffer, fill / n);
+
+            const uint8_t* src = in + b * n;
+            if (!out) {
+                accumulate(sums[index], h, src, count);
+            } else if (m_encrypt) {
+                xorBytes(out + b * n, src, gamma, qsizetype(count) * n);
+                accumulate(sums[index], h, out + b * n, count);
+            } else {
+                accumulate(sums[index], h, src, count);
+                xorBytes(out + b * n, src, gamma, qsizetype(count) * n);
+            }
+            b += count;
+        }
+        KeyScheduleCache::secureZero(buffer, sizeof(buffer));
+        KeyScheduleCache::secureZero(y, sizeof(y));
+        KeyScheduleCache::secureZero(z, sizeof(z));
+    });
+
+    for (const Accumulator& sum : sums) {
+        addAccumulator(m_sum, sum);
+    }
+    if (out) {
+        addHalf(m_y, n, false, quint64(blocks));
+    }
+    addHalf(m_z, n, true, quint64(blocks));
+}
+
+bool MgmStream::process(const uint8_t* in, qsizetype len, QByteArray& out, QString* error)
+{
+    if (len <= 0) {
+        return true;
+    }
+    const int n = m_blockSize;
+
+    if (quint64(len) > maxMessageBytes(n) - m_dataBytes) {
+        if (error) {
+            *error = "ОШИБКА: Превышен допустимый для MGM объем данных на один nonce";
+        }
+        return false;
+    }
+
+    const qsizetype offset = out.size();
+    out.resize(offset + len);
+    uint8_t* dst = reinterpret_cast<uint8_t*>(out.data()) + offset;
+    m_dataBytes += quint64(len);
+
+    // Дописываем неполный блок прошлого вызова
+    while (m_partial > 0 && len > 0) {
+        *dst = *in ^ m_gamma[m_partial];
+        m_partialBlock[m_partial++] = m_encrypt ? *dst : *in;
+        ++dst;
+        ++in;
+        --len;
+        if (m_partial == n) {
+            absorbBlock(m_partialBlock);
+            m_partial = 0;
+        }
+    }
+
+    const qsizetype blocks = len / n;
+    const qsizetype total = blocks * n;
+    const qsizetype batchBlocks = PARALLEL_BATCH_BYTES / n;
+    for (qsizetype done = 0; done < blocks; ) {
+        const qsizetype batch = qMin(blocks - done, batchBlocks);
+        processBlocks(in + done * n, dst + done * n, batch);
+        done += batch;
+        if (!CipherProgress::report(done * n, total)) {
+            out.resize(offset);
+            if (error) {
+                *error = CipherProgress::canceledMessage();
+            }
+            return false;
+        }
+    }
+    in += total;
+    dst += total;
+    len -= total;
+
+    // Хвост: блок гаммы остается до следующего update
+    if (len > 0) {
+        m_block->encryptBlocks(m_y, m_gamma, 1);
+        addHalf(m_y, n, false, 1);
+        for (; len > 0; --len) {
+            *dst = *in ^ m_gamma[m_partial];
+            m_partialBlock[m_partial++] = m_encrypt ? *dst : *in;
+            ++dst;
+            ++in;
+        }
+    }
+    return true;
+}
+
+void MgmStream::clear()
+{
+    KeyScheduleCache::secureZero(m_y, sizeof(m_y));
+    KeyScheduleCache::secureZero(m_z, sizeof(m_z));
+    KeyScheduleCache::secureZero(&m_sum, sizeof(m_sum));
+    KeyScheduleCache::secureZero(m_gamma, sizeof(m_gamma));
+    KeyScheduleCache::secureZero(m_partialBlock, sizeof(m_partialBlock));
+    KeyScheduleCache::secureZero(m_tail, sizeof(m_tail));
+    m_dataBytes = 0;
+    m_partial = 0;
+    m_held = 0;
+    m_ready = false;
+    m_tagMismatch = false;
+}
@@ -0,0 +1,85 @@
+#ifndef MGM_H
+#define MGM_H
+
+#include "cipherstream.h"
+#include "gost3413.h"
+#include <QByteArray>
+#include <cstdint>
+#include <memory>
+
+// Режим MGM (Multilinear Galois Mode, Р 1323565.1.026-2019) — аутентифицированное
+// шифрование над блочным шифром ГОСТ Р 34.12-2015 (n = 16 или 8 байт).
+// Nonce — n байт со старшим битом 0: от Y1 = E(0||nonce) с инкрементом правой
+// половины идет гамма, от Z1 = E(1||nonce) с инкрементом левой — множители H_i = E(Z_i).
+// T = MSB_s(E(Σ H_i ⊗ A_i ⊕ Σ H_{h+j} ⊗ C_j ⊕ H_{h+q+1} ⊗ (len(A) || len(C)))),
+// умножение — в GF(2^128) по x^128 + x^7 + x^2 + x + 1 или в GF(2^64) по
+// x^64 + x^4 + x^3 + x + 1. Слагаемые суммы друг от друга не зависят, поэтому
+// пачки блоков делятся между потоками, а частичные суммы просто складываются.
+// При зашифровании имитовставка дописывается к шифртексту, при расшифровании
+// последние s байт входа — имитовставка, она сверяется в final.
+class MgmStream : public CipherStream
+{
+public:
+    MgmStream(std::shared_ptr<const Gost3413Block> block, const QByteArray& nonce, const QByteArray& aad,
+              int tagLength, bool encrypt);
+    ~MgmStream() override;
+
+    MgmStream(const MgmStream&) = delete;
+    MgmStream& operator=(const MgmStream&) = delete;
+
+    bool init(const QVariantMap& params, QString* error = nullptr) override;
+    bool update(const char* data, qsizetype len, QByteArray& out, QString* error = nullptr) override;
+    bool final(QByteArray& out, QString* error = nullptr) override;
+
+    using CipherStream::update;
+
+    // Последний final не прошел из-за несовпадения имитовставки
+    bool tagMismatch() const { return m_tagMismatch; }
+
+    // Несокращенная сумма произведений: 256 бит при n = 16, 128 бит при n = 8
+    // (w[0] — младшее слово); редукция линейна, поэтому выполняется один раз в конце
+    struct Accumulator {
+        quint64 w[4] = {0, 0, 0, 0};
+    };
+
+private:
+    // acc ⊕= Σ h_i ⊗ x_i по blocks парам блоков
+    void accumulate(Accumulator& acc, const uint8_t* h, const uint8_t* x, qsizetype blocks) const;
+
+    // Пачка целых блоков: при out == nullptr — только слагаемые суммы (AAD)
+    void processBlocks(const uint8_t* in, uint8_t* out, qsizetype blocks);
+    bool process(const uint8_t* in, qsizetype len, QByteArray& out, QString* error);
+
+    // Слагаемое для одного блока с множителем H = E(Z), Z — следующий
+    void absorbBlock(const uint8_t* block);
+
+    void clear();
+
+    static const int MAX_BLOCK_SIZE = 16;
+
+    std::shared_ptr<const Gost3413Block> m_block;
+    int m_blockSize;
+    int m_tagLength;
+    bool m_encrypt;
+    bool m_clmul;
+    bool m_ready = false;
+    bool m_tagMismatch = false;
+    QByteArray m_nonce;
+    QByteArray m_aad;
+
+    uint8_t m_y[MAX_BLOCK_SIZE] = {0};
+    uint8_t m_z[MAX_BLOCK_SIZE] = {0};
+    Accumulator m_sum;
+    quint64 m_dataBytes = 0;
+
+    // Неполный блок данных: гамма и накопленные байты шифртекста
+    uint8_t m_gamma[MAX_BLOCK_SIZE] = {0};
+    uint8_t m_partialBlock[MAX_BLOCK_SIZE] = {0};
+    int m_partial = 0;
+
+    // При расшифровании: последние байты входа, которые могут оказаться имитовставкой
+    uint8_t m_tail[MAX_BLOCK_SIZE] = {0};
+    int m_held = 0;
+};
+
+#endif // MGM_H
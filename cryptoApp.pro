@@ -13,7 +13,8 @@ INCLUDEPATH += \
     $$PWD\gui \
     $$PWD\ciphers \
     $$PWD\fabrics \
-    $$PWD\classes
+    $$PWD\classes \
+    $$PWD\cli
 
 
 
@@ -21,6 +22,7 @@ INCLUDEPATH += \
 SOURCES += main.cpp $$files($$PWD/*/*.cpp) \
     ciphers/a51.cpp \
     ciphers/a52.cpp \
+    ciphers/a52attack.cpp \
     ciphers/aes.cpp \
     ciphers/atbash.cpp \
     ciphers/belazo.cpp \
@@ -49,12 +51,24 @@ SOURCES += main.cpp $$files($$PWD/*/*.cpp) \
     ciphers/vigenere_auto.cpp \
     ciphers/vigenere_ciphertext.cpp \
     classes/RestrictedSpinBox.cpp \
+    cli/batchrunner.cpp \
     core/ciphercore.cpp \
+    core/cipherprogress.cpp \
+    core/cipherstream.cpp \
+    core/cpufeatures.cpp \
+    core/keyschedulecache.cpp \
+    core/cipherparallel.cpp \
+    core/ghash.cpp \
+    core/gost3413.cpp \
+    core/mgm.cpp \
+    core/magmacore.cpp \
+    core/hexcodec.cpp \
     fabrics/cipherfactory.cpp \
     fabrics/cipherwidgetfactory.cpp \
     gui/advancedsettingsdialog.cpp \
     gui/analysiswindow.cpp \
     gui/categoryfilterdialog.cpp \
+    gui/ciphertask.cpp \
     gui/formatter.cpp \
     gui/librarywindow.cpp \
     gui/logger.cpp \
@@ -66,6 +80,7 @@ SOURCES += main.cpp $$files($$PWD/*/*.cpp) \
 HEADERS += $$files($$PWD/*/*.h) \    \
     ciphers/a51.h \
     ciphers/a52.h \
+    ciphers/a52attack.h \
     ciphers/aes.h \
     ciphers/atbash.h \
     ciphers/belazo.h \
@@ -95,13 +110,25 @@ HEADERS += $$files($$PWD/*/*.h) \    \
     ciphers/vigenere_auto.h \
     ciphers/vigenere_ciphertext.h \
     classes/RestrictedSpinBox.h \
+    cli/batchrunner.h \
     core/ciphercore.h \
+    core/cipherprogress.h \
     core/cipherinterface.h \
+    core/cipherstream.h \
+    core/cpufeatures.h \
+    core/keyschedulecache.h \
+    core/cipherparallel.h \
+    core/ghash.h \
+    core/gost3413.h \
+    core/mgm.h \
+    core/magmacore.h \
+    core/hexcodec.h \
     fabrics/cipherfactory.h \
     fabrics/cipherwidgetfactory.h \
     gui/advancedsettingsdialog.h \
     gui/analysiswindow.h \
     gui/categoryfilterdialog.h \
+    gui/ciphertask.h \
     gui/formatter.h \
     gui/librarywindow.h \
     gui/logger.h \
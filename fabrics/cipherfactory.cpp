@@ -102,12 +102,14 @@ QString CipherFactory::displayNameFromId(int id) const
 
 std::unique_ptr<CipherInterface> CipherFactory::createCipher(int id)
 {
-    if (!m_ciphers.contains(id)) {
+    // Только чтение: после статической регистрации безопасно из нескольких потоков
+    auto it = m_ciphers.constFind(id);
+    if (it == m_ciphers.constEnd()) {
         qWarning() << "Шифр с ID" << id << "не найден";
         return nullptr;
     }
 
-    return std::unique_ptr<CipherInterface>(m_ciphers[id].creator());
+    return std::unique_ptr<CipherInterface>(it->creator());
 }
 
 std::unique_ptr<CipherInterface> CipherFactory::createCipher(const QString& displayName)
@@ -0,0 +1,65 @@
+#include "ciphertask.h"
+#include "cipherfactory.h"
+#include "cipherprogress.h"
+#include "formatter.h"
+#include <exception>
+
+CipherTask::CipherTask(int cipherId, bool encrypt, const QString& text, const QVariantMap& params,
+                       const CancelFlag& cancelFlag)
+    : m_cipherId(cipherId),
+      m_encrypt(encrypt),
+      m_text(text),
+      m_params(params),
+      m_cancelFlag(cancelFlag)
+{
+    // Объект удаляется в потоке окна (deleteLater по сигналу finished), не пулом
+    setAutoDelete(false);
+}
+
+void CipherTask::run()
+{
+    CipherResult result;
+    QString formatted;
+
+    std::unique_ptr<CipherInterface> cipher = CipherFactory::instance().createCipher(m_cipherId);
+    if (!cipher) {
+        result = CipherResult::failure(CipherStatus::InvalidParams,
+                                       QString("ОШИБКА: Не удалось создать шифр с ID %1").arg(m_cipherId));
+        emit finished(result, formatted);
+        return;
+    }
+
+    try {
+        CipherProgress::Scope scope(m_cancelFlag.get(), [this](qint64 done, qint64 total) {
+            emit progress(done, total);
+        });
+
+        result = m_encrypt ? cipher->encrypt(m_text, m_params)
+                           : cipher->decrypt(m_text, m_params);
+    } catch (const std::exception& e) {
+        result = CipherResult::failure(CipherStatus::InternalError,
+                                       QString("ОШИБКА: Исключение: ") + e.what());
+    } catch (...) {
+        result = CipherResult::failure(CipherStatus::InternalError,
+                                       QString("ОШИБКА: Неизвестное исключение при %1")
+                                           .arg(m_encrypt ? "шифровании" : "дешифровании"));
+    }
+
+    // Шифр прервал работу по флагу отмены и сообщил о нём своей ошибкой
+    if (!result.ok() && m_cancelFlag->load()) {
+        result.fail(CipherStatus::Canceled, CipherProgress::canceledMessage());
+    }
+
+    // Отменённую операцию окно не покажет — форматировать нечего
+    if (!m_cancelFlag->load()) {
+        try {
+            formatted = result.steps.isEmpty()
+                ? StepFormatter::formatResultOnly(result, 5, " ")
+                : StepFormatter::formatResult(result, true, 5, " ");
+        } catch (...) {
+            formatted = "Ошибка при форматировании шагов";
+        }
+    }
+
+    emit finished(result, formatted);
+}
@@ -0,0 +1,44 @@
+#ifndef CIPHERTASK_H
+#define CIPHERTASK_H
+
+#include "ciphercore.h"
+#include <QObject>
+#include <QRunnable>
+#include <QMetaType>
+#include <atomic>
+#include <memory>
+
+Q_DECLARE_METATYPE(CipherResult)
+
+// Шифрование/дешифрование в пуле потоков вместо потока интерфейса.
+// Экземпляр шифра создаётся заново через CipherFactory, форматирование шагов
+// (StepFormatter) тоже выполняется в рабочем потоке. Результат и ход работы
+// приходят в окно сигналами через очередь событий.
+class CipherTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+    CipherTask(int cipherId, bool encrypt, const QString& text, const QVariantMap& params,
+               const CancelFlag& cancelFlag);
+
+    void run() override;
+
+signals:
+    // done из total единиц — по мере обработки блоков
+    void progress(qint64 done, qint64 total);
+
+    // formatted — готовый текст для журнала (шаги или только результат)
+    void finished(const CipherResult& result, const QString& formatted);
+
+private:
+    int m_cipherId;
+    bool m_encrypt;
+    QString m_text;
+    QVariantMap m_params;
+    CancelFlag m_cancelFlag;
+};
+
+#endif // CIPHERTASK_H
@@ -47,6 +47,10 @@ QString StepFormatter::formatResult(const CipherResult& result,
         formatted += formatStepsTable(result.steps);
     }
 
+    if (showSteps && result.suppressedSteps > 0) {
+        formatted += QStringLiteral(u"Пропущено шагов (уровень трассировки): %1\n").arg(result.suppressedSteps);
+    }
+
     // Результат
     formatted += QStringLiteral(u"\n");
     formatted += QStringLiteral(u"Результат");
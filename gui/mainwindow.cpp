@@ -5,6 +5,7 @@
 #include "stylemanager.h"
 #include "advancedsettingsdialog.h"
 #include "categoryfilterdialog.h"
+#include "ciphertask.h"
 
 #include <iostream>
 
@@ -26,6 +27,7 @@
 #include <QGraphicsDropShadowEffect>
 #include <QSequentialAnimationGroup>
 #include <QParallelAnimationGroup>
+#include <QProgressBar>
 
 // ==================== AnimatedButton Class Definition ====================
 class AnimatedButton : public QPushButton
@@ -100,7 +102,11 @@ MainWindow::MainWindow(QWidget *parent)
     , m_filterButton(nullptr)
     , m_analysisWindow(nullptr)
     , m_libraryWindow(nullptr)
+    , m_progressBar(nullptr)
+    , m_cancelButton(nullptr)
 {
+    qRegisterMetaType<CipherResult>();
+
     setupUI();
     setupCiphers();
     setupThemeSelector();
@@ -114,6 +120,11 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // Незавершённая операция прерывается; ждём рабочий поток, чтобы он не пережил окно
+    if (m_taskCancel) {
+        m_taskCancel->store(true);
+    }
+    m_taskPool.waitForDone();
 }
 
 void MainWindow::setupUI()
@@ -385,13 +396,28 @@ void MainWindow::setupUI()
     statusLabel->setAlignment(Qt::AlignCenter);
     statusLabel->setMinimumHeight(40);
 
+    // Ход длительной операции и её отмена (видны только во время работы шифра)
+    m_progressBar = new QProgressBar();
+    m_progressBar->setMaximumWidth(200);
+    m_progressBar->setVisible(false);
+
+    m_cancelButton = new QPushButton("⛔ Отмена");
+    m_cancelButton->setObjectName("cancelButton");
+    m_cancelButton->setToolTip("Прервать шифрование/дешифрование");
+    m_cancelButton->setVisible(false);
+
+    QHBoxLayout *statusLayout = new QHBoxLayout();
+    statusLayout->addWidget(statusLabel, 1);
+    statusLayout->addWidget(m_progressBar);
+    statusLayout->addWidget(m_cancelButton);
+
     // Компоновка всех элементов
     mainLayout->addLayout(topPanelLayout);
     mainLayout->addWidget(parametersGroup);
     mainLayout->addWidget(inputOutputContainer);
     mainLayout->addWidget(consoleGroup);
     mainLayout->addStretch(1);
-    mainLayout->addWidget(statusLabel);
+    mainLayout->addLayout(statusLayout);
 
     // Подключение сигналов
     connect(m_cipherComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -402,6 +428,8 @@ void MainWindow::setupUI()
             this, &MainWindow::onDecryptClicked);
     connect(m_advancedSettingsButton, &QPushButton::clicked,
             this, &MainWindow::onAdvancedSettingsClicked);
+    connect(m_cancelButton, &QPushButton::clicked,
+            this, &MainWindow::onCancelClicked);
 
     // CLEAR
     connect(clearButton, &QPushButton::clicked,
@@ -631,185 +659,158 @@ QVariantMap MainWindow::collectParameters() const
 
 void MainWindow::onEncryptClicked()
 {
+    startCipherTask(true);
+}
+
+void MainWindow::onDecryptClicked()
+{
+    startCipherTask(false);
+}
+
+void MainWindow::startCipherTask(bool encrypt)
+{
+    const QString operation = encrypt ? "шифрования" : "дешифрования";
+
     if (!m_currentCipher) {
         handleError("Шифр не выбран!");
         return;
     }
 
+    if (m_taskRunning) {
+        return;
+    }
+
     QString inputText = inputTextEdit->toPlainText().trimmed();
     if (inputText.isEmpty()) {
-        handleError("Введите текст для шифрования!");
+        handleError("Введите текст для " + operation + "!");
         return;
     }
 
-    setStatusText("Выполняется шифрование...", "info");
+    setStatusText(encrypt ? "Выполняется шифрование..." : "Выполняется дешифрование...", "info");
 
-    try {
-        logToConsole("\n════════════════════════════════════════");
-        logToConsole("ШИФРОВАНИЕ: " + m_currentCipher->name());
-        logToConsole("Входной текст: " + inputText);
+    logToConsole("\n════════════════════════════════════════");
+    logToConsole((encrypt ? "ШИФРОВАНИЕ: " : "ДЕШИФРОВАНИЕ: ") + m_currentCipher->name());
+    logToConsole("Входной текст: " + inputText);
 
-        // Собираем параметры из UI
-        QVariantMap params = collectParameters();
+    // Собираем параметры из UI
+    QVariantMap params = collectParameters();
 
-        // Логируем параметры
-        for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
-            logToConsole(it.key() + ": " + it.value().toString());
-        }
-
-        // Выполняем шифрование с параметрами
-        CipherResult result = m_currentCipher->encrypt(inputText, params);
-
-        // Безопасная проверка результата
-        QString resultText = result.result;
-        QString cipherName = result.cipherName;
-
-        // Проверяем результат на наличие ошибки
-        bool hasError = resultText.isEmpty() ||
-                       resultText.contains("ошибка", Qt::CaseInsensitive) ||
-                       resultText.contains("error", Qt::CaseInsensitive) ||
-                       cipherName.contains("ошибка", Qt::CaseInsensitive);
-
-        if (hasError) {
-            // Формируем сообщение об ошибке
-            QString errorMsg;
-            outputTextEdit->clear();
-            if (resultText.isEmpty()) {
-                errorMsg = "Пустой результат шифрования";
-            } else if (resultText.length() > 100) {
-                errorMsg = resultText.left(100) + "...";
-            } else {
-                errorMsg = resultText;
-            }
+    // Логируем параметры
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        logToConsole(it.key() + ": " + it.value().toString());
+    }
 
-            handleError(errorMsg);
+    // Шифр выполняется в пуле: свой экземпляр, результат — сигналом через очередь
+    m_taskCancel = std::make_shared<std::atomic<bool>>(false);
+    m_taskEncrypt = encrypt;
+    const quint64 serial = ++m_taskSerial;
 
-            // Безопасно логируем шаги, если они есть
-            if (!result.steps.isEmpty()) {
-                try {
-                    QString formatted = StepFormatter::formatResult(result, true, 5, " ");
-                    logToConsole(formatted);
-                } catch (...) {
-                    logToConsole("Ошибка при форматировании шагов");
-                }
-            }
+    CipherTask* task = new CipherTask(m_currentCipherId, encrypt, inputText, params, m_taskCancel);
+    connect(task, &CipherTask::progress, this, [this, serial](qint64 done, qint64 total) {
+        if (serial == m_taskSerial && !m_taskCanceling) {
+            onTaskProgress(done, total);
+        }
+    }, Qt::QueuedConnection);
+    connect(task, &CipherTask::finished, this, [this, serial](const CipherResult& result, const QString& formatted) {
+        if (serial != m_taskSerial) {
             return;
         }
-
-        // Успешное шифрование
-        outputTextEdit->setText(resultText);
-        showSuccessAnimation();
-
-        // Форматируем и выводим результат
-        try {
-            if (!result.steps.isEmpty()) {
-                QString formatted = StepFormatter::formatResult(result, true, 5, " ");
-                logToConsole(formatted);
-            } else {
-                QString formatted = StepFormatter::formatResultOnly(result, 5, " ");
-                logToConsole(formatted);
-            }
-        } catch (...) {
-            logToConsole("Результат: " + resultText);
+        // Результат отменённой операции не показываем; управление возвращается
+        // только теперь, когда рабочий поток действительно завершился
+        if (m_taskCanceling) {
+            setTaskRunning(false);
+            logToConsole(m_taskEncrypt ? "✗ Шифрование отменено" : "✗ Дешифрование отменено");
+            setStatusText("Операция отменена", "warning");
+            return;
         }
+        onTaskFinished(result, formatted);
+    }, Qt::QueuedConnection);
+    connect(task, &CipherTask::finished, task, &QObject::deleteLater, Qt::QueuedConnection);
 
-        handleSuccess("Шифрование успешно завершено! Получено символов: " +
-                     QString::number(resultText.length()));
-
-    } catch (const std::exception& e) {
-        handleError(QString("Исключение: ") + e.what());
-    } catch (...) {
-        handleError("Неизвестное исключение при шифровании");
-    }
+    setTaskRunning(true);
+    m_taskPool.start(task);
 }
 
-void MainWindow::onDecryptClicked()
+void MainWindow::onCancelClicked()
 {
-    if (!m_currentCipher) {
-        handleError("Шифр не выбран!");
+    if (!m_taskRunning || m_taskCanceling) {
         return;
     }
 
-    QString inputText = inputTextEdit->toPlainText().trimmed();
-    if (inputText.isEmpty()) {
-        handleError("Введите текст для дешифрования!");
+    // Рабочий поток остановится на ближайшей проверке; кнопки запуска остаются
+    // недоступными до его сигнала finished, чтобы отмененные задачи не копились в пуле
+    m_taskCancel->store(true);
+    m_taskCanceling = true;
+    m_cancelButton->setEnabled(false);
+    m_cancelButton->setText("⏳ Отмена...");
+    m_progressBar->setRange(0, 0);
+    setStatusText("Отмена операции...", "warning");
+}
+
+void MainWindow::onTaskProgress(qint64 done, qint64 total)
+{
+    if (total <= 0) {
         return;
     }
 
-    setStatusText("Выполняется дешифрование...", "info");
+    m_progressBar->setRange(0, 100);
+    m_progressBar->setValue(int(done * 100 / total));
+}
 
-    try {
-        logToConsole("\n════════════════════════════════════════");
-        logToConsole("ДЕШИФРОВАНИЕ: " + m_currentCipher->name());
-        logToConsole("Входной текст: " + inputText);
-
-        // Собираем параметры из UI
-        QVariantMap params = collectParameters();
-
-        // Выполняем дешифрование
-        CipherResult result = m_currentCipher->decrypt(inputText, params);
-
-        // Безопасная проверка результата
-        QString resultText = result.result;
-        QString cipherName = result.cipherName;
-
-        // Проверяем результат на наличие ошибки
-        bool hasError = resultText.isEmpty() ||
-                       resultText.contains("ошибка", Qt::CaseInsensitive) ||
-                       resultText.contains("error", Qt::CaseInsensitive) ||
-                       cipherName.contains("ошибка", Qt::CaseInsensitive);
-
-        if (hasError) {
-            // Формируем сообщение об ошибке
-            outputTextEdit->clear();
-            QString errorMsg;
-            if (resultText.isEmpty()) {
-                errorMsg = "Пустой результат дешифрования";
-            } else if (resultText.length() > 100) {
-                errorMsg = resultText.left(100) + "...";
-            } else {
-                errorMsg = resultText;
-            }
+void MainWindow::onTaskFinished(const CipherResult& result, const QString& formatted)
+{
+    setTaskRunning(false);
+
+    const bool encrypt = m_taskEncrypt;
+
+    QString resultText = result.result;
+
+    // Успех определяется кодом завершения; пустой результат тоже считаем ошибкой
+    if (!result.ok() || resultText.isEmpty()) {
+        // Формируем сообщение об ошибке
+        outputTextEdit->clear();
+        QString errorMsg;
+        if (result.ok()) {
+            errorMsg = encrypt ? "Пустой результат шифрования" : "Пустой результат дешифрования";
+        } else if (result.message.length() > 100) {
+            errorMsg = result.message.left(100) + "...";
+        } else {
+            errorMsg = result.message;
+        }
 
-            handleError(errorMsg);
+        handleError(errorMsg);
 
-            // Безопасно логируем шаги, если они есть
-            if (!result.steps.isEmpty()) {
-                try {
-                    QString formatted = StepFormatter::formatResult(result, true, 5, " ");
-                    logToConsole(formatted);
-                } catch (...) {
-                    logToConsole("Ошибка при форматировании шагов");
-                }
-            }
-            return;
+        // Шаги, если они есть, уже отформатированы в рабочем потоке
+        if (!result.steps.isEmpty()) {
+            logToConsole(formatted);
         }
+        return;
+    }
 
-        // Успешное дешифрование
-        outputTextEdit->setText(resultText);
-        showSuccessAnimation();
-
-        // Форматируем и выводим результат
-        try {
-            if (!result.steps.isEmpty()) {
-                QString formatted = StepFormatter::formatResult(result, true, 5, " ");
-                logToConsole(formatted);
-            } else {
-                QString formatted = StepFormatter::formatResultOnly(result, 5, " ");
-                logToConsole(formatted);
-            }
-        } catch (...) {
-            logToConsole("Результат: " + resultText);
-        }
+    // Успешное выполнение
+    outputTextEdit->setText(resultText);
+    showSuccessAnimation();
 
-        handleSuccess("Дешифрование успешно завершено! Получено символов: " +
-                     QString::number(resultText.length()));
+    logToConsole(formatted.isEmpty() ? "Результат: " + resultText : formatted);
 
-    } catch (const std::exception& e) {
-        handleError(QString("Исключение: ") + e.what());
-    } catch (...) {
-        handleError("Неизвестное исключение при дешифровании");
-    }
+    handleSuccess(QString(encrypt ? "Шифрование" : "Дешифрование") +
+                  " успешно завершено! Получено символов: " + QString::number(resultText.length()));
+}
+
+void MainWindow::setTaskRunning(bool running)
+{
+    m_taskRunning = running;
+    m_taskCanceling = false;
+    m_cancelButton->setEnabled(true);
+    m_cancelButton->setText("⛔ Отмена");
+    encryptButton->setEnabled(!running);
+    decryptButton->setEnabled(!running);
+    m_cancelButton->setVisible(running);
+    m_progressBar->setVisible(running);
+
+    // Пока шифр не сообщил о ходе работы — неопределённый индикатор
+    m_progressBar->setRange(0, 0);
+    m_progressBar->setValue(0);
 }
 
 void MainWindow::onClearClicked()
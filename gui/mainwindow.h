@@ -26,6 +26,9 @@
 #include <QParallelAnimationGroup>
 #include <QPlainTextEdit>
 #include <QTimer>
+#include <QProgressBar>
+#include <QThreadPool>
+#include <atomic>
 
 
 class CategoryFilterDialog;
@@ -56,6 +59,7 @@ private slots:
     void onInputTextChanged();
     void onAnalysisWindowOpen();
     void onLibraryWindowOpen();
+    void onCancelClicked();
 
 private:
     void setupUI();
@@ -74,6 +78,12 @@ private:
     QVariantMap collectParameters() const;
     void applyFilter();                // Добавить
 
+    // Выполнение шифра в рабочем потоке
+    void startCipherTask(bool encrypt);
+    void onTaskProgress(qint64 done, qint64 total);
+    void onTaskFinished(const CipherResult& result, const QString& formatted);
+    void setTaskRunning(bool running);
+
     // UI Elements
     QComboBox* m_cipherComboBox;
     QComboBox* themeComboBox;
@@ -114,6 +124,16 @@ private:
     QMap<QString, QVariantMap> m_cipherAdvancedSettings;
 
     QTimer* m_statusResetTimer;
+
+    // Рабочий поток шифра
+    QProgressBar* m_progressBar;
+    QPushButton* m_cancelButton;
+    QThreadPool m_taskPool;
+    std::shared_ptr<std::atomic<bool>> m_taskCancel;
+    quint64 m_taskSerial = 0;
+    bool m_taskRunning = false;
+    bool m_taskCanceling = false;   // Отмена запрошена, рабочий поток еще не завершился
+    bool m_taskEncrypt = true;
 };
 
 #endif // MAINWINDOW_H
@@ -1,38 +1,9 @@
 // main.cpp - отдельный файл
 #include <QApplication>
-#include <iostream>
+#include <QCoreApplication>
+#include <cstdlib>
 #include "mainwindow.h"
-#include "atbash.h"
-#include "formatter.h"
-
-// Функция для консольных тестов
-void runConsoleTests() {
-#ifdef _WIN32
-    system("chcp 65001 > nul");
-#endif
-
-    std::cout << "=== КОНСОЛЬНЫЙ РЕЖИМ ===" << std::endl;
-    std::cout << "Для запуска GUI используйте: cryptoApp --gui" << std::endl;
-    std::cout << std::endl;
-
-    // Простой тест Atbash
-    AtbashCipher cipher;
-
-    std::cout << "Быстрый тест Atbash:" << std::endl;
-    std::cout << "====================" << std::endl;
-
-    QString testText = "ПРИВЕТМИР";
-    CipherResult result = cipher.encrypt(testText);
-
-    std::cout << "Вход:  " << testText.toUtf8().constData() << std::endl;
-    std::cout << "Выход: " << result.result.toUtf8().constData() << std::endl;
-
-    // Используем ваш formatter
-    QString formatted = StepFormatter::formatResultOnly(result, 5);
-    std::cout << "Форматированный: " << formatted.toUtf8().constData() << std::endl;
-
-    std::cout << std::endl << "=== ТЕСТ ЗАВЕРШЕН ===" << std::endl;
-}
+#include "batchrunner.h"
 
 int main(int argc, char *argv[]) {
     // Проверяем аргументы командной строки
@@ -46,9 +17,12 @@ int main(int argc, char *argv[]) {
     }
 
     if (!guiMode) {
-        // Консольный режим
-        runConsoleTests();
-        return 0;
+        // Консольный режим: только QtCore, без виджетов (cryptoApp --help)
+#ifdef _WIN32
+        system("chcp 65001 > nul");
+#endif
+        QCoreApplication app(argc, argv);
+        return BatchRunner::run(app.arguments());
     }
 
     // GUI режим